@@ -1,7 +1,89 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
+#include <random>
+#include <thread>
+#include "game_loop.hpp"
 #include "platform.hpp"
+#include "replay.hpp"
+
+// The standard simulation benchmark: 8 players with 1000 units each, every
+// player ordering a random group of 50 to a random spot every few ticks,
+// for 3000 ticks (100 s of game at 30 Hz). Recorded the way a live game
+// would be: commands scheduled a couple of ticks ahead, captured per step.
+static Replay record_benchmark() {
+  constexpr uint32_t kPlayers = 8, kUnits = 1000, kGroup = 50;
+  constexpr uint64_t kTicks = 3000, kInputDelay = 2;
+
+  std::mt19937 rng(50);
+  std::uniform_int_distribution<int32_t>  coord(0, 512 * Fixed::kOne);
+  std::uniform_int_distribution<uint32_t> unit(0, kUnits - 1);
+  uint32_t seq[kPlayers] = {};
+
+  LockstepSim sim;
+  Replay      replay;
+  for (uint32_t p = 0; p < kPlayers; ++p)
+    for (uint32_t i = 0; i < kUnits; ++i)
+      sim.schedule({ 0, p, seq[p]++, SimCommandType::Spawn, {},
+                     Fixed::from_raw(coord(rng)), Fixed::from_raw(coord(rng)) });
+
+  while (sim.tick() < kTicks) {
+    const uint64_t due = sim.tick() + kInputDelay;
+    if (due < kTicks && due % 4 == 0) {
+      for (uint32_t p = 0; p < kPlayers; ++p) {
+        const Fixed x = Fixed::from_raw(coord(rng)), z = Fixed::from_raw(coord(rng));
+        // spawns run in (player, seq) order: player p owns p*kUnits ...
+        for (uint32_t k = 0; k < kGroup; ++k)
+          sim.schedule({ due, p, seq[p]++, SimCommandType::Move, Entity{ p * kUnits + unit(rng), 0 }, x, z });
+      }
+    }
+    sim.step();
+    replay_capture(replay, sim);
+  }
+  return replay;
+}
+
+// Headless: no window, no device. Runs the recording as fast as the CPU
+// allows and reports the tick rate; exits non-zero on a checksum mismatch.
+static int run_replay(const char* path) {
+  Replay replay;
+  if (!load_replay(path, replay)) {
+    std::cerr << "can't read replay " << path << "\n";
+    return 1;
+  }
+
+  using Clock = std::chrono::steady_clock;
+  LockstepSim sim;
+  const auto   t0      = Clock::now();
+  const bool   match   = replay_play(replay, sim);
+  const double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+
+  std::printf("replay %s: %llu ticks, %zu commands, %u units\n", path,
+              (unsigned long long)replay.ticks, replay.commands.size(), sim.state().size());
+  std::printf("  %.3f s  %.0f ticks/s  (%.1fx a 30 Hz game)\n",
+              seconds, double(replay.ticks) / seconds, double(replay.ticks) / seconds / 30.0);
+  std::printf("  checksum %016llx %s\n", (unsigned long long)sim.checksum(),
+              match ? "matches" : "DOES NOT MATCH the recording: the sim desynced");
+  return match ? 0 : 2;
+}
+
+int main(int argc, char** argv) {
+  for (int i = 1; i < argc; ++i) {
+    if (!std::strcmp(argv[i], "--replay") && i + 1 < argc)
+      return run_replay(argv[i + 1]);
+    if (!std::strcmp(argv[i], "--record-benchmark") && i + 1 < argc) {
+      const Replay replay = record_benchmark();
+      if (!save_replay(argv[i + 1], replay)) {
+        std::cerr << "can't write replay " << argv[i + 1] << "\n";
+        return 1;
+      }
+      std::cout << "wrote " << argv[i + 1] << ": " << replay.ticks << " ticks, "
+                << replay.commands.size() << " commands\n";
+      return 0;
+    }
+  }
 
-int main() {
   std::cout << "hello, world 👋 \n";
 
   print_libs();
@@ -12,10 +94,21 @@ int main() {
   std::cout << "platform inilized \n";
 
 
-  while(!platform_should_quit()){
+  // The sim ticks at its fixed rate (LockstepSim::kDt, 30 Hz) from the
+  // frame loop. Nothing is drawn yet, so there is no vsync to block on:
+  // sleep until the next tick is due instead of spinning a core.
+  LockstepSim sim;
+  GameLoop    loop;
+  loop.start(30.0, [&](uint64_t) { sim.step(); }, nullptr, /*threaded*/false);
 
+  while(!platform_should_quit()){
+    loop.pump();
+    const double wait = (1.0 - loop.alpha(loop.ticks())) * loop.tick_seconds();
+    std::this_thread::sleep_for(std::chrono::duration<double>(wait));
   }
 
+  loop.stop();
+
   std::cout << "cleanup \n";
 
   platform_shutdown();
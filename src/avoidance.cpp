@@ -0,0 +1,273 @@
+#include "avoidance.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include "jobs.hpp"
+
+namespace {
+
+struct Vec2 { float x, z; };
+inline Vec2  operator+(Vec2 a, Vec2 b)  { return { a.x + b.x, a.z + b.z }; }
+inline Vec2  operator-(Vec2 a, Vec2 b)  { return { a.x - b.x, a.z - b.z }; }
+inline Vec2  operator*(float s, Vec2 a) { return { s * a.x, s * a.z }; }
+inline float dot(Vec2 a, Vec2 b)        { return a.x * b.x + a.z * b.z; }
+inline float det(Vec2 a, Vec2 b)        { return a.x * b.z - a.z * b.x; }
+inline float len2(Vec2 a)               { return dot(a, a); }
+
+constexpr float kEps = 1e-5f;
+
+// Allowed velocities lie left of 'direction' through 'point'.
+struct Line { Vec2 point, direction; };
+
+using Lines = std::array<Line, CrowdAvoidance::kMaxNeighbors>;
+
+// Best point on line 'no' within the speed circle and lines [0, no).
+bool lp1(const Line* lines, uint32_t no, float radius, Vec2 opt, bool direction_opt, Vec2& result) {
+    const Line& L = lines[no];
+    const float d    = dot(L.point, L.direction);
+    const float disc = d * d + radius * radius - len2(L.point);
+    if (disc < 0.f) return false;   // the speed circle misses the line
+
+    const float sq = std::sqrt(disc);
+    float t_left = -d - sq, t_right = -d + sq;
+    for (uint32_t i = 0; i < no; ++i) {
+        const float denom = det(L.direction, lines[i].direction);
+        const float numer = det(lines[i].direction, L.point - lines[i].point);
+        if (std::fabs(denom) <= kEps) {   // parallel
+            if (numer < 0.f) return false;
+            continue;
+        }
+        const float t = numer / denom;
+        if (denom >= 0.f) t_right = std::min(t_right, t);
+        else              t_left  = std::max(t_left, t);
+        if (t_left > t_right) return false;
+    }
+
+    if (direction_opt) {
+        result = L.point + (dot(opt, L.direction) > 0.f ? t_right : t_left) * L.direction;
+    } else {
+        const float t = std::clamp(dot(L.direction, opt - L.point), t_left, t_right);
+        result = L.point + t * L.direction;
+    }
+    return true;
+}
+
+// Closest velocity to 'opt' satisfying every line; returns the count on
+// success, else the index of the line that made it infeasible.
+uint32_t lp2(const Line* lines, uint32_t count, float radius, Vec2 opt, bool direction_opt, Vec2& result) {
+    if (direction_opt)                  result = radius * opt;   // opt is a unit direction here
+    else if (len2(opt) > radius * radius) result = (radius / std::sqrt(len2(opt))) * opt;
+    else                                result = opt;
+
+    for (uint32_t i = 0; i < count; ++i) {
+        if (det(lines[i].direction, lines[i].point - result) > 0.f) {
+            const Vec2 keep = result;
+            if (!lp1(lines, i, radius, opt, direction_opt, result)) { result = keep; return i; }
+        }
+    }
+    return count;
+}
+
+// Infeasible: minimise the largest violation from line 'begin' on instead.
+void lp3(const Line* lines, uint32_t count, uint32_t begin, float radius, Vec2& result) {
+    float distance = 0.f;
+    Lines proj;
+    for (uint32_t i = begin; i < count; ++i) {
+        if (det(lines[i].direction, lines[i].point - result) <= distance) continue;
+
+        uint32_t n = 0;
+        for (uint32_t j = 0; j < i; ++j) {
+            Line line;
+            const float d = det(lines[i].direction, lines[j].direction);
+            if (std::fabs(d) <= kEps) {
+                if (dot(lines[i].direction, lines[j].direction) > 0.f) continue;   // same direction
+                line.point = 0.5f * (lines[i].point + lines[j].point);
+            } else {
+                line.point = lines[i].point +
+                             (det(lines[j].direction, lines[i].point - lines[j].point) / d) * lines[i].direction;
+            }
+            const Vec2 dir = lines[j].direction - lines[i].direction;
+            line.direction = (1.f / std::sqrt(len2(dir))) * dir;
+            proj[n++] = line;
+        }
+
+        const Vec2 keep = result;
+        if (lp2(proj.data(), n, radius, Vec2{ -lines[i].direction.z, lines[i].direction.x }, true, result) < n)
+            result = keep;   // only float error gets here
+        distance = det(lines[i].direction, lines[i].point - result);
+    }
+}
+
+} // namespace
+
+void CrowdAvoidance::bin_(const AvoidanceAgents& a) {
+    const uint32_t n = a.size();
+    float max_x = a.x[0], max_z = a.z[0];
+    m_min_x = a.x[0]; m_min_z = a.z[0];
+    for (uint32_t i = 1; i < n; ++i) {
+        m_min_x = std::min(m_min_x, a.x[i]); max_x = std::max(max_x, a.x[i]);
+        m_min_z = std::min(m_min_z, a.z[i]); max_z = std::max(max_z, a.z[i]);
+    }
+    // Cells at least as wide as the neighbour range, so a search reads 3x3
+    // of them; sparse crowds over a big area get coarser cells to bound the grid.
+    m_cell = std::max(params.neighbor_dist, 1e-3f);
+    for (;;) {
+        m_cells_x = uint32_t((max_x - m_min_x) / m_cell) + 1;
+        m_cells_z = uint32_t((max_z - m_min_z) / m_cell) + 1;
+        if (uint64_t(m_cells_x) * m_cells_z <= 4ull * n + 64) break;
+        m_cell *= 2.f;
+    }
+
+    // counting sort by cell; ties keep input order
+    const uint32_t cells = m_cells_x * m_cells_z;
+    m_cell_of.resize(n);
+    m_start.assign(size_t(cells) + 1, 0);
+    for (uint32_t i = 0; i < n; ++i) {
+        m_cell_of[i] = cell_(a.x[i], a.z[i]);
+        ++m_start[m_cell_of[i] + 1];
+    }
+    for (uint32_t c = 0; c < cells; ++c) m_start[c + 1] += m_start[c];
+
+    m_next.assign(m_start.begin(), m_start.end() - 1);
+    m_order.resize(n);
+    for (uint32_t i = 0; i < n; ++i) m_order[m_next[m_cell_of[i]]++] = i;
+
+    for (auto* v : { &m_x, &m_z, &m_vx, &m_vz, &m_r }) v->resize(n);
+    for (uint32_t s = 0; s < n; ++s) {
+        const uint32_t i = m_order[s];
+        m_x[s]  = a.x[i];  m_z[s]  = a.z[i];
+        m_vx[s] = a.vx[i]; m_vz[s] = a.vz[i];
+        m_r[s]  = a.radius[i];
+    }
+}
+
+void CrowdAvoidance::solve(AvoidanceAgents& a, float dt) {
+    const uint32_t n = a.size();
+    if (n == 0) return;
+    bin_(a);
+
+    const uint32_t max_nb  = std::min(params.max_neighbors, kMaxNeighbors);
+    const float    range2  = params.neighbor_dist * params.neighbor_dist;
+    const float    inv_tau = 1.f / params.time_horizon;
+    const float    inv_dt  = 1.f / dt;
+
+    // Results go straight to the caller's arrays: each agent writes its own
+    // entry only, and reads neighbours from the sorted copies.
+    g_jobs.parallel_for(n, 128, [&](uint32_t begin, uint32_t end) {
+        std::vector<float> d2;
+        for (uint32_t s = begin; s < end; ++s) {
+            const float px = m_x[s], pz = m_z[s];
+
+            // nearest max_nb in range, kept sorted by (distance², slot)
+            std::array<std::pair<float, uint32_t>, kMaxNeighbors> nb;
+            uint32_t count = 0;
+            const uint32_t cell = cell_(px, pz), cx = cell % m_cells_x, cz = cell / m_cells_x;
+            for (uint32_t z = cz > 0 ? cz - 1 : 0; z <= std::min(m_cells_z - 1, cz + 1); ++z) {
+                const uint32_t x0 = cx > 0 ? cx - 1 : 0, x1 = std::min(m_cells_x - 1, cx + 1);
+                // a row of cells is one contiguous run of sorted slots
+                const uint32_t first = m_start[z * m_cells_x + x0], last = m_start[z * m_cells_x + x1 + 1];
+                d2.resize(last - first);
+                for (uint32_t j = first; j < last; ++j) {   // vectorizes: plain SoA arithmetic
+                    const float dx = m_x[j] - px, dz = m_z[j] - pz;
+                    d2[j - first] = dx * dx + dz * dz;
+                }
+                for (uint32_t j = first; j < last; ++j) {
+                    const float d = d2[j - first];
+                    if (d >= range2 || j == s) continue;
+                    if (count == max_nb && (count == 0 || !(std::make_pair(d, j) < nb[count - 1]))) continue;
+                    uint32_t k = count < max_nb ? count++ : count - 1;
+                    for (; k > 0 && std::make_pair(d, j) < nb[k - 1]; --k) nb[k] = nb[k - 1];
+                    nb[k] = { d, j };
+                }
+            }
+
+            // one ORCA half-plane per neighbour
+            Lines lines;
+            const Vec2  pos{ px, pz }, vel{ m_vx[s], m_vz[s] };
+            const float r = m_r[s];
+            for (uint32_t k = 0; k < count; ++k) {
+                const uint32_t o = nb[k].second;
+                const Vec2  rel_pos = Vec2{ m_x[o], m_z[o] } - pos;
+                const Vec2  rel_vel = vel - Vec2{ m_vx[o], m_vz[o] };
+                const float dist2   = nb[k].first;
+                const float rr      = r + m_r[o];
+                const float rr2     = rr * rr;
+
+                Line line;
+                Vec2 u;
+                if (dist2 > rr2) {
+                    // w: from the cut-off circle's centre to the relative velocity
+                    const Vec2  w     = rel_vel - inv_tau * rel_pos;
+                    const float w2    = len2(w);
+                    const float dot1  = dot(w, rel_pos);
+                    if (dot1 < 0.f && dot1 * dot1 > rr2 * w2) {   // project on the cut-off circle
+                        const float wl     = std::sqrt(w2);
+                        const Vec2  unit_w = (1.f / wl) * w;
+                        line.direction = { unit_w.z, -unit_w.x };
+                        u = (rr * inv_tau - wl) * unit_w;
+                    } else {                                     // project on a leg of the cone
+                        const float leg = std::sqrt(dist2 - rr2);
+                        if (det(rel_pos, w) > 0.f)
+                            line.direction = (1.f / dist2) * Vec2{ rel_pos.x * leg - rel_pos.z * rr,
+                                                                   rel_pos.x * rr + rel_pos.z * leg };
+                        else
+                            line.direction = (-1.f / dist2) * Vec2{ rel_pos.x * leg + rel_pos.z * rr,
+                                                                    -rel_pos.x * rr + rel_pos.z * leg };
+                        u = dot(rel_vel, line.direction) * line.direction - rel_vel;
+                    }
+                } else {
+                    // already overlapping: get apart within one step
+                    const Vec2  w  = rel_vel - inv_dt * rel_pos;
+                    const float wl = std::sqrt(len2(w));
+                    // stacked exactly: split by slot so the pair goes opposite ways
+                    const Vec2  unit_w = wl > kEps ? (1.f / wl) * w : Vec2{ s < o ? -1.f : 1.f, 0.f };
+                    line.direction = { unit_w.z, -unit_w.x };
+                    u = (rr * inv_dt - wl) * unit_w;
+                }
+                line.point = vel + 0.5f * u;   // reciprocal: each side takes half
+                lines[k] = line;
+            }
+
+            const float max_speed = a.max_speed[m_order[s]];
+            const Vec2  pref{ a.pref_x[m_order[s]], a.pref_z[m_order[s]] };
+            Vec2 result;
+            const uint32_t fail = lp2(lines.data(), count, max_speed, pref, false, result);
+            if (fail < count) lp3(lines.data(), count, fail, max_speed, result);
+            // nearly parallel lines put lp3's intersections far out, and
+            // float error there can land past the speed circle
+            const float speed2 = len2(result);
+            if (speed2 > max_speed * max_speed) result = (max_speed / std::sqrt(speed2)) * result;
+
+            a.vx[m_order[s]] = result.x;
+            a.vz[m_order[s]] = result.z;
+        }
+    });
+}
+
+void CrowdAvoidance::solve(UnitStore& units, float dt) {
+    const auto&   pool = units.pool<Agent>();
+    const Agent*  ag   = pool.values().data();
+    const Entity* e    = pool.entities().data();
+
+    m_units.resize(0);
+    m_entities.clear();
+    for (uint32_t i = 0; i < pool.size(); ++i) {
+        const Position* p = units.get<Position>(e[i]);
+        const Velocity* v = units.get<Velocity>(e[i]);
+        if (!p || !v) continue;
+        m_units.x.push_back(p->x);        m_units.z.push_back(p->z);
+        m_units.vx.push_back(ag[i].vx);   m_units.vz.push_back(ag[i].vz);
+        m_units.pref_x.push_back(v->x);   m_units.pref_z.push_back(v->z);
+        m_units.radius.push_back(ag[i].radius);
+        m_units.max_speed.push_back(ag[i].max_speed);
+        m_entities.push_back(e[i]);
+    }
+    solve(m_units, dt);
+
+    for (uint32_t i = 0; i < m_entities.size(); ++i) {
+        *units.get<Velocity>(m_entities[i]) = Velocity{ m_units.vx[i], m_units.vz[i] };
+        Agent* a = units.get<Agent>(m_entities[i]);
+        a->vx = m_units.vx[i];
+        a->vz = m_units.vz[i];
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef AVOIDANCE_HPP
+#define AVOIDANCE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "unit_store.hpp"
+
+// Local collision avoidance with ORCA (optimal reciprocal collision
+// avoidance, the RVO2 formulation without static obstacles): each agent
+// turns every nearby agent into a half-plane of velocities that keep them
+// apart for 'time_horizon' seconds, each side taking half the correction,
+// and picks the allowed velocity closest to the one it wanted with a small
+// 2D linear program. Pathing (flow fields, HPA*) says where to go; this
+// keeps units from walking through each other on the way.
+//
+// Agents are binned into a cell grid and copied into cell-sorted SoA arrays
+// every solve, so the neighbour scan reads contiguous floats (a straight
+// loop the compiler vectorizes) and nearby agents share cache lines. Agents
+// are solved in parallel on g_jobs; each one reads the shared arrays and
+// writes only its own result, in a fixed neighbour order, so the output
+// doesn't depend on the thread count. Pure CPU.
+struct AvoidanceParams {
+    float    neighbor_dist = 3.f;    // world units between centres
+    uint32_t max_neighbors = 10;     // nearest ones considered, at most kMaxNeighbors
+    float    time_horizon  = 1.5f;   // seconds of lookahead
+};
+
+// Input and output of a solve, one entry per agent. vx/vz hold the current
+// velocity on the way in and the avoiding one on the way out.
+struct AvoidanceAgents {
+    std::vector<float> x, z, vx, vz, pref_x, pref_z, radius, max_speed;
+
+    uint32_t size() const { return uint32_t(x.size()); }
+    void resize(uint32_t n) {
+        for (auto* v : { &x, &z, &vx, &vz, &pref_x, &pref_z, &radius, &max_speed }) v->resize(n);
+    }
+};
+
+class CrowdAvoidance {
+public:
+    static constexpr uint32_t kMaxNeighbors = 16;
+
+    AvoidanceParams params;
+
+    // New vx/vz for every agent. 'dt' is the sim step (used to separate
+    // agents that already overlap).
+    void solve(AvoidanceAgents& agents, float dt);
+
+    // Every unit with Position + Velocity + Agent: Velocity is the preferred
+    // velocity on the way in (what steer_along wrote) and the avoiding one
+    // on the way out; Agent keeps it as next tick's current velocity. Run
+    // between steering and integrate_velocity.
+    void solve(UnitStore& units, float dt);
+
+private:
+    void bin_(const AvoidanceAgents& a);
+    uint32_t cell_(float x, float z) const {
+        const uint32_t cx = std::min(m_cells_x - 1, uint32_t(std::max(0.f, x - m_min_x) / m_cell));
+        const uint32_t cz = std::min(m_cells_z - 1, uint32_t(std::max(0.f, z - m_min_z) / m_cell));
+        return cz * m_cells_x + cx;
+    }
+
+    float    m_cell = 1.f, m_min_x = 0.f, m_min_z = 0.f;
+    uint32_t m_cells_x = 0, m_cells_z = 0;
+
+    std::vector<uint32_t> m_cell_of;     // per agent
+    std::vector<uint32_t> m_start;       // per cell + 1: first sorted slot
+    std::vector<uint32_t> m_next;        // counting-sort cursors
+    std::vector<uint32_t> m_order;       // sorted slot -> agent
+    std::vector<float>    m_x, m_z, m_vx, m_vz, m_r;   // sorted SoA
+
+    AvoidanceAgents       m_units;       // scratch for the UnitStore path
+    std::vector<Entity>   m_entities;
+};
+
+#endif // AVOIDANCE_HPP
@@ -0,0 +1,113 @@
+#include "bindless.hpp"
+#include "render_pipeline.hpp"
+
+#include <algorithm>
+
+VkResult BindlessTextures::create(VkDevice device, DescriptorLayoutCache& layouts, uint32_t capacity) {
+    destroy();
+    m_device   = device;
+    m_indexing = g_vulkan.descriptor_indexing;
+    m_capacity = std::min(capacity, g_vulkan.max_bindless_textures);
+    DEBUG_ASSERT(m_capacity > 0);
+
+    const VkShaderStageFlags stages = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT |
+                                      VK_SHADER_STAGE_COMPUTE_BIT;
+    auto binding = render::desc_binding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, m_capacity, stages);
+
+    // update-after-bind needs its own pool flag, so the table owns its pool
+    // instead of going through a DescriptorAllocator
+    VkDescriptorSetLayoutCreateFlags layout_flags = 0;
+    VkDescriptorPoolCreateFlags      pool_flags   = 0;
+    VkDescriptorBindingFlags         bind_flags   = 0;
+    if (m_indexing) {
+        layout_flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+        pool_flags   = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+        bind_flags   = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+                       VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT;
+    }
+
+    if (auto e = layouts.get({ &binding, 1 }, m_layout, layout_flags,
+                             m_indexing ? std::span<const VkDescriptorBindingFlags>(&bind_flags, 1)
+                                        : std::span<const VkDescriptorBindingFlags>())) return e;
+
+    auto size = render::desc_pool_size(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, m_capacity);
+    auto pci  = render::desc_pool_info({ &size, 1 }, 1, pool_flags);
+    if (auto e = vkCreateDescriptorPool(device, &pci, nullptr, &m_pool)) return e;
+
+    auto ai = render::desc_alloc_info(m_pool, { &m_layout, 1 });
+    if (auto e = vkAllocateDescriptorSets(device, &ai, &m_set)) return e;
+
+    LOG("bindless textures: %u slots (%s)", m_capacity,
+        m_indexing ? "update-after-bind" : "fixed array fallback");
+    return VK_SUCCESS;
+}
+
+void BindlessTextures::destroy() {
+    if (m_pool) vkDestroyDescriptorPool(m_device, m_pool, nullptr);
+    m_pool   = VK_NULL_HANDLE;
+    m_set    = VK_NULL_HANDLE;
+    m_layout = VK_NULL_HANDLE;
+    m_free.clear();
+    m_next = m_count = m_capacity = 0;
+}
+
+void BindlessTextures::write_(uint32_t index, VkImageView view, VkSampler sampler, VkImageLayout layout) {
+    auto ii = render::desc_image_info(sampler, view, layout);
+    auto w  = render::desc_write_image(m_set, 0, &ii, index);
+    vkUpdateDescriptorSets(m_device, 1, &w, 0, nullptr);
+}
+
+uint32_t BindlessTextures::add(VkImageView view, VkSampler sampler, VkImageLayout layout) {
+    const bool first_ever = m_next == 0;
+    uint32_t index;
+    if (!m_free.empty()) { index = m_free.back(); m_free.pop_back(); }
+    else if (m_next < m_capacity) index = m_next++;
+    else return INVALID;
+
+    ++m_count;
+    if (!m_indexing && first_ever) {
+        // every slot must be valid without partially bound: seed them all with
+        // the first texture so indices nobody wrote yet still sample something
+        std::vector<VkDescriptorImageInfo> fill(m_capacity, render::desc_image_info(sampler, view, layout));
+        auto w = render::desc_write_image(m_set, 0, fill.data(), 0);
+        w.descriptorCount = m_capacity;
+        vkUpdateDescriptorSets(m_device, 1, &w, 0, nullptr);
+        return index;
+    }
+    write_(index, view, sampler, layout);
+    return index;
+}
+
+void BindlessTextures::update(uint32_t index, VkImageView view, VkSampler sampler, VkImageLayout layout) {
+    DEBUG_ASSERT(index < m_next);
+    write_(index, view, sampler, layout);
+}
+
+void BindlessTextures::remove(uint32_t index) {
+    DEBUG_ASSERT(index < m_next && m_count > 0);
+    DEBUG_ASSERT(std::find(m_free.begin(), m_free.end(), index) == m_free.end() && "double remove");
+    m_free.push_back(index);
+    --m_count;
+    // the stale descriptor stays written: harmless as long as nobody indexes it
+}
+
+void BindlessTextures::bind(VkCommandBuffer cb, VkPipelineLayout layout, uint32_t set_index,
+                            VkPipelineBindPoint bind_point) const {
+    vkCmdBindDescriptorSets(cb, bind_point, layout, set_index, 1, &m_set, 0, nullptr);
+}
+
+std::string BindlessTextures::glsl_decl(uint32_t set) const {
+    std::string s;
+    if (m_indexing) {
+        s += "#extension GL_EXT_nonuniform_qualifier : require\n";
+        s += "layout(set=" + std::to_string(set) + ", binding=0) uniform sampler2D u_textures[];\n";
+        s += "#define bindless_texture(i) u_textures[nonuniformEXT(i)]\n";
+    } else {
+        // without nonuniform indexing the index must be dynamically uniform
+        // (per draw); per-instance indices then need one draw per texture
+        s += "layout(set=" + std::to_string(set) + ", binding=0) uniform sampler2D u_textures["
+           + std::to_string(m_capacity) + "];\n";
+        s += "#define bindless_texture(i) u_textures[i]\n";
+    }
+    return s;
+}
@@ -0,0 +1,65 @@
+#ifndef BINDLESS_HPP
+#define BINDLESS_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "platform.hpp"
+#include "descriptors.hpp"
+
+// One global array of combined image samplers. Textures register once and get
+// a stable index; shaders read them as u_textures[nonuniformEXT(index)], with
+// the index carried in instance data. Renderers then batch across textures
+// instead of splitting draws on every descriptor change.
+//
+// With g_vulkan.descriptor_indexing the set is update-after-bind and partially
+// bound: registering while the set is bound in pending command buffers is fine
+// and unused slots may stay empty. Without it the table still works as a plain
+// fixed-size array (unused slots point at texture 0), but register/update must
+// happen while no submitted work uses the set (load time).
+class BindlessTextures {
+public:
+    // capacity is clamped to g_vulkan.max_bindless_textures.
+    VkResult create(VkDevice device, DescriptorLayoutCache& layouts, uint32_t capacity = 4096);
+    void destroy();
+
+    static constexpr uint32_t INVALID = UINT32_MAX;
+
+    // Returns the slot index, or INVALID when the table is full.
+    uint32_t add(VkImageView view, VkSampler sampler,
+                 VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    void     update(uint32_t index, VkImageView view, VkSampler sampler,
+                    VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    // Slot becomes reusable; the caller makes sure the GPU is done sampling it.
+    void     remove(uint32_t index);
+
+    void bind(VkCommandBuffer cb, VkPipelineLayout layout, uint32_t set_index,
+              VkPipelineBindPoint bind_point = VK_PIPELINE_BIND_POINT_GRAPHICS) const;
+
+    VkDescriptorSetLayout set_layout() const { return m_layout; }
+    VkDescriptorSet       set()        const { return m_set; }
+    uint32_t              capacity()   const { return m_capacity; }
+    uint32_t              count()      const { return m_count; }
+
+    // GLSL declaration of the table at (set, binding 0), named u_textures.
+    // Index it through bindless_texture(i) so the same shader source works on
+    // both paths.
+    std::string glsl_decl(uint32_t set) const;
+
+private:
+    void write_(uint32_t index, VkImageView view, VkSampler sampler, VkImageLayout layout);
+
+    VkDevice              m_device   = VK_NULL_HANDLE;
+    VkDescriptorPool      m_pool     = VK_NULL_HANDLE;
+    VkDescriptorSetLayout m_layout   = VK_NULL_HANDLE;  // owned by the layout cache
+    VkDescriptorSet       m_set      = VK_NULL_HANDLE;
+    uint32_t              m_capacity = 0;
+    uint32_t              m_count    = 0;
+    bool                  m_indexing = false;
+
+    std::vector<uint32_t> m_free;      // released slots, reused first
+    uint32_t              m_next = 0;  // first never-used slot
+};
+
+#endif // BINDLESS_HPP
@@ -0,0 +1,106 @@
+#include "camera.hpp"
+#include <algorithm>
+#include <cmath>
+
+static float dot3(const float a[3], const float b[3]) { return a[0]*b[0] + a[1]*b[1] + a[2]*b[2]; }
+
+void Camera::set_viewport(float width_px, float height_px) {
+    m_w = std::max(width_px,  1.f);
+    m_h = std::max(height_px, 1.f);
+}
+
+void Camera::update() {
+    zoom = std::clamp(zoom, min_zoom, max_zoom);
+
+    const float p = mode == CameraMode::TopDown ? 1.57079633f : pitch;
+    const float y = mode == CameraMode::TopDown ? 0.f         : yaw;
+    const float sp = std::sin(p), cp = std::cos(p);
+    const float sy = std::sin(y), cy = std::cos(y);
+
+    // forward looks down and toward -z (yaw 0), so nearer ground sits lower on
+    // screen; down = forward x right, which is +z for TopDown
+    const float f[3] = { -cp * sy, -sp, -cp * cy };
+    const float r[3] = {  cy,      0.f, -sy      };
+    const float d[3] = { f[1]*r[2] - f[2]*r[1], f[2]*r[0] - f[0]*r[2], f[0]*r[1] - f[1]*r[0] };
+    for (int i = 0; i < 3; ++i) { m_fwd[i] = f[i]; m_right[i] = r[i]; m_down[i] = d[i]; }
+
+    m_half_h = 0.5f * zoom;
+    m_half_w = m_half_h * (m_w / m_h);
+
+    // rows: right / half_w, down / half_h, forward / depth (+0.5 so the target
+    // sits mid-range), then (0,0,0,1)
+    const float sx = 1.f / m_half_w, sdn = 1.f / m_half_h, sz = 1.f / depth;
+    float* m = m_vp;
+    for (int c = 0; c < 3; ++c) {
+        m[c*4 + 0] = r[c] * sx;
+        m[c*4 + 1] = d[c] * sdn;
+        m[c*4 + 2] = f[c] * sz;
+        m[c*4 + 3] = 0.f;
+    }
+    m[12] = -dot3(r, target) * sx;
+    m[13] = -dot3(d, target) * sdn;
+    m[14] = 0.5f - dot3(f, target) * sz;
+    m[15] = 1.f;
+
+    m_frustum = Frustum::from_view_proj(m_vp);
+}
+
+bool Camera::world_to_screen(float x, float y, float z, float& sx, float& sy) const {
+    const float* m = m_vp;
+    const float nx = m[0]*x + m[4]*y + m[8]*z  + m[12];
+    const float ny = m[1]*x + m[5]*y + m[9]*z  + m[13];
+    const float nz = m[2]*x + m[6]*y + m[10]*z + m[14];
+    sx = (nx + 1.f) * 0.5f * m_w;
+    sy = (ny + 1.f) * 0.5f * m_h;
+    return nz >= 0.f && nz <= 1.f;
+}
+
+bool Camera::screen_to_world(float sx, float sy, float& x, float& z, float ground) const {
+    if (std::fabs(m_fwd[1]) < 1e-6f) return false;
+
+    const float nx = 2.f * sx / m_w - 1.f;
+    const float ny = 2.f * sy / m_h - 1.f;
+    float o[3];
+    for (int i = 0; i < 3; ++i)
+        o[i] = target[i] + m_right[i] * (nx * m_half_w) + m_down[i] * (ny * m_half_h);
+
+    const float t = (ground - o[1]) / m_fwd[1];
+    x = o[0] + m_fwd[0] * t;
+    z = o[2] + m_fwd[2] * t;
+    return true;
+}
+
+void Camera::pan_pixels(float dx, float dy) {
+    const float cx = 0.5f * m_w, cy = 0.5f * m_h;
+    float x0, z0, x1, z1;
+    if (!screen_to_world(cx, cy, x0, z0, target[1]) ||
+        !screen_to_world(cx + dx, cy + dy, x1, z1, target[1])) return;
+    target[0] -= x1 - x0;
+    target[2] -= z1 - z0;
+    update();
+}
+
+void Camera::zoom_at(float factor, float sx, float sy) {
+    float x0, z0, x1, z1;
+    const bool had = screen_to_world(sx, sy, x0, z0, target[1]);
+    zoom /= factor;
+    update();
+    if (!had || !screen_to_world(sx, sy, x1, z1, target[1])) return;
+    target[0] += x0 - x1;
+    target[2] += z0 - z1;
+    update();
+}
+
+bool Camera::label_visible(float x, float y, float z, float w_px, float h_px, float& sx, float& sy) const {
+    if (!world_to_screen(x, y, z, sx, sy)) return false;
+    const float hw = 0.5f * w_px, hh = 0.5f * h_px;
+    return sx + hw >= 0.f && sx - hw <= m_w &&
+           sy + hh >= 0.f && sy - hh <= m_h;
+}
+
+void Camera::screen_view(float out[4]) const {
+    out[0] =  2.f / m_w;
+    out[1] =  2.f / m_h;
+    out[2] = -1.f;
+    out[3] = -1.f;
+}
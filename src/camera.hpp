@@ -0,0 +1,74 @@
+#ifndef CAMERA_HPP
+#define CAMERA_HPP
+
+#include <cstdint>
+#include "frustum.hpp"
+
+// Strategy camera over the XZ ground plane (y up), the same layout the
+// terrain and units use. Orthographic only: TopDown looks straight down with
+// +x right and +z down the screen; Isometric tilts by 'pitch' and spins by
+// 'yaw' around the target. Screen coordinates are pixels, origin top-left.
+//
+// Pure CPU: the renderers take view_proj() as a push constant once per frame,
+// and picking/culling run on the sim side without a device.
+enum class CameraMode : uint8_t { TopDown, Isometric };
+
+class Camera {
+public:
+    CameraMode mode   = CameraMode::Isometric;
+    float target[3]   = { 0.f, 0.f, 0.f };   // look-at point, center of the screen
+    float zoom        = 32.f;                // world units visible vertically
+    float min_zoom    = 4.f;
+    float max_zoom    = 512.f;
+    float yaw         = 0.78539816f;         // isometric: 45 degrees
+    float pitch       = 0.61547971f;         // isometric: atan(1/sqrt(2)), "true" isometric
+    float depth       = 256.f;               // near..far span, centered on the target
+
+    void set_viewport(float width_px, float height_px);
+    float width()  const { return m_w; }
+    float height() const { return m_h; }
+
+    // Rebuilds the matrices and frustum from the fields above. Call once per
+    // frame after input; the getters and conversions use the last update().
+    void update();
+
+    // Column-major, Vulkan clip space (y down, 0..1 depth).
+    const float*   view_proj() const { return m_vp; }
+    const Frustum& frustum()   const { return m_frustum; }
+
+    // false when the point falls outside the near/far range.
+    bool world_to_screen(float x, float y, float z, float& sx, float& sy) const;
+    // Casts the pixel's view ray onto the plane y = ground; false if the ray
+    // runs parallel to it (never for TopDown / pitch > 0).
+    bool screen_to_world(float sx, float sy, float& x, float& z, float ground = 0.f) const;
+
+    // Drag: moves the target so the ground stays under the cursor.
+    void pan_pixels(float dx, float dy);
+    // Scroll: factor > 1 zooms in (zoom is clamped), keeping the ground point
+    // under (sx, sy) fixed.
+    void zoom_at(float factor, float sx, float sy);
+
+    // Culling for terrain chunks, units and anything else with bounds.
+    bool visible(const float mn[3], const float mx[3]) const { return m_frustum.aabb(mn, mx); }
+    bool visible(float x, float y, float z, float r)   const { return m_frustum.sphere(x, y, z, r); }
+
+    // Screen-space test for labels: projects the anchor and checks a w x h
+    // pixel box centered on it against the viewport. sx/sy get the anchor.
+    bool label_visible(float x, float y, float z, float w_px, float h_px, float& sx, float& sy) const;
+
+    // view[] mapping pixels (origin top-left) to NDC, for the 2D overlay
+    // renderers: ndc = px * (view[0], view[1]) + (view[2], view[3]).
+    void screen_view(float out[4]) const;
+
+private:
+    float m_w = 1.f, m_h = 1.f;
+
+    // orthonormal basis and half extents of the last update(), for picking
+    float m_right[3]{}, m_down[3]{}, m_fwd[3]{};
+    float m_half_w = 1.f, m_half_h = 1.f;
+
+    float   m_vp[16]{};
+    Frustum m_frustum{};
+};
+
+#endif // CAMERA_HPP
@@ -0,0 +1,45 @@
+#include "deletion_queue.hpp"
+#include "gpu_timeline.hpp"
+#include "memory_tracker.hpp"
+
+template <class... F> struct Overloaded : F... { using F::operator()...; };
+template <class... F> Overloaded(F...) -> Overloaded<F...>;
+
+void DeletionQueue::destroy_(const Object& o) {
+    VkDevice d = m_device;
+    std::visit(Overloaded{
+        [d](VkBuffer h)              { vkDestroyBuffer(d, h, nullptr); },
+        [d](VkImage h)               { vkDestroyImage(d, h, nullptr); },
+        [d](VkImageView h)           { vkDestroyImageView(d, h, nullptr); },
+        [d](VkDeviceMemory h)        { tracked_free(d, h); },
+        [d](VkSampler h)             { vkDestroySampler(d, h, nullptr); },
+        [d](VkPipeline h)            { vkDestroyPipeline(d, h, nullptr); },
+        [d](VkPipelineLayout h)      { vkDestroyPipelineLayout(d, h, nullptr); },
+        [d](VkFramebuffer h)         { vkDestroyFramebuffer(d, h, nullptr); },
+        [d](VkRenderPass h)          { vkDestroyRenderPass(d, h, nullptr); },
+        [d](VkDescriptorPool h)      { vkDestroyDescriptorPool(d, h, nullptr); },
+        [d](VkShaderModule h)        { vkDestroyShaderModule(d, h, nullptr); },
+        [d](VkCommandPool h)         { vkDestroyCommandPool(d, h, nullptr); },
+    }, o);
+}
+
+void DeletionQueue::collect(uint64_t completed) {
+    // entries are mostly in value order but not guaranteed: compact in place,
+    // keeping the destruction order of ready entries (views before images...)
+    size_t keep = 0;
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        if (m_entries[i].after <= completed) destroy_(m_entries[i].object);
+        else                                 m_entries[keep++] = m_entries[i];
+    }
+    m_entries.resize(keep);
+}
+
+void DeletionQueue::collect(GpuTimeline& timeline) {
+    timeline.poll();
+    collect(timeline.completed_value());
+}
+
+void DeletionQueue::flush() {
+    for (const Entry& e : m_entries) destroy_(e.object);
+    m_entries.clear();
+}
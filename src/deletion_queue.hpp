@@ -0,0 +1,53 @@
+#ifndef DELETION_QUEUE_HPP
+#define DELETION_QUEUE_HPP
+
+#include <cstdint>
+#include <variant>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+#include "common.hpp"
+
+class GpuTimeline;
+
+// Destroys Vulkan objects once the GPU is past their last use, instead of
+// idling the device first. Each object is tagged with a GpuTimeline value:
+// the submission that last uses it (when still recording a command buffer
+// that references it, use GpuTimeline::next_value()). collect() then frees
+// everything whose value completed.
+class DeletionQueue {
+public:
+    void init(VkDevice device) { m_device = device; }
+
+    template <typename Handle>
+    void retire(Handle h, uint64_t after) {
+        if (h != VK_NULL_HANDLE) m_entries.push_back({ after, Object{ h } });
+    }
+
+    // Frees everything tagged <= completed. Call once per frame.
+    void collect(uint64_t completed);
+    void collect(GpuTimeline& timeline);
+
+    // Frees everything now (device must be idle, e.g. at shutdown).
+    void flush();
+
+    size_t pending() const { return m_entries.size(); }
+
+private:
+    // non-dispatchable handles are distinct pointer types only on 64-bit
+    static_assert(sizeof(void*) == 8, "DeletionQueue needs typed (64-bit) Vulkan handles");
+    using Object = std::variant<VkBuffer, VkImage, VkImageView, VkDeviceMemory, VkSampler,
+                                VkPipeline, VkPipelineLayout, VkFramebuffer, VkRenderPass,
+                                VkDescriptorPool, VkShaderModule, VkCommandPool>;
+    struct Entry {
+        uint64_t after;
+        Object   object;
+    };
+
+    void destroy_(const Object& o);
+
+    VkDevice           m_device = VK_NULL_HANDLE;
+    std::vector<Entry> m_entries;
+};
+
+#endif // DELETION_QUEUE_HPP
@@ -0,0 +1,146 @@
+#include "descriptors.hpp"
+#include "render_pipeline.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// -----------------------------
+// DescriptorAllocator
+// -----------------------------
+
+VkResult DescriptorAllocator::create(VkDevice device, uint32_t initial_sets,
+                                     std::span<const DescriptorRatio> ratios,
+                                     uint32_t max_sets_per_pool) {
+    DEBUG_ASSERT(initial_sets > 0 && !ratios.empty());
+    destroy();
+    m_device    = device;
+    m_ratios.assign(ratios.begin(), ratios.end());
+    m_next_sets = initial_sets;
+    m_max_sets  = std::max(initial_sets, max_sets_per_pool);
+    return next_pool_(m_current);
+}
+
+VkResult DescriptorAllocator::next_pool_(VkDescriptorPool& out) {
+    if (!m_ready.empty()) {
+        out = m_ready.back();
+        m_ready.pop_back();
+        return VK_SUCCESS;
+    }
+
+    std::vector<VkDescriptorPoolSize> sizes;
+    sizes.reserve(m_ratios.size());
+    for (const DescriptorRatio& r : m_ratios) {
+        const uint32_t n = static_cast<uint32_t>(std::ceil(r.per_set * float(m_next_sets)));
+        if (n) sizes.push_back(render::desc_pool_size(r.type, n));
+    }
+
+    auto ci = render::desc_pool_info(sizes, m_next_sets);
+    if (auto e = vkCreateDescriptorPool(m_device, &ci, nullptr, &out)) return e;
+
+    // grow so a busy frame settles on a handful of pools
+    m_next_sets = std::min(m_max_sets, m_next_sets + m_next_sets / 2);
+    return VK_SUCCESS;
+}
+
+VkResult DescriptorAllocator::allocate(VkDescriptorSetLayout layout, VkDescriptorSet& out, const void* pNext) {
+    DEBUG_ASSERT(m_device && "DescriptorAllocator::create not called");
+    if (!m_current)
+        if (auto e = next_pool_(m_current)) return e;
+
+    auto ai  = render::desc_alloc_info(m_current, { &layout, 1 });
+    ai.pNext = pNext;
+    VkResult r = vkAllocateDescriptorSets(m_device, &ai, &out);
+    if (r != VK_ERROR_OUT_OF_POOL_MEMORY && r != VK_ERROR_FRAGMENTED_POOL) return r;
+
+    // current pool is done for this cycle; retry once in a fresh one
+    m_full.push_back(m_current);
+    if (auto e = next_pool_(m_current)) { m_current = VK_NULL_HANDLE; return e; }
+    ai.descriptorPool = m_current;
+    return vkAllocateDescriptorSets(m_device, &ai, &out);
+}
+
+void DescriptorAllocator::reset() {
+    if (m_current) m_full.push_back(m_current);
+    m_current = VK_NULL_HANDLE;
+    for (VkDescriptorPool p : m_full) {
+        vkResetDescriptorPool(m_device, p, 0);
+        m_ready.push_back(p);
+    }
+    m_full.clear();
+}
+
+void DescriptorAllocator::destroy() {
+    if (!m_device) return;
+    if (m_current) vkDestroyDescriptorPool(m_device, m_current, nullptr);
+    for (VkDescriptorPool p : m_full)  vkDestroyDescriptorPool(m_device, p, nullptr);
+    for (VkDescriptorPool p : m_ready) vkDestroyDescriptorPool(m_device, p, nullptr);
+    m_current = VK_NULL_HANDLE;
+    m_full.clear();
+    m_ready.clear();
+    m_ratios.clear();
+    m_device = VK_NULL_HANDLE;
+}
+
+// -----------------------------
+// DescriptorLayoutCache
+// -----------------------------
+
+size_t DescriptorLayoutCache::KeyHash::operator()(const Key& k) const {
+    // FNV-1a over the fields (not the raw structs: no padding in the hash)
+    uint64_t h = 1469598103934665603ull;
+    auto mix = [&h](uint64_t v) { h ^= v; h *= 1099511628211ull; };
+    mix(k.flags);
+    mix(k.bindings.size());
+    for (const Binding& b : k.bindings) {
+        mix(b.binding);
+        mix(uint64_t(b.type));
+        mix(b.count);
+        mix(b.stages);
+        mix(b.flags);
+    }
+    return static_cast<size_t>(h);
+}
+
+VkResult DescriptorLayoutCache::get(std::span<const VkDescriptorSetLayoutBinding> bindings,
+                                    VkDescriptorSetLayout& out,
+                                    VkDescriptorSetLayoutCreateFlags flags,
+                                    std::span<const VkDescriptorBindingFlags> binding_flags) {
+    DEBUG_ASSERT(m_device && "DescriptorLayoutCache::init not called");
+    DEBUG_ASSERT(binding_flags.empty() || binding_flags.size() == bindings.size());
+
+    Key key;
+    key.flags = flags;
+    key.bindings.reserve(bindings.size());
+    for (size_t i = 0; i < bindings.size(); ++i) {
+        const VkDescriptorSetLayoutBinding& b = bindings[i];
+        DEBUG_ASSERT(!b.pImmutableSamplers && "immutable samplers aren't part of the cache key");
+        key.bindings.push_back({ b.binding, b.descriptorType, b.descriptorCount, b.stageFlags,
+                                 binding_flags.empty() ? 0u : binding_flags[i] });
+    }
+    std::sort(key.bindings.begin(), key.bindings.end(),
+              [](const Binding& a, const Binding& b) { return a.binding < b.binding; });
+
+    if (auto it = m_layouts.find(key); it != m_layouts.end()) {
+        out = it->second;
+        return VK_SUCCESS;
+    }
+
+    auto ci = render::desc_layout_info(bindings, flags);
+    VkDescriptorSetLayoutBindingFlagsCreateInfo fci{};
+    if (!binding_flags.empty()) {
+        fci.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+        fci.bindingCount  = static_cast<uint32_t>(binding_flags.size());
+        fci.pBindingFlags = binding_flags.data();
+        ci.pNext          = &fci;
+    }
+    if (auto e = vkCreateDescriptorSetLayout(m_device, &ci, nullptr, &out)) return e;
+
+    m_layouts.emplace(std::move(key), out);
+    return VK_SUCCESS;
+}
+
+void DescriptorLayoutCache::destroy() {
+    for (auto& [key, layout] : m_layouts)
+        vkDestroyDescriptorSetLayout(m_device, layout, nullptr);
+    m_layouts.clear();
+}
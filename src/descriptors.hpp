@@ -0,0 +1,96 @@
+#ifndef DESCRIPTORS_HPP
+#define DESCRIPTORS_HPP
+
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+#include "common.hpp"
+
+// How many descriptors of 'type' a pool reserves per set it can hold.
+struct DescriptorRatio {
+    VkDescriptorType type;
+    float            per_set;
+};
+
+// Reasonable mix for materials / text / sprites.
+inline constexpr DescriptorRatio kDefaultDescriptorRatios[] = {
+    { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2.0f },
+    { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,         1.0f },
+    { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,         1.0f },
+    { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,          0.5f },
+    { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,          0.5f },
+};
+
+// Growable descriptor allocator. Sets come out of the current pool; when it
+// runs dry (or fragments) a new, bigger pool is created. reset() recycles every
+// pool at once, so keep one allocator per frame in flight for transient sets
+// and a separate one (never reset) for long-lived sets.
+class DescriptorAllocator {
+public:
+    VkResult create(VkDevice device,
+                    uint32_t initial_sets = 64,
+                    std::span<const DescriptorRatio> ratios = kDefaultDescriptorRatios,
+                    uint32_t max_sets_per_pool = 4096);
+
+    // pNext is forwarded to VkDescriptorSetAllocateInfo (variable counts...).
+    VkResult allocate(VkDescriptorSetLayout layout, VkDescriptorSet& out, const void* pNext = nullptr);
+
+    // Every set handed out so far becomes invalid; pools are kept for reuse.
+    void reset();
+    void destroy();
+
+    uint32_t pool_count() const { return static_cast<uint32_t>(m_full.size() + m_ready.size() + (m_current ? 1 : 0)); }
+
+private:
+    VkResult next_pool_(VkDescriptorPool& out);
+
+    VkDevice                      m_device = VK_NULL_HANDLE;
+    std::vector<DescriptorRatio>  m_ratios;
+    uint32_t                      m_next_sets = 0;   // size of the next pool we create
+    uint32_t                      m_max_sets  = 0;
+
+    VkDescriptorPool              m_current = VK_NULL_HANDLE;
+    std::vector<VkDescriptorPool> m_full;            // exhausted this cycle
+    std::vector<VkDescriptorPool> m_ready;           // reset, waiting to be reused
+};
+
+// Deduplicates descriptor set layouts: identical bindings (in any order) give
+// back the same VkDescriptorSetLayout. Layouts live until destroy().
+class DescriptorLayoutCache {
+public:
+    void init(VkDevice device) { m_device = device; }
+
+    // binding_flags (optional) must match 'bindings' one to one.
+    VkResult get(std::span<const VkDescriptorSetLayoutBinding> bindings,
+                 VkDescriptorSetLayout& out,
+                 VkDescriptorSetLayoutCreateFlags flags = 0,
+                 std::span<const VkDescriptorBindingFlags> binding_flags = {});
+
+    void destroy();
+
+    size_t size() const { return m_layouts.size(); }
+
+private:
+    struct Binding {
+        uint32_t                 binding;
+        VkDescriptorType         type;
+        uint32_t                 count;
+        VkShaderStageFlags       stages;
+        VkDescriptorBindingFlags flags;
+        bool operator==(const Binding&) const = default;
+    };
+    struct Key {
+        VkDescriptorSetLayoutCreateFlags flags = 0;
+        std::vector<Binding>             bindings;   // sorted by binding index
+        bool operator==(const Key&) const = default;
+    };
+    struct KeyHash { size_t operator()(const Key& k) const; };
+
+    VkDevice                                                 m_device = VK_NULL_HANDLE;
+    std::unordered_map<Key, VkDescriptorSetLayout, KeyHash>  m_layouts;
+};
+
+#endif // DESCRIPTORS_HPP
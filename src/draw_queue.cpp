@@ -0,0 +1,172 @@
+#include "draw_queue.hpp"
+
+#include <algorithm>
+#include <array>
+
+void DrawQueue::push(const DrawPacket& p, const void* push_constants) {
+    DEBUG_ASSERT(p.pipeline != VK_NULL_HANDLE && p.layout != VK_NULL_HANDLE);
+    DEBUG_ASSERT((p.push_size == 0) == (push_constants == nullptr));
+
+    DrawPacket& q = m_packets.emplace_back(p);
+    if (p.push_size) {
+        q.push_data = static_cast<uint32_t>(m_push_bytes.size());
+        const auto* src = static_cast<const uint8_t*>(push_constants);
+        m_push_bytes.insert(m_push_bytes.end(), src, src + p.push_size);
+    }
+    m_sorted = false;
+}
+
+// LSD radix sort, 8 bits per digit. Digits where every key agrees (typically
+// most of the pass/pipeline bytes) are skipped after one counting sweep.
+static void radix_sort(std::vector<uint64_t>& keys,  std::vector<uint32_t>& order,
+                       std::vector<uint64_t>& keys_tmp, std::vector<uint32_t>& order_tmp) {
+    const size_t n = keys.size();
+    keys_tmp.resize(n);
+    order_tmp.resize(n);
+
+    std::array<std::array<uint32_t, 256>, 8> hist{};
+    for (uint64_t k : keys)
+        for (int d = 0; d < 8; ++d) ++hist[d][(k >> (d * 8)) & 0xFF];
+
+    for (int d = 0; d < 8; ++d) {
+        auto& h = hist[d];
+        const uint32_t first = static_cast<uint32_t>((keys[0] >> (d * 8)) & 0xFF);
+        if (h[first] == n) continue; // all keys share this digit
+
+        uint32_t sum = 0;
+        for (uint32_t& c : h) { const uint32_t t = c; c = sum; sum += t; }
+
+        const int shift = d * 8;
+        for (size_t i = 0; i < n; ++i) {
+            const uint32_t dst = h[(keys[i] >> shift) & 0xFF]++;
+            keys_tmp[dst]  = keys[i];
+            order_tmp[dst] = order[i];
+        }
+        keys.swap(keys_tmp);
+        order.swap(order_tmp);
+    }
+}
+
+void DrawQueue::sort() {
+    const size_t n = m_packets.size();
+    m_keys.resize(n);
+    m_order.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        m_keys[i]  = m_packets[i].key;
+        m_order[i] = static_cast<uint32_t>(i);
+    }
+    if (n > 1) radix_sort(m_keys, m_order, m_keys_tmp, m_order_tmp);
+    m_sorted = true;
+}
+
+namespace {
+
+struct VkRecorder {
+    VkCommandBuffer             cb;
+    const std::vector<uint8_t>& push_bytes;
+
+    void bind_pipeline(const DrawPacket& p, uint32_t) { vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, p.pipeline); }
+    void bind_set(const DrawPacket& p, uint32_t) {
+        vkCmdBindDescriptorSets(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, p.layout, p.set_index, 1, &p.set, 0, nullptr);
+    }
+    void bind_vertex_buffer(const DrawPacket& p, uint32_t) { vkCmdBindVertexBuffers(cb, 0, 1, &p.vertex_buffer, &p.vertex_offset); }
+    void bind_index_buffer(const DrawPacket& p, uint32_t)  { vkCmdBindIndexBuffer(cb, p.index_buffer, p.index_offset, p.index_type); }
+    void push_constants(const DrawPacket& p, uint32_t) {
+        vkCmdPushConstants(cb, p.layout, p.push_stages, p.push_offset, p.push_size, push_bytes.data() + p.push_data);
+    }
+    void draw(const DrawPacket& p, uint32_t) {
+        if (p.index_buffer)
+            vkCmdDrawIndexed(cb, p.count, p.instance_count, p.first, p.base_vertex, p.first_instance);
+        else
+            vkCmdDraw(cb, p.count, p.instance_count, p.first, p.first_instance);
+    }
+};
+
+struct ListRecorder {
+    std::vector<DrawCommand>& out;
+
+    void bind_pipeline(const DrawPacket&, uint32_t i)      { out.push_back({ DrawCommand::BindPipeline, i }); }
+    void bind_set(const DrawPacket&, uint32_t i)           { out.push_back({ DrawCommand::BindSet, i }); }
+    void bind_vertex_buffer(const DrawPacket&, uint32_t i) { out.push_back({ DrawCommand::BindVertexBuffer, i }); }
+    void bind_index_buffer(const DrawPacket&, uint32_t i)  { out.push_back({ DrawCommand::BindIndexBuffer, i }); }
+    void push_constants(const DrawPacket&, uint32_t i)     { out.push_back({ DrawCommand::PushConstants, i }); }
+    void draw(const DrawPacket& p, uint32_t i) {
+        out.push_back({ p.index_buffer ? DrawCommand::DrawIndexed : DrawCommand::Draw, i });
+    }
+};
+
+} // namespace
+
+template <class Recorder>
+void DrawQueue::replay_(Recorder& rec, uint8_t pass) {
+    DEBUG_ASSERT(m_sorted && "DrawQueue::replay before sort()");
+
+    const uint64_t lo = draw_key::make(pass, 0, 0, 0);
+    size_t i = static_cast<size_t>(std::lower_bound(m_keys.begin(), m_keys.end(), lo) - m_keys.begin());
+
+    // bind state is tracked per replay: a new pass may start with a fresh command buffer
+    VkPipeline       cur_pipeline = VK_NULL_HANDLE;
+    VkPipelineLayout cur_layout   = VK_NULL_HANDLE;
+    std::array<VkDescriptorSet, 4> cur_sets{};
+    VkBuffer     cur_vb = VK_NULL_HANDLE, cur_ib = VK_NULL_HANDLE;
+    VkDeviceSize cur_vb_off = 0, cur_ib_off = 0;
+    VkIndexType  cur_ib_type = VK_INDEX_TYPE_UINT16;
+
+    for (; i < m_keys.size() && draw_key::pass(m_keys[i]) == pass; ++i) {
+        const uint32_t    at = m_order[i];
+        const DrawPacket& p  = m_packets[at];
+
+        if (p.pipeline != cur_pipeline) {
+            rec.bind_pipeline(p, at);
+            cur_pipeline = p.pipeline;
+            ++m_stats.pipeline_binds;
+        }
+        if (p.layout != cur_layout) {
+            // sets stay bound across compatible layouts, but we don't track compatibility
+            cur_layout = p.layout;
+            cur_sets.fill(VK_NULL_HANDLE);
+        }
+        if (p.set) {
+            DEBUG_ASSERT(p.set_index < cur_sets.size());
+            if (cur_sets[p.set_index] != p.set) {
+                rec.bind_set(p, at);
+                cur_sets[p.set_index] = p.set;
+                ++m_stats.set_binds;
+            }
+        }
+        if (p.vertex_buffer && (p.vertex_buffer != cur_vb || p.vertex_offset != cur_vb_off)) {
+            rec.bind_vertex_buffer(p, at);
+            cur_vb = p.vertex_buffer; cur_vb_off = p.vertex_offset;
+            ++m_stats.buffer_binds;
+        }
+        if (p.index_buffer &&
+            (p.index_buffer != cur_ib || p.index_offset != cur_ib_off || p.index_type != cur_ib_type)) {
+            rec.bind_index_buffer(p, at);
+            cur_ib = p.index_buffer; cur_ib_off = p.index_offset; cur_ib_type = p.index_type;
+            ++m_stats.buffer_binds;
+        }
+        if (p.push_size) rec.push_constants(p, at);
+
+        rec.draw(p, at);
+        ++m_stats.draws;
+    }
+}
+
+void DrawQueue::replay(VkCommandBuffer cb, uint8_t pass) {
+    VkRecorder rec{ cb, m_push_bytes };
+    replay_(rec, pass);
+}
+
+void DrawQueue::replay(std::vector<DrawCommand>& out, uint8_t pass) {
+    ListRecorder rec{ out };
+    replay_(rec, pass);
+}
+
+void DrawQueue::clear() {
+    m_packets.clear();
+    m_push_bytes.clear();
+    m_keys.clear();
+    m_order.clear();
+    m_sorted = false;
+    m_stats  = {};
+}
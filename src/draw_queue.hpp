@@ -0,0 +1,124 @@
+#ifndef DRAW_QUEUE_HPP
+#define DRAW_QUEUE_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+#include "common.hpp"
+
+// Deferred draw submission. Systems push DrawPackets tagged with a 64-bit sort
+// key during the frame; sort() radix-sorts them once and replay() records one
+// pass worth of packets, skipping pipeline / descriptor / buffer binds that are
+// already current.
+//
+// Key layout (most significant first):
+//   [63..56] pass       which replay() call the packet belongs to
+//   [55..40] pipeline   caller-chosen id, groups packets sharing a VkPipeline
+//   [39..24] material   caller-chosen id, groups packets sharing descriptor sets
+//   [23.. 0] depth      see depth_key(); lowest draws first
+namespace draw_key {
+    inline constexpr uint64_t make(uint8_t pass, uint16_t pipeline, uint16_t material, uint32_t depth24 = 0) {
+        return (uint64_t(pass)     << 56) |
+               (uint64_t(pipeline) << 40) |
+               (uint64_t(material) << 24) |
+               (uint64_t(depth24) & 0xFFFFFFu);
+    }
+    inline constexpr uint8_t  pass(uint64_t k)     { return uint8_t(k >> 56); }
+    inline constexpr uint16_t pipeline(uint64_t k) { return uint16_t(k >> 40); }
+    inline constexpr uint16_t material(uint64_t k) { return uint16_t(k >> 24); }
+
+    // 24-bit depth for the low bits. Non-negative floats order like their bit
+    // patterns, so the top 24 bits keep the order (with some precision loss).
+    // back_to_front flips it for blended geometry.
+    inline uint32_t depth(float z, bool back_to_front = false) {
+        if (!(z > 0.0f)) z = 0.0f; // also catches NaN
+        uint32_t bits; std::memcpy(&bits, &z, sizeof bits);
+        const uint32_t d = bits >> 8;
+        return back_to_front ? (0xFFFFFFu - d) : d;
+    }
+}
+
+struct DrawPacket {
+    uint64_t key = 0;
+
+    VkPipeline       pipeline = VK_NULL_HANDLE;
+    VkPipelineLayout layout   = VK_NULL_HANDLE;
+
+    // optional: one descriptor set at 'set_index'
+    VkDescriptorSet  set       = VK_NULL_HANDLE;
+    uint32_t         set_index = 0;
+
+    // optional vertex (binding 0) / index buffers
+    VkBuffer     vertex_buffer = VK_NULL_HANDLE;
+    VkDeviceSize vertex_offset = 0;
+    VkBuffer     index_buffer  = VK_NULL_HANDLE;
+    VkDeviceSize index_offset  = 0;
+    VkIndexType  index_type    = VK_INDEX_TYPE_UINT16;
+
+    // vkCmdDraw / vkCmdDrawIndexed arguments (indexed when index_buffer is set)
+    uint32_t count          = 0;  // vertices or indices
+    uint32_t instance_count = 1;
+    uint32_t first          = 0;  // first vertex or first index
+    int32_t  base_vertex    = 0;  // indexed only
+    uint32_t first_instance = 0;
+
+    // push constants, filled by DrawQueue::push()
+    VkShaderStageFlags push_stages = 0;
+    uint32_t           push_offset = 0;  // vkCmdPushConstants offset
+    uint32_t           push_size   = 0;
+    uint32_t           push_data   = 0;  // index into the queue's byte store
+};
+
+// One entry per command replay() would record; for tests and debug views.
+struct DrawCommand {
+    enum Op : uint8_t {
+        BindPipeline, BindSet, BindVertexBuffer, BindIndexBuffer, PushConstants, Draw, DrawIndexed,
+    };
+    Op       op;
+    uint32_t packet;   // index in push() order
+};
+
+struct DrawQueueStats {
+    uint32_t draws          = 0;
+    uint32_t pipeline_binds = 0;
+    uint32_t set_binds      = 0;
+    uint32_t buffer_binds   = 0;  // vertex + index
+};
+
+class DrawQueue {
+public:
+    // Queue a packet; push constant bytes (if any) are copied.
+    void push(const DrawPacket& p, const void* push_constants = nullptr);
+
+    // Sort everything pushed so far (stable for equal keys: submission order).
+    void sort();
+
+    // Record all packets whose key has pass 'pass'. Requires sort().
+    void replay(VkCommandBuffer cb, uint8_t pass);
+    // Same walk, listing the commands instead of recording them.
+    void replay(std::vector<DrawCommand>& out, uint8_t pass);
+
+    // Drop all packets (keeps capacity). Call once per frame after replaying.
+    void clear();
+
+    size_t                size()  const { return m_packets.size(); }
+    const DrawQueueStats& stats() const { return m_stats; }
+
+private:
+    template <class Recorder>
+    void replay_(Recorder& rec, uint8_t pass);
+
+    std::vector<DrawPacket> m_packets;
+    std::vector<uint8_t>    m_push_bytes;
+
+    // sorted order: keys[i] belongs to m_packets[order[i]]
+    std::vector<uint64_t> m_keys,  m_keys_tmp;
+    std::vector<uint32_t> m_order, m_order_tmp;
+    bool                  m_sorted = false;
+
+    DrawQueueStats m_stats;
+};
+
+#endif // DRAW_QUEUE_HPP
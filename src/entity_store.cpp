@@ -0,0 +1,20 @@
+#include "entity_store.hpp"
+
+Entity EntityRegistry::create() {
+    ++m_alive;
+    if (!m_free.empty()) {
+        const uint32_t index = m_free.back();
+        m_free.pop_back();
+        return Entity{ index, ++m_generations[index] };   // odd -> even: live again
+    }
+    m_generations.push_back(0);
+    return Entity{ static_cast<uint32_t>(m_generations.size() - 1), 0 };
+}
+
+bool EntityRegistry::destroy(Entity e) {
+    if (!alive(e)) return false;
+    ++m_generations[e.index];   // stale handles stop matching
+    m_free.push_back(e.index);
+    --m_alive;
+    return true;
+}
@@ -0,0 +1,166 @@
+#ifndef ENTITY_STORE_HPP
+#define ENTITY_STORE_HPP
+
+#include <cstdint>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "common.hpp"
+
+// Entity/component storage for the simulation. Each component type lives in
+// its own sparse-set pool: a dense, contiguous array of values (what systems
+// iterate and what gets streamed into mapped instance buffers), the owning
+// entity per slot, and a sparse entity-index -> slot table. Entities are
+// generational handles, so a handle kept past destroy() just stops resolving.
+// Pure CPU, no Vulkan.
+
+struct Entity {
+    uint32_t index      = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool valid() const { return index != UINT32_MAX; }
+    friend bool operator==(Entity a, Entity b) { return a.index == b.index && a.generation == b.generation; }
+};
+
+// Hands out indices (recycling freed ones) and bumps the generation on free.
+class EntityRegistry {
+public:
+    Entity   create();
+    bool     destroy(Entity e);   // false if already dead
+    bool     alive(Entity e) const {
+        return e.index < m_generations.size() && m_generations[e.index] == e.generation;
+    }
+    uint32_t size()     const { return m_alive; }
+    uint32_t capacity() const { return static_cast<uint32_t>(m_generations.size()); }   // max index + 1
+
+private:
+    std::vector<uint32_t> m_generations;   // current generation per index (odd = free)
+    std::vector<uint32_t> m_free;
+    uint32_t              m_alive = 0;
+};
+
+template <class T>
+class ComponentPool {
+public:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    // Adds (or overwrites) e's component. Appends: O(1), may move the array.
+    T& add(Entity e, const T& value = {}) {
+        if (e.index >= m_sparse.size()) m_sparse.resize(size_t(e.index) + 1, kNone);
+        uint32_t& slot = m_sparse[e.index];
+        if (slot != kNone) {
+            m_entities[slot] = e;
+            return m_dense[slot] = value;
+        }
+        slot = static_cast<uint32_t>(m_dense.size());
+        m_entities.push_back(e);
+        m_dense.push_back(value);
+        return m_dense.back();
+    }
+
+    // Swap-and-pop: the last element takes e's slot.
+    bool remove(Entity e) {
+        const uint32_t slot = index_of(e);
+        if (slot == kNone) return false;
+        const uint32_t last = static_cast<uint32_t>(m_dense.size()) - 1;
+        if (slot != last) {
+            m_dense[slot]    = std::move(m_dense[last]);
+            m_entities[slot] = m_entities[last];
+            m_sparse[m_entities[slot].index] = slot;
+        }
+        m_dense.pop_back();
+        m_entities.pop_back();
+        m_sparse[e.index] = kNone;
+        return true;
+    }
+
+    // Dense slot of e's component, kNone if it has none (or e is stale).
+    uint32_t index_of(Entity e) const {
+        if (e.index >= m_sparse.size()) return kNone;
+        const uint32_t slot = m_sparse[e.index];
+        return slot != kNone && m_entities[slot].generation == e.generation ? slot : kNone;
+    }
+    bool     has(Entity e) const { return index_of(e) != kNone; }
+    T*       get(Entity e)       { const uint32_t s = index_of(e); return s == kNone ? nullptr : &m_dense[s]; }
+    const T* get(Entity e) const { const uint32_t s = index_of(e); return s == kNone ? nullptr : &m_dense[s]; }
+
+    // Exchanges two dense slots (values and owners).
+    void swap_slots(uint32_t a, uint32_t b) {
+        if (a == b) return;
+        std::swap(m_dense[a], m_dense[b]);
+        std::swap(m_entities[a], m_entities[b]);
+        m_sparse[m_entities[a].index] = a;
+        m_sparse[m_entities[b].index] = b;
+    }
+
+    std::span<T>            values()         { return m_dense; }
+    std::span<const T>      values()   const { return m_dense; }
+    std::span<const Entity> entities() const { return m_entities; }
+    uint32_t                size()     const { return static_cast<uint32_t>(m_dense.size()); }
+    void reserve(uint32_t n) { m_dense.reserve(n); m_entities.reserve(n); }
+    void clear()             { m_dense.clear(); m_entities.clear(); m_sparse.clear(); }
+
+private:
+    std::vector<T>        m_dense;
+    std::vector<Entity>   m_entities;   // owner of m_dense[i]
+    std::vector<uint32_t> m_sparse;     // entity index -> dense slot
+};
+
+// Moves the entities that have both components to the front of both pools,
+// in the same order, and returns how many there are: afterwards a.values()[i]
+// and b.values()[i] belong to the same entity for i < the result, so a system
+// walks two contiguous arrays in lockstep. O(a.size()); a pool packed against
+// one partner loses that order when packed against another, so pack right
+// before iterating.
+template <class A, class B>
+uint32_t pack_shared(ComponentPool<A>& a, ComponentPool<B>& b) {
+    uint32_t k = 0;
+    for (uint32_t i = 0; i < a.size(); ++i) {
+        const Entity   e  = a.entities()[i];
+        const uint32_t bi = b.index_of(e);
+        if (bi == ComponentPool<B>::kNone) continue;
+        a.swap_slots(i, k);
+        b.swap_slots(bi, k);
+        ++k;
+    }
+    return k;
+}
+
+// Registry + one pool per component type.
+template <class... Components>
+class EntityStore {
+public:
+    Entity create() { return m_registry.create(); }
+
+    // Drops every component, then frees the handle.
+    bool destroy(Entity e) {
+        if (!m_registry.alive(e)) return false;
+        (pool<Components>().remove(e), ...);
+        return m_registry.destroy(e);
+    }
+    bool alive(Entity e) const { return m_registry.alive(e); }
+    uint32_t size() const { return m_registry.size(); }
+
+    template <class T> ComponentPool<T>&       pool()       { return std::get<ComponentPool<T>>(m_pools); }
+    template <class T> const ComponentPool<T>& pool() const { return std::get<ComponentPool<T>>(m_pools); }
+
+    template <class T> T& add(Entity e, const T& value = {}) {
+        DEBUG_ASSERT(alive(e));
+        return pool<T>().add(e, value);
+    }
+    template <class T> bool     remove(Entity e)    { return pool<T>().remove(e); }
+    template <class T> T*       get(Entity e)       { return pool<T>().get(e); }
+    template <class T> const T* get(Entity e) const { return pool<T>().get(e); }
+
+    template <class A, class B> uint32_t pack() { return pack_shared(pool<A>(), pool<B>()); }
+
+    void reserve(uint32_t n) { (pool<Components>().reserve(n), ...); }
+
+private:
+    EntityRegistry                          m_registry;
+    std::tuple<ComponentPool<Components>...> m_pools;
+};
+
+#endif // ENTITY_STORE_HPP
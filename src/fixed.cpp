@@ -0,0 +1,108 @@
+#include "fixed.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdlib>
+
+namespace {
+
+constexpr int kTableBits = 10;                 // quarter wave entries
+constexpr int kTableSize = 1 << kTableBits;
+
+// sin(k/1024 * pi/2) in Q16.16 for k = 0..1024, from a Taylor series in Q30
+// integers: nothing here depends on the platform's libm.
+constexpr std::array<int32_t, kTableSize + 1> make_sin_table() {
+    constexpr int64_t kPiQ30 = 3373259426;     // pi * 2^30
+    std::array<int32_t, kTableSize + 1> t{};
+    for (int k = 0; k <= kTableSize; ++k) {
+        const int64_t x  = kPiQ30 * k / (2 * kTableSize);
+        const int64_t x2 = (x * x) >> 30;
+        int64_t term = x, sum = x;
+        for (int n = 1; n < 12; ++n) {
+            term = -((term * x2) >> 30) / ((2 * n) * (2 * n + 1));
+            sum += term;
+        }
+        t[size_t(k)] = int32_t((sum + (1 << 13)) >> 14);
+    }
+    return t;
+}
+
+constexpr auto kSin = make_sin_table();
+static_assert(kSin[0] == 0 && kSin[kTableSize] == Fixed::kOne, "sin table endpoints");
+
+// atan(2^-i) in 1/256ths of an angle step (2^24 per turn); generated once
+// offline, it is a constant of the algorithm.
+constexpr int32_t kAtan[] = {
+    2097152, 1238021, 654136, 332050, 166669, 83416, 41718, 20860,
+    10430, 5215, 2608, 1304, 652, 326, 163, 81, 41, 20, 10, 5, 3, 1,
+};
+
+uint64_t isqrt64(uint64_t v) {
+    if (!v) return 0;
+    uint64_t r = 0, bit = uint64_t(1) << ((63 - std::countl_zero(v)) & ~1);
+    while (bit) {
+        if (v >= r + bit) { v -= r + bit; r = (r >> 1) + bit; }
+        else              { r >>= 1; }
+        bit >>= 2;
+    }
+    return r;
+}
+
+} // namespace
+
+Fixed fx_sqrt(Fixed a) {
+    if (a.raw <= 0) return {};
+    return Fixed::from_raw(int32_t(isqrt64(uint64_t(a.raw) << Fixed::kFracBits)));
+}
+
+Fixed fx_sin(FxAngle a) {
+    // 2 bits of quadrant, 10 of table index, 4 of interpolation
+    const uint32_t quadrant = a >> 14;
+    uint32_t       within   = a & 0x3FFF;
+    if (quadrant & 1) within = 0x4000 - within;   // mirror the rising quarter
+    const uint32_t i = within >> 4, f = within & 15;
+    int32_t v = kSin[i];
+    if (f) v += ((kSin[i + 1] - kSin[i]) * int32_t(f)) >> 4;
+    return Fixed::from_raw(quadrant & 2 ? -v : v);
+}
+
+Fixed fx_cos(FxAngle a) { return fx_sin(FxAngle(a + kFxQuarterTurn)); }
+
+FxAngle fx_atan2(Fixed z, Fixed x) {
+    int64_t vx = x.raw, vz = z.raw;
+    if (vx == 0 && vz == 0) return 0;
+    int64_t angle = 0;                             // 1/256 steps
+    if (vx < 0) { vx = -vx; vz = -vz; angle = int64_t(kFxHalfTurn) << 8; }
+
+    // scale up so small vectors keep their precision through the shifts
+    const int shift = std::countl_zero(uint64_t(std::max(vx, std::abs(vz)))) - 34;
+    if (shift > 0) { vx <<= shift; vz <<= shift; }
+
+    // rotate onto the +x axis, summing the rotations
+    for (int i = 0; i < int(sizeof(kAtan) / sizeof(kAtan[0])); ++i) {
+        const int64_t px = vx;
+        if (vz > 0) { vx += vz >> i; vz -= px >> i; angle += kAtan[i]; }
+        else        { vx -= vz >> i; vz += px >> i; angle -= kAtan[i]; }
+    }
+    return FxAngle((angle + 128) >> 8);
+}
+
+namespace {
+uint64_t length64(FxVec2 v) {
+    const int64_t x = v.x.raw, z = v.z.raw;
+    return isqrt64(uint64_t(x * x) + uint64_t(z * z));
+}
+} // namespace
+
+Fixed fx_length(FxVec2 v) {
+    const uint64_t len = length64(v);
+    return Fixed::from_raw(len > uint64_t(INT32_MAX) ? INT32_MAX : int32_t(len));
+}
+
+FxVec2 fx_normalize(FxVec2 v) {
+    // divides by the unsaturated length, so long vectors keep their direction
+    const int64_t len = int64_t(length64(v));
+    if (len == 0) return {};
+    return { Fixed::from_raw(int32_t(fx_floor_div(int64_t(v.x.raw) << Fixed::kFracBits, len))),
+             Fixed::from_raw(int32_t(fx_floor_div(int64_t(v.z.raw) << Fixed::kFracBits, len))) };
+}
@@ -0,0 +1,92 @@
+#ifndef FIXED_HPP
+#define FIXED_HPP
+
+#include <cmath>
+#include <compare>
+#include <cstdint>
+
+// Q16.16 fixed point for the lockstep simulation. Every machine in a game
+// runs the same ticks on the same commands and has to land on the same bits;
+// float results change with the compiler, flags (FMA contraction, x87) and
+// libm, integers don't. Range is +-32768 with 1/65536 steps.
+//
+// Arithmetic wraps on overflow (done in unsigned / 64-bit and narrowed, so
+// it is defined behaviour and identical everywhere) and rounds toward minus
+// infinity, division included (C++ '/' truncates toward zero, so it goes
+// through fx_floor_div). Division by zero is as undefined as it is for int.
+constexpr int64_t fx_floor_div(int64_t a, int64_t b) {
+    const int64_t q = a / b;
+    return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+struct Fixed {
+    static constexpr int     kFracBits = 16;
+    static constexpr int32_t kOne      = 1 << kFracBits;
+
+    int32_t raw = 0;
+
+    static constexpr Fixed from_raw(int32_t r) { Fixed f; f.raw = r; return f; }
+    static constexpr Fixed from_int(int32_t i) { return from_raw(int32_t(uint32_t(i) << kFracBits)); }
+    // num/den without going through a float: constants like 1/30.
+    static constexpr Fixed from_ratio(int64_t num, int64_t den) { return from_raw(int32_t(fx_floor_div(num << kFracBits, den))); }
+    // Setup and tools only (maps, tests): the sim itself never touches floats.
+    static Fixed from_float(float f) { return from_raw(int32_t(std::lround(double(f) * kOne))); }
+
+    constexpr float   to_float() const { return float(raw) / float(kOne); }
+    constexpr int32_t floor()    const { return raw >> kFracBits; }
+
+    friend constexpr Fixed operator+(Fixed a, Fixed b) { return from_raw(int32_t(uint32_t(a.raw) + uint32_t(b.raw))); }
+    friend constexpr Fixed operator-(Fixed a, Fixed b) { return from_raw(int32_t(uint32_t(a.raw) - uint32_t(b.raw))); }
+    friend constexpr Fixed operator-(Fixed a)          { return from_raw(int32_t(0u - uint32_t(a.raw))); }
+    friend constexpr Fixed operator*(Fixed a, Fixed b) { return from_raw(int32_t((int64_t(a.raw) * b.raw) >> kFracBits)); }
+    friend constexpr Fixed operator/(Fixed a, Fixed b) { return from_raw(int32_t(fx_floor_div(int64_t(a.raw) << kFracBits, b.raw))); }
+    friend constexpr Fixed operator*(Fixed a, int32_t b) { return from_raw(int32_t(uint32_t(a.raw) * uint32_t(b))); }
+
+    constexpr Fixed& operator+=(Fixed b) { return *this = *this + b; }
+    constexpr Fixed& operator-=(Fixed b) { return *this = *this - b; }
+    constexpr Fixed& operator*=(Fixed b) { return *this = *this * b; }
+    constexpr Fixed& operator/=(Fixed b) { return *this = *this / b; }
+
+    friend constexpr auto operator<=>(Fixed a, Fixed b) = default;
+};
+
+constexpr Fixed fx_abs(Fixed a)          { return a.raw < 0 ? -a : a; }
+constexpr Fixed fx_min(Fixed a, Fixed b) { return b < a ? b : a; }
+constexpr Fixed fx_max(Fixed a, Fixed b) { return a < b ? b : a; }
+
+// Angles are binary: 65536 steps per turn, so wrapping is free. 0 points
+// along +x, a quarter turn (16384) along +z.
+using FxAngle = uint16_t;
+constexpr FxAngle kFxQuarterTurn = 16384;
+constexpr FxAngle kFxHalfTurn    = 32768;
+
+// Square root of a non-negative value (negative -> 0), exact to the last bit.
+Fixed fx_sqrt(Fixed a);
+
+// sin/cos from a 1024-entry quarter-wave table with linear interpolation
+// (error under 1e-5); the table is computed in integer math at compile time.
+Fixed fx_sin(FxAngle a);
+Fixed fx_cos(FxAngle a);
+
+// Angle of (x, z) from +x toward +z, integer CORDIC. Within one step of the
+// true angle; (0, 0) gives 0.
+FxAngle fx_atan2(Fixed z, Fixed x);
+
+struct FxVec2 {
+    Fixed x, z;
+
+    friend constexpr FxVec2 operator+(FxVec2 a, FxVec2 b) { return { a.x + b.x, a.z + b.z }; }
+    friend constexpr FxVec2 operator-(FxVec2 a, FxVec2 b) { return { a.x - b.x, a.z - b.z }; }
+    friend constexpr FxVec2 operator*(FxVec2 a, Fixed s)  { return { a.x * s, a.z * s }; }
+    friend constexpr bool   operator==(FxVec2 a, FxVec2 b) = default;
+};
+
+constexpr Fixed fx_dot(FxVec2 a, FxVec2 b) { return a.x * b.x + a.z * b.z; }
+// Computed at full 64-bit precision, so the squares don't overflow; a
+// length past the Fixed range (32768) saturates at the largest value.
+Fixed  fx_length(FxVec2 v);
+FxVec2 fx_normalize(FxVec2 v);   // zero stays zero
+// Unit vector at angle 'a'.
+inline FxVec2 fx_dir(FxAngle a) { return { fx_cos(a), fx_sin(a) }; }
+
+#endif // FIXED_HPP
@@ -0,0 +1,180 @@
+#include "flow_field.hpp"
+#include <algorithm>
+#include <cmath>
+
+CostField cost_field_from_tiles(const TileMap& map, std::span<const uint8_t> cost_per_type) {
+    CostField f;
+    f.width  = map.width();
+    f.height = map.height();
+    f.cost.resize(size_t(f.width) * f.height);
+    for (uint32_t y = 0; y < f.height; ++y)
+        for (uint32_t x = 0; x < f.width; ++x) {
+            const uint8_t type = map.at(x, y).type;
+            f.cost[size_t(y) * f.width + x] = type < cost_per_type.size() ? cost_per_type[type] : 1;
+        }
+    return f;
+}
+
+// A diagonal step needs both tiles it squeezes between to be open.
+static bool diagonal_open(const CostField& c, uint32_t x, uint32_t y, int dx, int dy) {
+    return c.at(x + dx, y) != CostField::kBlocked && c.at(x, y + dy) != CostField::kBlocked;
+}
+
+void build_flow_field(const CostField& costs, uint32_t gx, uint32_t gy, FlowField& out) {
+    const uint32_t W = costs.width, H = costs.height;
+    const size_t   N = size_t(W) * H;
+    out.width  = W;  out.height = H;
+    out.goal_x = gx; out.goal_y = gy;
+    out.integration.assign(N, FlowField::kUnreachable);
+    out.direction.assign(N, kFlowNone);
+    if (gx >= W || gy >= H || costs.at(gx, gy) == CostField::kBlocked) return;
+
+    // Integration: Dijkstra with a bucket queue (Dial). Steps cost 10 or 14
+    // times the tile cost, at most 14 * 254 < kBuckets, so a ring of buckets
+    // indexed by distance never wraps onto the one being drained.
+    constexpr uint32_t kBuckets = 4096;
+    std::vector<std::vector<uint32_t>> buckets(kBuckets);
+    uint32_t* dist = out.integration.data();
+    const size_t goal = size_t(gy) * W + gx;
+    dist[goal] = 0;
+    buckets[0].push_back(uint32_t(goal));
+    size_t queued = 1;
+
+    for (uint32_t d = 0; queued; ++d) {
+        std::vector<uint32_t>& bucket = buckets[d & (kBuckets - 1)];
+        for (size_t k = 0; k < bucket.size(); ++k) {
+            const uint32_t i = bucket[k];
+            --queued;
+            if (dist[i] != d) continue;   // superseded by a shorter path
+            const uint32_t x = i % W, y = i / W;
+            for (int n = 0; n < 8; ++n) {
+                const int nx = int(x) + kFlowDx[n], ny = int(y) + kFlowDy[n];
+                if (nx < 0 || ny < 0 || nx >= int(W) || ny >= int(H)) continue;
+                const uint8_t c = costs.at(uint32_t(nx), uint32_t(ny));
+                if (c == CostField::kBlocked) continue;
+                const bool diag = (n & 1) != 0;
+                if (diag && !diagonal_open(costs, x, y, kFlowDx[n], kFlowDy[n])) continue;
+
+                const uint32_t nd = d + uint32_t(c) * (diag ? 14u : 10u);
+                const size_t   j  = size_t(ny) * W + uint32_t(nx);
+                if (nd >= dist[j]) continue;
+                dist[j] = nd;
+                buckets[nd & (kBuckets - 1)].push_back(uint32_t(j));
+                ++queued;
+            }
+        }
+        bucket.clear();
+    }
+
+    // Direction: each reachable tile points at its cheapest neighbour. Rows
+    // are independent, so they go wide.
+    g_jobs.parallel_for(H, 16, [&](uint32_t y0, uint32_t y1) {
+        for (uint32_t y = y0; y < y1; ++y)
+            for (uint32_t x = 0; x < W; ++x) {
+                const size_t i = size_t(y) * W + x;
+                if (dist[i] == FlowField::kUnreachable) continue;
+                if (i == goal) { out.direction[i] = kFlowGoal; continue; }
+
+                uint32_t best = dist[i];
+                uint8_t  dir  = kFlowNone;
+                for (int n = 0; n < 8; ++n) {
+                    const int nx = int(x) + kFlowDx[n], ny = int(y) + kFlowDy[n];
+                    if (nx < 0 || ny < 0 || nx >= int(W) || ny >= int(H)) continue;
+                    if ((n & 1) && !diagonal_open(costs, x, y, kFlowDx[n], kFlowDy[n])) continue;
+                    const uint32_t nd = dist[size_t(ny) * W + uint32_t(nx)];
+                    if (nd < best) { best = nd; dir = uint8_t(n); }
+                }
+                out.direction[i] = dir;
+            }
+    });
+}
+
+bool FlowField::steer(float x, float z, float& dx, float& dz) const {
+    const float tx = std::floor(x / kTerrainTileSize), tz = std::floor(z / kTerrainTileSize);
+    if (tx < 0.f || tz < 0.f || tx >= float(width) || tz >= float(height)) return false;
+    const uint8_t d = dir_at(uint32_t(tx), uint32_t(tz));
+    if (d >= 8) return false;
+    constexpr float kDiag = 0.70710678f;
+    const float s = (d & 1) ? kDiag : 1.f;
+    dx = float(kFlowDx[d]) * s;
+    dz = float(kFlowDy[d]) * s;
+    return true;
+}
+
+// -----------------------------
+// cache
+// -----------------------------
+
+void FlowFieldCache::set_costs(CostField costs) {
+    std::lock_guard lock(m_mutex);
+    m_costs = std::make_shared<const CostField>(std::move(costs));
+    ++m_version;
+    m_entries.clear();
+}
+
+uint32_t FlowFieldCache::size() const {
+    std::lock_guard lock(m_mutex);
+    return uint32_t(m_entries.size());
+}
+
+void FlowFieldCache::evict_(uint64_t keep) {
+    while (m_entries.size() > m_capacity) {
+        auto victim = m_entries.end();
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+            if (it->second.field && it->first != keep &&
+                (victim == m_entries.end() || it->second.last_used < victim->second.last_used))
+                victim = it;
+        if (victim == m_entries.end()) {
+            // everything left is building (or just landed): stay over
+            // capacity until the next call instead of spinning here
+            ++m_over_capacity;
+            return;
+        }
+        m_entries.erase(victim);
+    }
+}
+
+std::shared_ptr<const FlowField> FlowFieldCache::request(uint32_t gx, uint32_t gy) {
+    std::lock_guard lock(m_mutex);
+    if (!m_costs || gx >= m_costs->width || gy >= m_costs->height) return nullptr;
+
+    const uint64_t key = uint64_t(gy) * m_costs->width + gx;
+    auto [it, inserted] = m_entries.try_emplace(key);
+    it->second.last_used = ++m_clock;
+    if (!inserted) return it->second.field;
+    evict_(key);
+
+    g_jobs.run([this, costs = m_costs, version = m_version, gx, gy, key] {
+        auto field = std::make_shared<FlowField>();
+        build_flow_field(*costs, gx, gy, *field);
+        ++m_builds;
+
+        std::lock_guard lock(m_mutex);
+        if (version != m_version) return;   // costs changed underneath
+        auto found = m_entries.find(key);
+        if (found != m_entries.end()) found->second.field = std::move(field);
+        evict_(key);   // fields still building couldn't be evicted at request time
+    }, &m_pending);
+    return nullptr;
+}
+
+std::shared_ptr<const FlowField> FlowFieldCache::get(uint32_t gx, uint32_t gy) {
+    // a landed field can still be evicted by other threads' requests (or
+    // dropped by set_costs) before we get to it; after a few rounds of that,
+    // build a private copy rather than keep waiting
+    constexpr int kMaxAttempts = 4;
+    std::shared_ptr<const CostField> costs;
+    for (int attempt = 0; attempt < kMaxAttempts; ++attempt) {
+        if (auto field = request(gx, gy)) return field;
+        {
+            std::lock_guard lock(m_mutex);
+            if (!m_costs || gx >= m_costs->width || gy >= m_costs->height) return nullptr;
+            costs = m_costs;
+        }
+        wait_idle();
+    }
+    auto field = std::make_shared<FlowField>();
+    build_flow_field(*costs, gx, gy, *field);
+    ++m_builds;
+    return field;
+}
@@ -0,0 +1,111 @@
+#ifndef FLOW_FIELD_HPP
+#define FLOW_FIELD_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "jobs.hpp"
+#include "terrain_mesh.hpp"
+
+// Flow-field pathfinding on the tile grid: instead of one A* per unit, a
+// group ordered to the same destination shares one field that tells every
+// tile which way to walk. Three layers, built in order:
+//   cost        - per tile step cost, 1..254, or kBlocked
+//   integration - total cost to the goal (Dijkstra from the goal outwards)
+//   direction   - per tile, the neighbour with the lowest integration value
+// Tile (x, y) covers world x in [x, x+1), z in [y, y+1) (kTerrainTileSize).
+// Pure CPU.
+
+struct CostField {
+    static constexpr uint8_t kBlocked = 255;
+
+    uint32_t             width = 0, height = 0;
+    std::vector<uint8_t> cost;   // row-major
+
+    uint8_t at(uint32_t x, uint32_t y) const { return cost[size_t(y) * width + x]; }
+};
+
+// Cost per tile from its type; types past the end of the table cost 1.
+CostField cost_field_from_tiles(const TileMap& map, std::span<const uint8_t> cost_per_type);
+
+// Eight neighbours, clockwise from +x with y down the map (= +z in world).
+enum FlowDir : uint8_t {
+    kFlowE, kFlowSE, kFlowS, kFlowSW, kFlowW, kFlowNW, kFlowN, kFlowNE,
+    kFlowGoal = 8,      // the goal tile itself
+    kFlowNone = 255,    // blocked, or the goal can't be reached from here
+};
+constexpr int kFlowDx[8] = { 1, 1, 0, -1, -1, -1,  0,  1 };
+constexpr int kFlowDy[8] = { 0, 1, 1,  1,  0, -1, -1, -1 };
+
+struct FlowField {
+    static constexpr uint32_t kUnreachable = UINT32_MAX;
+
+    uint32_t width = 0, height = 0;
+    uint32_t goal_x = 0, goal_y = 0;
+    std::vector<uint32_t> integration;   // 10 per straight step of cost 1, 14 per diagonal
+    std::vector<uint8_t>  direction;     // FlowDir
+
+    uint8_t dir_at(uint32_t x, uint32_t y) const { return direction[size_t(y) * width + x]; }
+
+    // Unit vector to walk along from world (x, z); false at the goal, off the
+    // map, or where the goal can't be reached.
+    bool steer(float x, float z, float& dx, float& dz) const;
+};
+
+// Builds all three layers for goal tile (gx, gy). Diagonal steps never cut
+// the corner of a blocked tile. The direction pass runs on g_jobs.
+void build_flow_field(const CostField& costs, uint32_t gx, uint32_t gy, FlowField& out);
+
+// Fields keyed by goal tile, built on g_jobs the first time a goal is asked
+// for and shared (read-only) by every unit heading there. Least recently used
+// fields are dropped past 'capacity'; fields still building can't be, so the
+// cache may run over it for a while (see over_capacity()). request() may be called
+// from the sim thread while builds are running.
+class FlowFieldCache {
+public:
+    explicit FlowFieldCache(uint32_t capacity = 32) : m_capacity(capacity) {}
+    ~FlowFieldCache() { wait_idle(); }
+
+    // New costs (terrain changed): every cached field is dropped, builds in
+    // flight are discarded when they land.
+    void set_costs(CostField costs);
+
+    // The field for the goal, or null while it's still being built (the first
+    // request starts the job). Callers hold on to the pointer while they use it.
+    std::shared_ptr<const FlowField> request(uint32_t gx, uint32_t gy);
+    // request() that helps run jobs until the field is there; if it keeps
+    // getting evicted before we see it, builds an uncached copy instead.
+    std::shared_ptr<const FlowField> get(uint32_t gx, uint32_t gy);
+
+    void     wait_idle() { g_jobs.wait(m_pending); }
+    uint32_t size() const;
+    uint32_t builds() const { return m_builds.load(); }   // fields built since creation
+    // Times an eviction found nothing it could drop and left the cache over
+    // capacity. Growing now and then is expected; steadily, capacity is too small.
+    uint32_t over_capacity() const { return m_over_capacity.load(); }
+
+private:
+    struct Entry {
+        std::shared_ptr<const FlowField> field;   // null while building
+        uint64_t                         last_used = 0;
+    };
+
+    void evict_(uint64_t keep);   // never drops 'keep' or fields still building
+
+    mutable std::mutex                         m_mutex;
+    std::shared_ptr<const CostField>           m_costs;
+    uint64_t                                   m_version = 0;   // bumped by set_costs
+    uint64_t                                   m_clock   = 0;   // request counter for LRU
+    std::unordered_map<uint64_t, Entry>        m_entries;       // key: gy * width + gx
+    uint32_t                                   m_capacity;
+    std::atomic<uint32_t>                      m_builds{0};
+    std::atomic<uint32_t>                      m_over_capacity{0};
+    JobCounter                                 m_pending;
+};
+
+#endif // FLOW_FIELD_HPP
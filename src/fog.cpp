@@ -0,0 +1,132 @@
+#include "fog.hpp"
+#include <algorithm>
+#include <cmath>
+#include "terrain_mesh.hpp"   // kTerrainTileSize
+
+void FogOfWar::init(uint32_t width, uint32_t height, uint32_t players) {
+    DEBUG_ASSERT(players > 0 && players <= kMaxPlayers);
+    m_w = width;
+    m_h = height;
+    m_words    = (width + 63) / 64;
+    m_blocks_x = (width  + kBlock - 1) / kBlock;
+    m_blocks_y = (height + kBlock - 1) / kBlock;
+    m_stamps   = 0;
+    m_where.clear();
+
+    m_layers.assign(players, {});
+    for (Layer& l : m_layers) {
+        l.count.assign(size_t(width) * height, 0);
+        l.visible.assign(size_t(m_words) * height, 0);
+        l.explored.assign(size_t(m_words) * height, 0);
+        l.dirty.assign(size_t(m_blocks_x) * m_blocks_y, 0);
+    }
+
+    // discs: tile (dx, dy) is in sight when dx² + dy² <= r² + r (rounder than r²)
+    m_stencils.resize(kMaxSight + 1);
+    for (uint32_t r = 0; r <= kMaxSight; ++r) {
+        m_stencils[r].resize(r + 1);
+        for (uint32_t dy = 0; dy <= r; ++dy)
+            m_stencils[r][dy] = uint8_t(std::sqrt(double(r * r + r - dy * dy)));
+    }
+}
+
+void FogOfWar::stamp_(uint32_t player, uint32_t tile, uint32_t radius, bool add) {
+    Layer& l = m_layers[player];
+    const std::vector<uint8_t>& half = m_stencils[radius];
+    const int cx = int(tile % m_w), cy = int(tile / m_w);
+    ++m_stamps;
+
+    for (int dy = -int(radius); dy <= int(radius); ++dy) {
+        const int y = cy + dy;
+        if (y < 0 || y >= int(m_h)) continue;
+        const int hw = half[size_t(std::abs(dy))];
+        const uint32_t x0 = uint32_t(std::max(0, cx - hw));
+        const uint32_t x1 = uint32_t(std::min(int(m_w) - 1, cx + hw));
+
+        uint16_t* count = &l.count[size_t(y) * m_w];
+        uint64_t* vis   = &l.visible[size_t(y) * m_words];
+        bool flipped = false;
+        if (add) {
+            for (uint32_t x = x0; x <= x1; ++x)
+                if (count[x]++ == 0) { vis[x >> 6] |= 1ull << (x & 63); flipped = true; }
+            if (flipped) {   // whatever is visible now is explored; whole words at once
+                uint64_t* exp = &l.explored[size_t(y) * m_words];
+                for (uint32_t w = x0 >> 6; w <= x1 >> 6; ++w) exp[w] |= vis[w];
+            }
+        } else {
+            for (uint32_t x = x0; x <= x1; ++x)
+                if (--count[x] == 0) { vis[x >> 6] &= ~(1ull << (x & 63)); flipped = true; }
+        }
+        if (flipped)
+            for (uint32_t bx = x0 / kBlock; bx <= x1 / kBlock; ++bx) mark_block_(l, bx, uint32_t(y) / kBlock);
+    }
+}
+
+void FogOfWar::update(Entity e, uint32_t player, float x, float z, uint32_t radius) {
+    if (e.index >= m_where.size()) m_where.resize(size_t(e.index) + 1);
+    Where& w = m_where[e.index];
+    const int tx = std::clamp(int(std::floor(x / kTerrainTileSize)), 0, int(m_w) - 1);
+    const int ty = std::clamp(int(std::floor(z / kTerrainTileSize)), 0, int(m_h) - 1);
+    const uint32_t tile = uint32_t(ty) * m_w + uint32_t(tx);
+    radius = std::min(radius, kMaxSight);
+
+    if (w.tile != kNone) {
+        // common case: still on the same tile, nothing to do
+        if (w.generation == e.generation && w.tile == tile && w.player == player && w.radius == radius) return;
+        stamp_(w.player, w.tile, w.radius, false);   // moved, changed, or a stale handle's leftovers
+    }
+    w.generation = e.generation;
+    w.tile       = tile;
+    w.player     = uint16_t(player);
+    w.radius     = uint16_t(radius);
+    stamp_(player, tile, radius, true);
+}
+
+bool FogOfWar::remove(Entity e) {
+    if (e.index >= m_where.size()) return false;
+    Where& w = m_where[e.index];
+    if (w.tile == kNone || w.generation != e.generation) return false;
+    stamp_(w.player, w.tile, w.radius, false);
+    w.tile = kNone;
+    return true;
+}
+
+void FogOfWar::take_dirty(uint32_t player, std::vector<FogRect>& out) {
+    Layer& l = m_layers[player];
+    if (!l.dirty_count) return;
+    for (uint32_t by = 0; by < m_blocks_y; ++by) {
+        uint8_t* row = &l.dirty[size_t(by) * m_blocks_x];
+        for (uint32_t bx = 0; bx < m_blocks_x; ) {
+            if (!row[bx]) { ++bx; continue; }
+            uint32_t end = bx;
+            while (end < m_blocks_x && row[end]) row[end++] = 0;
+            const uint32_t x = bx * kBlock, y = by * kBlock;
+            out.push_back(FogRect{ x, y, std::min(m_w, end * kBlock) - x, std::min(m_h, y + kBlock) - y });
+            bx = end;
+        }
+    }
+    l.dirty_count = 0;
+}
+
+void FogOfWar::mark_dirty(uint32_t player, const FogRect& r) {
+    if (!r.w || !r.h) return;
+    Layer& l = m_layers[player];
+    for (uint32_t by = r.y / kBlock; by <= (r.y + r.h - 1) / kBlock; ++by)
+        for (uint32_t bx = r.x / kBlock; bx <= (r.x + r.w - 1) / kBlock; ++bx) mark_block_(l, bx, by);
+}
+
+void FogOfWar::mark_all_dirty(uint32_t player) {
+    mark_dirty(player, FogRect{ 0, 0, m_w, m_h });
+}
+
+void FogOfWar::write_texels(uint32_t player, const FogRect& r, uint8_t* out) const {
+    const Layer& l = m_layers[player];
+    for (uint32_t y = r.y; y < r.y + r.h; ++y) {
+        const uint64_t* vis = &l.visible[size_t(y) * m_words];
+        const uint64_t* exp = &l.explored[size_t(y) * m_words];
+        for (uint32_t x = r.x; x < r.x + r.w; ++x) {
+            const uint64_t bit = 1ull << (x & 63);
+            *out++ = (vis[x >> 6] & bit) ? kTexelVisible : (exp[x >> 6] & bit) ? kTexelExplored : kTexelHidden;
+        }
+    }
+}
@@ -0,0 +1,102 @@
+#ifndef FOG_HPP
+#define FOG_HPP
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "entity_store.hpp"
+
+// Per-player fog of war over the tile grid. Each player has two packed
+// bitsets (64 tiles per word, rows padded to whole words): 'visible' (some
+// unit of theirs sees the tile now) and 'explored' (ever seen). Under the
+// bits sits a viewer count per tile, so vision is kept incrementally: a unit
+// that stays on its tile costs a compare, and one crossing into another tile
+// takes its sight stencil (a precomputed disc, as half-widths per row) off
+// the old tile and stamps it on the new one. Nothing is ever recomputed per
+// player per tick.
+//
+// Tiles whose bits flip mark their kBlock² block dirty per player;
+// take_dirty() hands those back as rects for partial texture uploads
+// (FogTexture). Pure CPU.
+struct FogRect {
+    uint32_t x, y, w, h;   // tiles
+};
+
+class FogOfWar {
+public:
+    static constexpr uint32_t kMaxPlayers = 8;
+    static constexpr uint32_t kMaxSight   = 32;   // tiles; larger radii clamp
+    static constexpr uint32_t kBlock      = 32;   // dirty-tracking granularity, tiles per side
+
+    // R8 texel values written by write_texels().
+    static constexpr uint8_t kTexelHidden   = 0;
+    static constexpr uint8_t kTexelExplored = 128;
+    static constexpr uint8_t kTexelVisible  = 255;
+
+    void init(uint32_t width, uint32_t height, uint32_t players);
+
+    // Puts e's sight (radius in tiles) on the tile under world (x, z), or
+    // moves it there. Restamps only when the tile, radius or owner changed.
+    void update(Entity e, uint32_t player, float x, float z, uint32_t radius);
+    bool remove(Entity e);   // false if e isn't in (or is a stale handle)
+
+    bool visible(uint32_t player, uint32_t x, uint32_t y) const {
+        return (m_layers[player].visible[size_t(y) * m_words + (x >> 6)] >> (x & 63)) & 1;
+    }
+    bool explored(uint32_t player, uint32_t x, uint32_t y) const {
+        return (m_layers[player].explored[size_t(y) * m_words + (x >> 6)] >> (x & 63)) & 1;
+    }
+    std::span<const uint64_t> visible_bits(uint32_t player)  const { return m_layers[player].visible; }
+    std::span<const uint64_t> explored_bits(uint32_t player) const { return m_layers[player].explored; }
+    uint32_t words_per_row() const { return m_words; }
+
+    // Appends the rects changed for 'player' since the last call (dirty
+    // blocks, merged along block rows) and clears their flags.
+    void take_dirty(uint32_t player, std::vector<FogRect>& out);
+    bool any_dirty(uint32_t player) const { return m_layers[player].dirty_count != 0; }
+    void mark_dirty(uint32_t player, const FogRect& r);   // e.g. an upload that didn't fit
+    void mark_all_dirty(uint32_t player);                 // switching whose fog is shown
+
+    // r.w * r.h tightly packed kTexel* values for 'player'.
+    void write_texels(uint32_t player, const FogRect& r, uint8_t* out) const;
+
+    uint32_t width()   const { return m_w; }
+    uint32_t height()  const { return m_h; }
+    uint32_t players() const { return uint32_t(m_layers.size()); }
+    uint64_t stamps()  const { return m_stamps; }   // stencils applied or lifted, ever
+
+private:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    struct Layer {
+        std::vector<uint16_t> count;      // viewers per tile
+        std::vector<uint64_t> visible;
+        std::vector<uint64_t> explored;
+        std::vector<uint8_t>  dirty;      // per block
+        uint32_t              dirty_count = 0;
+    };
+    // what an entity index currently has stamped
+    struct Where {
+        uint32_t generation = 0;
+        uint32_t tile       = kNone;
+        uint16_t player     = 0;
+        uint16_t radius     = 0;
+    };
+
+    void stamp_(uint32_t player, uint32_t tile, uint32_t radius, bool add);
+    void mark_block_(Layer& l, uint32_t bx, uint32_t by) {
+        uint8_t& d = l.dirty[size_t(by) * m_blocks_x + bx];
+        if (!d) { d = 1; ++l.dirty_count; }
+    }
+
+    uint32_t m_w = 0, m_h = 0, m_words = 0;
+    uint32_t m_blocks_x = 0, m_blocks_y = 0;
+    uint64_t m_stamps = 0;
+
+    std::vector<Layer>                m_layers;     // per player
+    std::vector<std::vector<uint8_t>> m_stencils;   // per radius: half-width for dy = 0..radius
+    std::vector<Where>                m_where;      // by entity index
+};
+
+#endif // FOG_HPP
@@ -0,0 +1,128 @@
+#include "fog_texture.hpp"
+#include "memory_tracker.hpp"
+
+VkResult FogTexture::create(VkDevice device, VkPhysicalDevice phys, uint32_t width, uint32_t height) {
+    m_width  = width;
+    m_height = height;
+    m_player = kNoPlayer;
+    m_fresh  = true;
+
+    VkImageCreateInfo ici{};
+    ici.sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    ici.imageType     = VK_IMAGE_TYPE_2D;
+    ici.format        = VK_FORMAT_R8_UNORM;
+    ici.extent        = { width, height, 1 };
+    ici.mipLevels     = 1;
+    ici.arrayLayers   = 1;
+    ici.samples       = VK_SAMPLE_COUNT_1_BIT;
+    ici.tiling        = VK_IMAGE_TILING_OPTIMAL;
+    ici.usage         = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    ici.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
+    ici.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    if (auto e = vkCreateImage(device, &ici, nullptr, &m_image)) return e;
+
+    VkMemoryRequirements mr{};
+    vkGetImageMemoryRequirements(device, m_image, &mr);
+    const uint32_t type = render::find_mem_type(phys, mr.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    if (type == UINT32_MAX) return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+
+    VkMemoryAllocateInfo mai{};
+    mai.sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    mai.allocationSize  = mr.size;
+    mai.memoryTypeIndex = type;
+    if (auto e = tracked_allocate(device, mai, &m_memory, MemoryCategory::Texture)) return e;
+    if (auto e = vkBindImageMemory(device, m_image, m_memory, 0)) return e;
+
+    VkImageViewCreateInfo iv{};
+    iv.sType    = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    iv.image    = m_image;
+    iv.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    iv.format   = VK_FORMAT_R8_UNORM;
+    iv.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+    return vkCreateImageView(device, &iv, nullptr, &m_view);
+}
+
+void FogTexture::destroy(VkDevice device) {
+    if (m_view)   vkDestroyImageView(device, m_view, nullptr);
+    if (m_image)  vkDestroyImage(device, m_image, nullptr);
+    if (m_memory) tracked_free(device, m_memory);
+    m_view   = VK_NULL_HANDLE;
+    m_image  = VK_NULL_HANDLE;
+    m_memory = VK_NULL_HANDLE;
+    m_dirty.clear();
+    m_regions.clear();
+    m_stats = {};
+}
+
+VkResult FogTexture::update(VkCommandBuffer cb, MappedArena& arena, FogOfWar& fog, uint32_t player) {
+    m_stats = {};
+    if (player != m_player) {   // the image holds someone else's fog
+        fog.mark_all_dirty(player);
+        m_player = player;
+    }
+    if (!fog.any_dirty(player)) return VK_SUCCESS;
+
+    arena.assert_matches(VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+    m_dirty.clear();
+    fog.take_dirty(player, m_dirty);
+
+    // stage every rect; R8 rows are tightly packed, so a rect is w * h bytes
+    VkResult result = VK_SUCCESS;
+    VkBuffer src    = VK_NULL_HANDLE;
+    m_regions.clear();
+    for (size_t i = 0; i < m_dirty.size(); ++i) {
+        const FogRect& r = m_dirty[i];
+        const VkDeviceSize bytes = VkDeviceSize(r.w) * r.h;
+        UploadAlloc a{};
+        if ((result = arena.alloc(bytes, a, 4))) {
+            // out of room: put the rest back for next time
+            for (size_t j = i; j < m_dirty.size(); ++j) fog.mark_dirty(player, m_dirty[j]);
+            break;
+        }
+        fog.write_texels(player, r, static_cast<uint8_t*>(a.cpu_ptr));
+        arena.flush(a, bytes);
+        src = a.buffer;
+
+        VkBufferImageCopy c{};
+        c.bufferOffset     = a.offset;
+        c.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+        c.imageOffset      = { int32_t(r.x), int32_t(r.y), 0 };
+        c.imageExtent      = { r.w, r.h, 1 };
+        m_regions.push_back(c);
+        m_stats.bytes += uint32_t(bytes);
+    }
+    if (m_regions.empty() && !m_fresh) return result;
+
+    // last frame's samples are done before we overwrite (contents only matter if not fresh)
+    auto to_dst = render::image_barrier2(m_image,
+        m_fresh ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, 0,
+        VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
+    render::cmd_barriers(cb, { &to_dst, 1 });
+
+    if (m_fresh) {   // undefined texels read as hidden until their rect lands
+        const VkClearColorValue hidden{};
+        const VkImageSubresourceRange all{ VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+        vkCmdClearColorImage(cb, m_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &hidden, 1, &all);
+        m_fresh = false;
+        if (!m_regions.empty()) {   // clear and copies both write: order them
+            auto waw = render::image_barrier2(m_image,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
+            render::cmd_barriers(cb, { &waw, 1 });
+        }
+    }
+    if (!m_regions.empty())
+        vkCmdCopyBufferToImage(cb, src, m_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                               uint32_t(m_regions.size()), m_regions.data());
+    m_stats.regions = uint32_t(m_regions.size());
+
+    auto to_read = render::image_barrier2(m_image,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+        VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT);
+    render::cmd_barriers(cb, { &to_read, 1 });
+    return result;
+}
@@ -0,0 +1,53 @@
+#ifndef FOG_TEXTURE_HPP
+#define FOG_TEXTURE_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "render_pipeline.hpp"
+#include "memory.hpp"
+#include "fog.hpp"
+
+struct FogTextureStats {
+    uint32_t regions = 0;   // copy regions recorded by the last update()
+    uint32_t bytes   = 0;   // texels staged by the last update()
+};
+
+// One player's fog of war as an R8_UNORM image, one texel per tile (see
+// FogOfWar::kTexel* for the values), sampled by whatever draws the ground.
+// update() stages only the rects FogOfWar::take_dirty() hands back into a
+// MappedArena and copies them with one multi-region vkCmdCopyBufferToImage,
+// so a tick where a few units crossed a tile boundary uploads a few 32x32
+// blocks instead of the whole map.
+class FogTexture {
+public:
+    VkResult create(VkDevice device, VkPhysicalDevice phys, uint32_t width, uint32_t height);
+    void destroy(VkDevice device);
+
+    // Outside rendering, once per tick: brings the image up to date with
+    // 'player's fog (needs TRANSFER_SRC on 'arena'). Showing another player
+    // than last time re-uploads everything. The image is in
+    // SHADER_READ_ONLY_OPTIMAL for fragment shaders afterwards. OOM leaves
+    // the rest dirty for the next call.
+    VkResult update(VkCommandBuffer cb, MappedArena& arena, FogOfWar& fog, uint32_t player);
+
+    VkImage     image() const { return m_image; }
+    VkImageView view()  const { return m_view; }
+    const FogTextureStats& stats() const { return m_stats; }
+
+private:
+    static constexpr uint32_t kNoPlayer = UINT32_MAX;
+
+    VkImage        m_image  = VK_NULL_HANDLE;
+    VkDeviceMemory m_memory = VK_NULL_HANDLE;
+    VkImageView    m_view   = VK_NULL_HANDLE;
+    uint32_t       m_width = 0, m_height = 0;
+    uint32_t       m_player = kNoPlayer;   // whose fog the image holds
+    bool           m_fresh  = true;        // layout still UNDEFINED
+
+    std::vector<FogRect>           m_dirty;     // scratch
+    std::vector<VkBufferImageCopy> m_regions;   // scratch
+    FogTextureStats                m_stats;
+};
+
+#endif // FOG_TEXTURE_HPP
@@ -0,0 +1,49 @@
+#ifndef FRUSTUM_HPP
+#define FRUSTUM_HPP
+
+#include <cmath>
+
+// Six normalized planes (n.xyz, d) with dot(n, p) + d >= 0 inside, taken from
+// a column-major view-projection matrix (GLSL layout, Vulkan 0..1 depth).
+// Pure CPU: usable from the sim side and from tests without a device.
+struct Frustum {
+    float planes[6][4];
+
+    static Frustum from_view_proj(const float m[16]) {
+        Frustum f;
+        for (int c = 0; c < 4; ++c) {
+            const float r0 = m[c*4 + 0], r1 = m[c*4 + 1], r2 = m[c*4 + 2], r3 = m[c*4 + 3];
+            f.planes[0][c] = r3 + r0;  // left
+            f.planes[1][c] = r3 - r0;  // right
+            f.planes[2][c] = r3 + r1;  // top (Vulkan y points down)
+            f.planes[3][c] = r3 - r1;  // bottom
+            f.planes[4][c] = r2;       // near (z >= 0)
+            f.planes[5][c] = r3 - r2;  // far
+        }
+        for (auto& p : f.planes) {
+            const float len = std::sqrt(p[0]*p[0] + p[1]*p[1] + p[2]*p[2]);
+            if (len > 0.f) for (float& v : p) v /= len;
+        }
+        return f;
+    }
+
+    bool sphere(float x, float y, float z, float r) const {
+        for (const auto& p : planes)
+            if (p[0]*x + p[1]*y + p[2]*z + p[3] < -r) return false;
+        return true;
+    }
+
+    // Conservative: true unless the box is fully outside one plane.
+    bool aabb(const float mn[3], const float mx[3]) const {
+        for (const auto& p : planes) {
+            // the box corner furthest along the plane normal
+            const float x = p[0] >= 0.f ? mx[0] : mn[0];
+            const float y = p[1] >= 0.f ? mx[1] : mn[1];
+            const float z = p[2] >= 0.f ? mx[2] : mn[2];
+            if (p[0]*x + p[1]*y + p[2]*z + p[3] < 0.f) return false;
+        }
+        return true;
+    }
+};
+
+#endif // FRUSTUM_HPP
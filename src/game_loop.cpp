@@ -0,0 +1,86 @@
+#include "game_loop.hpp"
+#include "common.hpp"
+#include <algorithm>
+
+void GameLoop::start(double tick_hz, TickFn tick, PublishFn publish,
+                     bool threaded, uint32_t max_catchup)
+{
+    stop();
+    m_tick        = std::move(tick);
+    m_publish     = std::move(publish);
+    DEBUG_ASSERT(tick_hz >= 1.0 && tick_hz <= kMaxTickHz);
+    // past kMaxTickHz a tick would round to 0 ns (and divide by zero below)
+    m_dt          = 1.0 / std::clamp(tick_hz, 1.0, kMaxTickHz);
+    m_dt_ns       = std::max<int64_t>(int64_t(m_dt * 1e9), 1);
+    m_max_catchup = std::max(max_catchup, 1u);
+    m_ticks.store(0);
+    m_dropped.store(0);
+    m_tick_ms.store(0.0);
+    m_epoch.store(now_ns_());
+    m_running.store(true);
+
+    if (threaded) m_thread = std::thread([this] { thread_main_(); });
+}
+
+void GameLoop::stop() {
+    m_running.store(false);
+    if (m_thread.joinable()) m_thread.join();
+}
+
+uint32_t GameLoop::pump() {
+    if (threaded() || !m_running.load(std::memory_order_relaxed)) return 0;
+    return run_due_();
+}
+
+uint32_t GameLoop::run_due_() {
+    const uint64_t done = m_ticks.load(std::memory_order_relaxed);
+    const int64_t  now  = now_ns_();
+    int64_t        epoch = m_epoch.load(std::memory_order_relaxed);
+
+    uint64_t due = uint64_t(std::max<int64_t>(now - epoch, 0) / m_dt_ns);
+    if (due <= done) return 0;
+
+    if (due - done > m_max_catchup) {
+        // drop the backlog: shift time 0 so only max_catchup ticks are due
+        const uint64_t drop = due - done - m_max_catchup;
+        epoch += int64_t(drop) * m_dt_ns;
+        m_epoch.store(epoch, std::memory_order_relaxed);
+        m_dropped.fetch_add(drop, std::memory_order_relaxed);
+        due = done + m_max_catchup;
+    }
+
+    const auto t0 = Clock::now();
+    for (uint64_t n = done; n < due; ++n) m_tick(n);
+    const double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count() / double(due - done);
+    m_tick_ms.store(0.9 * m_tick_ms.load(std::memory_order_relaxed) + 0.1 * ms, std::memory_order_relaxed);
+
+    m_ticks.store(due, std::memory_order_release);
+    if (m_publish) m_publish(due);
+    return uint32_t(due - done);
+}
+
+void GameLoop::thread_main_() {
+    while (m_running.load(std::memory_order_relaxed)) {
+        run_due_();
+        // sleep until the next tick is due (epoch may have moved); relative,
+        // so a clock from set_clock() works too
+        const int64_t next = m_epoch.load(std::memory_order_relaxed)
+                           + int64_t(m_ticks.load(std::memory_order_relaxed) + 1) * m_dt_ns;
+        const int64_t wait = std::clamp<int64_t>(next - now_ns_(), 0, m_dt_ns);
+        if (wait > 0) std::this_thread::sleep_for(std::chrono::nanoseconds(wait));
+    }
+}
+
+float GameLoop::alpha(uint64_t snapshot_ticks) const {
+    const int64_t elapsed = now_ns_() - m_epoch.load(std::memory_order_relaxed);
+    const double  a = double(elapsed) / double(m_dt_ns) - double(snapshot_ticks);
+    return float(std::clamp(a, 0.0, 1.0));
+}
+
+GameLoopStats GameLoop::stats() const {
+    GameLoopStats s;
+    s.ticks         = m_ticks.load(std::memory_order_relaxed);
+    s.dropped_ticks = m_dropped.load(std::memory_order_relaxed);
+    s.tick_ms_avg   = m_tick_ms.load(std::memory_order_relaxed);
+    return s;
+}
@@ -0,0 +1,131 @@
+#ifndef GAME_LOOP_HPP
+#define GAME_LOOP_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+// Hands simulation snapshots to the renderer without either side waiting:
+// three slots (one being written, one being read, one in between) and a
+// single atomic index swap on each side. The writer must fill write()
+// completely before each publish(): the slot it gets back is whatever the
+// reader dropped, not the previous snapshot. To interpolate, put both the
+// previous and the current tick's state in T.
+template <class T>
+class SnapshotExchange {
+public:
+    // --- sim side ---
+    T& write() { return m_slots[m_write].value; }
+    void publish(uint64_t tick) {
+        m_slots[m_write].tick = tick;
+        m_write = m_middle.exchange(m_write | kFresh, std::memory_order_acq_rel) & kIndex;
+    }
+
+    // --- render side ---
+    // Picks up the latest publish(); false (current() unchanged) if none since.
+    bool acquire() {
+        if (!(m_middle.load(std::memory_order_relaxed) & kFresh)) return false;
+        m_read = m_middle.exchange(m_read, std::memory_order_acq_rel) & kIndex;
+        return true;
+    }
+    const T& current()      const { return m_slots[m_read].value; }
+    uint64_t current_tick() const { return m_slots[m_read].tick; }
+    bool     ready()        const { return m_slots[m_read].tick != kNoTick; }
+
+private:
+    static constexpr uint32_t kIndex  = 3;
+    static constexpr uint32_t kFresh  = 4;
+    static constexpr uint64_t kNoTick = UINT64_MAX;
+
+    struct Slot {
+        T        value{};
+        uint64_t tick = kNoTick;
+    };
+
+    Slot                  m_slots[3];
+    uint32_t              m_write = 0;        // sim thread only
+    uint32_t              m_read  = 1;        // render thread only
+    std::atomic<uint32_t> m_middle{2};        // index | kFresh
+};
+
+struct GameLoopStats {
+    uint64_t ticks         = 0;
+    uint64_t dropped_ticks = 0;     // skipped to catch up after a stall
+    double   tick_ms_avg   = 0.0;   // smoothed cost of one tick
+};
+
+// Fixed-timestep simulation. Ticks run at 'tick_hz' regardless of the frame
+// rate: inline, the render loop calls pump() each frame and it runs whatever
+// ticks came due (an accumulator on the wall clock); threaded, a sim thread
+// does the same on its own schedule and the render loop never touches the
+// sim state, only the snapshots 'publish' hands over.
+//
+// Falling behind by more than 'max_catchup' ticks drops the excess time
+// instead of spiraling: the sim slows down rather than freezing the frame.
+class GameLoop {
+public:
+    // tick(n): advance the sim one step (n = 0, 1, 2...).
+    // publish(n): snapshot the state after n ticks, e.g. into a SnapshotExchange.
+    // Called once after each batch of ticks, on the thread that ran them.
+    using TickFn    = std::function<void(uint64_t tick)>;
+    using PublishFn = std::function<void(uint64_t ticks)>;
+    // Nanoseconds on any monotonic scale; thread-safe in threaded mode.
+    using ClockFn   = std::function<int64_t()>;
+
+    // tick_hz is clamped to [1, kMaxTickHz].
+    static constexpr double kMaxTickHz = 10000.0;
+
+    ~GameLoop() { stop(); }
+
+    void start(double tick_hz, TickFn tick, PublishFn publish,
+               bool threaded, uint32_t max_catchup = 8);
+    void stop();
+
+    // Replaces steady_clock (tests drive time by hand); null restores it.
+    // Call before start().
+    void set_clock(ClockFn now_ns) { m_clock = std::move(now_ns); }
+
+    // Inline mode: call once per frame. Returns the ticks run (0 when threaded).
+    uint32_t pump();
+
+    // Interpolation factor for a snapshot taken after 'snapshot_ticks' ticks:
+    // how far (0..1) wall-clock time has moved into the next tick. Render
+    // lerp(previous, current, alpha) with both states from that snapshot.
+    float alpha(uint64_t snapshot_ticks) const;
+
+    double   tick_seconds() const { return m_dt; }
+    bool     threaded()     const { return m_thread.joinable(); }
+    uint64_t ticks()        const { return m_ticks.load(std::memory_order_acquire); }
+    GameLoopStats stats()   const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    uint32_t run_due_();           // on whichever thread owns the sim
+    void     thread_main_();
+    int64_t  now_ns_() const {
+        if (m_clock) return m_clock();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+    }
+
+    TickFn    m_tick;
+    PublishFn m_publish;
+    ClockFn   m_clock;
+    double    m_dt          = 1.0 / 30.0;
+    int64_t   m_dt_ns       = 0;
+    uint32_t  m_max_catchup = 8;
+
+    // time 0 of the sim: tick n is due at m_epoch + n * dt. Dropped time
+    // moves it forward.
+    std::atomic<int64_t>  m_epoch{0};
+    std::atomic<uint64_t> m_ticks{0};
+    std::atomic<uint64_t> m_dropped{0};
+    std::atomic<double>   m_tick_ms{0.0};
+
+    std::atomic<bool> m_running{false};
+    std::thread       m_thread;
+};
+
+#endif // GAME_LOOP_HPP
@@ -0,0 +1,148 @@
+#include "gpu_timeline.hpp"
+#include "common.hpp"
+#include <algorithm>
+
+VkResult GpuTimeline::create(VkDevice device) {
+    destroy();
+    m_device   = device;
+    m_timeline = g_vulkan.timeline_semaphore;
+    m_submitted = m_completed = 0;
+
+    if (!m_timeline) return VK_SUCCESS;
+
+    VkSemaphoreTypeCreateInfo type{};
+    type.sType         = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    type.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    type.initialValue  = 0;
+
+    VkSemaphoreCreateInfo si{};
+    si.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    si.pNext = &type;
+    return vkCreateSemaphore(device, &si, nullptr, &m_semaphore);
+}
+
+void GpuTimeline::destroy() {
+    if (!m_device) return;
+    if (m_semaphore) vkDestroySemaphore(m_device, m_semaphore, nullptr);
+    for (const PendingFence& p : m_pending) vkDestroyFence(m_device, p.fence, nullptr);
+    for (VkFence f : m_free_fences)         vkDestroyFence(m_device, f, nullptr);
+    m_semaphore = VK_NULL_HANDLE;
+    m_pending.clear();
+    m_free_fences.clear();
+    m_device = VK_NULL_HANDLE;
+}
+
+VkResult GpuTimeline::submit(VkQueue queue, const VkSubmitInfo& submit, uint64_t& out_value) {
+    DEBUG_ASSERT(m_device && "GpuTimeline::create not called");
+    const uint64_t value = m_submitted + 1;
+
+    VkResult r = m_timeline ? VK_SUCCESS : fence_submit_(queue, submit, value);
+    if (m_timeline) {
+        // a submit takes one VkTimelineSemaphoreSubmitInfo: if the caller
+        // chained one (waits on another timeline, timeline signals), its
+        // values go into ours and ours takes its place in the chain
+        const VkBaseInStructure*             prev   = nullptr;
+        const VkTimelineSemaphoreSubmitInfo* theirs = nullptr;
+        for (auto* s = static_cast<const VkBaseInStructure*>(submit.pNext); s; prev = s, s = s->pNext)
+            if (s->sType == VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO) {
+                theirs = reinterpret_cast<const VkTimelineSemaphoreSubmitInfo*>(s);
+                break;
+            }
+
+        // append our semaphore to the caller's signals (binary ones get a dummy value)
+        m_signal.assign(submit.pSignalSemaphores, submit.pSignalSemaphores + submit.signalSemaphoreCount);
+        m_signal_values.assign(submit.signalSemaphoreCount, 0);
+        if (theirs && theirs->pSignalSemaphoreValues) {
+            const uint32_t n = std::min(theirs->signalSemaphoreValueCount, submit.signalSemaphoreCount);
+            std::copy(theirs->pSignalSemaphoreValues, theirs->pSignalSemaphoreValues + n, m_signal_values.begin());
+        }
+        m_signal.push_back(m_semaphore);
+        m_signal_values.push_back(value);
+
+        VkTimelineSemaphoreSubmitInfo ts{};
+        ts.sType                     = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        ts.pNext                     = theirs && !prev ? theirs->pNext : submit.pNext;
+        ts.waitSemaphoreValueCount   = theirs ? theirs->waitSemaphoreValueCount : 0;
+        ts.pWaitSemaphoreValues      = theirs ? theirs->pWaitSemaphoreValues : nullptr;
+        ts.signalSemaphoreValueCount = static_cast<uint32_t>(m_signal_values.size());
+        ts.pSignalSemaphoreValues    = m_signal_values.data();
+
+        VkSubmitInfo si         = submit;
+        si.pNext                = &ts;
+        si.signalSemaphoreCount = static_cast<uint32_t>(m_signal.size());
+        si.pSignalSemaphores    = m_signal.data();
+
+        // deeper in the chain: unlink theirs for the call, then put it back
+        VkBaseInStructure* link = theirs && prev ? const_cast<VkBaseInStructure*>(prev) : nullptr;
+        if (link) link->pNext = theirs->pNext;
+        r = vkQueueSubmit(queue, 1, &si, VK_NULL_HANDLE);
+        if (link) link->pNext = reinterpret_cast<const VkBaseInStructure*>(theirs);
+    }
+    if (r) return r;
+
+    m_submitted = value;
+    out_value   = value;
+    return VK_SUCCESS;
+}
+
+VkResult GpuTimeline::fence_submit_(VkQueue queue, const VkSubmitInfo& submit, uint64_t value) {
+    VkFence fence = VK_NULL_HANDLE;
+    if (!m_free_fences.empty()) {
+        fence = m_free_fences.back();
+        m_free_fences.pop_back();
+    } else {
+        VkFenceCreateInfo fi{};
+        fi.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        if (auto e = vkCreateFence(m_device, &fi, nullptr, &fence)) return e;
+    }
+
+    VkResult r = vkQueueSubmit(queue, 1, &submit, fence);
+    if (r) { m_free_fences.push_back(fence); return r; }
+    m_pending.push_back({ value, fence });
+    return VK_SUCCESS;
+}
+
+void GpuTimeline::poll() {
+    if (m_timeline) {
+        uint64_t v = 0;
+        if (g_vulkan.get_semaphore_counter_value(m_device, m_semaphore, &v) == VK_SUCCESS && v > m_completed)
+            m_completed = v;
+        return;
+    }
+
+    // retire in submission order; a later fence signalling first doesn't help
+    // until everything before it is done too
+    while (!m_pending.empty() && vkGetFenceStatus(m_device, m_pending.front().fence) == VK_SUCCESS) {
+        const PendingFence p = m_pending.front();
+        m_pending.pop_front();
+        vkResetFences(m_device, 1, &p.fence);
+        m_free_fences.push_back(p.fence);
+        m_completed = p.value;
+    }
+}
+
+VkResult GpuTimeline::wait(uint64_t value, uint64_t timeout_ns) {
+    if (completed(value)) return VK_SUCCESS;
+    DEBUG_ASSERT(value <= m_submitted && "waiting on a value that was never submitted");
+
+    if (m_timeline) {
+        VkSemaphoreWaitInfo wi{};
+        wi.sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        wi.semaphoreCount = 1;
+        wi.pSemaphores    = &m_semaphore;
+        wi.pValues        = &value;
+        VkResult r = g_vulkan.wait_semaphores(m_device, &wi, timeout_ns);
+        if (r == VK_SUCCESS) m_completed = std::max(m_completed, value);
+        return r;
+    }
+
+    // wait on the first pending fence tagged >= value
+    for (const PendingFence& p : m_pending) {
+        if (p.value < value) continue;
+        VkResult r = vkWaitForFences(m_device, 1, &p.fence, VK_TRUE, timeout_ns);
+        if (r) return r;
+        break;
+    }
+    poll();
+    return completed(value) ? VK_SUCCESS : VK_TIMEOUT;
+}
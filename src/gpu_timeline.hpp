@@ -0,0 +1,72 @@
+#ifndef GPU_TIMELINE_HPP
+#define GPU_TIMELINE_HPP
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "platform.hpp"
+
+// Monotonic GPU progress counter. Every submit() through the timeline gets the
+// next value; anything holding GPU-visible memory remembers the value of the
+// submission that last used it and later asks completed(value), which never
+// blocks. One timeline semaphore replaces a fence per submission.
+//
+// Without g_vulkan.timeline_semaphore the same API runs on a recycled pool of
+// binary fences (one per submission, polled in submission order).
+class GpuTimeline {
+public:
+    VkResult create(VkDevice device);
+    void     destroy();
+
+    // Submits 'submit' (its own wait/signal semaphores are kept, and so are
+    // the values of a VkTimelineSemaphoreSubmitInfo in its pNext chain) and
+    // signals the returned value when it completes. Submissions must go through the
+    // timeline in the order their values should complete on one queue.
+    VkResult submit(VkQueue queue, const VkSubmitInfo& submit, uint64_t& out_value);
+
+    // Non-blocking: has the GPU finished the submission tagged 'value'?
+    bool completed(uint64_t value) {
+        if (value <= m_completed) return true;
+        poll();
+        return value <= m_completed;
+    }
+
+    // Blocks until 'value' completed (or timeout). VK_TIMEOUT on timeout.
+    VkResult wait(uint64_t value, uint64_t timeout_ns = UINT64_MAX);
+    VkResult wait_idle() { return wait(m_submitted); }
+
+    // Refreshes completed_value() from the device.
+    void poll();
+
+    uint64_t submitted_value() const { return m_submitted; }  // last handed out
+    uint64_t next_value()      const { return m_submitted + 1; } // what the next submit() gets
+    uint64_t completed_value() const { return m_completed; }  // as of the last poll
+
+    // Raw semaphore for callers that build their own submits (timeline path only).
+    VkSemaphore semaphore() const { return m_semaphore; }
+
+private:
+    struct PendingFence {
+        uint64_t value;
+        VkFence  fence;
+    };
+
+    VkResult fence_submit_(VkQueue queue, const VkSubmitInfo& submit, uint64_t value);
+
+    VkDevice                 m_device    = VK_NULL_HANDLE;
+    bool                     m_timeline  = false;
+    VkSemaphore              m_semaphore = VK_NULL_HANDLE;
+    uint64_t                 m_submitted = 0;
+    uint64_t                 m_completed = 0;
+
+    // fence fallback
+    std::deque<PendingFence> m_pending;   // submission order
+    std::vector<VkFence>     m_free_fences;
+
+    // scratch for building the merged submit
+    std::vector<VkSemaphore> m_signal;
+    std::vector<uint64_t>    m_signal_values;
+};
+
+#endif // GPU_TIMELINE_HPP
@@ -0,0 +1,429 @@
+#include "hpa.hpp"
+#include <algorithm>
+#include <queue>
+
+namespace {
+
+struct Rect { uint32_t x0, y0, x1, y1; };   // [x0, x1) x [y0, y1)
+
+inline bool blocked(const CostField& c, uint32_t x, uint32_t y) { return c.at(x, y) == CostField::kBlocked; }
+
+inline uint32_t step_cost(const CostField& c, uint32_t a, uint32_t b, bool diag) {
+    return (uint32_t(c.cost[a]) + c.cost[b]) * (diag ? 7u : 5u);
+}
+
+// Octile distance at the cheapest ground: never overestimates.
+inline uint32_t heuristic(uint32_t W, uint32_t a, uint32_t b) {
+    const uint32_t ax = a % W, ay = a / W, bx = b % W, by = b / W;
+    const uint32_t dx = ax > bx ? ax - bx : bx - ax, dy = ay > by ? ay - by : by - ay;
+    return 10 * std::max(dx, dy) + 4 * std::min(dx, dy);
+}
+
+// A* from start confined to r. With goal == kNoPath it runs to exhaustion
+// (Dijkstra) and leaves every reached tile's cost in dist. Indices into dist
+// and parent are local: (y - r.y0) * width(r) + (x - r.x0).
+uint32_t search_rect(const CostField& c, Rect r, uint32_t start, uint32_t goal,
+                     std::vector<uint32_t>& dist, std::vector<uint32_t>* parent) {
+    const uint32_t W = c.width, rw = r.x1 - r.x0, rh = r.y1 - r.y0;
+    auto local = [&](uint32_t cell) { return (cell / W - r.y0) * rw + (cell % W - r.x0); };
+    auto cell  = [&](uint32_t l)    { return (r.y0 + l / rw) * W + r.x0 + l % rw; };
+
+    dist.assign(size_t(rw) * rh, hpa::kNoPath);
+    if (parent) parent->assign(size_t(rw) * rh, hpa::kNoPath);
+
+    using Item = std::pair<uint32_t, uint32_t>;   // f, local index
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> open;
+    const uint32_t ls = local(start);
+    dist[ls] = 0;
+    open.push({ goal == hpa::kNoPath ? 0 : heuristic(W, start, goal), ls });
+
+    while (!open.empty()) {
+        const auto [f, l] = open.top();
+        open.pop();
+        const uint32_t here = cell(l);
+        const uint32_t g    = dist[l];
+        if (goal != hpa::kNoPath) {
+            if (here == goal) return g;
+            if (f != g + heuristic(W, here, goal)) continue;   // stale entry
+        } else if (f != g) {
+            continue;
+        }
+
+        const int x = int(here % W), y = int(here / W);
+        for (int n = 0; n < 8; ++n) {
+            const int nx = x + kFlowDx[n], ny = y + kFlowDy[n];
+            if (nx < int(r.x0) || ny < int(r.y0) || nx >= int(r.x1) || ny >= int(r.y1)) continue;
+            if (blocked(c, uint32_t(nx), uint32_t(ny))) continue;
+            const bool diag = (n & 1) != 0;
+            if (diag && (blocked(c, uint32_t(nx), uint32_t(y)) || blocked(c, uint32_t(x), uint32_t(ny)))) continue;
+
+            const uint32_t next = uint32_t(ny) * W + uint32_t(nx);
+            const uint32_t ng   = g + step_cost(c, here, next, diag);
+            const uint32_t ln   = local(next);
+            if (ng >= dist[ln]) continue;
+            dist[ln] = ng;
+            if (parent) (*parent)[ln] = l;
+            open.push({ goal == hpa::kNoPath ? ng : ng + heuristic(W, next, goal), ln });
+        }
+    }
+    return goal == hpa::kNoPath ? 0 : hpa::kNoPath;
+}
+
+// Path-finding A* in r; appends the tiles after 'start' up to and including
+// 'goal' to path. Returns the cost.
+uint32_t refine(const CostField& c, Rect r, uint32_t start, uint32_t goal, std::vector<uint32_t>& path) {
+    std::vector<uint32_t> dist, parent;
+    const uint32_t cost = search_rect(c, r, start, goal, dist, &parent);
+    if (cost == hpa::kNoPath) return cost;
+
+    const uint32_t W = c.width, rw = r.x1 - r.x0;
+    const size_t first = path.size();
+    for (uint32_t l = (goal / W - r.y0) * rw + (goal % W - r.x0); ; l = parent[l]) {
+        const uint32_t cell = (r.y0 + l / rw) * W + r.x0 + l % rw;
+        if (cell == start) break;
+        path.push_back(cell);
+    }
+    std::reverse(path.begin() + first, path.end());
+    return cost;
+}
+
+} // namespace
+
+namespace hpa {
+
+uint32_t find_path_grid(const CostField& costs, uint32_t start, uint32_t goal, std::vector<uint32_t>& path) {
+    path.clear();
+    const uint32_t n = costs.width * costs.height;
+    if (start >= n || goal >= n || costs.cost[start] == CostField::kBlocked || costs.cost[goal] == CostField::kBlocked)
+        return kNoPath;
+    path.push_back(start);
+    const uint32_t cost = refine(costs, Rect{ 0, 0, costs.width, costs.height }, start, goal, path);
+    if (cost == kNoPath) path.clear();
+    return cost;
+}
+
+uint32_t path_cost(const CostField& costs, const std::vector<uint32_t>& path) {
+    const uint32_t W = costs.width;
+    uint32_t total = 0;
+    for (size_t i = 0; i < path.size(); ++i) {
+        if (path[i] >= W * costs.height || costs.cost[path[i]] == CostField::kBlocked) return kNoPath;
+        if (i == 0) continue;
+        const int x0 = int(path[i - 1] % W), y0 = int(path[i - 1] / W);
+        const int x1 = int(path[i] % W),     y1 = int(path[i] / W);
+        const int dx = x1 - x0, dy = y1 - y0;
+        if ((dx == 0 && dy == 0) || dx < -1 || dx > 1 || dy < -1 || dy > 1) return kNoPath;
+        const bool diag = dx != 0 && dy != 0;
+        if (diag && (blocked(costs, uint32_t(x1), uint32_t(y0)) || blocked(costs, uint32_t(x0), uint32_t(y1)))) return kNoPath;
+        total += step_cost(costs, path[i - 1], path[i], diag);
+    }
+    return total;
+}
+
+} // namespace hpa
+
+// -----------------------------
+// abstract graph
+// -----------------------------
+
+uint32_t HpaPathfinder::sector_of_(uint32_t cell) const {
+    const uint32_t W = m_costs->width;
+    return (cell / W / m_s) * m_sx + (cell % W) / m_s;
+}
+
+void HpaPathfinder::sector_borders_(uint32_t sector, uint32_t out[4]) const {
+    const uint32_t i = sector % m_sx, j = sector / m_sx;
+    const uint32_t vertical = (m_sx - 1) * m_sy;
+    out[0] = i > 0        ? j * (m_sx - 1) + (i - 1)      : UINT32_MAX;   // left
+    out[1] = i + 1 < m_sx ? j * (m_sx - 1) + i            : UINT32_MAX;   // right
+    out[2] = j > 0        ? vertical + (j - 1) * m_sx + i : UINT32_MAX;   // top
+    out[3] = j + 1 < m_sy ? vertical + j * m_sx + i       : UINT32_MAX;   // bottom
+}
+
+// Maximal open stretches along the border: short ones get a transition in
+// the middle, long ones one at each end and one in the middle.
+void HpaPathfinder::build_border_(uint32_t border) {
+    const CostField& c = *m_costs;
+    const uint32_t W = c.width, H = c.height;
+    const uint32_t vertical = (m_sx - 1) * m_sy;
+
+    uint32_t len, ax, ay;   // first 'a' tile, walked along the border
+    bool along_y;
+    if (border < vertical) {
+        const uint32_t i = border % (m_sx - 1), j = border / (m_sx - 1);
+        ax = (i + 1) * m_s - 1; ay = j * m_s;
+        len = std::min(H, ay + m_s) - ay;
+        along_y = true;
+    } else {
+        const uint32_t b = border - vertical, i = b % m_sx, j = b / m_sx;
+        ax = i * m_s; ay = (j + 1) * m_s - 1;
+        len = std::min(W, ax + m_s) - ax;
+        along_y = false;
+    }
+
+    auto tile_a = [&](uint32_t k) { return along_y ? (ay + k) * W + ax : ay * W + ax + k; };
+    auto tile_b = [&](uint32_t k) { return along_y ? (ay + k) * W + ax + 1 : (ay + 1) * W + ax + k; };
+    auto open   = [&](uint32_t k) {
+        return c.cost[tile_a(k)] != CostField::kBlocked && c.cost[tile_b(k)] != CostField::kBlocked;
+    };
+
+    std::vector<Transition>& out = m_borders[border];
+    out.clear();
+    for (uint32_t k = 0; k < len; ) {
+        if (!open(k)) { ++k; continue; }
+        uint32_t end = k;
+        while (end < len && open(end)) ++end;
+        if (end - k < 6) {
+            const uint32_t mid = k + (end - k) / 2;
+            out.push_back({ tile_a(mid), tile_b(mid) });
+        } else {
+            const uint32_t mid = k + (end - k) / 2;
+            out.push_back({ tile_a(k),       tile_b(k) });
+            out.push_back({ tile_a(mid),     tile_b(mid) });
+            out.push_back({ tile_a(end - 1), tile_b(end - 1) });
+        }
+        k = end;
+    }
+}
+
+void HpaPathfinder::build_nodes_(uint32_t sector) {
+    Sector& s = m_sectors[sector];
+    uint32_t borders[4];
+    sector_borders_(sector, borders);
+
+    s.cells.clear();
+    for (int side = 0; side < 4; ++side) {
+        if (borders[side] == UINT32_MAX) continue;
+        const bool mine_is_a = side == 1 || side == 3;   // right / bottom: this sector is the left / top one
+        for (const Transition& t : m_borders[borders[side]]) s.cells.push_back(mine_is_a ? t.a : t.b);
+    }
+    std::sort(s.cells.begin(), s.cells.end());
+    s.cells.erase(std::unique(s.cells.begin(), s.cells.end()), s.cells.end());
+
+    // in-sector costs between every pair of nodes, one Dijkstra per node
+    const uint32_t n = uint32_t(s.cells.size());
+    const uint32_t W = m_costs->width, rw = s.x1 - s.x0;
+    s.intra.assign(size_t(n) * n, hpa::kNoPath);
+    std::vector<uint32_t> dist;
+    for (uint32_t a = 0; a < n; ++a) {
+        search_rect(*m_costs, Rect{ s.x0, s.y0, s.x1, s.y1 }, s.cells[a], hpa::kNoPath, dist, nullptr);
+        for (uint32_t b = 0; b < n; ++b)
+            s.intra[size_t(a) * n + b] = dist[(s.cells[b] / W - s.y0) * rw + (s.cells[b] % W - s.x0)];
+    }
+}
+
+void HpaPathfinder::build_links_(uint32_t sector) {
+    Sector& s = m_sectors[sector];
+    uint32_t borders[4];
+    sector_borders_(sector, borders);
+    auto index_in = [](const Sector& t, uint32_t cell) {
+        return uint32_t(std::lower_bound(t.cells.begin(), t.cells.end(), cell) - t.cells.begin());
+    };
+
+    s.links.assign(s.cells.size(), {});
+    for (int side = 0; side < 4; ++side) {
+        if (borders[side] == UINT32_MAX) continue;
+        const bool mine_is_a = side == 1 || side == 3;
+        for (const Transition& t : m_borders[borders[side]]) {
+            const uint32_t mine  = mine_is_a ? t.a : t.b;
+            const uint32_t other = mine_is_a ? t.b : t.a;
+            const uint32_t os    = sector_of_(other);
+            s.links[index_in(s, mine)].push_back(
+                Link{ os, index_in(m_sectors[os], other), step_cost(*m_costs, mine, other, false) });
+        }
+    }
+}
+
+void HpaPathfinder::renumber_() {
+    m_node_base.resize(m_sectors.size());
+    m_node_total = 0;
+    for (size_t s = 0; s < m_sectors.size(); ++s) {
+        m_node_base[s] = m_node_total;
+        m_node_total += uint32_t(m_sectors[s].cells.size());
+    }
+    m_node_sector.resize(m_node_total);
+    for (size_t s = 0; s < m_sectors.size(); ++s)
+        std::fill_n(m_node_sector.begin() + m_node_base[s], m_sectors[s].cells.size(), uint32_t(s));
+}
+
+void HpaPathfinder::build(const CostField& costs, uint32_t sector_size) {
+    wait();
+    m_costs = &costs;
+    m_s  = std::max(4u, sector_size);
+    m_sx = (costs.width  + m_s - 1) / m_s;
+    m_sy = (costs.height + m_s - 1) / m_s;
+
+    m_sectors.assign(size_t(m_sx) * m_sy, {});
+    for (uint32_t j = 0; j < m_sy; ++j)
+        for (uint32_t i = 0; i < m_sx; ++i)
+            m_sectors[size_t(j) * m_sx + i] = Sector{ i * m_s, j * m_s,
+                std::min(costs.width, (i + 1) * m_s), std::min(costs.height, (j + 1) * m_s), {}, {}, {} };
+
+    m_borders.assign(size_t(m_sx - 1) * m_sy + size_t(m_sx) * (m_sy - 1), {});
+    for (uint32_t b = 0; b < m_borders.size(); ++b) build_border_(b);
+
+    // sectors are independent once the borders are in
+    g_jobs.parallel_for(uint32_t(m_sectors.size()), 8, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t s = begin; s < end; ++s) build_nodes_(s);
+    });
+    for (uint32_t s = 0; s < m_sectors.size(); ++s) build_links_(s);
+    renumber_();
+}
+
+void HpaPathfinder::repair(uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1) {
+    wait();
+    const uint32_t W = m_costs->width, H = m_costs->height;
+    // one tile of margin: an edit on a sector's edge changes the neighbour's border too
+    const uint32_t sx0 = (x0 > 0 ? x0 - 1 : 0) / m_s, sx1 = std::min(W - 1, x1 + 1) / m_s;
+    const uint32_t sy0 = (y0 > 0 ? y0 - 1 : 0) / m_s, sy1 = std::min(H - 1, y1 + 1) / m_s;
+
+    std::vector<uint8_t> dirty(m_sectors.size(), 0), affected(m_sectors.size(), 0), relink(m_sectors.size(), 0);
+    uint32_t borders[4];
+    for (uint32_t j = sy0; j <= sy1; ++j)
+        for (uint32_t i = sx0; i <= sx1; ++i) dirty[size_t(j) * m_sx + i] = 1;
+
+    std::vector<uint8_t> border_done(m_borders.size(), 0);
+    auto mark_around = [&](std::vector<uint8_t>& v, uint32_t s) {
+        v[s] = 1;
+        const uint32_t i = s % m_sx, j = s / m_sx;
+        if (i > 0)        v[s - 1]    = 1;
+        if (i + 1 < m_sx) v[s + 1]    = 1;
+        if (j > 0)        v[s - m_sx] = 1;
+        if (j + 1 < m_sy) v[s + m_sx] = 1;
+    };
+    for (uint32_t s = 0; s < m_sectors.size(); ++s) {
+        if (!dirty[s]) continue;
+        sector_borders_(s, borders);
+        for (uint32_t b : borders)
+            if (b != UINT32_MAX && !border_done[b]) { build_border_(b); border_done[b] = 1; }
+        mark_around(affected, s);   // their node sets may have changed
+    }
+    for (uint32_t s = 0; s < m_sectors.size(); ++s)
+        if (affected[s]) { build_nodes_(s); mark_around(relink, s); }   // neighbours' links index into s
+    for (uint32_t s = 0; s < m_sectors.size(); ++s)
+        if (relink[s]) build_links_(s);
+    renumber_();
+}
+
+// -----------------------------
+// queries
+// -----------------------------
+
+uint32_t HpaPathfinder::find_path(uint32_t start, uint32_t goal, std::vector<uint32_t>& path) const {
+    path.clear();
+    const CostField& c = *m_costs;
+    const uint32_t W = c.width, N = c.width * c.height;
+    if (start >= N || goal >= N || c.cost[start] == CostField::kBlocked || c.cost[goal] == CostField::kBlocked)
+        return hpa::kNoPath;
+    if (start == goal) { path.push_back(start); return 0; }
+
+    const uint32_t ss = sector_of_(start), gs = sector_of_(goal);
+    const Sector&  S  = m_sectors[ss];
+    const Sector&  G  = m_sectors[gs];
+    auto rect_of = [](const Sector& s) { return Rect{ s.x0, s.y0, s.x1, s.y1 }; };
+    auto local   = [&](const Sector& s, uint32_t cell) { return (cell / W - s.y0) * (s.x1 - s.x0) + (cell % W - s.x0); };
+
+    // hook start and goal into their sectors' nodes
+    std::vector<uint32_t> from_start, to_goal;
+    search_rect(c, rect_of(S), start, hpa::kNoPath, from_start, nullptr);
+    search_rect(c, rect_of(G), goal,  hpa::kNoPath, to_goal,    nullptr);   // symmetric edges
+
+    // abstract A*: global node ids, then the two virtual ends
+    const uint32_t kStart = m_node_total, kGoal = m_node_total + 1;
+    std::vector<uint32_t> g(m_node_total + 2, hpa::kNoPath), parent(m_node_total + 2, hpa::kNoPath);
+    using Item = std::pair<uint32_t, uint32_t>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> open;
+    auto node_cell = [&](uint32_t id) {
+        return id == kStart ? start : id == kGoal ? goal
+                            : m_sectors[m_node_sector[id]].cells[id - m_node_base[m_node_sector[id]]];
+    };
+    auto relax = [&](uint32_t from, uint32_t to, uint32_t cost) {
+        if (cost == hpa::kNoPath || g[from] + cost >= g[to]) return;
+        g[to] = g[from] + cost;
+        parent[to] = from;
+        open.push({ g[to] + heuristic(W, node_cell(to), goal), to });
+    };
+
+    g[kStart] = 0;
+    for (uint32_t i = 0; i < S.cells.size(); ++i) relax(kStart, m_node_base[ss] + i, from_start[local(S, S.cells[i])]);
+    // Goals in the same or a neighbouring sector also get a direct search
+    // over both sectors: the transitions alone make short trips zigzag.
+    const Rect near{ std::min(S.x0, G.x0), std::min(S.y0, G.y0), std::max(S.x1, G.x1), std::max(S.y1, G.y1) };
+    const bool is_near = near.x1 - near.x0 <= 2 * m_s && near.y1 - near.y0 <= 2 * m_s;
+    if (is_near) {
+        std::vector<uint32_t> dist;
+        relax(kStart, kGoal, search_rect(c, near, start, goal, dist, nullptr));
+    }
+
+    while (!open.empty()) {
+        const auto [f, u] = open.top();
+        open.pop();
+        if (u == kGoal) break;
+        if (f != g[u] + heuristic(W, node_cell(u), goal)) continue;
+
+        const uint32_t sec = m_node_sector[u], i = u - m_node_base[sec];
+        const Sector&  s   = m_sectors[sec];
+        const uint32_t n   = uint32_t(s.cells.size());
+        if (sec == gs) relax(u, kGoal, to_goal[local(G, s.cells[i])]);
+        for (uint32_t j = 0; j < n; ++j)
+            if (j != i) relax(u, m_node_base[sec] + j, s.intra[size_t(i) * n + j]);
+        for (const Link& l : s.links[i]) relax(u, m_node_base[l.sector] + l.node, l.cost);
+    }
+    if (g[kGoal] == hpa::kNoPath) return hpa::kNoPath;
+
+    // refine each abstract hop into tiles
+    std::vector<uint32_t> chain;
+    for (uint32_t id = kGoal; id != hpa::kNoPath; id = parent[id]) chain.push_back(id);
+    std::reverse(chain.begin(), chain.end());
+
+    path.push_back(start);
+    for (size_t k = 1; k < chain.size(); ++k) {
+        const uint32_t a = chain[k - 1], b = chain[k];
+        const uint32_t ca = node_cell(a), cb = node_cell(b);
+        if (ca == cb) continue;
+        if (a != kStart && b != kGoal && m_node_sector[a] != m_node_sector[b]) {
+            path.push_back(cb);   // a link: the facing tile
+            continue;
+        }
+        if (a == kStart && b == kGoal) refine(c, near, ca, cb, path);
+        else refine(c, rect_of(m_sectors[a == kStart ? ss : m_node_sector[a]]), ca, cb, path);
+    }
+    return g[kGoal];
+}
+
+uint32_t HpaPathfinder::request(uint32_t start, uint32_t goal) {
+    std::lock_guard lock(m_requests_mutex);
+    const uint32_t ticket = m_next_ticket++;
+    auto r = std::make_unique<Request>();
+    r->start = start;
+    r->goal  = goal;
+    m_queued.push_back(r.get());
+    m_requests.emplace(ticket, std::move(r));
+    return ticket;
+}
+
+void HpaPathfinder::dispatch() {
+    std::vector<Request*> batch;
+    {
+        std::lock_guard lock(m_requests_mutex);
+        batch.swap(m_queued);
+    }
+    constexpr size_t kPerJob = 16;
+    for (size_t first = 0; first < batch.size(); first += kPerJob) {
+        std::vector<Request*> slice(batch.begin() + first, batch.begin() + std::min(batch.size(), first + kPerJob));
+        g_jobs.run([this, slice = std::move(slice)] {
+            for (Request* r : slice) {
+                find_path(r->start, r->goal, r->path);
+                r->done.store(true, std::memory_order_release);
+            }
+        }, &m_batch);
+    }
+}
+
+bool HpaPathfinder::poll(uint32_t ticket, std::vector<uint32_t>& path) {
+    std::lock_guard lock(m_requests_mutex);
+    auto it = m_requests.find(ticket);
+    if (it == m_requests.end() || !it->second->done.load(std::memory_order_acquire)) return false;
+    path = std::move(it->second->path);
+    m_requests.erase(it);
+    return true;
+}
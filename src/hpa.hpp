@@ -0,0 +1,113 @@
+#ifndef HPA_HPP
+#define HPA_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "flow_field.hpp"   // CostField
+#include "jobs.hpp"
+
+// Hierarchical A* (HPA*) for single-unit orders on the tile grid, where a
+// flow field per destination would be wasted. The map is cut into square
+// sectors; wherever two neighbouring sectors share an open stretch of border,
+// up to three transitions (a pair of facing tiles) become abstract nodes. Each
+// sector stores the in-sector path cost between every pair of its nodes, so a
+// query is a small A* over that graph (start and goal hooked in by a search
+// inside their own sectors), then each abstract hop is refined with an A*
+// confined to one sector.
+//
+// Steps cost (a + b) * 5 straight and (a + b) * 7 diagonally for tiles of
+// cost a and b (10 / 14 on cost-1 ground); that keeps every edge symmetric.
+// Diagonals never cut the corner of a blocked tile. Paths are tile indices
+// (y * width + x), start and goal included. Pure CPU.
+
+namespace hpa {
+
+constexpr uint32_t kNoPath = UINT32_MAX;
+
+// Plain A* over the whole grid: the optimal reference and the fallback for
+// tiny maps. Returns the path cost, kNoPath if there's none.
+uint32_t find_path_grid(const CostField& costs, uint32_t start, uint32_t goal, std::vector<uint32_t>& path);
+
+// Cost of walking 'path' under the rules above (kNoPath if a step is illegal).
+uint32_t path_cost(const CostField& costs, const std::vector<uint32_t>& path);
+
+} // namespace hpa
+
+class HpaPathfinder {
+public:
+    ~HpaPathfinder() { wait(); }
+
+    // Keeps a pointer to 'costs': edit it, then call repair() on what changed.
+    void build(const CostField& costs, uint32_t sector_size = 16);
+
+    // Re-derives transitions and sector edges around the changed tiles
+    // [x0, x1] x [y0, y1] (a building placed or destroyed). Waits for an
+    // in-flight batch first; no find_path() may run meanwhile.
+    void repair(uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1);
+
+    // One query on the calling thread. Returns the path cost, hpa::kNoPath if
+    // the goal can't be reached.
+    uint32_t find_path(uint32_t start, uint32_t goal, std::vector<uint32_t>& path) const;
+
+    // Batched, asynchronous queries: request() queues, dispatch() answers the
+    // queued batch on g_jobs, poll() hands a result over once it's there
+    // (an empty path when there is none).
+    uint32_t request(uint32_t start, uint32_t goal);   // ticket
+    void     dispatch();
+    bool     poll(uint32_t ticket, std::vector<uint32_t>& path);
+    void     wait() { g_jobs.wait(m_batch); }
+
+    uint32_t sector_size()  const { return m_s; }
+    uint32_t sector_count() const { return uint32_t(m_sectors.size()); }
+    uint32_t node_count()   const { return m_node_total; }
+
+private:
+    struct Link {
+        uint32_t sector, node, cost;   // the facing node in the neighbouring sector
+    };
+    struct Sector {
+        uint32_t x0, y0, x1, y1;                 // tile bounds, [x0, x1)
+        std::vector<uint32_t>          cells;    // node tiles
+        std::vector<uint32_t>          intra;    // cells.size()^2 in-sector costs (hpa::kNoPath if cut off)
+        std::vector<std::vector<Link>> links;    // per node
+    };
+    struct Transition {
+        uint32_t a, b;   // facing tiles: a in the left/top sector, b in the right/bottom one
+    };
+    struct Request {
+        uint32_t              start, goal;
+        std::vector<uint32_t> path;
+        std::atomic<bool>     done{false};
+    };
+
+    uint32_t sector_of_(uint32_t cell) const;
+    void     sector_borders_(uint32_t sector, uint32_t out[4]) const;   // UINT32_MAX where there's none
+    void     build_border_(uint32_t border);
+    void     build_nodes_(uint32_t sector);
+    void     build_links_(uint32_t sector);
+    void     renumber_();
+
+    const CostField* m_costs = nullptr;
+    uint32_t m_s = 16, m_sx = 0, m_sy = 0;
+    std::vector<Sector>                  m_sectors;
+    // borders: (m_sx-1)*m_sy vertical ones (between x and x+1), then m_sx*(m_sy-1) horizontal
+    std::vector<std::vector<Transition>> m_borders;
+    std::vector<uint32_t>                m_node_base;   // first global node id per sector
+    std::vector<uint32_t>                m_node_sector; // sector per global node id
+    uint32_t                             m_node_total = 0;
+
+    // Requests live in their own allocation so jobs can fill them while new
+    // ones are added.
+    std::mutex                                             m_requests_mutex;
+    std::unordered_map<uint32_t, std::unique_ptr<Request>> m_requests;   // by ticket
+    std::vector<Request*>                                  m_queued;     // waiting for dispatch()
+    uint32_t                                               m_next_ticket = 0;
+    JobCounter                                             m_batch;
+};
+
+#endif // HPA_HPP
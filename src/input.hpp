@@ -0,0 +1,29 @@
+#ifndef INPUT_HPP
+#define INPUT_HPP
+
+// Mouse state for the frame, filled by platform_should_quit() from the SDL
+// event pump. Positions are swapchain pixels, origin top-left (the Camera's
+// screen space), so they can go straight into picking. The held flags and
+// position persist; the edges, motion and wheel cover the last poll only.
+// Pure CPU: selection and camera code take it without pulling in SDL.
+struct MouseInput {
+    float x = 0.f, y = 0.f;
+    float dx = 0.f, dy = 0.f;        // motion since the last poll
+
+    bool left = false, right = false, middle = false;   // held
+    bool left_pressed  = false, left_released  = false;
+    bool right_pressed = false, right_released = false;
+
+    // where the left button last went down (a press and release can both
+    // land in one poll, so the current position isn't enough for a drag)
+    float press_x = 0.f, press_y = 0.f;
+
+    float wheel = 0.f;               // notches, + = away from the user
+
+    void begin_frame() {
+        dx = dy = wheel = 0.f;
+        left_pressed = left_released = right_pressed = right_released = false;
+    }
+};
+
+#endif // INPUT_HPP
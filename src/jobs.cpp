@@ -0,0 +1,162 @@
+#include "jobs.hpp"
+#include <algorithm>
+
+JobSystem g_jobs;
+
+namespace {
+thread_local const JobSystem* tl_system = nullptr;
+thread_local uint32_t         tl_index  = 0;
+}
+
+JobSystem::JobSystem() {
+    m_workers.emplace_back(std::make_unique<Worker>());   // the outside deque
+}
+
+void JobSystem::start(uint32_t workers) {
+    if (running()) return;
+    if (workers == 0) {
+        const uint32_t hw = std::thread::hardware_concurrency();
+        workers = hw > 1 ? hw - 1 : 1;
+    }
+
+    // worker deques first, the outside one (with anything queued before start) last
+    std::unique_ptr<Worker> outside = std::move(m_workers.back());
+    m_workers.clear();
+    for (uint32_t i = 0; i < workers; ++i) m_workers.emplace_back(std::make_unique<Worker>());
+    m_workers.push_back(std::move(outside));
+
+    m_stopping.store(false);
+    for (uint32_t i = 0; i < workers; ++i)
+        m_threads.emplace_back([this, i] { worker_main_(i); });
+}
+
+void JobSystem::stop() {
+    if (!running()) return;
+    m_stopping.store(true);
+    { std::lock_guard lock(m_sleep_mutex); }
+    m_wake.notify_all();
+    for (std::thread& t : m_threads) t.join();
+    m_threads.clear();
+
+    std::unique_ptr<Worker> outside = std::move(m_workers.back());
+    m_workers.clear();
+    m_workers.push_back(std::move(outside));
+    m_stopping.store(false);
+}
+
+void JobSystem::push_(Job job) {
+    const uint32_t n = static_cast<uint32_t>(m_workers.size());
+    const uint32_t target = tl_system == this ? tl_index : m_next.fetch_add(1, std::memory_order_relaxed) % n;
+    {
+        Worker& w = *m_workers[target];
+        std::lock_guard lock(w.mutex);
+        w.jobs.push_back(std::move(job));
+        m_queued.fetch_add(1, std::memory_order_release);
+    }
+    { std::lock_guard lock(m_sleep_mutex); }
+    m_wake.notify_one();
+}
+
+bool JobSystem::pop_or_steal_(uint32_t self, Job& out) {
+    const uint32_t n = static_cast<uint32_t>(m_workers.size());
+    {
+        Worker& w = *m_workers[self];
+        std::lock_guard lock(w.mutex);
+        if (!w.jobs.empty()) {
+            out = std::move(w.jobs.back());
+            w.jobs.pop_back();
+            m_queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    for (uint32_t k = 1; k < n; ++k) {
+        Worker& w = *m_workers[(self + k) % n];
+        std::lock_guard lock(w.mutex);
+        if (!w.jobs.empty()) {
+            out = std::move(w.jobs.front());   // oldest: likely the biggest piece of work
+            w.jobs.pop_front();
+            m_queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::execute_(Job& job) {
+    job.fn();
+    complete_(job.counter);
+}
+
+void JobSystem::complete_(JobCounter* counter) {
+    if (!counter) return;
+    uint32_t c = counter->m_count.load(std::memory_order_relaxed);
+    while (c > 1)
+        if (counter->m_count.compare_exchange_weak(c, c - 1, std::memory_order_acq_rel)) return;
+
+    // maybe the last one: drop to zero under the lock, so wait() (which takes
+    // it before returning) can't let the counter die while we're inside
+    std::vector<JobCounter::Deferred> ready;
+    {
+        std::lock_guard lock(counter->m_mutex);
+        if (counter->m_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            ready.swap(counter->m_waiting);
+    }
+    for (JobCounter::Deferred& d : ready) push_(Job{ std::move(d.fn), d.counter });
+}
+
+void JobSystem::worker_main_(uint32_t index) {
+    tl_system = this;
+    tl_index  = index;
+    for (;;) {
+        Job job;
+        if (pop_or_steal_(index, job)) { execute_(job); continue; }
+        if (m_stopping.load() && m_queued.load() == 0) break;
+
+        std::unique_lock lock(m_sleep_mutex);
+        m_wake.wait(lock, [this] { return m_queued.load() > 0 || m_stopping.load(); });
+    }
+    tl_system = nullptr;
+}
+
+void JobSystem::run(std::function<void()> fn, JobCounter* counter) {
+    if (counter) counter->m_count.fetch_add(1, std::memory_order_relaxed);
+    push_(Job{ std::move(fn), counter });
+}
+
+void JobSystem::run_after(JobCounter& dependency, std::function<void()> fn, JobCounter* counter) {
+    if (counter) counter->m_count.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard lock(dependency.m_mutex);
+        if (dependency.m_count.load(std::memory_order_acquire) != 0) {
+            dependency.m_waiting.push_back({ std::move(fn), counter });
+            return;
+        }
+    }
+    push_(Job{ std::move(fn), counter });
+}
+
+void JobSystem::wait(JobCounter& counter) {
+    const uint32_t self = tl_system == this ? tl_index : static_cast<uint32_t>(m_workers.size()) - 1;
+    while (!counter.done()) {
+        Job job;
+        if (pop_or_steal_(self, job)) execute_(job);
+        else                          std::this_thread::yield();
+    }
+    // the job that zeroed it may still hold the lock; after this it is done with it
+    std::lock_guard lock(counter.m_mutex);
+}
+
+void JobSystem::parallel_for(uint32_t count, uint32_t chunk,
+                             const std::function<void(uint32_t, uint32_t)>& body)
+{
+    if (count == 0) return;
+    if (chunk == 0) chunk = std::max(1u, count / (4 * (worker_count() + 1)));
+    if (chunk >= count) { body(0, count); return; }
+
+    JobCounter done;
+    for (uint32_t begin = 0; begin < count; begin += chunk) {
+        const uint32_t end = std::min(count, begin + chunk);
+        run([&body, begin, end] { body(begin, end); }, &done);
+    }
+    wait(done);
+}
@@ -0,0 +1,98 @@
+#ifndef JOBS_HPP
+#define JOBS_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem;
+
+// Counts outstanding jobs. run(fn, &counter) adds one and the job's
+// completion takes it away; JobSystem::wait(counter) helps run jobs until it
+// reaches zero, and run_after(counter, fn) starts fn only then. Reusable once
+// it is back at zero. Must outlive the jobs that reference it: finish with
+// wait() rather than polling done() before destroying it.
+class JobCounter {
+public:
+    uint32_t value() const { return m_count.load(std::memory_order_acquire); }
+    bool     done()  const { return value() == 0; }
+
+private:
+    friend class JobSystem;
+    struct Deferred {
+        std::function<void()> fn;
+        JobCounter*           counter;
+    };
+
+    std::atomic<uint32_t> m_count{0};
+    std::mutex            m_mutex;      // guards m_waiting
+    std::vector<Deferred> m_waiting;    // run_after() jobs parked until zero
+};
+
+// One pool of worker threads for everything in the core library: asset
+// builds, shader compiles, simulation systems. Each worker owns a deque: it
+// pushes and pops its own jobs at the back (LIFO, cache-warm) and steals from
+// the front of the others' when empty. Jobs submitted from outside the pool
+// are spread round-robin. Threads that wait() or parallel_for() run jobs too,
+// so with zero workers everything still completes on the caller.
+class JobSystem {
+public:
+    JobSystem();
+    ~JobSystem() { stop(); }
+
+    // workers = 0 picks hardware_concurrency - 1 (the main thread helps out).
+    void start(uint32_t workers = 0);
+    void stop();    // runs what's queued, then joins
+
+    uint32_t worker_count() const { return static_cast<uint32_t>(m_threads.size()); }
+    bool     running()      const { return !m_threads.empty(); }
+
+    void run(std::function<void()> fn, JobCounter* counter = nullptr);
+    // fn becomes runnable once 'dependency' reaches zero (immediately if it is).
+    void run_after(JobCounter& dependency, std::function<void()> fn, JobCounter* counter = nullptr);
+
+    // Runs other jobs until counter reaches zero.
+    void wait(JobCounter& counter);
+
+    // body(begin, end) over [0, count) in chunks of 'chunk' (0 = a few chunks
+    // per thread); blocks until done, the caller takes chunks as well.
+    void parallel_for(uint32_t count, uint32_t chunk,
+                      const std::function<void(uint32_t begin, uint32_t end)>& body);
+
+private:
+    struct Job {
+        std::function<void()> fn;
+        JobCounter*           counter;
+    };
+    struct Worker {
+        std::mutex      mutex;
+        std::deque<Job> jobs;
+    };
+
+    void push_(Job job);
+    bool pop_or_steal_(uint32_t self, Job& out);
+    void execute_(Job& job);
+    void complete_(JobCounter* counter);
+    void worker_main_(uint32_t index);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;   // one deque per worker (+1 for outside threads)
+    std::vector<std::thread>             m_threads;
+    std::atomic<uint32_t>                m_next{0};   // round-robin for outside submits
+    std::atomic<uint32_t>                m_queued{0};
+    std::atomic<bool>                    m_stopping{false};
+
+    std::mutex              m_sleep_mutex;
+    std::condition_variable m_wake;
+};
+
+// The shared pool. platform_init() starts it; pure CPU tools and tests may
+// start it themselves (or not: everything then runs on the waiting thread).
+extern JobSystem g_jobs;
+
+#endif // JOBS_HPP
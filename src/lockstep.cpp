@@ -0,0 +1,119 @@
+#include "lockstep.hpp"
+#include <algorithm>
+#include <tuple>
+
+namespace {
+
+// FNV-1a over 64-bit words instead of bytes, with a shift-xor so high input
+// bits reach the low output bits. Fed value by value (not struct bytes:
+// padding and endianness would differ between machines).
+struct StateHash {
+    uint64_t h = 14695981039346656037ull;
+    void add(uint64_t v) { h = (h ^ v) * 1099511628211ull; h ^= h >> 29; }
+    void add(uint32_t a, uint32_t b) { add(uint64_t(a) | uint64_t(b) << 32); }
+    void add(Fixed a, Fixed b)       { add(uint32_t(a.raw), uint32_t(b.raw)); }
+    void add(FxVec2 v)               { add(v.x, v.z); }
+    void add(Entity e)               { add(e.index, e.generation); }
+};
+
+bool later_tick(const SimCommand& a, const SimCommand& b) { return a.tick > b.tick; }
+
+auto command_key(const SimCommand& c) {
+    return std::tuple(c.player, c.seq, c.type, c.unit.index, c.unit.generation, c.x.raw, c.z.raw);
+}
+
+} // namespace
+
+bool LockstepSim::schedule(const SimCommand& cmd) {
+    if (cmd.tick < m_tick) return false;
+    m_pending.push_back(cmd);
+    std::push_heap(m_pending.begin(), m_pending.end(), later_tick);
+    return true;
+}
+
+void LockstepSim::step() {
+    m_due.clear();
+    while (!m_pending.empty() && m_pending.front().tick == m_tick) {
+        std::pop_heap(m_pending.begin(), m_pending.end(), later_tick);
+        m_due.push_back(m_pending.back());
+        m_pending.pop_back();
+    }
+    std::sort(m_due.begin(), m_due.end(),
+              [](const SimCommand& a, const SimCommand& b) { return command_key(a) < command_key(b); });
+    for (const SimCommand& c : m_due) apply_(c);
+
+    move_units_();
+
+    ++m_tick;
+    m_checksums.push_back(checksum());
+}
+
+void LockstepSim::apply_(const SimCommand& cmd) {
+    switch (cmd.type) {
+    case SimCommandType::Spawn: {
+        const Entity e = m_state.create();
+        m_state.add<SimBody>(e, { { cmd.x, cmd.z }, 0, cmd.player });
+        break;
+    }
+    case SimCommandType::Move:
+    case SimCommandType::Stop: {
+        // players only order their own units; everyone rejects the same ones
+        SimBody* body = m_state.get<SimBody>(cmd.unit);
+        if (!body || body->player != cmd.player) break;
+        if (cmd.type == SimCommandType::Stop) { m_state.remove<SimMove>(cmd.unit); break; }
+
+        // straight line: the heading and per-tick step are worked out once
+        // here, so walking costs two adds a tick
+        const FxVec2 target{ cmd.x, cmd.z }, d = target - body->pos;
+        if (d.x.raw || d.z.raw) body->facing = fx_atan2(d.z, d.x);
+        m_state.add<SimMove>(cmd.unit, { target, fx_normalize(d) * kStep, fx_length(d) });
+        break;
+    }
+    }
+}
+
+void LockstepSim::move_units_() {
+    const uint32_t n = m_state.pack<SimMove, SimBody>();
+    SimMove*       m = m_state.pool<SimMove>().values().data();
+    SimBody*       b = m_state.pool<SimBody>().values().data();
+    const Entity*  e = m_state.pool<SimMove>().entities().data();
+
+    m_arrived.clear();
+    for (uint32_t i = 0; i < n; ++i) {
+        if (m[i].left <= kStep) {   // rounding in 'step' never leaves a unit off target
+            b[i].pos = m[i].target;
+            m_arrived.push_back(e[i]);
+            continue;
+        }
+        b[i].pos   = b[i].pos + m[i].step;
+        m[i].left -= kStep;
+    }
+    for (Entity a : m_arrived) m_state.remove<SimMove>(a);
+}
+
+uint64_t LockstepSim::checksum() const {
+    StateHash h;
+    h.add(m_tick);
+    const auto& bodies = m_state.pool<SimBody>();
+    for (uint32_t i = 0; i < bodies.size(); ++i) {
+        const SimBody& b = bodies.values()[i];
+        h.add(bodies.entities()[i]);
+        h.add(b.pos);
+        h.add(uint32_t(b.facing), b.player);
+    }
+    const auto& moves = m_state.pool<SimMove>();
+    for (uint32_t i = 0; i < moves.size(); ++i) {
+        const SimMove& m = moves.values()[i];
+        h.add(moves.entities()[i]);
+        h.add(m.target); h.add(m.step);
+        h.add(uint32_t(m.left.raw));
+    }
+    return h.h;
+}
+
+uint64_t first_desync(std::span<const uint64_t> a, std::span<const uint64_t> b) {
+    const size_t n = std::min(a.size(), b.size());
+    for (size_t i = 0; i < n; ++i)
+        if (a[i] != b[i]) return i;
+    return UINT64_MAX;
+}
@@ -0,0 +1,98 @@
+#ifndef LOCKSTEP_HPP
+#define LOCKSTEP_HPP
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "entity_store.hpp"
+#include "fixed.hpp"
+
+// Deterministic lockstep core. Peers never send unit state, only commands:
+// each one is stamped with the tick it takes effect on (a few ticks ahead,
+// to hide latency), every machine schedules every player's commands, and
+// since the simulation is a pure function of (state, commands) they all
+// compute the same next tick. A thousand units moving costs the same
+// bandwidth as one.
+//
+// "The same" means to the bit, so the state is fixed point only (Fixed,
+// FxAngle) and the order of everything is pinned: commands due on a tick
+// are applied sorted by (player, seq), never in arrival order, and systems
+// walk pools in dense order, which only depends on earlier ticks. A 64-bit
+// checksum of the whole state is kept per tick; peers compare them and the
+// first mismatch names the tick that desynced.
+//
+// The float systems (flow fields, ORCA, fog) are presentation-side until
+// they get fixed-point ports; the renderer reads to_float() copies.
+
+enum class SimCommandType : uint8_t {
+    Spawn,   // new unit for 'player' at (x, z)
+    Move,    // 'unit' walks to (x, z)
+    Stop,    // 'unit' stops where it is
+};
+
+struct SimCommand {
+    uint64_t       tick   = 0;   // applied at the start of this tick
+    uint32_t       player = 0;
+    uint32_t       seq    = 0;   // sender's running count: orders one player's commands
+    SimCommandType type   = SimCommandType::Stop;
+    Entity         unit;         // Move / Stop
+    Fixed          x, z;         // Spawn position or Move target
+};
+
+struct SimBody {
+    FxVec2   pos;
+    FxAngle  facing = 0;
+    uint32_t player = 0;
+};
+struct SimMove {     // present while walking, removed on arrival
+    FxVec2 target;
+    FxVec2 step;     // movement per tick, set when the order lands
+    Fixed  left;     // distance still to go
+};
+
+using SimStore = EntityStore<SimBody, SimMove>;
+
+class LockstepSim {
+public:
+    static constexpr Fixed kDt    = Fixed::from_ratio(1, 30);   // seconds per tick
+    static constexpr Fixed kSpeed = Fixed::from_int(3);         // world units per second
+    static constexpr Fixed kStep  = kSpeed * kDt;               // world units per tick
+
+    // Queues a command; false (and ignored) if its tick has already run,
+    // which in a real session means the peer broke the input delay.
+    bool schedule(const SimCommand& cmd);
+
+    // Runs tick 'tick()': applies the commands due on it, moves units,
+    // records the checksum, advances the counter.
+    void step();
+
+    uint64_t tick() const { return m_tick; }
+
+    // Hash of the current state.
+    uint64_t checksum() const;
+    // checksums()[t] is the state after tick t.
+    std::span<const uint64_t> checksums() const { return m_checksums; }
+
+    // The commands applied by the last step(), in the order they ran.
+    std::span<const SimCommand> last_commands() const { return m_due; }
+
+    const SimStore& state() const { return m_state; }
+
+private:
+    void apply_(const SimCommand& cmd);
+    void move_units_();
+
+    SimStore                m_state;
+    uint64_t                m_tick = 0;
+    std::vector<SimCommand> m_pending;   // heap, earliest tick on top
+    std::vector<SimCommand> m_due;
+    std::vector<Entity>     m_arrived;
+    std::vector<uint64_t>   m_checksums;
+};
+
+// First tick where two checksum histories differ, or UINT64_MAX if they
+// agree over their common length.
+uint64_t first_desync(std::span<const uint64_t> a, std::span<const uint64_t> b);
+
+#endif // LOCKSTEP_HPP
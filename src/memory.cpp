@@ -1,5 +1,7 @@
 #include "memory.hpp"
 #include "render_pipeline.hpp"
+#include "deletion_queue.hpp"
+#include "memory_tracker.hpp"
 #include <cstring>
 
 
@@ -53,7 +55,7 @@ VkResult MappedArena::create(VkDevice device,
     VkMemoryAllocateInfo ai{VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
     ai.allocationSize  = mr.size;         // driver-aligned
     ai.memoryTypeIndex = typeIndex;
-    VK_CHECK(vkAllocateMemory(device, &ai, nullptr, &m_memory));
+    VK_CHECK(tracked_allocate(device, ai, &m_memory, MemoryCategory::Dynamic));
     VK_CHECK(vkBindBufferMemory(device, m_buffer, m_memory, 0));
 
     // Map once, whole size
@@ -77,6 +79,25 @@ VkResult MappedArena::realloc(VkPhysicalDevice phys, VkDeviceSize newCapacity) {
     return create(device, phys, newCapacity, usage, preferCoherent);
 }
 
+// Recreate without waiting: in-flight work keeps using the old buffer until
+// 'lastUse' completes, then the deletion queue frees it.
+VkResult MappedArena::realloc(VkPhysicalDevice phys, VkDeviceSize newCapacity,
+                              DeletionQueue& retire, uint64_t lastUse) {
+    VkDevice device = m_device;
+    VkBufferUsageFlags usage = m_usage;
+    bool preferCoherent = (m_memProps & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+
+    // the host is done writing it; the GPU doesn't care about the mapping
+    if (m_mapped) { vkUnmapMemory(device, m_memory); m_mapped = nullptr; }
+    retire.retire(m_buffer, lastUse);
+    retire.retire(m_memory, lastUse);
+    m_buffer = VK_NULL_HANDLE;
+    m_memory = VK_NULL_HANDLE;
+
+    destroy(device);
+    return create(device, phys, newCapacity, usage, preferCoherent);
+}
+
 // Free GPU resources (safe to call on an uninitialized object).
 void MappedArena::destroy(VkDevice device) {
     if (m_mapped) {
@@ -84,7 +105,7 @@ void MappedArena::destroy(VkDevice device) {
         m_mapped = nullptr;
     }
     if (m_memory) {
-        vkFreeMemory(device, m_memory, nullptr);
+        tracked_free(device, m_memory);
         m_memory = VK_NULL_HANDLE;
     }
     if (m_buffer) {
@@ -99,13 +120,11 @@ void MappedArena::destroy(VkDevice device) {
     m_atom = 1;
 }
 
-// Allocate space (optionally aligned) and copy CPU data into it.
-// On success, 'out' contains buffer/offset/cpu_ptr for immediate use.
+// Allocate space (optionally aligned) without touching it.
 // Returns VK_ERROR_OUT_OF_DEVICE_MEMORY if ring has no room.
-VkResult MappedArena::allocAndWrite(const void* src,
-                       VkDeviceSize size,
-                       UploadAlloc& out,
-                       VkDeviceSize align)
+VkResult MappedArena::alloc(VkDeviceSize size,
+                            UploadAlloc& out,
+                            VkDeviceSize align)
 {
     if (size == 0) size = 1; // forbid zero-sized nonsense
 
@@ -115,25 +134,76 @@ VkResult MappedArena::allocAndWrite(const void* src,
         return VK_ERROR_OUT_OF_DEVICE_MEMORY;
     }
 
-    void* dst = static_cast<char*>(m_mapped) + off;
-    std::memcpy(dst, src, size);
-
-    if (!m_isCoherent) {
-        // Do an aligned flush
-        VkDeviceSize flushOff  = align_down(off, m_atom);
-        VkDeviceSize flushEnd  = align_up(off + size, m_atom);
-        VkMappedMemoryRange rng{VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE};
-        rng.memory = m_memory;
-        rng.offset = flushOff;
-        rng.size   = flushEnd - flushOff;
-        vkFlushMappedMemoryRanges(m_device, 1, &rng);
-    }
-
     out.buffer  = m_buffer;
     out.offset  = off;
-    out.cpu_ptr = dst;
+    out.cpu_ptr = static_cast<char*>(m_mapped) + off;
     out.size    = size;
 
     m_head = off + size;
     return VK_SUCCESS;
 }
+
+void MappedArena::flush(const UploadAlloc& a, VkDeviceSize bytes) const {
+    if (m_isCoherent || bytes == 0) return;
+
+    // Do an aligned flush
+    VkDeviceSize flushOff  = align_down(a.offset, m_atom);
+    VkDeviceSize flushEnd  = std::min(align_up(a.offset + bytes, m_atom), align_up(m_capacity, m_atom));
+    VkMappedMemoryRange rng{VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE};
+    rng.memory = m_memory;
+    rng.offset = flushOff;
+    rng.size   = flushEnd - flushOff;
+    vkFlushMappedMemoryRanges(m_device, 1, &rng);
+}
+
+// Allocate space (optionally aligned) and copy CPU data into it.
+// On success, 'out' contains buffer/offset/cpu_ptr for immediate use.
+// Returns VK_ERROR_OUT_OF_DEVICE_MEMORY if ring has no room.
+VkResult MappedArena::allocAndWrite(const void* src,
+                       VkDeviceSize size,
+                       UploadAlloc& out,
+                       VkDeviceSize align)
+{
+    if (auto r = alloc(size, out, align)) return r;
+    std::memcpy(out.cpu_ptr, src, out.size);
+    flush(out, out.size);
+    return VK_SUCCESS;
+}
+
+VkResult GpuBuffer::create(VkDevice device,
+                           VkPhysicalDevice phys,
+                           VkDeviceSize sizeBytes,
+                           VkBufferUsageFlags usage,
+                           VkMemoryPropertyFlags props)
+{
+    destroy(device);
+
+    VkBufferCreateInfo bi{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    bi.size        = sizeBytes;
+    bi.usage       = usage;
+    bi.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    if (auto r = vkCreateBuffer(device, &bi, nullptr, &m_buffer)) return r;
+
+    VkMemoryRequirements mr{};
+    vkGetBufferMemoryRequirements(device, m_buffer, &mr);
+    uint32_t typeIndex = render::find_mem_type(phys, mr.memoryTypeBits, props);
+    if (typeIndex == UINT32_MAX) typeIndex = render::find_mem_type(phys, mr.memoryTypeBits, 0);
+    if (typeIndex == UINT32_MAX) { destroy(device); return VK_ERROR_OUT_OF_DEVICE_MEMORY; }
+
+    VkMemoryAllocateInfo ai{VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+    ai.allocationSize  = mr.size;
+    ai.memoryTypeIndex = typeIndex;
+    if (auto r = tracked_allocate(device, ai, &m_memory, MemoryCategory::Buffer)) { destroy(device); return r; }
+    if (auto r = vkBindBufferMemory(device, m_buffer, m_memory, 0)) { destroy(device); return r; }
+
+    m_size = sizeBytes;
+    return VK_SUCCESS;
+}
+
+void GpuBuffer::destroy(VkDevice device) {
+    if (m_buffer) vkDestroyBuffer(device, m_buffer, nullptr);
+    if (m_memory) tracked_free(device, m_memory);
+    m_buffer = VK_NULL_HANDLE;
+    m_memory = VK_NULL_HANDLE;
+    m_size   = 0;
+}
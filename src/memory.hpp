@@ -11,6 +11,8 @@ inline VkDeviceSize align_down(VkDeviceSize v, VkDeviceSize a) {
     return (a ? v / a * a : v);
 }
 
+class DeletionQueue;
+
 struct UploadAlloc {
     VkBuffer       buffer = VK_NULL_HANDLE;
     VkDeviceSize   offset = 0;     // offset you can bind/use
@@ -37,6 +39,18 @@ public:
     	return realloc(phys,newCapacity);
     }
 
+    // Same, but the old buffer/memory go to 'retire' tagged with 'lastUse'
+    // (a GpuTimeline value) instead of being freed now: no device idle needed.
+    VkResult realloc(VkPhysicalDevice phys, VkDeviceSize newCapacity,
+                     DeletionQueue& retire, uint64_t lastUse);
+    inline VkResult maybe_realloc(VkPhysicalDevice phys, VkDeviceSize newCapacity,
+                                  DeletionQueue& retire, uint64_t lastUse){
+    	if (newCapacity<=capacity())
+    		return VK_SUCCESS;
+
+    	return realloc(phys,newCapacity,retire,lastUse);
+    }
+
     // Free GPU resources
     void destroy(VkDevice device);
 
@@ -50,6 +64,14 @@ public:
     	DEBUG_ASSERT((usage() & need)==need);
     }
 
+    // Allocate space only; write through out.cpu_ptr, then flush() what you wrote
+    VkResult alloc(VkDeviceSize size,
+                   UploadAlloc& out,
+                   VkDeviceSize align = 16);
+
+    // Make host writes in [a.offset, a.offset+bytes) visible (no-op when coherent)
+    void flush(const UploadAlloc& a, VkDeviceSize bytes) const;
+
     // Allocate space and copy CPU data into it
     VkResult allocAndWrite(const void* src,
                            VkDeviceSize size,
@@ -81,5 +103,25 @@ private:
     VkMemoryPropertyFlags  m_memProps  = 0;
 };
 
+// Plain device-local buffer (not mapped): filled by copies, uploads or compute.
+class GpuBuffer {
+public:
+    VkResult create(VkDevice device,
+                    VkPhysicalDevice phys,
+                    VkDeviceSize sizeBytes,
+                    VkBufferUsageFlags usage,
+                    VkMemoryPropertyFlags props = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    void destroy(VkDevice device);
+
+    VkBuffer       buffer() const { return m_buffer; }
+    VkDeviceMemory memory() const { return m_memory; }
+    VkDeviceSize   size()   const { return m_size; }
+
+private:
+    VkBuffer       m_buffer = VK_NULL_HANDLE;
+    VkDeviceMemory m_memory = VK_NULL_HANDLE;
+    VkDeviceSize   m_size   = 0;
+};
+
 #endif // MEMORY_HPP
 
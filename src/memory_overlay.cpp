@@ -0,0 +1,58 @@
+#include "memory_overlay.hpp"
+#include <cstdio>
+#include <string_view>
+
+static constexpr double kMiB = 1.0 / (1024.0 * 1024.0);
+
+void MemoryOverlay::update(VkPhysicalDevice phys, double dt) {
+    m_since += dt;
+    if (m_since < refresh_s) return;
+    m_since = 0.0;
+    memory_stats(phys, m_stats);
+    format_();
+}
+
+void MemoryOverlay::format_() {
+    m_line_count = 0;
+    const MemoryStats& s = m_stats;
+
+    for (uint32_t h = 0; h < s.heap_count && m_line_count < kMaxLines - 2; ++h) {
+        const HeapStats& heap = s.heaps[h];
+        if (!heap.usage && !heap.tracked) continue;   // heaps we never touch
+        const float p = heap.budget ? float(heap.usage) / float(heap.budget) : 0.f;
+        std::snprintf(m_lines[m_line_count], kLineChars, "%s%u: %.1f / %.1f MiB (%.0f%%) ours %.1f",
+                      (heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) ? "vram" : "host", h,
+                      double(heap.usage) * kMiB, double(heap.budget) * kMiB, double(p) * 100.0,
+                      double(heap.tracked) * kMiB);
+        m_pressure[m_line_count++] = p;
+    }
+
+    std::snprintf(m_lines[m_line_count], kLineChars, "buf %.1f  dyn %.1f  stg %.1f  tex %.1f  rt %.1f MiB",
+                  double(s.by_category[uint32_t(MemoryCategory::Buffer)])       * kMiB,
+                  double(s.by_category[uint32_t(MemoryCategory::Dynamic)])      * kMiB,
+                  double(s.by_category[uint32_t(MemoryCategory::Staging)])      * kMiB,
+                  double(s.by_category[uint32_t(MemoryCategory::Texture)])      * kMiB,
+                  double(s.by_category[uint32_t(MemoryCategory::RenderTarget)]) * kMiB);
+    m_pressure[m_line_count++] = 0.f;
+
+    std::snprintf(m_lines[m_line_count], kLineChars, "%u allocations%s",
+                  s.allocations, s.from_driver ? "" : " (no budget ext: heap size as budget)");
+    m_pressure[m_line_count++] = 0.f;
+}
+
+VkResult MemoryOverlay::record(VkCommandBuffer cb, MappedArena& arena, TextRenderer& text,
+                               const FontAtlasCPU& font, float x, float y) const
+{
+    static constexpr float kOk[4]   = { 0.8f, 0.8f, 0.8f, 1.0f };
+    static constexpr float kHigh[4] = { 1.0f, 0.8f, 0.2f, 1.0f };   // > 75% of budget
+    static constexpr float kFull[4] = { 1.0f, 0.25f, 0.2f, 1.0f };  // > 90%
+
+    const float line_h = float(measure_y_px(font));
+    for (uint32_t i = 0; i < m_line_count; ++i) {
+        const float* color = m_pressure[i] > 0.9f ? kFull : m_pressure[i] > 0.75f ? kHigh : kOk;
+        if (auto r = text.record_draw_line(cb, arena, std::string_view(m_lines[i]),
+                                           x, y + line_h * float(i), 1.0f, -1.0f, font, color))
+            return r;
+    }
+    return VK_SUCCESS;
+}
@@ -0,0 +1,42 @@
+#ifndef MEMORY_OVERLAY_HPP
+#define MEMORY_OVERLAY_HPP
+
+#include <cstdint>
+
+#include "memory_tracker.hpp"
+#include "text_render.hpp"
+
+// Debug overlay: one line per heap (usage / budget, colored by pressure),
+// the per-category split and the live allocation count. Stats are refreshed
+// every 'refresh_s' seconds since the budget query goes to the driver.
+class MemoryOverlay {
+public:
+    double refresh_s = 0.25;
+
+    // Call once per frame with the frame time.
+    void update(VkPhysicalDevice phys, double dt);
+
+    // Inside rendering. (x, y) is the first baseline in pixels: the text
+    // renderer's view must map pixels (TextRenderer::set_view with
+    // Camera::screen_view). Needs max_glyphs() * 2 TriPairs of arena room.
+    VkResult record(VkCommandBuffer cb, MappedArena& arena, TextRenderer& text,
+                    const FontAtlasCPU& font, float x, float y) const;
+
+    const MemoryStats& stats() const { return m_stats; }
+
+    static constexpr uint32_t kMaxLines    = VK_MAX_MEMORY_HEAPS + 2;
+    static constexpr uint32_t kLineChars   = 96;
+    static constexpr uint32_t max_glyphs() { return kMaxLines * kLineChars; }
+
+private:
+    void format_();
+
+    MemoryStats m_stats{};
+    double      m_since = 1e9;   // refresh on the first update()
+
+    char     m_lines[kMaxLines][kLineChars]{};
+    float    m_pressure[kMaxLines]{};   // per line, for the color
+    uint32_t m_line_count = 0;
+};
+
+#endif // MEMORY_OVERLAY_HPP
@@ -0,0 +1,155 @@
+#include "memory_tracker.hpp"
+#include "platform.hpp"
+#include <algorithm>
+#include <iterator>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+
+struct Entry {
+    VkDeviceSize   size;
+    uint32_t       heap;
+    MemoryCategory category;
+};
+
+// warn once a heap's tracked bytes pass this share of its (last known) budget
+constexpr float kWarnPressure = 0.9f;
+
+struct Books {
+    std::mutex mutex;
+    std::unordered_map<VkDeviceMemory, Entry> live;
+
+    uint32_t     type_heap[VK_MAX_MEMORY_TYPES] = {};
+    uint32_t     heap_count = 0;
+    VkDeviceSize heap_size[VK_MAX_MEMORY_HEAPS] = {};
+    VkDeviceSize budget[VK_MAX_MEMORY_HEAPS]    = {};   // refreshed by memory_stats()
+    VkDeviceSize per_heap[VK_MAX_MEMORY_HEAPS]  = {};
+    VkDeviceSize per_category[kMemoryCategoryCount] = {};
+    bool         warned[VK_MAX_MEMORY_HEAPS]    = {};
+};
+
+Books& books() {
+    static Books b;
+    return b;
+}
+
+constexpr double kMiB = 1.0 / (1024.0 * 1024.0);
+
+} // namespace
+
+const char* memory_category_name(MemoryCategory c) {
+    switch (c) {
+        case MemoryCategory::Buffer:       return "buffer";
+        case MemoryCategory::Dynamic:      return "dynamic";
+        case MemoryCategory::Staging:      return "staging";
+        case MemoryCategory::Texture:      return "texture";
+        case MemoryCategory::RenderTarget: return "render target";
+        default:                           return "?";
+    }
+}
+
+void memory_tracker_init(VkPhysicalDevice phys) {
+    VkPhysicalDeviceMemoryProperties mp{};
+    vkGetPhysicalDeviceMemoryProperties(phys, &mp);
+
+    Books& b = books();
+    std::lock_guard lock(b.mutex);
+    for (uint32_t i = 0; i < mp.memoryTypeCount; ++i) b.type_heap[i] = mp.memoryTypes[i].heapIndex;
+    b.heap_count = mp.memoryHeapCount;
+    for (uint32_t h = 0; h < mp.memoryHeapCount; ++h) {
+        b.heap_size[h] = mp.memoryHeaps[h].size;
+        b.budget[h]    = mp.memoryHeaps[h].size;
+    }
+}
+
+void memory_tracker_shutdown() {
+    Books& b = books();
+    std::lock_guard lock(b.mutex);
+    for (const auto& [mem, e] : b.live)
+        LOG_ERROR("memory leak: %.2f MiB (%s) on heap %u still allocated",
+                  double(e.size) * kMiB, memory_category_name(e.category), e.heap);
+    b.live.clear();
+    std::fill(std::begin(b.per_heap), std::end(b.per_heap), VkDeviceSize(0));
+    std::fill(std::begin(b.per_category), std::end(b.per_category), VkDeviceSize(0));
+    std::fill(std::begin(b.warned), std::end(b.warned), false);
+}
+
+VkResult tracked_allocate(VkDevice device, const VkMemoryAllocateInfo& info,
+                          VkDeviceMemory* out, MemoryCategory category) {
+    VkResult r = vkAllocateMemory(device, &info, nullptr, out);
+
+    Books& b = books();
+    std::lock_guard lock(b.mutex);
+    const uint32_t heap = info.memoryTypeIndex < VK_MAX_MEMORY_TYPES ? b.type_heap[info.memoryTypeIndex] : 0;
+    if (r != VK_SUCCESS) {
+        LOG_ERROR("vkAllocateMemory(%.2f MiB, %s) failed on heap %u: %s (tracked %.2f / budget %.2f MiB)",
+                  double(info.allocationSize) * kMiB, memory_category_name(category), heap,
+                  vk_result_str(r), double(b.per_heap[heap]) * kMiB, double(b.budget[heap]) * kMiB);
+        return r;
+    }
+
+    b.live[*out] = Entry{ info.allocationSize, heap, category };
+    b.per_heap[heap] += info.allocationSize;
+    b.per_category[uint32_t(category)] += info.allocationSize;
+
+    const bool high = b.budget[heap] && float(b.per_heap[heap]) > kWarnPressure * float(b.budget[heap]);
+    if (high && !b.warned[heap])
+        LOG_ERROR("device memory heap %u at %.2f of %.2f MiB budget",
+                  heap, double(b.per_heap[heap]) * kMiB, double(b.budget[heap]) * kMiB);
+    b.warned[heap] = high;
+    return r;
+}
+
+void tracked_free(VkDevice device, VkDeviceMemory memory) {
+    if (memory == VK_NULL_HANDLE) return;
+    {
+        Books& b = books();
+        std::lock_guard lock(b.mutex);
+        auto it = b.live.find(memory);
+        if (it != b.live.end()) {
+            b.per_heap[it->second.heap] -= it->second.size;
+            b.per_category[uint32_t(it->second.category)] -= it->second.size;
+            b.live.erase(it);
+        }
+    }
+    vkFreeMemory(device, memory, nullptr);
+}
+
+float MemoryStats::worst_pressure() const {
+    float worst = 0.f;
+    for (uint32_t h = 0; h < heap_count; ++h)
+        if (heaps[h].budget) worst = std::max(worst, float(heaps[h].usage) / float(heaps[h].budget));
+    return worst;
+}
+
+void memory_stats(VkPhysicalDevice phys, MemoryStats& out) {
+    out = MemoryStats{};
+
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budget{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT};
+    VkPhysicalDeviceMemoryProperties2 mp2{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2};
+    if (g_vulkan.memory_budget) {
+        mp2.pNext = &budget;
+        vkGetPhysicalDeviceMemoryProperties2(phys, &mp2);
+    } else {
+        vkGetPhysicalDeviceMemoryProperties(phys, &mp2.memoryProperties);
+    }
+    const VkPhysicalDeviceMemoryProperties& mp = mp2.memoryProperties;
+
+    Books& b = books();
+    std::lock_guard lock(b.mutex);
+    out.heap_count  = mp.memoryHeapCount;
+    out.from_driver = g_vulkan.memory_budget;
+    for (uint32_t h = 0; h < mp.memoryHeapCount; ++h) {
+        HeapStats& s = out.heaps[h];
+        s.size    = mp.memoryHeaps[h].size;
+        s.flags   = mp.memoryHeaps[h].flags;
+        s.tracked = b.per_heap[h];
+        s.usage   = out.from_driver ? budget.heapUsage[h]  : s.tracked;
+        s.budget  = out.from_driver ? budget.heapBudget[h] : s.size;
+        b.budget[h] = s.budget;
+        out.total += s.tracked;
+    }
+    for (uint32_t c = 0; c < kMemoryCategoryCount; ++c) out.by_category[c] = b.per_category[c];
+    out.allocations = static_cast<uint32_t>(b.live.size());
+}
@@ -0,0 +1,61 @@
+#ifndef MEMORY_TRACKER_HPP
+#define MEMORY_TRACKER_HPP
+
+#include <cstdint>
+#include <vulkan/vulkan.h>
+
+// Central accounting for device memory. Every vkAllocateMemory in the engine
+// goes through tracked_allocate() so usage can be broken down by heap and by
+// what the memory is for; memory_stats() adds the driver's own numbers from
+// VK_EXT_memory_budget when the device has it (g_vulkan.memory_budget).
+//
+// Thread-safe: allocations may come from loader threads.
+enum class MemoryCategory : uint8_t {
+    Buffer,        // device-local buffers (GpuBuffer)
+    Dynamic,       // persistently mapped rings (MappedArena)
+    Staging,       // short-lived upload sources
+    Texture,       // sampled images (atlas, sprites)
+    RenderTarget,  // attachments, render graph transients
+    Count
+};
+constexpr uint32_t kMemoryCategoryCount = uint32_t(MemoryCategory::Count);
+
+const char* memory_category_name(MemoryCategory c);
+
+// Caches the memory type -> heap mapping (platform_init calls it once the
+// device exists; allocations before that are booked on heap 0).
+void memory_tracker_init(VkPhysicalDevice phys);
+// Logs whatever is still allocated (leaks) and clears the books.
+void memory_tracker_shutdown();
+
+// Drop-in replacements for vkAllocateMemory / vkFreeMemory. Freeing memory
+// the tracker never saw is fine (it is just freed).
+VkResult tracked_allocate(VkDevice device, const VkMemoryAllocateInfo& info,
+                          VkDeviceMemory* out, MemoryCategory category);
+void     tracked_free(VkDevice device, VkDeviceMemory memory);
+
+struct HeapStats {
+    VkDeviceSize      size    = 0;   // heap size
+    VkMemoryHeapFlags flags   = 0;
+    VkDeviceSize      tracked = 0;   // what we allocated on it
+    VkDeviceSize      usage   = 0;   // driver's usage for this process (== tracked without the extension)
+    VkDeviceSize      budget  = 0;   // what we can use before it hurts (== size without the extension)
+};
+
+struct MemoryStats {
+    uint32_t     heap_count  = 0;
+    HeapStats    heaps[VK_MAX_MEMORY_HEAPS];
+    VkDeviceSize by_category[kMemoryCategoryCount] = {};
+    VkDeviceSize total       = 0;    // sum of tracked
+    uint32_t     allocations = 0;    // live vkAllocateMemory count (maxMemoryAllocationCount is often 4096)
+    bool         from_driver = false; // usage/budget came from VK_EXT_memory_budget
+
+    // Highest usage / budget over all heaps (0..1+).
+    float worst_pressure() const;
+};
+
+// Snapshot of the books plus, when available, the driver's budget. The
+// budget query isn't free: call it a few times a second, not per draw.
+void memory_stats(VkPhysicalDevice phys, MemoryStats& out);
+
+#endif // MEMORY_TRACKER_HPP
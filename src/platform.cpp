@@ -1,9 +1,12 @@
 #define SDL_MAIN_HANDLED
 #include "platform.hpp"
 #include <vector>
+#include <span>
 #include <cstring>
 #include <algorithm>
 #include "common.hpp"
+#include "memory_tracker.hpp"
+#include "jobs.hpp"
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
@@ -30,6 +33,7 @@
 SDL_Window* g_window = nullptr;
 int window_w = 0;
 int window_h = 0;
+MouseInput g_mouse;
 
 VulkanGlobals g_vulkan;
 
@@ -38,6 +42,10 @@ static const char* kWindowTitle = "Vulkan Strategy Game";
 FT_Library free_type;
 
 bool platform_should_quit() {
+  g_mouse.begin_frame();
+  // SDL reports window coordinates; the swapchain (and Camera) use pixels
+  const float density = g_window ? SDL_GetWindowPixelDensity(g_window) : 1.f;
+
   SDL_Event e;
   while (SDL_PollEvent(&e)) {
     switch (e.type) {
@@ -46,6 +54,38 @@ bool platform_should_quit() {
       case SDL_EVENT_KEY_DOWN:
         if (e.key.key == SDLK_ESCAPE) return true; // handy during bring-up
         break;
+      case SDL_EVENT_MOUSE_MOTION:
+        g_mouse.x   = e.motion.x * density;
+        g_mouse.y   = e.motion.y * density;
+        g_mouse.dx += e.motion.xrel * density;
+        g_mouse.dy += e.motion.yrel * density;
+        break;
+      case SDL_EVENT_MOUSE_BUTTON_DOWN:
+      case SDL_EVENT_MOUSE_BUTTON_UP: {
+        const bool down = e.type == SDL_EVENT_MOUSE_BUTTON_DOWN;
+        g_mouse.x = e.button.x * density;
+        g_mouse.y = e.button.y * density;
+        switch (e.button.button) {
+          case SDL_BUTTON_LEFT:
+            g_mouse.left = down;
+            if (down) { g_mouse.left_pressed = true; g_mouse.press_x = g_mouse.x; g_mouse.press_y = g_mouse.y; }
+            else        g_mouse.left_released = true;
+            break;
+          case SDL_BUTTON_RIGHT:
+            g_mouse.right = down;
+            (down ? g_mouse.right_pressed : g_mouse.right_released) = true;
+            break;
+          case SDL_BUTTON_MIDDLE:
+            g_mouse.middle = down;
+            break;
+          default:
+            break;
+        }
+        break;
+      }
+      case SDL_EVENT_MOUSE_WHEEL:
+        g_mouse.wheel += e.wheel.direction == SDL_MOUSEWHEEL_FLIPPED ? -e.wheel.y : e.wheel.y;
+        break;
       default:
         break;
     }
@@ -321,15 +361,232 @@ static bool pick_phisical_device(){
         return false;
     }
 
+    // --- transfer family: a transfer-only (DMA) family if there is one, else
+    // any non-graphics family with transfer; otherwise uploads share graphics
+    {
+        uint32_t qcount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(g_vulkan.physical_device, &qcount, nullptr);
+        std::vector<VkQueueFamilyProperties> qprops(qcount);
+        vkGetPhysicalDeviceQueueFamilyProperties(g_vulkan.physical_device, &qcount, qprops.data());
+
+        uint32_t best = UINT32_MAX;
+        int      best_rank = 0;
+        for (uint32_t i = 0; i < qcount; ++i) {
+            const VkQueueFlags f = qprops[i].queueFlags;
+            if (!(f & VK_QUEUE_TRANSFER_BIT) || (f & VK_QUEUE_GRAPHICS_BIT) || qprops[i].queueCount == 0) continue;
+            const int rank = (f & VK_QUEUE_COMPUTE_BIT) ? 1 : 2;
+            if (rank > best_rank) { best = i; best_rank = rank; }
+        }
+        g_vulkan.dedicated_transfer = best != UINT32_MAX;
+        g_vulkan.transfer_family    = g_vulkan.dedicated_transfer ? best : g_vulkan.graphics_family;
+    }
+
     VkPhysicalDeviceProperties device_props{};
     vkGetPhysicalDeviceProperties(g_vulkan.physical_device, &device_props);
-    LOG("found physical device %s (gfx qf=%u, present qf=%u)",
-           device_props.deviceName, g_vulkan.graphics_family, g_vulkan.present_family);
+    LOG("found physical device %s (gfx qf=%u, present qf=%u, transfer qf=%u%s)",
+           device_props.deviceName, g_vulkan.graphics_family, g_vulkan.present_family,
+           g_vulkan.transfer_family, g_vulkan.dedicated_transfer ? " dedicated" : "");
 
     return true;
 
 }
 
+// OPTIONAL FEATURES
+// Feature structs we query and then hand straight back to vkCreateDevice.
+// Every struct here is only linked into the chain when the device can accept it
+// (promoted to core for our api version, or the extension is advertised).
+struct OptionalFeatures {
+    VkPhysicalDeviceFeatures2                core{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+    VkPhysicalDeviceSynchronization2Features sync2{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES};
+    VkPhysicalDeviceDynamicRenderingFeatures dynamic_rendering{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES};
+    VkPhysicalDeviceExtendedDynamicStateFeaturesEXT  eds{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT};
+    VkPhysicalDeviceExtendedDynamicState3FeaturesEXT eds3{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT};
+    VkPhysicalDeviceDescriptorIndexingFeatures       indexing{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES};
+    VkPhysicalDeviceTimelineSemaphoreFeatures        timeline{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES};
+
+    std::vector<const char*> extensions;
+};
+
+static bool has_extension(const std::vector<VkExtensionProperties>& exts, const char* name) {
+    for (const auto& e : exts)
+        if (std::strcmp(e.extensionName, name) == 0) return true;
+    return false;
+}
+
+// Links 'feature' into the chain if it is core at 'promoted' or 'ext' (and the
+// extensions it depends on) is present. Returns true when linked (the caller
+// reads the queried bits afterwards).
+template <typename T>
+static bool link_feature(OptionalFeatures& f, T& feature,
+                         uint32_t promoted, const char* ext,
+                         const std::vector<VkExtensionProperties>& exts,
+                         std::span<const char* const> deps = {}) {
+    const bool core = g_vulkan.api_version >= promoted;
+    if (!core) {
+        if (!ext || !has_extension(exts, ext)) return false;
+        for (const char* d : deps) if (!has_extension(exts, d)) return false;
+        for (const char* d : deps) if (!vec_contains(f.extensions, d)) f.extensions.push_back(d);
+        f.extensions.push_back(ext);
+    }
+    feature.pNext = f.core.pNext;
+    f.core.pNext  = &feature;
+    return true;
+}
+
+// The few core 1.0 features we use; everything else stays off.
+static void keep_core_features(const VkPhysicalDeviceFeatures& supported, VkPhysicalDeviceFeatures& out) {
+    out = VkPhysicalDeviceFeatures{}; // don't blanket-enable every supported core feature
+    out.shaderSampledImageArrayDynamicIndexing = supported.shaderSampledImageArrayDynamicIndexing; // bindless fallback
+    out.multiDrawIndirect                      = supported.multiDrawIndirect;
+    out.drawIndirectFirstInstance              = supported.drawIndirectFirstInstance;
+    g_vulkan.multi_draw_indirect          = out.multiDrawIndirect;
+    g_vulkan.draw_indirect_first_instance = out.drawIndirectFirstInstance;
+}
+
+// Fills 'f' with everything we want to enable and stamps the g_vulkan flags.
+// Returns false when we can't even query (Vulkan 1.0), in which case the
+// device is created the classic way with no optional features.
+static bool query_optional_features(OptionalFeatures& f) {
+    if (g_vulkan.api_version < VK_API_VERSION_1_1) return false;
+
+    uint32_t extCount = 0;
+    VK_CHECK(vkEnumerateDeviceExtensionProperties(g_vulkan.physical_device, nullptr, &extCount, nullptr));
+    std::vector<VkExtensionProperties> exts(extCount);
+    VK_CHECK(vkEnumerateDeviceExtensionProperties(g_vulkan.physical_device, nullptr, &extCount, exts.data()));
+
+    const bool sync2 = link_feature(f, f.sync2, VK_API_VERSION_1_3, VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME, exts);
+
+    // KHR_dynamic_rendering needs depth_stencil_resolve (+ create_renderpass2) below 1.2
+    static const char* const kDynamicRenderingDeps[] = {
+        VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME, VK_KHR_DEPTH_STENCIL_RESOLVE_EXTENSION_NAME
+    };
+    const bool dynamic_rendering = link_feature(f, f.dynamic_rendering, VK_API_VERSION_1_3,
+        VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME, exts,
+        g_vulkan.api_version < VK_API_VERSION_1_2 ? std::span<const char* const>(kDynamicRenderingDeps)
+                                                  : std::span<const char* const>());
+
+    // extended dynamic state is core in 1.3 without a feature bit; below that it's the EXT
+    const bool eds_core = g_vulkan.api_version >= VK_API_VERSION_1_3;
+    const bool eds  = !eds_core && link_feature(f, f.eds, UINT32_MAX,
+        VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME, exts);
+    const bool eds3 = link_feature(f, f.eds3, UINT32_MAX,
+        VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME, exts);
+
+    static const char* const kDescriptorIndexingDeps[] = { VK_KHR_MAINTENANCE_3_EXTENSION_NAME };
+    const bool indexing = link_feature(f, f.indexing, VK_API_VERSION_1_2,
+        VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME, exts, kDescriptorIndexingDeps);
+
+    const bool timeline = link_feature(f, f.timeline, VK_API_VERSION_1_2,
+        VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME, exts);
+
+    // no feature bit to query: the extension alone enables the command (we
+    // don't chain VkPhysicalDeviceVulkan12Features, so 1.2 goes through it too)
+    const bool indirect_count = has_extension(exts, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+    if (indirect_count) f.extensions.push_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+
+    // properties-only extension, read through vkGetPhysicalDeviceMemoryProperties2
+    const bool memory_budget = has_extension(exts, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    if (memory_budget) f.extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
+    vkGetPhysicalDeviceFeatures2(g_vulkan.physical_device, &f.core);
+    keep_core_features(VkPhysicalDeviceFeatures(f.core.features), f.core.features);
+
+    // bindless textures need exactly these four; drop the rest
+    {
+        const VkPhysicalDeviceDescriptorIndexingFeatures q = f.indexing;
+        const bool ok = indexing &&
+            q.shaderSampledImageArrayNonUniformIndexing &&
+            q.descriptorBindingSampledImageUpdateAfterBind &&
+            q.descriptorBindingPartiallyBound &&
+            q.runtimeDescriptorArray;
+        void* next = f.indexing.pNext;
+        f.indexing = VkPhysicalDeviceDescriptorIndexingFeatures{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES};
+        f.indexing.pNext = next;
+        if (ok) {
+            f.indexing.shaderSampledImageArrayNonUniformIndexing    = VK_TRUE;
+            f.indexing.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+            f.indexing.descriptorBindingPartiallyBound              = VK_TRUE;
+            f.indexing.runtimeDescriptorArray                       = VK_TRUE;
+        }
+        g_vulkan.descriptor_indexing = ok;
+    }
+
+    // of extended_dynamic_state3 we only want blend enable
+    const VkBool32 blend_enable = f.eds3.extendedDynamicState3ColorBlendEnable;
+    void* eds3_next = f.eds3.pNext;
+    f.eds3 = VkPhysicalDeviceExtendedDynamicState3FeaturesEXT{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT};
+    f.eds3.pNext = eds3_next;
+    f.eds3.extendedDynamicState3ColorBlendEnable = blend_enable;
+
+    g_vulkan.synchronization2       = sync2 && f.sync2.synchronization2;
+    g_vulkan.dynamic_rendering      = dynamic_rendering && f.dynamic_rendering.dynamicRendering;
+    g_vulkan.extended_dynamic_state = eds_core || (eds && f.eds.extendedDynamicState);
+    g_vulkan.dynamic_blend_enable   = eds3 && blend_enable;
+    g_vulkan.timeline_semaphore     = timeline && f.timeline.timelineSemaphore;
+    g_vulkan.draw_indirect_count    = indirect_count;
+    g_vulkan.memory_budget          = memory_budget;
+
+    VkPhysicalDeviceDescriptorIndexingProperties ip{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES};
+    VkPhysicalDeviceProperties2 p2{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2};
+    p2.pNext = &ip;
+    if (g_vulkan.descriptor_indexing) {
+        vkGetPhysicalDeviceProperties2(g_vulkan.physical_device, &p2);
+        g_vulkan.max_bindless_textures = std::min(ip.maxDescriptorSetUpdateAfterBindSampledImages,
+                                                  ip.maxPerStageDescriptorUpdateAfterBindSampledImages);
+    }
+    return true;
+}
+
+static void load_optional_functions() {
+    const bool core13 = g_vulkan.api_version >= VK_API_VERSION_1_3;
+    if (g_vulkan.synchronization2) {
+        g_vulkan.cmd_pipeline_barrier2 = reinterpret_cast<PFN_vkCmdPipelineBarrier2>(
+            vkGetDeviceProcAddr(g_vulkan.device, core13 ? "vkCmdPipelineBarrier2" : "vkCmdPipelineBarrier2KHR"));
+        if (!g_vulkan.cmd_pipeline_barrier2) g_vulkan.synchronization2 = false;
+    }
+    if (g_vulkan.dynamic_rendering) {
+        g_vulkan.cmd_begin_rendering = reinterpret_cast<PFN_vkCmdBeginRendering>(
+            vkGetDeviceProcAddr(g_vulkan.device, core13 ? "vkCmdBeginRendering" : "vkCmdBeginRenderingKHR"));
+        g_vulkan.cmd_end_rendering = reinterpret_cast<PFN_vkCmdEndRendering>(
+            vkGetDeviceProcAddr(g_vulkan.device, core13 ? "vkCmdEndRendering" : "vkCmdEndRenderingKHR"));
+        if (!g_vulkan.cmd_begin_rendering || !g_vulkan.cmd_end_rendering) g_vulkan.dynamic_rendering = false;
+    }
+    if (g_vulkan.extended_dynamic_state) {
+        g_vulkan.cmd_set_cull_mode = reinterpret_cast<PFN_vkCmdSetCullMode>(
+            vkGetDeviceProcAddr(g_vulkan.device, core13 ? "vkCmdSetCullMode" : "vkCmdSetCullModeEXT"));
+        g_vulkan.cmd_set_primitive_topology = reinterpret_cast<PFN_vkCmdSetPrimitiveTopology>(
+            vkGetDeviceProcAddr(g_vulkan.device, core13 ? "vkCmdSetPrimitiveTopology" : "vkCmdSetPrimitiveTopologyEXT"));
+        if (!g_vulkan.cmd_set_cull_mode || !g_vulkan.cmd_set_primitive_topology) g_vulkan.extended_dynamic_state = false;
+    }
+    if (g_vulkan.dynamic_blend_enable) {
+        g_vulkan.cmd_set_color_blend_enable = reinterpret_cast<PFN_vkCmdSetColorBlendEnableEXT>(
+            vkGetDeviceProcAddr(g_vulkan.device, "vkCmdSetColorBlendEnableEXT"));
+        if (!g_vulkan.cmd_set_color_blend_enable) g_vulkan.dynamic_blend_enable = false;
+    }
+    if (g_vulkan.timeline_semaphore) {
+        const bool core12 = g_vulkan.api_version >= VK_API_VERSION_1_2;
+        g_vulkan.get_semaphore_counter_value = reinterpret_cast<PFN_vkGetSemaphoreCounterValue>(
+            vkGetDeviceProcAddr(g_vulkan.device, core12 ? "vkGetSemaphoreCounterValue" : "vkGetSemaphoreCounterValueKHR"));
+        g_vulkan.wait_semaphores = reinterpret_cast<PFN_vkWaitSemaphores>(
+            vkGetDeviceProcAddr(g_vulkan.device, core12 ? "vkWaitSemaphores" : "vkWaitSemaphoresKHR"));
+        if (!g_vulkan.get_semaphore_counter_value || !g_vulkan.wait_semaphores) g_vulkan.timeline_semaphore = false;
+    }
+    if (g_vulkan.draw_indirect_count) {
+        g_vulkan.cmd_draw_indexed_indirect_count = reinterpret_cast<PFN_vkCmdDrawIndexedIndirectCount>(
+            vkGetDeviceProcAddr(g_vulkan.device, "vkCmdDrawIndexedIndirectCountKHR"));
+        if (!g_vulkan.cmd_draw_indexed_indirect_count) g_vulkan.draw_indirect_count = false;
+    }
+    LOG("optional features: sync2=%d dynamic_rendering=%d extended_dynamic_state=%d dynamic_blend_enable=%d "
+        "descriptor_indexing=%d (max %u textures) timeline_semaphore=%d "
+        "multi_draw_indirect=%d draw_indirect_first_instance=%d draw_indirect_count=%d memory_budget=%d",
+        (int)g_vulkan.synchronization2, (int)g_vulkan.dynamic_rendering,
+        (int)g_vulkan.extended_dynamic_state, (int)g_vulkan.dynamic_blend_enable,
+        (int)g_vulkan.descriptor_indexing, g_vulkan.max_bindless_textures,
+        (int)g_vulkan.timeline_semaphore,
+        (int)g_vulkan.multi_draw_indirect, (int)g_vulkan.draw_indirect_first_instance,
+        (int)g_vulkan.draw_indirect_count, (int)g_vulkan.memory_budget);
+}
+
 bool platform_init(uint32_t vulkan_version,bool vsync,uint32_t imageCount) {
     if (g_window) return true; // already init
 
@@ -436,24 +693,60 @@ bool platform_init(uint32_t vulkan_version,bool vsync,uint32_t imageCount) {
     // -----------------------
     // Logical device + queue
     // -----------------------
+    {
+        VkPhysicalDeviceProperties device_props{};
+        vkGetPhysicalDeviceProperties(g_vulkan.physical_device, &device_props);
+        g_vulkan.api_version = std::min(vulkan_version, device_props.apiVersion);
+        // plain fixed-size sampler array (no descriptor indexing); refined below on 1.1+
+        g_vulkan.max_bindless_textures = std::min(device_props.limits.maxPerStageDescriptorSampledImages,
+                                                  device_props.limits.maxPerStageDescriptorSamplers);
+    }
+
+    OptionalFeatures features;
+    const bool use_features2 = query_optional_features(features);
+
+    // one queue per distinct family (graphics, present, transfer)
     float qprio = 1.0f;
-    VkDeviceQueueCreateInfo qci{};
-    qci.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-    qci.queueFamilyIndex = g_vulkan.present_family;
-    qci.queueCount = 1;
-    qci.pQueuePriorities = &qprio;
+    std::vector<VkDeviceQueueCreateInfo> qcis;
+    for (uint32_t family : { g_vulkan.graphics_family, g_vulkan.present_family, g_vulkan.transfer_family }) {
+        bool seen = false;
+        for (const auto& q : qcis) seen |= q.queueFamilyIndex == family;
+        if (seen) continue;
+
+        VkDeviceQueueCreateInfo qci{};
+        qci.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+        qci.queueFamilyIndex = family;
+        qci.queueCount = 1;
+        qci.pQueuePriorities = &qprio;
+        qcis.push_back(qci);
+    }
+
+    std::vector<const char*> devExts = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+    devExts.insert(devExts.end(), features.extensions.begin(), features.extensions.end());
 
-    const char* devExts[] = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
     VkDeviceCreateInfo dci{};
     dci.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-    dci.queueCreateInfoCount = 1;
-    dci.pQueueCreateInfos = &qci;
-    dci.enabledExtensionCount = 1;
-    dci.ppEnabledExtensionNames = devExts;
+    dci.pNext = use_features2 ? &features.core : nullptr;
+    VkPhysicalDeviceFeatures core10{};
+    if (!use_features2) {
+        VkPhysicalDeviceFeatures supported{};
+        vkGetPhysicalDeviceFeatures(g_vulkan.physical_device, &supported);
+        keep_core_features(supported, core10);
+        dci.pEnabledFeatures = &core10;
+    }
+    dci.queueCreateInfoCount = static_cast<uint32_t>(qcis.size());
+    dci.pQueueCreateInfos = qcis.data();
+    dci.enabledExtensionCount = static_cast<uint32_t>(devExts.size());
+    dci.ppEnabledExtensionNames = devExts.data();
 
     VK_CHECK(vkCreateDevice(g_vulkan.physical_device, &dci, nullptr, &g_vulkan.device));
+    load_optional_functions();
+    memory_tracker_init(g_vulkan.physical_device);
+    g_jobs.start();
+    LOG("job system: %u workers", g_jobs.worker_count());
     vkGetDeviceQueue(g_vulkan.device, g_vulkan.present_family, 0, &g_vulkan.present_queue);
     vkGetDeviceQueue(g_vulkan.device, g_vulkan.graphics_family, 0, &g_vulkan.graphics_queue);
+    vkGetDeviceQueue(g_vulkan.device, g_vulkan.transfer_family, 0, &g_vulkan.transfer_queue);
 
 
     // --- Create swapchain (SDL3 + Vulkan) ---
@@ -642,6 +935,7 @@ bool platform_init(uint32_t vulkan_version,bool vsync,uint32_t imageCount) {
 
 void platform_shutdown() {
   if (!g_window) return;
+  g_jobs.stop();
   if (g_vulkan.device)     { vkDeviceWaitIdle(g_vulkan.device);}
   if (g_vulkan.swapchain != VK_NULL_HANDLE) {
       for (auto iv : g_vulkan.swapchain_image_views) if (iv) vkDestroyImageView(g_vulkan.device, iv, nullptr);
@@ -656,6 +950,7 @@ void platform_shutdown() {
       glslang::FinalizeProcess();
   }
 
+  memory_tracker_shutdown();
   if (g_vulkan.device)     { vkDestroyDevice(g_vulkan.device, nullptr); g_vulkan.device = VK_NULL_HANDLE; }
   if (g_vulkan.surface)    { SDL_Vulkan_DestroySurface(g_vulkan.instance, g_vulkan.surface, nullptr); g_vulkan.surface = VK_NULL_HANDLE; }
   if (g_vulkan.instance)   { vkDestroyInstance(g_vulkan.instance, nullptr); g_vulkan.instance = VK_NULL_HANDLE; }
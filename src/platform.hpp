@@ -9,6 +9,8 @@
 #include <SDL3/SDL_vulkan.h>
 #include <vulkan/vulkan.h>
 
+#include "input.hpp"
+
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
@@ -29,6 +31,7 @@
 extern SDL_Window* g_window;
 extern int window_w;
 extern int window_h;
+extern MouseInput g_mouse;   // updated by platform_should_quit()
 
 struct VulkanGlobals {
     // Core instance/device objects
@@ -39,10 +42,13 @@ struct VulkanGlobals {
     // Queue family indices
     uint32_t          graphics_family = 0;
     uint32_t          present_family  = 0;
+    uint32_t          transfer_family = 0;     // == graphics_family unless dedicated_transfer
+    bool              dedicated_transfer = false;
 
     // Queues
     VkQueue           graphics_queue  = VK_NULL_HANDLE;
     VkQueue           present_queue   = VK_NULL_HANDLE;
+    VkQueue           transfer_queue  = VK_NULL_HANDLE;  // == graphics_queue unless dedicated_transfer
 
     // Surface
     VkSurfaceKHR      surface         = VK_NULL_HANDLE;
@@ -57,6 +63,29 @@ struct VulkanGlobals {
     // Viewport & scissor (match swapchain extent)
     VkViewport                  viewport{};
     VkRect2D                    scissor{};
+
+    // Optional device features (resolved in platform_init; false/null when unsupported)
+    uint32_t                    api_version           = VK_API_VERSION_1_0; // min(requested, device)
+    bool                        synchronization2      = false;
+    PFN_vkCmdPipelineBarrier2   cmd_pipeline_barrier2 = nullptr;
+    bool                        dynamic_rendering     = false; // VkRenderPass-free rendering
+    PFN_vkCmdBeginRendering     cmd_begin_rendering   = nullptr;
+    PFN_vkCmdEndRendering       cmd_end_rendering     = nullptr;
+    bool                        extended_dynamic_state = false; // cull mode / topology per draw
+    PFN_vkCmdSetCullMode        cmd_set_cull_mode      = nullptr;
+    PFN_vkCmdSetPrimitiveTopology cmd_set_primitive_topology = nullptr;
+    bool                        dynamic_blend_enable   = false; // EXT_extended_dynamic_state3
+    PFN_vkCmdSetColorBlendEnableEXT cmd_set_color_blend_enable = nullptr;
+    bool                        descriptor_indexing    = false; // bindless: update-after-bind + partially bound
+    uint32_t                    max_bindless_textures  = 0;     // sampled images in one update-after-bind set
+    bool                        timeline_semaphore     = false;
+    PFN_vkGetSemaphoreCounterValue get_semaphore_counter_value = nullptr;
+    PFN_vkWaitSemaphores        wait_semaphores        = nullptr;
+    bool                        multi_draw_indirect    = false; // drawCount > 1 in one indirect call
+    bool                        draw_indirect_first_instance = false; // firstInstance != 0 in indirect commands
+    bool                        draw_indirect_count    = false; // KHR_draw_indirect_count: GPU-written draw count
+    PFN_vkCmdDrawIndexedIndirectCount cmd_draw_indexed_indirect_count = nullptr;
+    bool                        memory_budget          = false; // EXT_memory_budget: driver heap usage/budget
 };
 
 
@@ -77,7 +106,7 @@ bool platform_init(uint32_t vulkan_version = VK_API_VERSION_1_0,bool vsync=true,
 // Destroys all resources.
 void platform_shutdown();
 
-// Poll events; returns true if quit requested.
+// Poll events (mouse state lands in g_mouse); returns true if quit requested.
 bool platform_should_quit();
 
 // Human-readable VkResult (minimal)
@@ -1,4 +1,5 @@
 #include "render.hpp"
+#include "render_pipeline.hpp"
 #include "common.hpp"
 
 static void build_color_only_renderpass_and_fbos(
@@ -76,9 +77,25 @@ void RenderTargets::init(
     VkImageLayout       finalLayout,
     VkAttachmentLoadOp  loadOp,
     VkAttachmentStoreOp storeOp,
-    VkImageLayout       initialLayout
+    VkImageLayout       initialLayout,
+    const std::vector<VkImage>& images
 ) {
     shutdown(device);
+    this->extent   = extent;
+    load_op        = loadOp;
+    store_op       = storeOp;
+    initial_layout = initialLayout;
+    final_layout   = finalLayout;
+
+    if (g_vulkan.dynamic_rendering && images.size() == imageViews.size() && !images.empty()) {
+        dynamic      = true;
+        this->images = images;
+        views        = imageViews;
+        color_format = colorFormat;
+        rendering    = render::rendering_info({ &color_format, 1 });
+        return;
+    }
+
     build_color_only_renderpass_and_fbos(
         device, colorFormat, extent, imageViews,
         loadOp, storeOp, initialLayout, finalLayout,
@@ -95,6 +112,57 @@ void RenderTargets::shutdown(VkDevice device) {
         vkDestroyRenderPass(device, render_pass, nullptr);
         render_pass = VK_NULL_HANDLE;
     }
+
+    dynamic = false;
+    images.clear();
+    views.clear();
+    color_format = VK_FORMAT_UNDEFINED;
+    rendering    = {};
+}
+
+void RenderTargets::begin(VkCommandBuffer cb, uint32_t index, std::span<const VkClearValue> clears) const {
+    if (!dynamic) {
+        DEBUG_ASSERT(index < framebuffers.size());
+        auto rpbi = render::render_pass_begin_info(render_pass, framebuffers[index], extent, clears);
+        vkCmdBeginRenderPass(cb, &rpbi, VK_SUBPASS_CONTENTS_INLINE);
+        render::cmd_set_viewport_scissor(cb, extent);
+        return;
+    }
+
+    DEBUG_ASSERT(index < views.size());
+    const bool load = load_op == VK_ATTACHMENT_LOAD_OP_LOAD;
+
+    // same scope as the render pass path's external dependency: chains with
+    // the acquire semaphore wait at COLOR_ATTACHMENT_OUTPUT
+    VkImageMemoryBarrier2 to_attachment = render::image_barrier2(images[index],
+        load ? initial_layout : VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+        VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, 0,
+        VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+        VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT | (load ? VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT : 0));
+    render::cmd_barriers(cb, { &to_attachment, 1 });
+
+    VkRenderingAttachmentInfo color = render::rendering_attachment(
+        views[index], VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+        load_op, store_op, clears.empty() ? VkClearValue{} : clears[0]);
+    VkRenderingInfo ri = render::begin_rendering_info(extent, { &color, 1 });
+    g_vulkan.cmd_begin_rendering(cb, &ri);
+    render::cmd_set_viewport_scissor(cb, extent);
+}
+
+void RenderTargets::end(VkCommandBuffer cb, uint32_t index) const {
+    if (!dynamic) {
+        vkCmdEndRenderPass(cb);
+        return;
+    }
+
+    g_vulkan.cmd_end_rendering(cb);
+    if (final_layout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL) return;
+
+    VkImageMemoryBarrier2 to_final = render::image_barrier2(images[index],
+        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, final_layout,
+        VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+        VK_PIPELINE_STAGE_2_NONE, 0);
+    render::cmd_barriers(cb, { &to_final, 1 });
 }
 
 // --- CommandResources ---
@@ -170,7 +238,10 @@ VkResult FrameSync::submit_one(
         uint32_t imageIndex,
         const CommandResources& cmd,
         VkPipelineStageFlags waitDstStage,
-        VkFence fence
+        VkFence fence,
+        VkSemaphore timeline,
+        uint64_t timelineValue,
+        VkPipelineStageFlags timelineStage
 ) const{
     DEBUG_ASSERT(imageIndex < cmd.buffers.size());
     DEBUG_ASSERT(image_available != VK_NULL_HANDLE);
@@ -180,13 +251,23 @@ VkResult FrameSync::submit_one(
         fence = in_flight_fence;
     }
 
-    VkPipelineStageFlags stageMask = waitDstStage; // must outlive submit struct
+    // must outlive submit struct
+    const VkSemaphore          waits[2]      = { image_available, timeline };
+    const VkPipelineStageFlags stageMasks[2] = { waitDstStage, timelineStage };
+    const uint64_t             waitValues[2] = { 0, timelineValue }; // binary entry ignored
+    const uint32_t             waitCount     = timeline ? 2u : 1u;
+
+    VkTimelineSemaphoreSubmitInfo ts{};
+    ts.sType                   = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    ts.waitSemaphoreValueCount = waitCount;
+    ts.pWaitSemaphoreValues    = waitValues;
 
     VkSubmitInfo submit{};
     submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submit.waitSemaphoreCount   = 1;
-    submit.pWaitSemaphores      = &image_available;
-    submit.pWaitDstStageMask    = &stageMask;
+    submit.pNext                = timeline ? &ts : nullptr;
+    submit.waitSemaphoreCount   = waitCount;
+    submit.pWaitSemaphores      = waits;
+    submit.pWaitDstStageMask    = stageMasks;
     submit.commandBufferCount   = 1;
     submit.pCommandBuffers      = &cmd.buffers[imageIndex];
     submit.signalSemaphoreCount = 1;
@@ -3,11 +3,36 @@
 
 #include <platform.hpp>
 #include <vector>
+#include <span>
 
+// Color-only targets for a set of swapchain-like images. With
+// g_vulkan.dynamic_rendering (and the images passed in) no VkRenderPass or
+// framebuffers are created at all; begin()/end() hide which path is in use.
 struct RenderTargets {
+    // 'rendering' points into the object itself, so a copy would keep a
+    // pointer into the original: not copyable or movable.
+    RenderTargets() = default;
+    RenderTargets(const RenderTargets&)            = delete;
+    RenderTargets& operator=(const RenderTargets&) = delete;
+
     VkRenderPass                render_pass = VK_NULL_HANDLE;
     std::vector<VkFramebuffer>  framebuffers;
 
+    // dynamic rendering path
+    bool                          dynamic = false;
+    std::vector<VkImage>          images;
+    std::vector<VkImageView>      views;
+    VkFormat                      color_format   = VK_FORMAT_UNDEFINED;
+    VkPipelineRenderingCreateInfo rendering{};   // points at color_format
+
+    VkExtent2D          extent        = {};
+    VkAttachmentLoadOp  load_op       = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    VkAttachmentStoreOp store_op      = VK_ATTACHMENT_STORE_OP_STORE;
+    VkImageLayout       initial_layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    VkImageLayout       final_layout   = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+    // 'images' are only needed for the dynamic path (it does its own layout
+    // transitions); leave empty to force the VkRenderPass path.
     void init(
         VkDevice device,
         VkFormat colorFormat,
@@ -16,11 +41,25 @@ struct RenderTargets {
         VkImageLayout       finalLayout   = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
         VkAttachmentLoadOp  loadOp        = VK_ATTACHMENT_LOAD_OP_CLEAR,
         VkAttachmentStoreOp storeOp       = VK_ATTACHMENT_STORE_OP_STORE,
-        VkImageLayout       initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+        VkImageLayout       initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+        const std::vector<VkImage>& images = {}
     );
 
     void shutdown(VkDevice device);
-    bool valid() const { return render_pass != VK_NULL_HANDLE; }
+    bool valid() const { return render_pass != VK_NULL_HANDLE || dynamic; }
+    uint32_t image_count() const {
+        return static_cast<uint32_t>(dynamic ? views.size() : framebuffers.size());
+    }
+
+    // Chain into pipeline creation (with render_pass); nullptr on the render pass path.
+    const VkPipelineRenderingCreateInfo* pipeline_rendering() const {
+        return dynamic ? &rendering : nullptr;
+    }
+
+    // Begin/end rendering into image 'index' (vkCmdBeginRenderPass or vkCmdBeginRendering).
+    // begin() also sets a full-extent dynamic viewport/scissor.
+    void begin(VkCommandBuffer cb, uint32_t index, std::span<const VkClearValue> clears) const;
+    void end(VkCommandBuffer cb, uint32_t index) const;
 };
 
 struct CommandResources {
@@ -63,12 +102,17 @@ struct FrameSync {
 
     // Submit this->buffers[imageIndex] with the standard “imageAvailable -> draw -> renderFinished” chain.
     // If fence == VK_NULL_HANDLE, uses in_flight_fence by default.
+    // An optional timeline semaphore (e.g. from UploadQueue::acquire) is waited
+    // on at timelineStage until it reaches timelineValue.
     VkResult submit_one(
         VkQueue queue,
         uint32_t imageIndex,
         const CommandResources& cmd,
         VkPipelineStageFlags waitDstStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-        VkFence fence = VK_NULL_HANDLE
+        VkFence fence = VK_NULL_HANDLE,
+        VkSemaphore timeline = VK_NULL_HANDLE,
+        uint64_t timelineValue = 0,
+        VkPipelineStageFlags timelineStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT
     ) const;
 };
 
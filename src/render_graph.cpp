@@ -0,0 +1,698 @@
+#include "render_graph.hpp"
+#include "common.hpp"
+#include "memory_tracker.hpp"
+
+#include <algorithm>
+
+// -----------------------------
+// access tables (internal)
+// -----------------------------
+
+static bool is_write(RGAccess a) {
+    switch (a) {
+        case RGAccess::ColorAttachment:
+        case RGAccess::DepthAttachment:
+        case RGAccess::StorageWrite:
+        case RGAccess::TransferDst:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool is_attachment(RGAccess a) {
+    return a == RGAccess::ColorAttachment || a == RGAccess::DepthAttachment;
+}
+
+static VkImageLayout layout_for(RGAccess a) {
+    switch (a) {
+        case RGAccess::ColorAttachment: return VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        case RGAccess::DepthAttachment: return VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        case RGAccess::Sampled:         return VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        case RGAccess::StorageRead:
+        case RGAccess::StorageWrite:    return VK_IMAGE_LAYOUT_GENERAL;
+        case RGAccess::TransferSrc:     return VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        case RGAccess::TransferDst:     return VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    }
+    return VK_IMAGE_LAYOUT_UNDEFINED;
+}
+
+static VkAccessFlags2 access_for(RGAccess a, VkAttachmentLoadOp load) {
+    switch (a) {
+        case RGAccess::ColorAttachment:
+            return VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT |
+                   (load == VK_ATTACHMENT_LOAD_OP_LOAD ? VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT : 0);
+        case RGAccess::DepthAttachment:
+            return VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+                   VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+        case RGAccess::Sampled:      return VK_ACCESS_2_SHADER_SAMPLED_READ_BIT;
+        case RGAccess::StorageRead:  return VK_ACCESS_2_SHADER_STORAGE_READ_BIT;
+        case RGAccess::StorageWrite: return VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT | VK_ACCESS_2_SHADER_STORAGE_READ_BIT;
+        case RGAccess::TransferSrc:  return VK_ACCESS_2_TRANSFER_READ_BIT;
+        case RGAccess::TransferDst:  return VK_ACCESS_2_TRANSFER_WRITE_BIT;
+    }
+    return 0;
+}
+
+static VkImageUsageFlags usage_for(RGAccess a) {
+    switch (a) {
+        case RGAccess::ColorAttachment: return VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        case RGAccess::DepthAttachment: return VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+        case RGAccess::Sampled:         return VK_IMAGE_USAGE_SAMPLED_BIT;
+        case RGAccess::StorageRead:
+        case RGAccess::StorageWrite:    return VK_IMAGE_USAGE_STORAGE_BIT;
+        case RGAccess::TransferSrc:     return VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        case RGAccess::TransferDst:     return VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    }
+    return 0;
+}
+
+// -----------------------------
+// builder
+// -----------------------------
+
+RGPassBuilder& RGPassBuilder::use_(RGHandle h, RGAccess a, VkPipelineStageFlags2 stages,
+                                   VkAttachmentLoadOp load, VkClearValue clear) {
+    DEBUG_ASSERT(h < m_graph->m_res.size());
+    auto& uses = m_graph->m_passes[m_pass].uses;
+#ifndef NDEBUG
+    for (const auto& u : uses) DEBUG_ASSERT(u.res != h && "a pass may use each image once");
+#endif
+    uses.push_back({h, a, stages, load, clear});
+    return *this;
+}
+
+RGPassBuilder& RGPassBuilder::color(RGHandle h, VkAttachmentLoadOp load, VkClearColorValue clear) {
+    VkClearValue cv{}; cv.color = clear;
+    return use_(h, RGAccess::ColorAttachment, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, load, cv);
+}
+
+RGPassBuilder& RGPassBuilder::depth(RGHandle h, VkAttachmentLoadOp load, float clear_depth) {
+    VkClearValue cv{}; cv.depthStencil = {clear_depth, 0};
+    return use_(h, RGAccess::DepthAttachment,
+                VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+                load, cv);
+}
+
+RGPassBuilder& RGPassBuilder::sampled(RGHandle h, VkPipelineStageFlags2 stages) {
+    return use_(h, RGAccess::Sampled, stages);
+}
+RGPassBuilder& RGPassBuilder::storage_read(RGHandle h, VkPipelineStageFlags2 stages) {
+    return use_(h, RGAccess::StorageRead, stages);
+}
+RGPassBuilder& RGPassBuilder::storage_write(RGHandle h, VkPipelineStageFlags2 stages) {
+    return use_(h, RGAccess::StorageWrite, stages);
+}
+RGPassBuilder& RGPassBuilder::transfer_src(RGHandle h) {
+    return use_(h, RGAccess::TransferSrc, VK_PIPELINE_STAGE_2_TRANSFER_BIT);
+}
+RGPassBuilder& RGPassBuilder::transfer_dst(RGHandle h) {
+    return use_(h, RGAccess::TransferDst, VK_PIPELINE_STAGE_2_TRANSFER_BIT);
+}
+RGPassBuilder& RGPassBuilder::side_effect() {
+    m_graph->m_passes[m_pass].side_effect = true;
+    return *this;
+}
+
+// -----------------------------
+// declaration
+// -----------------------------
+
+RGHandle RenderGraph::import_image(const char* name, VkFormat format, VkExtent2D extent,
+                                   VkImageLayout final_layout, VkImageLayout initial_layout) {
+    Resource r{};
+    r.name           = name;
+    r.desc.format    = format;
+    r.desc.extent    = extent;
+    r.imported       = true;
+    r.initial_layout = initial_layout;
+    r.final_layout   = final_layout;
+    m_res.push_back(std::move(r));
+    return static_cast<RGHandle>(m_res.size() - 1);
+}
+
+RGHandle RenderGraph::create_transient(const char* name, const RGImageDesc& desc) {
+    Resource r{};
+    r.name = name;
+    r.desc = desc;
+    m_res.push_back(std::move(r));
+    return static_cast<RGHandle>(m_res.size() - 1);
+}
+
+RGPassBuilder RenderGraph::add_pass(const char* name, RGRecordFn record) {
+    Pass p{};
+    p.name   = name;
+    p.record = std::move(record);
+    m_passes.push_back(std::move(p));
+    return RGPassBuilder(this, static_cast<uint32_t>(m_passes.size() - 1));
+}
+
+void RenderGraph::bind_imported(RGHandle h, VkImage image, VkImageView view) {
+    DEBUG_ASSERT(h < m_res.size() && m_res[h].imported);
+    m_res[h].image = image;
+    m_res[h].view  = view;
+}
+
+// -----------------------------
+// compile
+// -----------------------------
+
+// Passes can only depend on earlier declarations, so any order that respects
+// those edges is valid. Live passes are kept alive by side effects or by
+// writing an imported image, and keep alive whoever produced what they read.
+void RenderGraph::order_and_cull_() {
+    const uint32_t n = static_cast<uint32_t>(m_passes.size());
+
+    // producers[i] = passes whose writes pass i consumes (RAW / WAW)
+    // after[i]     = every pass that must run before pass i (adds WAR)
+    std::vector<std::vector<uint32_t>> producers(n), after(n);
+    std::vector<uint32_t>              last_writer(m_res.size(), UINT32_MAX);
+    std::vector<std::vector<uint32_t>> readers(m_res.size());
+
+    for (uint32_t i = 0; i < n; ++i) {
+        for (const Use& u : m_passes[i].uses) {
+            const uint32_t w = last_writer[u.res];
+            // only attachments that clear/discard fully replace the previous contents
+            const bool keeps_contents = !is_attachment(u.access) || u.load == VK_ATTACHMENT_LOAD_OP_LOAD;
+            if (w != UINT32_MAX) {
+                after[i].push_back(w);
+                if (keeps_contents) producers[i].push_back(w);
+            }
+            if (is_write(u.access)) {
+                for (uint32_t r : readers[u.res]) if (r != i) after[i].push_back(r);
+                readers[u.res].clear();
+                last_writer[u.res] = i;
+            } else {
+                readers[u.res].push_back(i);
+            }
+        }
+    }
+
+    std::vector<bool> alive(n, false);
+    for (uint32_t i = 0; i < n; ++i) {
+        if (m_passes[i].side_effect) alive[i] = true;
+        for (const Use& u : m_passes[i].uses)
+            if (is_write(u.access) && m_res[u.res].imported) alive[i] = true;
+    }
+    for (uint32_t i = n; i-- > 0;) {
+        if (!alive[i]) continue;
+        for (uint32_t p : producers[i]) alive[p] = true;
+    }
+
+    // Kahn over live passes. Among ready passes prefer one that does not
+    // depend on the pass we just scheduled, so producer/consumer pairs get
+    // independent work between them instead of a back-to-back barrier stall.
+    std::vector<uint32_t> pending(n, 0);
+    std::vector<std::vector<uint32_t>> users(n);
+    for (uint32_t i = 0; i < n; ++i) {
+        if (!alive[i]) continue;
+        std::sort(after[i].begin(), after[i].end());
+        after[i].erase(std::unique(after[i].begin(), after[i].end()), after[i].end());
+        for (uint32_t d : after[i]) {
+            if (!alive[d]) continue;
+            pending[i]++;
+            users[d].push_back(i);
+        }
+    }
+
+    std::vector<uint32_t> ready;
+    for (uint32_t i = 0; i < n; ++i)
+        if (alive[i] && pending[i] == 0) ready.push_back(i);
+
+    m_order.clear();
+    uint32_t prev = UINT32_MAX;
+    while (!ready.empty()) {
+        size_t pick = 0;
+        if (prev != UINT32_MAX) {
+            for (size_t k = 0; k < ready.size(); ++k) {
+                if (!vec_contains(after[ready[k]], prev)) { pick = k; break; }
+            }
+        }
+        const uint32_t p = ready[pick];
+        ready.erase(ready.begin() + pick);
+        m_order.push_back(p);
+        prev = p;
+
+        for (uint32_t u : users[p]) {
+            if (--pending[u] == 0) {
+                // keep 'ready' in declaration order so ties stay stable
+                ready.insert(std::upper_bound(ready.begin(), ready.end(), u), u);
+            }
+        }
+    }
+}
+
+std::vector<RGHandle> RenderGraph::live_transients_() {
+    for (uint32_t pos = 0; pos < m_order.size(); ++pos) {
+        for (const Use& u : m_passes[m_order[pos]].uses) {
+            Resource& r = m_res[u.res];
+            r.first = std::min(r.first, pos);
+            r.last  = std::max(r.last, pos);
+        }
+    }
+    std::vector<RGHandle> transients;
+    for (RGHandle h = 0; h < m_res.size(); ++h)
+        if (!m_res[h].imported && m_res[h].first != UINT32_MAX) transients.push_back(h);
+    return transients;
+}
+
+// Biggest first; each image takes the lowest offset in its memory type's
+// block where nothing it overlaps is alive at the same time.
+void RenderGraph::place_transients_(std::vector<RGHandle> transients, const std::vector<RGMemoryReq>& reqs) {
+    struct Placed { RGHandle res; VkDeviceSize offset, size; };
+    std::vector<std::vector<Placed>> placed; // per block
+
+    std::stable_sort(transients.begin(), transients.end(), [&](RGHandle a, RGHandle b) {
+        return reqs[a].size > reqs[b].size;
+    });
+
+    for (RGHandle h : transients) {
+        Resource& r = m_res[h];
+        const RGMemoryReq& mr = reqs[h];
+
+        uint32_t b = 0;
+        while (b < m_blocks.size() && m_blocks[b].type != mr.type) ++b;
+        if (b == m_blocks.size()) { m_blocks.push_back({VK_NULL_HANDLE, mr.type, 0}); placed.emplace_back(); }
+
+        auto conflicts = [&](VkDeviceSize off) {
+            for (const Placed& p : placed[b]) {
+                const Resource& o = m_res[p.res];
+                const bool mem_overlap  = off < p.offset + p.size && p.offset < off + mr.size;
+                const bool time_overlap = r.first <= o.last && o.first <= r.last;
+                if (mem_overlap && time_overlap) return true;
+            }
+            return false;
+        };
+
+        VkDeviceSize best = align_up(m_blocks[b].size, mr.alignment);
+        if (!conflicts(0)) best = 0;
+        else {
+            for (const Placed& p : placed[b]) {
+                VkDeviceSize cand = align_up(p.offset + p.size, mr.alignment);
+                if (cand < best && !conflicts(cand)) best = cand;
+            }
+        }
+
+        r.block  = b;
+        r.offset = best;
+        r.size   = mr.size;
+        placed[b].push_back({h, best, mr.size});
+        m_blocks[b].size = std::max(m_blocks[b].size, best + mr.size);
+    }
+
+    m_transient_bytes = 0;
+    for (const Block& blk : m_blocks) m_transient_bytes += blk.size;
+}
+
+VkResult RenderGraph::allocate_transients_(VkDevice device, VkPhysicalDevice phys) {
+    const std::vector<RGHandle> transients = live_transients_();
+
+    std::vector<VkImageUsageFlags> usage(m_res.size(), 0);
+    for (uint32_t idx : m_order)
+        for (const Use& u : m_passes[idx].uses) usage[u.res] |= usage_for(u.access);
+
+    std::vector<RGMemoryReq> reqs(m_res.size());
+    for (RGHandle h : transients) {
+        Resource& r = m_res[h];
+        VkImageCreateInfo ici{};
+        ici.sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        ici.imageType     = VK_IMAGE_TYPE_2D;
+        ici.format        = r.desc.format;
+        ici.extent        = { r.desc.extent.width, r.desc.extent.height, 1 };
+        ici.mipLevels     = 1;
+        ici.arrayLayers   = 1;
+        ici.samples       = r.desc.samples;
+        ici.tiling        = VK_IMAGE_TILING_OPTIMAL;
+        ici.usage         = usage[h] | r.desc.extra_usage;
+        ici.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
+        ici.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        if (auto e = vkCreateImage(device, &ici, nullptr, &r.image)) return e;
+
+        VkMemoryRequirements mr{};
+        vkGetImageMemoryRequirements(device, r.image, &mr);
+        uint32_t type = render::find_mem_type(phys, mr.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        if (type == UINT32_MAX) type = render::find_mem_type(phys, mr.memoryTypeBits, 0);
+        if (type == UINT32_MAX) return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+        reqs[h] = { mr.size, mr.alignment, type };
+    }
+
+    place_transients_(transients, reqs);
+
+    for (Block& blk : m_blocks) {
+        VkMemoryAllocateInfo ai{};
+        ai.sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        ai.allocationSize  = blk.size;
+        ai.memoryTypeIndex = blk.type;
+        if (auto e = tracked_allocate(device, ai, &blk.memory, MemoryCategory::RenderTarget)) return e;
+    }
+
+    for (RGHandle h : transients) {
+        Resource& r = m_res[h];
+        if (auto e = vkBindImageMemory(device, r.image, m_blocks[r.block].memory, r.offset)) return e;
+
+        VkImageViewCreateInfo iv{};
+        iv.sType    = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        iv.image    = r.image;
+        iv.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        iv.format   = r.desc.format;
+        iv.components = {
+            VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY,
+            VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY
+        };
+        iv.subresourceRange.aspectMask     = render::aspect_for_format(r.desc.format);
+        iv.subresourceRange.baseMipLevel   = 0;
+        iv.subresourceRange.levelCount     = 1;
+        iv.subresourceRange.baseArrayLayer = 0;
+        iv.subresourceRange.layerCount     = 1;
+        if (auto e = vkCreateImageView(device, &iv, nullptr, &r.view)) return e;
+    }
+
+    LOG("render graph: %zu live passes, %zu transients in %zu blocks (%llu bytes)",
+        m_order.size(), transients.size(), m_blocks.size(), (unsigned long long)m_transient_bytes);
+    return VK_SUCCESS;
+}
+
+// Tracks, per image, the last write and which stages have already been made
+// to see it, so read-after-read never barriers and a second reader in a new
+// stage only gets the execution/memory dependency it is missing.
+void RenderGraph::build_barriers_() {
+    struct State {
+        VkImageLayout         layout       = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkPipelineStageFlags2 write_stage  = VK_PIPELINE_STAGE_2_NONE;
+        VkAccessFlags2        write_access = 0;
+        VkPipelineStageFlags2 read_stages  = VK_PIPELINE_STAGE_2_NONE; // since last write (WAR)
+        VkPipelineStageFlags2 synced       = VK_PIPELINE_STAGE_2_NONE; // already see last write
+    };
+    std::vector<State> st(m_res.size());
+
+    // Last use of each image: transients inherit it from whatever occupied
+    // their memory before (or themselves, one frame ago).
+    std::vector<VkPipelineStageFlags2> last_stage(m_res.size(), VK_PIPELINE_STAGE_2_NONE);
+    std::vector<VkAccessFlags2>        last_write(m_res.size(), 0);
+    for (uint32_t pos = 0; pos < m_order.size(); ++pos) {
+        for (const Use& u : m_passes[m_order[pos]].uses) {
+            if (pos != m_res[u.res].last) continue;
+            last_stage[u.res] = u.stages;
+            last_write[u.res] = is_write(u.access) ? access_for(u.access, u.load) : 0;
+        }
+    }
+
+    for (RGHandle h = 0; h < m_res.size(); ++h) {
+        const Resource& r = m_res[h];
+        State& s = st[h];
+        if (r.imported) {
+            // we don't know who touched it last (present engine, uploads, a
+            // previous frame's compute): order against everything and make
+            // any earlier write available, which also chains with acquire waits.
+            s.layout       = r.initial_layout;
+            s.write_stage  = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+            s.write_access = VK_ACCESS_2_MEMORY_WRITE_BIT;
+            continue;
+        }
+        if (r.block == UINT32_MAX) continue;
+        for (RGHandle o = 0; o < m_res.size(); ++o) {
+            const Resource& other = m_res[o];
+            if (other.imported || other.block != r.block) continue;
+            if (other.offset >= r.offset + r.size || r.offset >= other.offset + other.size) continue;
+            s.write_stage  |= last_stage[o];
+            s.write_access |= last_write[o];
+        }
+    }
+
+    for (uint32_t pos = 0; pos < m_order.size(); ++pos) {
+        Pass& p = m_passes[m_order[pos]];
+        p.barriers.clear();
+
+        for (const Use& u : p.uses) {
+            State& s = st[u.res];
+            const VkImageLayout  layout = layout_for(u.access);
+            const VkAccessFlags2 access = access_for(u.access, u.load);
+            const bool discard = is_attachment(u.access) && u.load != VK_ATTACHMENT_LOAD_OP_LOAD;
+
+            if (is_write(u.access)) {
+                const VkPipelineStageFlags2 prior = s.write_stage | s.read_stages;
+                if (prior != VK_PIPELINE_STAGE_2_NONE || s.layout != layout) {
+                    p.barriers.push_back({u.res,
+                        discard ? VK_IMAGE_LAYOUT_UNDEFINED : s.layout, layout,
+                        prior, u.stages, s.write_access, access});
+                }
+                s.layout       = layout;
+                s.write_stage  = u.stages;
+                s.write_access = access;
+                s.read_stages  = VK_PIPELINE_STAGE_2_NONE;
+                s.synced       = VK_PIPELINE_STAGE_2_NONE;
+            } else if (s.layout != layout) {
+                p.barriers.push_back({u.res, s.layout, layout,
+                    s.write_stage | s.read_stages, u.stages, s.write_access, access});
+                // the transition itself is a write the next readers must chain onto
+                s.layout       = layout;
+                s.write_stage |= s.read_stages | u.stages;
+                s.read_stages |= u.stages;
+                s.synced       = u.stages;
+            } else {
+                const VkPipelineStageFlags2 missing = u.stages & ~s.synced;
+                if (missing && s.write_stage != VK_PIPELINE_STAGE_2_NONE) {
+                    p.barriers.push_back({u.res, layout, layout,
+                        s.write_stage, u.stages, s.write_access, access});
+                }
+                s.synced      |= u.stages;
+                s.read_stages |= u.stages;
+            }
+        }
+    }
+
+    m_final.clear();
+    for (RGHandle h = 0; h < m_res.size(); ++h) {
+        const Resource& r = m_res[h];
+        if (!r.imported || r.final_layout == VK_IMAGE_LAYOUT_UNDEFINED) continue;
+        const State& s = st[h];
+        if (r.first == UINT32_MAX || s.layout == r.final_layout) continue;
+        m_final.push_back({h, s.layout, r.final_layout,
+            s.write_stage | s.read_stages, VK_PIPELINE_STAGE_2_NONE, s.write_access, 0});
+    }
+}
+
+VkResult RenderGraph::build_render_passes_(VkDevice device) {
+    for (uint32_t pos = 0; pos < m_order.size(); ++pos) {
+        Pass& p = m_passes[m_order[pos]];
+        p.attachments.clear();
+        p.clears.clear();
+        p.color_formats.clear();
+
+        std::vector<VkAttachmentDescription>& descs = p.descs;
+        descs.clear();
+        std::vector<VkAttachmentReference>   color_refs;
+        VkAttachmentReference                depth_ref{};
+        bool                                 has_depth = false;
+
+        // colors first, then the (single) depth attachment
+        for (int pass_depth = 0; pass_depth < 2; ++pass_depth) {
+            for (const Use& u : p.uses) {
+                const bool want = pass_depth ? u.access == RGAccess::DepthAttachment
+                                             : u.access == RGAccess::ColorAttachment;
+                if (!want) continue;
+                const Resource& r = m_res[u.res];
+
+                // nobody reads a transient after its last pass: let tilers drop it
+                const bool keep = r.imported || r.last != pos;
+
+                VkAttachmentDescription d{};
+                d.format         = r.desc.format;
+                d.samples        = r.desc.samples;
+                d.loadOp         = u.load;
+                d.storeOp        = keep ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+                d.stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+                d.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+                d.initialLayout  = layout_for(u.access);
+                d.finalLayout    = layout_for(u.access);
+
+                VkAttachmentReference ref{ static_cast<uint32_t>(descs.size()), layout_for(u.access) };
+                if (pass_depth) { DEBUG_ASSERT(!has_depth); depth_ref = ref; has_depth = true; }
+                else            { color_refs.push_back(ref); p.color_formats.push_back(r.desc.format); }
+
+                descs.push_back(d);
+                p.attachments.push_back(u.res);
+                p.clears.push_back(u.clear);
+
+                if (p.extent.width == 0) p.extent = r.desc.extent;
+                DEBUG_ASSERT(p.extent.width == r.desc.extent.width &&
+                             p.extent.height == r.desc.extent.height &&
+                             "attachments of one pass must share an extent");
+            }
+        }
+        if (descs.empty()) continue;
+
+        if (g_vulkan.dynamic_rendering) {
+            p.dynamic   = true;
+            p.rendering = render::rendering_info(p.color_formats,
+                has_depth ? descs.back().format : VK_FORMAT_UNDEFINED);
+            continue;
+        }
+
+        VkSubpassDescription sub{};
+        sub.pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        sub.colorAttachmentCount    = static_cast<uint32_t>(color_refs.size());
+        sub.pColorAttachments       = color_refs.data();
+        sub.pDepthStencilAttachment = has_depth ? &depth_ref : nullptr;
+
+        // layouts/hazards are handled by our own barriers before the pass
+        VkRenderPassCreateInfo rp{};
+        rp.sType           = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+        rp.attachmentCount = static_cast<uint32_t>(descs.size());
+        rp.pAttachments    = descs.data();
+        rp.subpassCount    = 1;
+        rp.pSubpasses      = &sub;
+
+        if (auto e = vkCreateRenderPass(device, &rp, nullptr, &p.render_pass)) return e;
+    }
+    return VK_SUCCESS;
+}
+
+VkResult RenderGraph::compile(VkDevice device, VkPhysicalDevice phys) {
+    release_compiled_(device);
+    m_device = device;
+
+    order_and_cull_();
+    if (auto e = allocate_transients_(device, phys)) return e;
+    build_barriers_();
+    return build_render_passes_(device);
+}
+
+void RenderGraph::plan(const std::function<RGMemoryReq(RGHandle)>& req) {
+    release_compiled_(m_device);
+
+    order_and_cull_();
+    std::vector<RGHandle>    transients = live_transients_();
+    std::vector<RGMemoryReq> reqs(m_res.size());
+    for (RGHandle h : transients) reqs[h] = req(h);
+    place_transients_(std::move(transients), reqs);
+    build_barriers_();
+}
+
+// -----------------------------
+// execute
+// -----------------------------
+
+VkFramebuffer RenderGraph::framebuffer_for_(uint32_t pass) {
+    const Pass& p = m_passes[pass];
+
+    std::vector<VkImageView> views;
+    views.reserve(p.attachments.size());
+    for (RGHandle h : p.attachments) views.push_back(m_res[h].view);
+
+    for (const FramebufferEntry& e : m_fbs)
+        if (e.pass == pass && e.views == views) return e.fb;
+
+    VkFramebufferCreateInfo fb{};
+    fb.sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    fb.renderPass      = p.render_pass;
+    fb.attachmentCount = static_cast<uint32_t>(views.size());
+    fb.pAttachments    = views.data();
+    fb.width           = p.extent.width;
+    fb.height          = p.extent.height;
+    fb.layers          = 1;
+
+    VkFramebuffer out = VK_NULL_HANDLE;
+    VK_CHECK(vkCreateFramebuffer(m_device, &fb, nullptr, &out));
+    m_fbs.push_back({pass, std::move(views), out});
+    return out;
+}
+
+void RenderGraph::execute(VkCommandBuffer cb) {
+    auto flush = [&](const std::vector<Barrier>& list) {
+        m_scratch.clear();
+        for (const Barrier& b : list) {
+            const Resource& r = m_res[b.res];
+            DEBUG_ASSERT(r.image != VK_NULL_HANDLE && "imported image not bound this frame");
+            m_scratch.push_back(render::image_barrier2(r.image,
+                b.old_layout, b.new_layout,
+                b.src_stage, b.src_access,
+                b.dst_stage, b.dst_access,
+                render::aspect_for_format(r.desc.format)));
+        }
+        render::cmd_barriers(cb, m_scratch);
+    };
+
+    for (uint32_t idx : m_order) {
+        Pass& p = m_passes[idx];
+        flush(p.barriers);
+
+        if (p.dynamic) {
+            m_scratch_att.clear();
+            for (size_t a = 0; a < p.attachments.size(); ++a) {
+                const VkAttachmentDescription& d = p.descs[a];
+                m_scratch_att.push_back(render::rendering_attachment(
+                    m_res[p.attachments[a]].view, d.initialLayout, d.loadOp, d.storeOp, p.clears[a]));
+            }
+            const size_t colors = p.color_formats.size();
+            VkRenderingInfo ri = render::begin_rendering_info(p.extent,
+                { m_scratch_att.data(), colors },
+                m_scratch_att.size() > colors ? &m_scratch_att[colors] : nullptr);
+            g_vulkan.cmd_begin_rendering(cb, &ri);
+            render::cmd_set_viewport_scissor(cb, p.extent);
+            if (p.record) p.record(cb, *this);
+            g_vulkan.cmd_end_rendering(cb);
+        } else if (p.render_pass) {
+            auto rpbi = render::render_pass_begin_info(
+                p.render_pass, framebuffer_for_(idx), p.extent, p.clears);
+            vkCmdBeginRenderPass(cb, &rpbi, VK_SUBPASS_CONTENTS_INLINE);
+            render::cmd_set_viewport_scissor(cb, p.extent);
+            if (p.record) p.record(cb, *this);
+            vkCmdEndRenderPass(cb);
+        } else if (p.record) {
+            p.record(cb, *this);
+        }
+    }
+
+    flush(m_final);
+}
+
+// -----------------------------
+// cleanup
+// -----------------------------
+
+void RenderGraph::release_compiled_(VkDevice device) {
+    for (FramebufferEntry& e : m_fbs) vkDestroyFramebuffer(device, e.fb, nullptr);
+    m_fbs.clear();
+
+    for (Pass& p : m_passes) {
+        if (p.render_pass) vkDestroyRenderPass(device, p.render_pass, nullptr);
+        p.render_pass = VK_NULL_HANDLE;
+        p.barriers.clear();
+        p.attachments.clear();
+        p.descs.clear();
+        p.clears.clear();
+        p.extent = {};
+        p.dynamic = false;
+        p.color_formats.clear();
+        p.rendering = {};
+    }
+
+    for (Resource& r : m_res) {
+        if (!r.imported) {
+            if (r.view)  vkDestroyImageView(device, r.view, nullptr);
+            if (r.image) vkDestroyImage(device, r.image, nullptr);
+            r.view  = VK_NULL_HANDLE;
+            r.image = VK_NULL_HANDLE;
+        }
+        r.first  = UINT32_MAX;
+        r.last   = 0;
+        r.block  = UINT32_MAX;
+        r.offset = 0;
+        r.size   = 0;
+    }
+
+    for (Block& b : m_blocks) if (b.memory) tracked_free(device, b.memory);
+    m_blocks.clear();
+
+    m_order.clear();
+    m_final.clear();
+    m_transient_bytes = 0;
+}
+
+void RenderGraph::destroy(VkDevice device) {
+    release_compiled_(device);
+    m_res.clear();
+    m_passes.clear();
+    m_device = VK_NULL_HANDLE;
+}
@@ -0,0 +1,234 @@
+#ifndef RENDER_GRAPH_HPP
+#define RENDER_GRAPH_HPP
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "platform.hpp"
+#include "render_pipeline.hpp"
+
+// A small frame graph: passes declare which images they read and write, the
+// graph orders them, drops passes nobody consumes, derives the minimal set of
+// barriers between them and packs transient images into shared memory.
+//
+// Typical frame:
+//   auto scene = g.create_transient("scene", {fmt, extent});
+//   auto back  = g.import_image("swapchain", swap_fmt, extent, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+//   g.add_pass("scene", draw_scene).color(scene);
+//   g.add_pass("post",  draw_post ).sampled(scene).color(back);
+//   g.compile(device, phys);
+//   ... per frame: g.bind_imported(back, img, view); g.execute(cb);
+
+using RGHandle = uint32_t;
+inline constexpr RGHandle RG_NONE = UINT32_MAX;
+
+struct RGImageDesc {
+    VkFormat              format  = VK_FORMAT_UNDEFINED;
+    VkExtent2D            extent  = {};
+    VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+    VkImageUsageFlags     extra_usage = 0; // usage is derived from the passes, add more here
+};
+
+// One image's memory needs, as vkGetImageMemoryRequirements would report
+// them (with the memory type already picked). Only used by plan().
+struct RGMemoryReq {
+    VkDeviceSize size      = 0;
+    VkDeviceSize alignment = 1;
+    uint32_t     type      = 0;
+};
+
+enum class RGAccess : uint8_t {
+    ColorAttachment,
+    DepthAttachment,
+    Sampled,
+    StorageRead,
+    StorageWrite,
+    TransferSrc,
+    TransferDst,
+};
+
+class RenderGraph;
+
+// Called inside the pass (rendering already begun and a full-extent
+// viewport/scissor set for raster passes).
+using RGRecordFn = std::function<void(VkCommandBuffer cb, const RenderGraph& graph)>;
+
+class RGPassBuilder {
+public:
+    RGPassBuilder& color(RGHandle h,
+                         VkAttachmentLoadOp load = VK_ATTACHMENT_LOAD_OP_CLEAR,
+                         VkClearColorValue clear = {{0.f, 0.f, 0.f, 1.f}});
+    RGPassBuilder& depth(RGHandle h,
+                         VkAttachmentLoadOp load = VK_ATTACHMENT_LOAD_OP_CLEAR,
+                         float clear_depth = 1.0f);
+    RGPassBuilder& sampled(RGHandle h, VkPipelineStageFlags2 stages = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT);
+    RGPassBuilder& storage_read(RGHandle h, VkPipelineStageFlags2 stages = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT);
+    RGPassBuilder& storage_write(RGHandle h, VkPipelineStageFlags2 stages = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT);
+    RGPassBuilder& transfer_src(RGHandle h);
+    RGPassBuilder& transfer_dst(RGHandle h);
+
+    // Keep the pass even if nothing reads its outputs (readbacks, queries...).
+    RGPassBuilder& side_effect();
+
+    // Id for pass_render_pass()/pass_rendering() once compiled.
+    uint32_t index() const { return m_pass; }
+
+private:
+    friend class RenderGraph;
+    RGPassBuilder(RenderGraph* g, uint32_t pass) : m_graph(g), m_pass(pass) {}
+    RGPassBuilder& use_(RGHandle h, RGAccess a, VkPipelineStageFlags2 stages,
+                        VkAttachmentLoadOp load = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+                        VkClearValue clear = {});
+
+    RenderGraph* m_graph;
+    uint32_t     m_pass;
+};
+
+class RenderGraph {
+public:
+    // --- declaration (rebuild + compile whenever the frame shape changes) ---
+
+    // External image (swapchain, persistent texture). The graph transitions it
+    // from 'initial' on first use and leaves it in 'final' at the end of execute().
+    RGHandle import_image(const char* name, VkFormat format, VkExtent2D extent,
+                          VkImageLayout final_layout,
+                          VkImageLayout initial_layout = VK_IMAGE_LAYOUT_UNDEFINED);
+
+    // Graph-owned image whose contents only live within one execute().
+    RGHandle create_transient(const char* name, const RGImageDesc& desc);
+
+    RGPassBuilder add_pass(const char* name, RGRecordFn record);
+
+    // Orders + culls passes, derives barriers, allocates (and aliases) transient
+    // memory and builds render passes. Safe to call again after edits.
+    VkResult compile(VkDevice device, VkPhysicalDevice phys);
+
+    // compile() without a device (tests, tools): orders, culls, places the
+    // transients using 'req' instead of real images and derives barriers.
+    // Nothing is created: the queries below work, image()/view()/execute()
+    // don't.
+    void plan(const std::function<RGMemoryReq(RGHandle)>& req);
+
+    // --- per frame ---
+    void bind_imported(RGHandle h, VkImage image, VkImageView view);
+    void execute(VkCommandBuffer cb);
+
+    // Frees everything, including the declarations.
+    void destroy(VkDevice device);
+
+    // --- queries (valid after compile) ---
+    VkImage     image(RGHandle h) const { return m_res[h].image; }
+    VkImageView view(RGHandle h)  const { return m_res[h].view; }
+    VkExtent2D  extent(RGHandle h) const { return m_res[h].desc.extent; }
+    uint32_t    live_pass_count() const { return static_cast<uint32_t>(m_order.size()); }
+    std::span<const uint32_t> pass_order() const { return m_order; }   // live passes, as executed
+    size_t      pass_barrier_count(uint32_t pass) const { return m_passes[pass].barriers.size(); }
+    // Source access of the pass's i-th barrier (i < pass_barrier_count).
+    VkAccessFlags2 pass_barrier_src_access(uint32_t pass, size_t i) const { return m_passes[pass].barriers[i].src_access; }
+
+    // Where a transient landed: UINT32_MAX if no live pass uses it. Two
+    // transients in one block may overlap only if their lifetimes don't.
+    uint32_t     transient_block(RGHandle h)  const { return m_res[h].block; }
+    VkDeviceSize transient_offset(RGHandle h) const { return m_res[h].offset; }
+
+    // What pipelines drawn inside 'pass' must be compatible with: a render
+    // pass, or (with g_vulkan.dynamic_rendering) the attachment formats.
+    VkRenderPass pass_render_pass(uint32_t pass) const { return m_passes[pass].render_pass; }
+    const VkPipelineRenderingCreateInfo* pass_rendering(uint32_t pass) const {
+        return m_passes[pass].dynamic ? &m_passes[pass].rendering : nullptr;
+    }
+    VkDeviceSize transient_bytes() const { return m_transient_bytes; }
+
+private:
+    friend class RGPassBuilder;
+
+    struct Use {
+        RGHandle              res;
+        RGAccess              access;
+        VkPipelineStageFlags2 stages;
+        VkAttachmentLoadOp    load;
+        VkClearValue          clear;
+    };
+
+    struct Resource {
+        std::string   name;
+        RGImageDesc   desc;
+        bool          imported       = false;
+        VkImageLayout initial_layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkImageLayout final_layout   = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        VkImage       image = VK_NULL_HANDLE;
+        VkImageView   view  = VK_NULL_HANDLE;
+
+        // lifetime in compiled order (transients)
+        uint32_t first = UINT32_MAX, last = 0;
+        uint32_t block = UINT32_MAX;    // index into m_blocks
+        VkDeviceSize offset = 0;
+        VkDeviceSize size   = 0;
+    };
+
+    // Barrier resolved at execute() time (imported images change every frame).
+    struct Barrier {
+        RGHandle              res;
+        VkImageLayout         old_layout, new_layout;
+        VkPipelineStageFlags2 src_stage, dst_stage;
+        VkAccessFlags2        src_access, dst_access;
+    };
+
+    struct Pass {
+        std::string       name;
+        RGRecordFn        record;
+        std::vector<Use>  uses;
+        bool              side_effect = false;
+
+        // compiled
+        std::vector<Barrier>      barriers;
+        VkRenderPass              render_pass = VK_NULL_HANDLE;
+        std::vector<RGHandle>     attachments;   // colors, then depth
+        std::vector<VkAttachmentDescription> descs;
+        std::vector<VkClearValue> clears;
+        VkExtent2D                extent = {};
+
+        // dynamic rendering (no render pass / framebuffers)
+        bool                          dynamic = false;
+        std::vector<VkFormat>         color_formats;
+        VkPipelineRenderingCreateInfo rendering{};
+    };
+
+    struct Block {
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        uint32_t       type   = UINT32_MAX;
+        VkDeviceSize   size   = 0;
+    };
+
+    struct FramebufferEntry {
+        uint32_t                 pass;
+        std::vector<VkImageView> views;
+        VkFramebuffer            fb;
+    };
+
+    void release_compiled_(VkDevice device);
+    void order_and_cull_();
+    std::vector<RGHandle> live_transients_();   // and their lifetimes
+    void place_transients_(std::vector<RGHandle> transients, const std::vector<RGMemoryReq>& reqs);
+    VkResult allocate_transients_(VkDevice device, VkPhysicalDevice phys);
+    void build_barriers_();
+    VkResult build_render_passes_(VkDevice device);
+    VkFramebuffer framebuffer_for_(uint32_t pass);
+
+    VkDevice                      m_device = VK_NULL_HANDLE;
+    std::vector<Resource>         m_res;
+    std::vector<Pass>             m_passes;
+    std::vector<uint32_t>         m_order;       // live passes, execution order
+    std::vector<Barrier>          m_final;       // imported -> final layout
+    std::vector<Block>            m_blocks;
+    std::vector<FramebufferEntry> m_fbs;
+    std::vector<VkImageMemoryBarrier2> m_scratch;
+    std::vector<VkRenderingAttachmentInfo> m_scratch_att;
+    VkDeviceSize                  m_transient_bytes = 0;
+};
+
+#endif // RENDER_GRAPH_HPP
@@ -8,6 +8,7 @@
 #include <array> 
 #include <span>
 #include <optional>
+#include <algorithm>
 
 #include <vulkan/vulkan.h>
 #include "common.hpp"
@@ -306,6 +307,62 @@ dynamic_state_info(std::span<const VkDynamicState> dynamic_states)
     return dyn;
 }
 
+// Extra state a pipeline can leave dynamic on top of viewport/scissor. Each is
+// dropped silently when the device lacks it (see g_vulkan), so check
+// DynamicStates::extras to know what the renderer has to set per pass.
+enum DynamicExtra : uint32_t {
+    DYNAMIC_CULL_MODE    = 1u << 0,  // extended_dynamic_state
+    DYNAMIC_TOPOLOGY     = 1u << 1,  // extended_dynamic_state (same topology class only)
+    DYNAMIC_BLEND_ENABLE = 1u << 2,  // extended_dynamic_state3
+};
+
+struct DynamicStates {
+    std::array<VkDynamicState, 5> states{};
+    uint32_t count  = 0;
+    uint32_t extras = 0; // DynamicExtra bits that made it in
+
+    VkPipelineDynamicStateCreateInfo info() const { return dynamic_state_info({ states.data(), count }); }
+};
+
+inline DynamicStates dynamic_states(uint32_t extras = 0, bool viewport_scissor = true) {
+    DynamicStates d;
+    if (viewport_scissor) {
+        d.states[d.count++] = VK_DYNAMIC_STATE_VIEWPORT;
+        d.states[d.count++] = VK_DYNAMIC_STATE_SCISSOR;
+    }
+    if (g_vulkan.extended_dynamic_state) {
+        if (extras & DYNAMIC_CULL_MODE) { d.states[d.count++] = VK_DYNAMIC_STATE_CULL_MODE;          d.extras |= DYNAMIC_CULL_MODE; }
+        if (extras & DYNAMIC_TOPOLOGY)  { d.states[d.count++] = VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY; d.extras |= DYNAMIC_TOPOLOGY; }
+    }
+    if (g_vulkan.dynamic_blend_enable && (extras & DYNAMIC_BLEND_ENABLE)) {
+        d.states[d.count++] = VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT;
+        d.extras |= DYNAMIC_BLEND_ENABLE;
+    }
+    return d;
+}
+
+// --- per-pass dynamic state (no-ops for extras the device doesn't have) ---
+
+inline void cmd_set_viewport_scissor(VkCommandBuffer cb, VkExtent2D extent, VkOffset2D offset = {0, 0}) {
+    const VkViewport vp{ float(offset.x), float(offset.y), float(extent.width), float(extent.height), 0.0f, 1.0f };
+    const VkRect2D   sc{ offset, extent };
+    vkCmdSetViewport(cb, 0, 1, &vp);
+    vkCmdSetScissor (cb, 0, 1, &sc);
+}
+
+inline void cmd_set_cull_mode(VkCommandBuffer cb, VkCullModeFlags cull) {
+    if (g_vulkan.extended_dynamic_state) g_vulkan.cmd_set_cull_mode(cb, cull);
+}
+
+inline void cmd_set_topology(VkCommandBuffer cb, VkPrimitiveTopology topology) {
+    if (g_vulkan.extended_dynamic_state) g_vulkan.cmd_set_primitive_topology(cb, topology);
+}
+
+inline void cmd_set_blend_enable(VkCommandBuffer cb, std::span<const VkBool32> enable, uint32_t first = 0) {
+    if (g_vulkan.dynamic_blend_enable)
+        g_vulkan.cmd_set_color_blend_enable(cb, first, static_cast<uint32_t>(enable.size()), enable.data());
+}
+
 
 inline VkGraphicsPipelineCreateInfo graphics_pipeline_info(
     // REQUIRED (non-null)
@@ -328,7 +385,10 @@ inline VkGraphicsPipelineCreateInfo graphics_pipeline_info(
     const VkPipelineTessellationStateCreateInfo*      tessellation    = nullptr,
     VkPipelineCreateFlags                             flags           = 0,
     VkPipeline                                        base_handle     = VK_NULL_HANDLE,
-    int32_t                                           base_index      = -1
+    int32_t                                           base_index      = -1,
+
+    // DYNAMIC RENDERING (render_pass must then be VK_NULL_HANDLE)
+    const VkPipelineRenderingCreateInfo*              rendering       = nullptr
 ) {
 #ifndef NDEBUG
     // Required pointers must be non-null for static path
@@ -340,7 +400,8 @@ inline VkGraphicsPipelineCreateInfo graphics_pipeline_info(
     DEBUG_ASSERT(multisample_state && "pMultisampleState must not be null (static path)");
     DEBUG_ASSERT(color_blend_state && "pColorBlendState must not be null (static path)");
     DEBUG_ASSERT(layout            != VK_NULL_HANDLE && "pipeline layout is required");
-    DEBUG_ASSERT(render_pass       != VK_NULL_HANDLE && "render pass is required");
+    DEBUG_ASSERT((render_pass != VK_NULL_HANDLE) != (rendering != nullptr) &&
+                 "need exactly one of render pass or dynamic rendering info");
 
     // If tessellation shaders are present, tessellation state must be provided
     bool has_tess = false;
@@ -360,7 +421,7 @@ inline VkGraphicsPipelineCreateInfo graphics_pipeline_info(
 
     VkGraphicsPipelineCreateInfo info{};
     info.sType               = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-    info.pNext               = nullptr;
+    info.pNext               = rendering;             // formats instead of a render pass
     info.flags               = flags;
 
     info.stageCount          = static_cast<uint32_t>(stages.size());
@@ -386,6 +447,9 @@ inline VkGraphicsPipelineCreateInfo graphics_pipeline_info(
     return info;
 }
 
+// viewport_state = nullptr (the default for new code) means one dynamic
+// viewport + scissor; with dynamic_state = nullptr those two are then made
+// dynamic automatically, so set them per pass with cmd_set_viewport_scissor.
 inline VkResult create_graphics_pipeline(
     VkPipeline& outPipe,
     VkDevice device,
@@ -410,9 +474,18 @@ inline VkResult create_graphics_pipeline(
     const VkPipelineTessellationStateCreateInfo* tessellation  = nullptr,
     VkPipelineCreateFlags flags = 0,
     VkPipeline base_handle = VK_NULL_HANDLE,
-    int32_t   base_index  = -1
+    int32_t   base_index  = -1,
+
+    // DYNAMIC RENDERING (pass VK_NULL_HANDLE as render_pass)
+    const VkPipelineRenderingCreateInfo* rendering = nullptr
 ) {
-    if (!viewport_state) return VK_ERROR_INITIALIZATION_FAILED; // required
+    const auto dyn_viewport = render::viewport_state_info_dynamic(1);
+    const auto dyn_default  = render::dynamic_states();
+    const auto dyn_info     = dyn_default.info();
+    if (!viewport_state) {
+        viewport_state = &dyn_viewport;
+        if (!dynamic_state) dynamic_state = &dyn_info;
+    }
 
     // Build the top-level create-info (addresses of by-value args are valid for the call)
     auto gp = render::graphics_pipeline_info(
@@ -431,7 +504,8 @@ inline VkResult create_graphics_pipeline(
         tessellation,
         flags,
         base_handle,
-        base_index
+        base_index,
+        rendering
     );
 
     return vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &gp, nullptr, &outPipe);
@@ -447,7 +521,8 @@ inline VkResult create_graphics_pipeline_basic(
     VkCullModeFlags cull = VK_CULL_MODE_BACK_BIT,
     const VkPipelineColorBlendAttachmentState& blend = render::alpha_blend,
     uint32_t subpass = 0,
-    const VkPipelineDynamicStateCreateInfo* dynamic_state = nullptr
+    const VkPipelineDynamicStateCreateInfo* dynamic_state = nullptr,
+    const VkPipelineRenderingCreateInfo* rendering = nullptr
 ) {
     // value blocks
     auto raster_state      = render::rasterization_state_info(cull);
@@ -462,10 +537,81 @@ inline VkResult create_graphics_pipeline_basic(
     return create_graphics_pipeline(
         outPipe, device, stages, viewport_state, layout, render_pass,
         raster_state, color_blend_state, vertex_input, input_assembly, multisample_state,
-        subpass, dynamic_state
+        subpass, dynamic_state,
+        nullptr, nullptr, 0, VK_NULL_HANDLE, -1,
+        rendering
     );
 }
 
+// -----------------------------------------------------------------------------
+// Compute pipelines
+// -----------------------------------------------------------------------------
+
+inline constexpr VkPipelineShaderStageCreateInfo
+compute_stage_info(VkShaderModule cs,
+                   const VkSpecializationInfo* specialization = nullptr,
+                   const char* entry = "main")
+{
+    VkPipelineShaderStageCreateInfo st{};
+    st.sType               = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    st.pNext               = nullptr;
+    st.flags               = 0;
+    st.stage               = VK_SHADER_STAGE_COMPUTE_BIT;
+    st.module              = cs;
+    st.pName               = entry;
+    st.pSpecializationInfo = specialization;
+    return st;
+}
+
+inline VkResult create_compute_pipeline(
+    VkPipeline& outPipe,
+    VkDevice device,
+    VkShaderModule cs,
+    VkPipelineLayout layout,
+    const VkSpecializationInfo* specialization = nullptr,
+    VkPipelineCreateFlags flags = 0
+) {
+    VkComputePipelineCreateInfo ci{};
+    ci.sType              = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    ci.flags              = flags;
+    ci.stage              = compute_stage_info(cs, specialization);
+    ci.layout             = layout;
+    ci.basePipelineHandle = VK_NULL_HANDLE;
+    ci.basePipelineIndex  = -1;
+    return vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &ci, nullptr, &outPipe);
+}
+
+// Workgroups needed to cover 'items' with groups of 'local_size'.
+inline constexpr uint32_t group_count(uint32_t items, uint32_t local_size) {
+    return (items + local_size - 1) / local_size;
+}
+
+// Dispatch enough groups of local_x*local_y*local_z to cover the item grid
+// (the shader bounds-checks the overhang).
+inline void cmd_dispatch_items(VkCommandBuffer cb,
+                               uint32_t items_x, uint32_t local_x,
+                               uint32_t items_y = 1, uint32_t local_y = 1,
+                               uint32_t items_z = 1, uint32_t local_z = 1)
+{
+    const uint32_t gx = group_count(items_x, local_x);
+    const uint32_t gy = group_count(items_y, local_y);
+    const uint32_t gz = group_count(items_z, local_z);
+    if (gx && gy && gz) vkCmdDispatch(cb, gx, gy, gz);
+}
+
+// Bind a compute pipeline and its descriptor sets in one go.
+inline void cmd_bind_compute(VkCommandBuffer cb,
+                             VkPipeline pipeline,
+                             VkPipelineLayout layout,
+                             std::span<const VkDescriptorSet> sets = {},
+                             uint32_t first_set = 0)
+{
+    vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+    if (!sets.empty())
+        vkCmdBindDescriptorSets(cb, VK_PIPELINE_BIND_POINT_COMPUTE, layout, first_set,
+                                static_cast<uint32_t>(sets.size()), sets.data(), 0, nullptr);
+}
+
 inline VkRenderPassBeginInfo render_pass_begin_info(
     VkRenderPass render_pass,
     VkFramebuffer framebuffer,
@@ -484,6 +630,68 @@ inline VkRenderPassBeginInfo render_pass_begin_info(
     return info;
 }
 
+// -----------------------------------------------------------------------------
+// Dynamic rendering helpers (VK_KHR_dynamic_rendering / Vulkan 1.3)
+// -----------------------------------------------------------------------------
+
+// Attachment formats a pipeline renders into; replaces the render pass at
+// pipeline creation. Borrows 'colors'.
+inline constexpr VkPipelineRenderingCreateInfo rendering_info(
+    std::span<const VkFormat> colors,
+    VkFormat depth   = VK_FORMAT_UNDEFINED,
+    VkFormat stencil = VK_FORMAT_UNDEFINED
+){
+    VkPipelineRenderingCreateInfo info{};
+    info.sType                   = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+    info.pNext                   = nullptr;
+    info.viewMask                = 0;
+    info.colorAttachmentCount    = static_cast<uint32_t>(colors.size());
+    info.pColorAttachmentFormats = colors.data();
+    info.depthAttachmentFormat   = depth;
+    info.stencilAttachmentFormat = stencil;
+    return info;
+}
+
+inline constexpr VkRenderingAttachmentInfo rendering_attachment(
+    VkImageView         view,
+    VkImageLayout       layout,
+    VkAttachmentLoadOp  load  = VK_ATTACHMENT_LOAD_OP_CLEAR,
+    VkAttachmentStoreOp store = VK_ATTACHMENT_STORE_OP_STORE,
+    VkClearValue        clear = {}
+){
+    VkRenderingAttachmentInfo info{};
+    info.sType       = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+    info.pNext       = nullptr;
+    info.imageView   = view;
+    info.imageLayout = layout;
+    info.resolveMode = VK_RESOLVE_MODE_NONE;
+    info.loadOp      = load;
+    info.storeOp     = store;
+    info.clearValue  = clear;
+    return info;
+}
+
+inline constexpr VkRenderingInfo begin_rendering_info(
+    VkExtent2D extent,
+    std::span<const VkRenderingAttachmentInfo> colors,
+    const VkRenderingAttachmentInfo* depth = nullptr,
+    VkOffset2D offset = {0, 0}
+){
+    VkRenderingInfo info{};
+    info.sType                = VK_STRUCTURE_TYPE_RENDERING_INFO;
+    info.pNext                = nullptr;
+    info.flags                = 0;
+    info.renderArea.offset    = offset;
+    info.renderArea.extent    = extent;
+    info.layerCount           = 1;
+    info.viewMask             = 0;
+    info.colorAttachmentCount = static_cast<uint32_t>(colors.size());
+    info.pColorAttachments    = colors.data();
+    info.pDepthAttachment     = depth;
+    info.pStencilAttachment   = nullptr;
+    return info;
+}
+
 // -----------------------------------------------------------------------------
 // Descriptor helpers (flat, prefixed with desc_)
 // -----------------------------------------------------------------------------
@@ -586,6 +794,237 @@ desc_write_image(VkDescriptorSet set,
     return w;
 }
 
+inline constexpr VkDescriptorBufferInfo
+desc_buffer_info(VkBuffer buffer,
+                 VkDeviceSize offset = 0,
+                 VkDeviceSize range  = VK_WHOLE_SIZE)
+{
+    VkDescriptorBufferInfo bi{};
+    bi.buffer = buffer;
+    bi.offset = offset;
+    bi.range  = range;
+    return bi;
+}
+
+// Storage images are read/written in GENERAL layout and take no sampler.
+inline constexpr VkDescriptorImageInfo
+desc_storage_image_info(VkImageView view)
+{
+    return desc_image_info(VK_NULL_HANDLE, view, VK_IMAGE_LAYOUT_GENERAL);
+}
+
+inline constexpr VkWriteDescriptorSet
+desc_write_storage_image(VkDescriptorSet set,
+                         uint32_t binding,
+                         const VkDescriptorImageInfo* info,
+                         uint32_t array_element = 0)
+{
+    return desc_write_image(set, binding, info, array_element, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE);
+}
+
+inline constexpr VkWriteDescriptorSet
+desc_write_buffer(VkDescriptorSet set,
+                  uint32_t binding,
+                  const VkDescriptorBufferInfo* info,
+                  uint32_t array_element = 0,
+                  VkDescriptorType type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+{
+    VkWriteDescriptorSet w{};
+    w.sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    w.pNext           = nullptr;
+    w.dstSet          = set;
+    w.dstBinding      = binding;
+    w.dstArrayElement = array_element;
+    w.descriptorCount = 1;
+    w.descriptorType  = type;
+    w.pBufferInfo     = info;
+    return w;
+}
+
+// -----------------------------------------------------------------------------
+// Barrier helpers (sync2 structs everywhere; lowered to vkCmdPipelineBarrier
+// when synchronization2 isn't enabled on the device)
+// -----------------------------------------------------------------------------
+
+inline constexpr VkImageAspectFlags aspect_for_format(VkFormat fmt) {
+    switch (fmt) {
+        case VK_FORMAT_D16_UNORM:
+        case VK_FORMAT_X8_D24_UNORM_PACK32:
+        case VK_FORMAT_D32_SFLOAT:
+            return VK_IMAGE_ASPECT_DEPTH_BIT;
+        case VK_FORMAT_S8_UINT:
+            return VK_IMAGE_ASPECT_STENCIL_BIT;
+        case VK_FORMAT_D16_UNORM_S8_UINT:
+        case VK_FORMAT_D24_UNORM_S8_UINT:
+        case VK_FORMAT_D32_SFLOAT_S8_UINT:
+            return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+        default:
+            return VK_IMAGE_ASPECT_COLOR_BIT;
+    }
+}
+
+inline constexpr VkImageMemoryBarrier2
+image_barrier2(VkImage image,
+               VkImageLayout old_layout, VkImageLayout new_layout,
+               VkPipelineStageFlags2 src_stage, VkAccessFlags2 src_access,
+               VkPipelineStageFlags2 dst_stage, VkAccessFlags2 dst_access,
+               VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT,
+               uint32_t src_family = VK_QUEUE_FAMILY_IGNORED,
+               uint32_t dst_family = VK_QUEUE_FAMILY_IGNORED)
+{
+    VkImageMemoryBarrier2 b{};
+    b.sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+    b.pNext               = nullptr;
+    b.srcStageMask        = src_stage;
+    b.srcAccessMask       = src_access;
+    b.dstStageMask        = dst_stage;
+    b.dstAccessMask       = dst_access;
+    b.oldLayout           = old_layout;
+    b.newLayout           = new_layout;
+    b.srcQueueFamilyIndex = src_family;
+    b.dstQueueFamilyIndex = dst_family;
+    b.image               = image;
+    b.subresourceRange.aspectMask     = aspect;
+    b.subresourceRange.baseMipLevel   = 0;
+    b.subresourceRange.levelCount     = VK_REMAINING_MIP_LEVELS;
+    b.subresourceRange.baseArrayLayer = 0;
+    b.subresourceRange.layerCount     = VK_REMAINING_ARRAY_LAYERS;
+    return b;
+}
+
+inline constexpr VkBufferMemoryBarrier2
+buffer_barrier2(VkBuffer buffer,
+                VkPipelineStageFlags2 src_stage, VkAccessFlags2 src_access,
+                VkPipelineStageFlags2 dst_stage, VkAccessFlags2 dst_access,
+                VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE,
+                uint32_t src_family = VK_QUEUE_FAMILY_IGNORED,
+                uint32_t dst_family = VK_QUEUE_FAMILY_IGNORED)
+{
+    VkBufferMemoryBarrier2 b{};
+    b.sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+    b.pNext               = nullptr;
+    b.srcStageMask        = src_stage;
+    b.srcAccessMask       = src_access;
+    b.dstStageMask        = dst_stage;
+    b.dstAccessMask       = dst_access;
+    b.srcQueueFamilyIndex = src_family;
+    b.dstQueueFamilyIndex = dst_family;
+    b.buffer              = buffer;
+    b.offset              = offset;
+    b.size                = size;
+    return b;
+}
+
+// Compute shader writes to 'buffer' made visible to the next consumer
+// (another dispatch by default; DRAW_INDIRECT/INDIRECT_COMMAND_READ for
+// indirect args, VERTEX_SHADER/SHADER_STORAGE_READ for instance data, ...).
+inline constexpr VkBufferMemoryBarrier2
+compute_write_barrier2(VkBuffer buffer,
+                       VkPipelineStageFlags2 dst_stage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                       VkAccessFlags2 dst_access = VK_ACCESS_2_SHADER_STORAGE_READ_BIT |
+                                                   VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                       VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE)
+{
+    return buffer_barrier2(buffer,
+                           VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                           dst_stage, dst_access, offset, size);
+}
+
+// sync2 stage bits above 32 have no classic twin; fold them into the nearest legacy stage.
+inline constexpr VkPipelineStageFlags lower_stage2(VkPipelineStageFlags2 s, bool is_src) {
+    VkPipelineStageFlags out = static_cast<VkPipelineStageFlags>(s & 0xFFFFFFFFull);
+    if (s & (VK_PIPELINE_STAGE_2_COPY_BIT | VK_PIPELINE_STAGE_2_RESOLVE_BIT |
+             VK_PIPELINE_STAGE_2_BLIT_BIT | VK_PIPELINE_STAGE_2_CLEAR_BIT))
+        out |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+    if (s & (VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT | VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT))
+        out |= VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+    if (s & VK_PIPELINE_STAGE_2_PRE_RASTERIZATION_SHADERS_BIT)
+        out |= VK_PIPELINE_STAGE_VERTEX_SHADER_BIT;
+    if (out == 0)
+        out = is_src ? VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+    return out;
+}
+
+inline constexpr VkAccessFlags lower_access2(VkAccessFlags2 a) {
+    VkAccessFlags out = static_cast<VkAccessFlags>(a & 0xFFFFFFFFull);
+    if (a & (VK_ACCESS_2_SHADER_SAMPLED_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_READ_BIT))
+        out |= VK_ACCESS_SHADER_READ_BIT;
+    if (a & VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT)
+        out |= VK_ACCESS_SHADER_WRITE_BIT;
+    return out;
+}
+
+// Records image/buffer barriers with vkCmdPipelineBarrier2 when available,
+// otherwise as classic vkCmdPipelineBarrier calls (32 barriers of each kind
+// per call) with the union of the stage masks.
+inline void cmd_barriers(VkCommandBuffer cb,
+                         std::span<const VkImageMemoryBarrier2>  images,
+                         std::span<const VkBufferMemoryBarrier2> buffers = {})
+{
+    if (images.empty() && buffers.empty()) return;
+
+    if (g_vulkan.cmd_pipeline_barrier2) {
+        VkDependencyInfo dep{};
+        dep.sType                    = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dep.imageMemoryBarrierCount  = static_cast<uint32_t>(images.size());
+        dep.pImageMemoryBarriers     = images.data();
+        dep.bufferMemoryBarrierCount = static_cast<uint32_t>(buffers.size());
+        dep.pBufferMemoryBarriers    = buffers.data();
+        g_vulkan.cmd_pipeline_barrier2(cb, &dep);
+        return;
+    }
+
+    // classic fallback: every barrier gets the union of the stage masks, in
+    // batches of kMaxClassic so a fixed buffer keeps this allocation-free
+    VkPipelineStageFlags src = 0, dst = 0;
+    for (const VkBufferMemoryBarrier2& in : buffers) {
+        src |= lower_stage2(in.srcStageMask, true);
+        dst |= lower_stage2(in.dstStageMask, false);
+    }
+    for (const VkImageMemoryBarrier2& in : images) {
+        src |= lower_stage2(in.srcStageMask, true);
+        dst |= lower_stage2(in.dstStageMask, false);
+    }
+
+    constexpr size_t kMaxClassic = 32;
+    std::array<VkImageMemoryBarrier,  kMaxClassic> classic{};
+    std::array<VkBufferMemoryBarrier, kMaxClassic> classic_buf{};
+    for (size_t first = 0; first < std::max(images.size(), buffers.size()); first += kMaxClassic) {
+        const size_t nb = buffers.size() > first ? std::min(buffers.size() - first, kMaxClassic) : 0;
+        for (size_t i = 0; i < nb; ++i) {
+            const VkBufferMemoryBarrier2& in = buffers[first + i];
+            VkBufferMemoryBarrier& b = classic_buf[i];
+            b.sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+            b.srcAccessMask       = lower_access2(in.srcAccessMask);
+            b.dstAccessMask       = lower_access2(in.dstAccessMask);
+            b.srcQueueFamilyIndex = in.srcQueueFamilyIndex;
+            b.dstQueueFamilyIndex = in.dstQueueFamilyIndex;
+            b.buffer              = in.buffer;
+            b.offset              = in.offset;
+            b.size                = in.size;
+        }
+        const size_t n = images.size() > first ? std::min(images.size() - first, kMaxClassic) : 0;
+        for (size_t i = 0; i < n; ++i) {
+            const VkImageMemoryBarrier2& in = images[first + i];
+            VkImageMemoryBarrier& b = classic[i];
+            b.sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            b.srcAccessMask       = lower_access2(in.srcAccessMask);
+            b.dstAccessMask       = lower_access2(in.dstAccessMask);
+            b.oldLayout           = in.oldLayout;
+            b.newLayout           = in.newLayout;
+            b.srcQueueFamilyIndex = in.srcQueueFamilyIndex;
+            b.dstQueueFamilyIndex = in.dstQueueFamilyIndex;
+            b.image               = in.image;
+            b.subresourceRange    = in.subresourceRange;
+        }
+
+        vkCmdPipelineBarrier(cb, src, dst, 0,
+            0, nullptr,
+            static_cast<uint32_t>(nb), classic_buf.data(),
+            static_cast<uint32_t>(n), classic.data());
+    }
+}
+
 inline uint32_t find_mem_type(VkPhysicalDevice phys, uint32_t bits, VkMemoryPropertyFlags req){
     VkPhysicalDeviceMemoryProperties mp{}; vkGetPhysicalDeviceMemoryProperties(phys,&mp);
     for(uint32_t i=0;i<mp.memoryTypeCount;i++)
@@ -0,0 +1,179 @@
+#include "replay.hpp"
+#include <cstdio>
+#include <utility>
+
+namespace {
+
+constexpr char    kMagic[4] = { 'M', 'G', 'R', 'P' };
+constexpr uint8_t kVersion  = 1;
+
+struct Writer {
+    std::vector<uint8_t> out;
+
+    void u8(uint8_t v) { out.push_back(v); }
+    void varint(uint64_t v) {
+        do {
+            const uint8_t b = v & 0x7F;
+            v >>= 7;
+            out.push_back(b | (v ? 0x80 : 0));
+        } while (v);
+    }
+    void zigzag(int32_t v) { varint((uint32_t(v) << 1) ^ uint32_t(v >> 31)); }
+    void u64(uint64_t v) { for (int i = 0; i < 8; ++i) out.push_back(uint8_t(v >> (i * 8))); }
+};
+
+// Every read checks the bounds; after the first failure 'ok' stays false and
+// reads return 0.
+struct Reader {
+    std::span<const uint8_t> in;
+    size_t pos = 0;
+    bool   ok  = true;
+
+    uint8_t u8() {
+        if (pos >= in.size()) { ok = false; return 0; }
+        return in[pos++];
+    }
+    uint64_t varint() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            const uint8_t b = u8();
+            v |= uint64_t(b & 0x7F) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        ok = false;
+        return 0;
+    }
+    uint32_t varint32() {
+        const uint64_t v = varint();
+        if (v > UINT32_MAX) ok = false;
+        return uint32_t(v);
+    }
+    int32_t zigzag() {
+        const uint32_t v = varint32();
+        return int32_t((v >> 1) ^ (0u - (v & 1)));
+    }
+    uint64_t u64() {
+        uint64_t v = 0;
+        for (int i = 0; i < 8; ++i) v |= uint64_t(u8()) << (i * 8);
+        return v;
+    }
+};
+
+} // namespace
+
+void replay_capture(Replay& replay, const LockstepSim& sim) {
+    const auto cmds = sim.last_commands();
+    replay.commands.insert(replay.commands.end(), cmds.begin(), cmds.end());
+    replay.ticks    = sim.tick();
+    replay.checksum = sim.checksum();
+}
+
+bool replay_play(const Replay& replay, LockstepSim& sim) {
+    DEBUG_ASSERT(sim.tick() == 0);
+    for (const SimCommand& c : replay.commands) sim.schedule(c);
+    while (sim.tick() < replay.ticks) sim.step();
+    return sim.checksum() == replay.checksum;
+}
+
+std::vector<uint8_t> encode_replay(const Replay& replay) {
+    Writer w;
+    for (char c : kMagic) w.u8(uint8_t(c));
+    w.u8(kVersion);
+    w.varint(replay.ticks);
+    w.u64(replay.checksum);
+
+    // group by tick
+    uint64_t blocks = 0;
+    for (size_t i = 0; i < replay.commands.size(); ++i)
+        blocks += i == 0 || replay.commands[i].tick != replay.commands[i - 1].tick;
+    w.varint(blocks);
+
+    // seq and coordinates are deltas: one player's commands in a tick
+    // count up by one, and group orders share a target
+    uint64_t last_tick = 0;
+    uint32_t last_player = 0, last_seq = 0;
+    int32_t  last_x = 0, last_z = 0;
+    for (size_t i = 0; i < replay.commands.size();) {
+        const uint64_t tick = replay.commands[i].tick;
+        size_t end = i;
+        while (end < replay.commands.size() && replay.commands[end].tick == tick) ++end;
+        w.varint(tick - last_tick);
+        w.varint(end - i);
+        last_tick = tick;
+
+        for (; i < end; ++i) {
+            const SimCommand& c = replay.commands[i];
+            w.varint(c.player);
+            w.varint(c.seq - (c.player == last_player ? last_seq : 0));
+            w.u8(uint8_t(c.type));
+            if (c.type != SimCommandType::Spawn) { w.varint(c.unit.index); w.varint(c.unit.generation); }
+            if (c.type != SimCommandType::Stop) {
+                w.zigzag(int32_t(uint32_t(c.x.raw) - uint32_t(last_x)));
+                w.zigzag(int32_t(uint32_t(c.z.raw) - uint32_t(last_z)));
+                last_x = c.x.raw; last_z = c.z.raw;
+            }
+            last_player = c.player; last_seq = c.seq;
+        }
+    }
+    return std::move(w.out);
+}
+
+bool decode_replay(std::span<const uint8_t> bytes, Replay& out) {
+    Reader r{ bytes };
+    for (char c : kMagic)
+        if (r.u8() != uint8_t(c)) return false;
+    if (r.u8() != kVersion) return false;
+    out.ticks    = r.varint();
+    out.checksum = r.u64();
+    out.commands.clear();
+
+    const uint64_t blocks = r.varint();
+    uint64_t tick = 0;
+    uint32_t last_player = 0, last_seq = 0;
+    int32_t  last_x = 0, last_z = 0;
+    for (uint64_t b = 0; b < blocks && r.ok; ++b) {
+        const uint64_t delta = r.varint();
+        if (b > 0 && delta == 0) return false;   // blocks are strictly increasing
+        tick += delta;
+        const uint64_t count = r.varint();
+        if (count == 0) return false;
+        for (uint64_t i = 0; i < count && r.ok; ++i) {
+            SimCommand c;
+            c.tick   = tick;
+            c.player = r.varint32();
+            c.seq    = r.varint32() + (c.player == last_player ? last_seq : 0);
+            const uint8_t type = r.u8();
+            if (type > uint8_t(SimCommandType::Stop)) return false;
+            c.type = SimCommandType(type);
+            if (c.type != SimCommandType::Spawn) { c.unit.index = r.varint32(); c.unit.generation = r.varint32(); }
+            if (c.type != SimCommandType::Stop) {
+                c.x.raw = last_x = int32_t(uint32_t(last_x) + uint32_t(r.zigzag()));
+                c.z.raw = last_z = int32_t(uint32_t(last_z) + uint32_t(r.zigzag()));
+            }
+            last_player = c.player; last_seq = c.seq;
+            out.commands.push_back(c);
+        }
+    }
+    if (!r.ok || r.pos != bytes.size()) return false;
+    return out.commands.empty() || out.commands.back().tick < out.ticks;
+}
+
+bool save_replay(const char* path, const Replay& replay) {
+    const std::vector<uint8_t> bytes = encode_replay(replay);
+    std::FILE* f = std::fopen(path, "wb");
+    if (!f) return false;
+    const bool ok = std::fwrite(bytes.data(), 1, bytes.size(), f) == bytes.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+bool load_replay(const char* path, Replay& out) {
+    std::FILE* f = std::fopen(path, "rb");
+    if (!f) return false;
+    std::vector<uint8_t> bytes;
+    uint8_t chunk[1 << 16];
+    size_t  n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), f)) > 0) bytes.insert(bytes.end(), chunk, chunk + n);
+    const bool read_ok = !std::ferror(f);
+    std::fclose(f);
+    return read_ok && decode_replay(bytes, out);
+}
@@ -0,0 +1,46 @@
+#ifndef REPLAY_HPP
+#define REPLAY_HPP
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "lockstep.hpp"
+
+// A recorded game is just its command stream: the lockstep sim is a pure
+// function of the commands, so replaying them on a fresh LockstepSim walks
+// through the exact same states. The recording also keeps the tick count
+// and the final checksum, so playback can tell whether it reproduced the
+// game (and a build that broke determinism shows up as a mismatch).
+//
+// File layout, little-endian with LEB128 varints (zigzag for signed):
+//   "MGRP" u8 version  varint ticks  u64 checksum  varint blocks
+//   per tick that had commands:  varint tick delta  varint count  commands
+//   per command:  varint player  varint seq  u8 type  then
+//                 Spawn: x z   Move: unit.index unit.generation x z
+//                 Stop:  unit.index unit.generation
+// seq is relative to the previous command when it has the same player, x/z
+// to the previous command that had coordinates (both wrap mod 2^32). Ticks
+// without commands cost nothing; a group order is about 8 bytes per unit.
+struct Replay {
+    uint64_t                ticks    = 0;   // length of the recording
+    uint64_t                checksum = 0;   // sim state after the last tick
+    std::vector<SimCommand> commands;       // in tick order; unused fields aren't kept
+};
+
+// Appends what 'sim' applied on its last step() and moves the end marker
+// up to it; call after every step while recording.
+void replay_capture(Replay& replay, const LockstepSim& sim);
+
+// Schedules every command on a fresh sim and runs all the ticks. True if it
+// ended on the recorded checksum.
+bool replay_play(const Replay& replay, LockstepSim& sim);
+
+std::vector<uint8_t> encode_replay(const Replay& replay);
+// False (and 'out' unspecified) on a bad header, truncation or junk.
+bool decode_replay(std::span<const uint8_t> bytes, Replay& out);
+
+bool save_replay(const char* path, const Replay& replay);
+bool load_replay(const char* path, Replay& out);   // false if missing or corrupt
+
+#endif // REPLAY_HPP
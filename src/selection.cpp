@@ -0,0 +1,83 @@
+#include "selection.hpp"
+#include <algorithm>
+
+void BoxSelect::set_box_(float x0, float y0, float x1, float y1) {
+    m_box[0] = std::min(x0, x1); m_box[1] = std::min(y0, y1);
+    m_box[2] = std::max(x0, x1); m_box[3] = std::max(y0, y1);
+}
+
+BoxSelect::Gesture BoxSelect::update(const MouseInput& m) {
+    if (m.left_pressed) {
+        m_pressed  = true;
+        m_dragging = false;
+        m_start[0] = m.press_x;
+        m_start[1] = m.press_y;
+    }
+    if (!m_pressed) return Gesture::None;
+
+    const float dx = m.x - m_start[0], dy = m.y - m_start[1];
+    if (!m_dragging && dx * dx + dy * dy > drag_px * drag_px) m_dragging = true;
+    if (m_dragging) set_box_(m_start[0], m_start[1], m.x, m.y);
+
+    if (!m.left_released) return Gesture::None;
+    m_pressed = false;
+    if (m_dragging) {
+        m_dragging = false;
+        return Gesture::Box;
+    }
+    set_box_(m.x, m.y, m.x, m.y);
+    return Gesture::Click;
+}
+
+// World XZ bounds of the ground under a pixel rect, padded by slack.
+static bool ground_bounds(const Camera& camera, float x0, float y0, float x1, float y1, float slack,
+                          float& mnx, float& mnz, float& mxx, float& mxz) {
+    const float px[4] = { x0, x1, x0, x1 };
+    const float py[4] = { y0, y0, y1, y1 };
+    mnx = mnz =  1e30f;
+    mxx = mxz = -1e30f;
+    for (int i = 0; i < 4; ++i) {
+        float x, z;
+        if (!camera.screen_to_world(px[i], py[i], x, z)) return false;
+        mnx = std::min(mnx, x); mxx = std::max(mxx, x);
+        mnz = std::min(mnz, z); mxz = std::max(mxz, z);
+    }
+    mnx -= slack; mnz -= slack;
+    mxx += slack; mxz += slack;
+    return true;
+}
+
+uint32_t select_in_box(const SpatialGrid& grid, const Camera& camera,
+                       float x0, float y0, float x1, float y1,
+                       std::vector<Entity>& out, float slack) {
+    if (x0 > x1) std::swap(x0, x1);
+    if (y0 > y1) std::swap(y0, y1);
+    float mnx, mnz, mxx, mxz;
+    if (!ground_bounds(camera, x0, y0, x1, y1, slack, mnx, mnz, mxx, mxz)) return 0;
+
+    const size_t before = out.size();
+    grid.for_each_in_rect(mnx, mnz, mxx, mxz, [&](const SpatialGrid::Item& it) {
+        float sx, sy;
+        if (camera.world_to_screen(it.x, it.y, it.z, sx, sy) &&
+            sx >= x0 && sx <= x1 && sy >= y0 && sy <= y1)
+            out.push_back(it.entity);
+    });
+    return uint32_t(out.size() - before);
+}
+
+Entity pick_unit(const SpatialGrid& grid, const Camera& camera,
+                 float sx, float sy, float radius_px, float slack) {
+    float mnx, mnz, mxx, mxz;
+    if (!ground_bounds(camera, sx - radius_px, sy - radius_px, sx + radius_px, sy + radius_px,
+                       slack, mnx, mnz, mxx, mxz)) return {};
+
+    Entity best{};
+    float  best_d2 = radius_px * radius_px;
+    grid.for_each_in_rect(mnx, mnz, mxx, mxz, [&](const SpatialGrid::Item& it) {
+        float px, py;
+        if (!camera.world_to_screen(it.x, it.y, it.z, px, py)) return;
+        const float d2 = (px - sx) * (px - sx) + (py - sy) * (py - sy);
+        if (d2 <= best_d2) { best_d2 = d2; best = it.entity; }
+    });
+    return best;
+}
@@ -0,0 +1,53 @@
+#ifndef SELECTION_HPP
+#define SELECTION_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "camera.hpp"
+#include "input.hpp"
+#include "spatial_grid.hpp"
+
+// Turns the frame's MouseInput into selection gestures: a left press that
+// travels more than drag_px before it's released is a box, anything shorter
+// is a click. Feed it once per frame after platform_should_quit().
+class BoxSelect {
+public:
+    enum class Gesture : uint8_t { None, Click, Box };
+
+    float drag_px = 4.f;
+
+    Gesture update(const MouseInput& m);
+
+    // While dragging (for drawing the rubber band) and after a Box gesture:
+    // the rect in pixels, sorted so x0 <= x1, y0 <= y1.
+    bool         dragging() const { return m_dragging; }
+    const float* box()      const { return m_box; }
+    // The click position after a Click gesture.
+    float click_x() const { return m_box[0]; }
+    float click_y() const { return m_box[1]; }
+
+private:
+    void set_box_(float x0, float y0, float x1, float y1);
+
+    bool  m_pressed  = false;
+    bool  m_dragging = false;
+    float m_start[2]{};
+    float m_box[4]{};
+};
+
+// Appends the units whose projected position falls inside the pixel rect and
+// returns how many. The rect's corners are cast onto the ground to bound a
+// grid query, then each candidate is projected and tested exactly (in the
+// isometric view the rect covers a rotated quad on the ground). 'slack' pads
+// the world bounds for units standing above the ground plane.
+uint32_t select_in_box(const SpatialGrid& grid, const Camera& camera,
+                       float x0, float y0, float x1, float y1,
+                       std::vector<Entity>& out, float slack = 2.f);
+
+// The unit projected nearest to the pixel, within radius_px; an invalid
+// Entity if there's none.
+Entity pick_unit(const SpatialGrid& grid, const Camera& camera,
+                 float sx, float sy, float radius_px = 12.f, float slack = 2.f);
+
+#endif // SELECTION_HPP
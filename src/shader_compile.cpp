@@ -1,5 +1,6 @@
 #include "shader_compile.hpp"
 #include "platform.hpp"   // your project’s place that includes <vulkan/vulkan.h> and VK_CHECK
+#include "jobs.hpp"
 
 #include <stdexcept>
 #include <cstdio>
@@ -38,7 +39,7 @@ static constexpr TBuiltInResource InitResources()
     Resources.maxComputeWorkGroupSizeZ                  = 64;
     Resources.maxComputeUniformComponents               = 1024;
     Resources.maxComputeTextureImageUnits               = 16;
-    Resources.maxComputeImageUniforms                   = 8;
+    Resources.maxComputeImageUniforms                   = 16;
     Resources.maxComputeAtomicCounters                  = 8;
     Resources.maxComputeAtomicCounterBuffers            = 1;
     Resources.maxVaryingComponents                      = 60;
@@ -46,16 +47,16 @@ static constexpr TBuiltInResource InitResources()
     Resources.maxGeometryInputComponents                = 64;
     Resources.maxGeometryOutputComponents               = 128;
     Resources.maxFragmentInputComponents                = 128;
-    Resources.maxImageUnits                             = 8;
-    Resources.maxCombinedImageUnitsAndFragmentOutputs   = 8;
-    Resources.maxCombinedShaderOutputResources          = 8;
+    Resources.maxImageUnits                             = 16;
+    Resources.maxCombinedImageUnitsAndFragmentOutputs   = 16;
+    Resources.maxCombinedShaderOutputResources          = 64;
     Resources.maxImageSamples                           = 0;
     Resources.maxVertexImageUniforms                    = 0;
     Resources.maxTessControlImageUniforms               = 0;
     Resources.maxTessEvaluationImageUniforms            = 0;
     Resources.maxGeometryImageUniforms                  = 0;
     Resources.maxFragmentImageUniforms                  = 8;
-    Resources.maxCombinedImageUniforms                  = 8;
+    Resources.maxCombinedImageUniforms                  = 16;
     Resources.maxGeometryTextureImageUnits              = 16;
     Resources.maxGeometryOutputVertices                 = 256;
     Resources.maxGeometryTotalOutputComponents          = 1024;
@@ -183,6 +184,16 @@ CompileResult compile_glsl_to_spirv(EShLanguage stage,
     return r;
 }
 
+bool compile_many(std::span<CompileJob> jobs) {
+    g_jobs.parallel_for(static_cast<uint32_t>(jobs.size()), 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i)
+            jobs[i].result = compile_glsl_to_spirv(jobs[i].stage, jobs[i].source, jobs[i].options, jobs[i].debugName);
+    });
+    bool ok = true;
+    for (const CompileJob& j : jobs) ok &= j.result.ok;
+    return ok;
+}
+
 VkShaderModule make_shader_module(VkDevice device, std::span<const uint32_t> words) {
     VkShaderModuleCreateInfo ci{};
     ci.sType    = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
@@ -35,6 +35,15 @@ struct Options {
 
     glslang::SpvOptions spv{};   // passed straight to GlslangToSpv
 
+    // Compute work (culling, particles, fog) wants subgroup ops, which need
+    // Vulkan 1.1 / SPIR-V 1.3; everything else stays as the defaults.
+    static Options compute() {
+        Options o;
+        o.vulkanTarget = glslang::EShTargetVulkan_1_1;
+        o.spirvTarget  = glslang::EShTargetSpv_1_3;
+        return o;
+    }
+
     Options() {
         spv.validate = true;
     #ifdef NDEBUG
@@ -55,6 +64,18 @@ CompileResult compile_glsl_to_spirv(EShLanguage stage,
                                     const Options& opt = Options(),
                                     std::string_view debugName = "shader.glsl");
 
+// One entry of a batch; 'result' is filled in by compile_many.
+struct CompileJob {
+    EShLanguage      stage;
+    std::string_view source;
+    Options          options{};
+    std::string_view debugName = "shader.glsl";
+    CompileResult    result{};
+};
+
+// Compiles every job on the shared job pool (each TShader is independent once
+// glslang::InitializeProcess has run). Returns true if all of them compiled.
+bool compile_many(std::span<CompileJob> jobs);
 
 VkShaderModule make_shader_module(VkDevice device, std::span<const uint32_t> words);
 
@@ -0,0 +1,102 @@
+#include "spatial_grid.hpp"
+#include <algorithm>
+#include <cmath>
+
+void SpatialGrid::init(float world_w, float world_d, float cell_size) {
+    DEBUG_ASSERT(cell_size > 0.f);
+    m_cell     = cell_size;
+    m_inv_cell = 1.f / cell_size;
+    m_cells_x  = std::max(1u, uint32_t(std::ceil(world_w * m_inv_cell)));
+    m_cells_z  = std::max(1u, uint32_t(std::ceil(world_d * m_inv_cell)));
+    m_cells.assign(size_t(m_cells_x) * m_cells_z, {});
+    m_where.clear();
+    m_size = 0;
+}
+
+void SpatialGrid::clear() {
+    for (auto& c : m_cells) c.clear();
+    m_where.clear();
+    m_size = 0;
+}
+
+uint32_t SpatialGrid::cell_of(float x, float z) const {
+    const int cx = std::clamp(int(std::floor(x * m_inv_cell)), 0, int(m_cells_x) - 1);
+    const int cz = std::clamp(int(std::floor(z * m_inv_cell)), 0, int(m_cells_z) - 1);
+    return uint32_t(cz) * m_cells_x + uint32_t(cx);
+}
+
+void SpatialGrid::cell_range_(float x0, float z0, float x1, float z1,
+                              uint32_t& cx0, uint32_t& cz0, uint32_t& cx1, uint32_t& cz1) const {
+    if (x0 > x1) std::swap(x0, x1);
+    if (z0 > z1) std::swap(z0, z1);
+    auto clamp_x = [&](float v) { return uint32_t(std::clamp(int(std::floor(v * m_inv_cell)), 0, int(m_cells_x) - 1)); };
+    auto clamp_z = [&](float v) { return uint32_t(std::clamp(int(std::floor(v * m_inv_cell)), 0, int(m_cells_z) - 1)); };
+    cx0 = clamp_x(x0); cx1 = clamp_x(x1);
+    cz0 = clamp_z(z0); cz1 = clamp_z(z1);
+}
+
+void SpatialGrid::erase_(uint32_t cell, uint32_t slot) {
+    std::vector<Item>& bucket = m_cells[cell];
+    const uint32_t last = uint32_t(bucket.size()) - 1;
+    if (slot != last) {
+        bucket[slot] = bucket[last];
+        m_where[bucket[slot].entity.index].slot = slot;
+    }
+    bucket.pop_back();
+}
+
+void SpatialGrid::update(Entity e, float x, float y, float z) {
+    if (e.index >= m_where.size()) m_where.resize(size_t(e.index) + 1);
+    Where& w = m_where[e.index];
+    const uint32_t cell = cell_of(x, z);
+
+    if (w.cell != kNone && w.generation == e.generation) {
+        if (w.cell == cell) {   // common case: same cell, refresh the position
+            m_cells[cell][w.slot] = Item{ e, x, y, z };
+            return;
+        }
+        erase_(w.cell, w.slot);
+    } else {
+        if (w.cell != kNone) erase_(w.cell, w.slot);   // a stale handle still listed: replace it
+        else                 ++m_size;
+    }
+
+    w.generation = e.generation;
+    w.cell       = cell;
+    w.slot       = uint32_t(m_cells[cell].size());
+    m_cells[cell].push_back(Item{ e, x, y, z });
+}
+
+bool SpatialGrid::remove(Entity e) {
+    if (!contains(e)) return false;
+    Where& w = m_where[e.index];
+    erase_(w.cell, w.slot);
+    w.cell = kNone;
+    --m_size;
+    return true;
+}
+
+bool SpatialGrid::contains(Entity e) const {
+    return e.index < m_where.size() && m_where[e.index].cell != kNone
+        && m_where[e.index].generation == e.generation;
+}
+
+uint32_t SpatialGrid::query_radius(float x, float z, float r, std::vector<Entity>& out) const {
+    const size_t before = out.size();
+    const float r2 = r * r;
+    for_each_in_rect(x - r, z - r, x + r, z + r, [&](const Item& it) {
+        const float dx = it.x - x, dz = it.z - z;
+        if (dx * dx + dz * dz <= r2) out.push_back(it.entity);
+    });
+    return uint32_t(out.size() - before);
+}
+
+uint32_t SpatialGrid::query_rect(float x0, float z0, float x1, float z1, std::vector<Entity>& out) const {
+    if (x0 > x1) std::swap(x0, x1);
+    if (z0 > z1) std::swap(z0, z1);
+    const size_t before = out.size();
+    for_each_in_rect(x0, z0, x1, z1, [&](const Item& it) {
+        if (it.x >= x0 && it.x <= x1 && it.z >= z0 && it.z <= z1) out.push_back(it.entity);
+    });
+    return uint32_t(out.size() - before);
+}
@@ -0,0 +1,79 @@
+#ifndef SPATIAL_GRID_HPP
+#define SPATIAL_GRID_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "entity_store.hpp"
+
+// Uniform grid over the XZ ground plane answering "what is near here":
+// neighbour search for the sim, range checks, box and click selection. The
+// world rectangle [0, world_w) x [0, world_d) is cut into square cells
+// (positions outside clamp into the border cells); each cell holds a dense
+// bucket of {entity, position}, so a query reads only the cells it overlaps
+// instead of every unit. update() is incremental: a unit that stays in its
+// cell only has its stored position refreshed, crossing into another cell is
+// a swap-and-pop plus an append. Pure CPU.
+//
+// Pick the cell size around the typical query radius (a unit's sensing range):
+// a radius query then touches 3x3 cells.
+class SpatialGrid {
+public:
+    struct Item {
+        Entity entity;
+        float  x, y, z;
+    };
+
+    void init(float world_w, float world_d, float cell_size);
+    void clear();   // drops every entity, keeps the layout
+
+    // Inserts e, or moves it if it's already in. O(1).
+    void update(Entity e, float x, float y, float z);
+    bool remove(Entity e);   // false if e isn't in (or is a stale handle)
+    bool contains(Entity e) const;
+    uint32_t size() const { return m_size; }
+
+    // Append the entities within r of (x, z) (distance on the ground plane) /
+    // inside the rect, and return how many were appended.
+    uint32_t query_radius(float x, float z, float r, std::vector<Entity>& out) const;
+    uint32_t query_rect(float x0, float z0, float x1, float z1, std::vector<Entity>& out) const;
+
+    // Calls f(const Item&) for everything in the cells the rect overlaps, with
+    // no exact test: the broad phase for callers that have their own.
+    template <class F>
+    void for_each_in_rect(float x0, float z0, float x1, float z1, F&& f) const {
+        uint32_t cx0, cz0, cx1, cz1;
+        cell_range_(x0, z0, x1, z1, cx0, cz0, cx1, cz1);
+        for (uint32_t cz = cz0; cz <= cz1; ++cz)
+            for (uint32_t cx = cx0; cx <= cx1; ++cx)
+                for (const Item& it : m_cells[size_t(cz) * m_cells_x + cx]) f(it);
+    }
+
+    float    cell_size() const { return m_cell; }
+    uint32_t cells_x()   const { return m_cells_x; }
+    uint32_t cells_z()   const { return m_cells_z; }
+    uint32_t cell_of(float x, float z) const;
+
+private:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    // where an entity index currently sits
+    struct Where {
+        uint32_t generation = 0;
+        uint32_t cell       = kNone;
+        uint32_t slot       = 0;
+    };
+
+    void cell_range_(float x0, float z0, float x1, float z1,
+                     uint32_t& cx0, uint32_t& cz0, uint32_t& cx1, uint32_t& cz1) const;
+    void erase_(uint32_t cell, uint32_t slot);
+
+    float    m_cell = 1.f, m_inv_cell = 1.f;
+    uint32_t m_cells_x = 0, m_cells_z = 0;
+    uint32_t m_size = 0;
+
+    std::vector<std::vector<Item>> m_cells;   // row-major, z rows of x cells
+    std::vector<Where>             m_where;   // by entity index
+};
+
+#endif // SPATIAL_GRID_HPP
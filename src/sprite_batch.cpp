@@ -0,0 +1,116 @@
+#include "sprite_batch.hpp"
+#include <cstddef>
+
+std::string sprite_batch_fs(const BindlessTextures& textures) {
+    std::string s = "#version 450\n";
+    s += textures.glsl_decl(0);
+    s += R"GLSL(
+layout(location=0) in vec2 vUV;
+layout(location=1) in vec4 vTint;
+layout(location=2) flat in uint vTexture;
+layout(location=0) out vec4 outColor;
+
+void main() {
+    outColor = texture(bindless_texture(vTexture), vUV) * vTint;
+}
+)GLSL";
+    return s;
+}
+
+VkResult SpriteBatch::create(VkDevice device,
+                             VkRenderPass renderPass,
+                             VkShaderModule vs, VkShaderModule fs,
+                             const BindlessTextures& textures,
+                             const VkPipelineRenderingCreateInfo* rendering)
+{
+    // set 0: the bindless table; VS push constant: view transform
+    VkDescriptorSetLayout set = textures.set_layout();
+    VkPushConstantRange pc{ VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(float)*4 };
+    auto pl = render::layout_info({ &set, 1 }, { &pc, 1 });
+    VK_CHECK(vkCreatePipelineLayout(device, &pl, nullptr, &m_layout));
+
+    VkVertexInputBindingDescription bind{
+        .binding   = 0,
+        .stride    = sizeof(SpriteInstance),
+        .inputRate = VK_VERTEX_INPUT_RATE_INSTANCE
+    };
+    VkVertexInputAttributeDescription attrs[6] = {
+        { .location=0, .binding=0, .format=VK_FORMAT_R32G32_SFLOAT,       .offset=offsetof(SpriteInstance, x)        },
+        { .location=1, .binding=0, .format=VK_FORMAT_R32G32_SFLOAT,       .offset=offsetof(SpriteInstance, w)        },
+        { .location=2, .binding=0, .format=VK_FORMAT_R32G32B32A32_SFLOAT, .offset=offsetof(SpriteInstance, u0)       },
+        { .location=3, .binding=0, .format=VK_FORMAT_R32_SFLOAT,          .offset=offsetof(SpriteInstance, rotation) },
+        { .location=4, .binding=0, .format=VK_FORMAT_R8G8B8A8_UNORM,      .offset=offsetof(SpriteInstance, tint)     },
+        { .location=5, .binding=0, .format=VK_FORMAT_R32_UINT,            .offset=offsetof(SpriteInstance, texture)  }
+    };
+    auto vin   = render::vertex_input_info({ &bind, 1 }, attrs);
+    auto ia    = render::input_assembly_info(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_FALSE);
+    auto rs    = render::rasterization_state_info(/*cull*/VK_CULL_MODE_NONE);
+    auto ms    = render::multisample_state_info();
+    VkPipelineColorBlendAttachmentState att[1] = { render::alpha_blend };
+    auto cb    = render::color_blend_state(att);
+    auto stages= render::fragment_vertex_stage_info(fs, vs);
+
+    return render::create_graphics_pipeline(
+        m_pipeline, device, stages, /*dynamic viewport*/nullptr, m_layout, renderPass,
+        rs, cb, vin, ia, ms,
+        0, nullptr, nullptr, nullptr, 0, VK_NULL_HANDLE, -1,
+        rendering
+    );
+}
+
+void SpriteBatch::destroy(VkDevice device) {
+    if (m_pipeline) vkDestroyPipeline(device, m_pipeline, nullptr);
+    if (m_layout)   vkDestroyPipelineLayout(device, m_layout, nullptr);
+    m_pipeline = VK_NULL_HANDLE;
+    m_layout   = VK_NULL_HANDLE;
+    m_mapped   = nullptr;
+    m_capacity = m_count = m_draws = 0;
+    m_runs.clear();
+}
+
+VkResult SpriteBatch::begin(MappedArena& arena, uint32_t max_sprites) {
+    arena.assert_matches(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+
+    m_mapped   = nullptr;
+    m_capacity = m_count = 0;
+    m_runs.clear();
+    if (max_sprites == 0) return VK_SUCCESS;
+
+    if (auto r = arena.alloc(VkDeviceSize(max_sprites) * sizeof(SpriteInstance), m_alloc,
+                             alignof(SpriteInstance))) return r;
+    m_mapped   = static_cast<SpriteInstance*>(m_alloc.cpu_ptr);
+    m_capacity = max_sprites;
+    return VK_SUCCESS;
+}
+
+void SpriteBatch::record(VkCommandBuffer cb, MappedArena& arena, const BindlessTextures& textures,
+                         const float view[4])
+{
+    m_draws = 0;
+    if (m_count == 0) return;
+
+    arena.flush(m_alloc, VkDeviceSize(m_count) * sizeof(SpriteInstance));
+
+    vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
+    textures.bind(cb, m_layout, 0);
+    vkCmdPushConstants(cb, m_layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(float)*4, view);
+
+    VkBuffer vb = m_alloc.buffer;
+    VkDeviceSize vbOff = m_alloc.offset;
+    vkCmdBindVertexBuffers(cb, 0, 1, &vb, &vbOff);
+
+    if (g_vulkan.descriptor_indexing) {
+        // nonuniform indexing: every texture in one draw
+        vkCmdDraw(cb, 6, m_count, 0, 0);
+        m_draws = 1;
+    } else {
+        // index must be uniform per draw: one draw per texture run
+        for (const Run& r : m_runs) vkCmdDraw(cb, 6, r.count, 0, r.first);
+        m_draws = uint32_t(m_runs.size());
+    }
+
+    // batch is consumed; the arena keeps the memory until its frame reset
+    m_mapped   = nullptr;
+    m_capacity = m_count = 0;
+    m_runs.clear();
+}
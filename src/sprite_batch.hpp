@@ -0,0 +1,133 @@
+#ifndef SPRITE_BATCH_HPP
+#define SPRITE_BATCH_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "render.hpp"
+#include "render_pipeline.hpp"
+#include "memory.hpp"
+#include "bindless.hpp"
+
+// One instance per sprite, read straight from the mapped arena (48B).
+struct alignas(16) SpriteInstance {
+    float    x, y;            // center
+    float    w, h;            // size, same units as x/y
+    float    u0, v0, u1, v1;  // uv rect in the texture
+    float    rotation;        // radians, around the center
+    uint32_t tint;            // RGBA8, R in the low byte (see pack_rgba)
+    uint32_t texture;         // BindlessTextures slot
+    uint32_t _pad;
+};
+static_assert(sizeof(SpriteInstance) == 48, "SpriteInstance must be 48B");
+
+inline uint32_t pack_rgba(float r, float g, float b, float a) {
+    auto c = [](float v) { return uint32_t(std::clamp(v, 0.f, 1.f) * 255.f + .5f); };
+    return c(r) | (c(g) << 8) | (c(b) << 16) | (c(a) << 24);
+}
+
+// 6 vertices (two triangles) per instance, no vertex buffer besides the instances.
+constexpr const char* sprite_batch_vs = R"GLSL(
+#version 450
+layout(push_constant) uniform PC { vec4 view; } pc;  // ndc = pos * view.xy + view.zw
+
+layout(location=0) in vec2  in_center;
+layout(location=1) in vec2  in_size;
+layout(location=2) in vec4  in_uv;
+layout(location=3) in float in_rotation;
+layout(location=4) in vec4  in_tint;      // R8G8B8A8_UNORM
+layout(location=5) in uint  in_texture;
+
+layout(location=0) out vec2 vUV;
+layout(location=1) out vec4 vTint;
+layout(location=2) flat out uint vTexture;
+
+const vec2 kCorner[6] = vec2[](vec2(0,0), vec2(1,0), vec2(0,1),
+                               vec2(1,0), vec2(1,1), vec2(0,1));
+
+void main() {
+    vec2 c = kCorner[gl_VertexIndex % 6];
+    vec2 p = (c - 0.5) * in_size;
+    float s = sin(in_rotation), k = cos(in_rotation);
+    p = vec2(p.x * k - p.y * s, p.x * s + p.y * k) + in_center;
+
+    vUV      = mix(in_uv.xy, in_uv.zw, c);
+    vTint    = in_tint;
+    vTexture = in_texture;
+    gl_Position = vec4(p * pc.view.xy + pc.view.zw, 0.0, 1.0);
+}
+)GLSL";
+
+// Fragment shader source for the given table (its declaration depends on
+// whether descriptor indexing is available).
+std::string sprite_batch_fs(const BindlessTextures& textures);
+
+// Instanced 2D quads: unit icons, health bars, selection rings, UI. Sprites
+// are written directly into a MappedArena as they are pushed; record() then
+// binds one pipeline and the bindless table once and issues one draw per run
+// of sprites sharing a texture (a single draw when descriptor indexing lets
+// the index vary inside a draw). Push sprites grouped by texture page to keep
+// runs long; solid bars are a 1x1 white texture and a tint.
+class SpriteBatch {
+public:
+    // With dynamic rendering pass renderPass = VK_NULL_HANDLE + 'rendering'.
+    // Alpha blended, no depth; viewport/scissor are dynamic.
+    VkResult create(VkDevice device,
+                    VkRenderPass renderPass,
+                    VkShaderModule vs, VkShaderModule fs,
+                    const BindlessTextures& textures,
+                    const VkPipelineRenderingCreateInfo* rendering = nullptr);
+    void destroy(VkDevice device);
+
+    // Reserves room for max_sprites in 'arena' (needs VERTEX_BUFFER usage).
+    // OOM is returned as-is: the caller owns the growth policy, as with text.
+    VkResult begin(MappedArena& arena, uint32_t max_sprites);
+
+    // Writes into mapped memory; false once the reservation is full.
+    bool push(const SpriteInstance& s) {
+        if (m_count == m_capacity) return false;
+        m_mapped[m_count] = s;
+        if (m_runs.empty() || m_runs.back().texture != s.texture)
+            m_runs.push_back({ s.texture, m_count, 0 });
+        ++m_runs.back().count;
+        ++m_count;
+        return true;
+    }
+
+    // Records the draws and ends the batch. view maps sprite coordinates to
+    // NDC: ndc = pos * (view[0], view[1]) + (view[2], view[3]).
+    void record(VkCommandBuffer cb, MappedArena& arena, const BindlessTextures& textures,
+                const float view[4]);
+
+    // view[] for sprite coordinates in pixels, origin top-left.
+    static void pixel_view(VkExtent2D extent, float out[4]) {
+        out[0] =  2.f / float(extent.width);
+        out[1] =  2.f / float(extent.height);
+        out[2] = -1.f;
+        out[3] = -1.f;
+    }
+
+    uint32_t size()       const { return m_count; }
+    uint32_t draw_count() const { return m_draws; }   // of the last record()
+
+private:
+    struct Run {
+        uint32_t texture;
+        uint32_t first;
+        uint32_t count;
+    };
+
+    VkPipelineLayout m_layout   = VK_NULL_HANDLE;
+    VkPipeline       m_pipeline = VK_NULL_HANDLE;
+
+    UploadAlloc      m_alloc{};
+    SpriteInstance*  m_mapped   = nullptr;
+    uint32_t         m_capacity = 0;
+    uint32_t         m_count    = 0;
+    uint32_t         m_draws    = 0;
+    std::vector<Run> m_runs;
+};
+
+#endif // SPRITE_BATCH_HPP
@@ -0,0 +1,161 @@
+#include "terrain.hpp"
+#include "jobs.hpp"
+#include <algorithm>
+#include <cstddef>
+
+VkResult TerrainRenderer::create(VkDevice device, VkPhysicalDevice phys,
+                                 const RenderTargets& targets,
+                                 VkShaderModule vs, VkShaderModule fs,
+                                 UploadQueue& uploads,
+                                 TileMap& map,
+                                 std::span<const uint32_t> palette,
+                                 const VkPipelineDepthStencilStateCreateInfo* depth)
+{
+    m_palette.assign(palette.begin(), palette.end());
+    const uint32_t chunks = map.chunk_count();
+
+    // pipeline: position + color, view_proj push constant
+    VkPushConstantRange pc{ VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(float)*16 };
+    auto pl = render::layout_info({}, { &pc, 1 });
+    VK_CHECK(vkCreatePipelineLayout(device, &pl, nullptr, &m_layout));
+
+    VkVertexInputBindingDescription bind{
+        .binding   = 0,
+        .stride    = sizeof(TerrainVertex),
+        .inputRate = VK_VERTEX_INPUT_RATE_VERTEX
+    };
+    VkVertexInputAttributeDescription attrs[2] = {
+        { .location=0, .binding=0, .format=VK_FORMAT_R32G32B32_SFLOAT, .offset=offsetof(TerrainVertex, x)     },
+        { .location=1, .binding=0, .format=VK_FORMAT_R8G8B8A8_UNORM,   .offset=offsetof(TerrainVertex, color) }
+    };
+    auto vin   = render::vertex_input_info({ &bind, 1 }, attrs);
+    auto ia    = render::input_assembly_info(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_FALSE);
+    auto rs    = render::rasterization_state_info(/*cull*/VK_CULL_MODE_NONE);
+    auto ms    = render::multisample_state_info();
+    VkPipelineColorBlendAttachmentState att[1] = { render::no_blend };
+    auto cb    = render::color_blend_state(att);
+    auto stages= render::fragment_vertex_stage_info(fs, vs);
+
+    if (auto r = render::create_graphics_pipeline(
+            m_pipeline, device, stages, /*dynamic viewport*/nullptr, m_layout, targets.render_pass,
+            rs, cb, vin, ia, ms,
+            0, nullptr, depth, nullptr, 0, VK_NULL_HANDLE, -1,
+            targets.pipeline_rendering())) return r;
+
+    // buffers
+    if (auto r = m_vertices.create(device, phys, kChunkBytes * chunks,
+                                   VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT)) return r;
+    if (auto r = m_indices.create(device, phys, kTerrainChunkIndices * sizeof(uint16_t),
+                                  VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT)) return r;
+
+    std::vector<uint16_t> indices(kTerrainChunkIndices);
+    build_chunk_indices(indices.data());
+    if (auto r = uploads.buffer(m_indices.buffer(), 0, indices.data(), indices.size() * sizeof(uint16_t),
+                                VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT, VK_ACCESS_2_INDEX_READ_BIT)) return r;
+
+    // every chunk once, a batch at a time: build the batch on the job pool,
+    // then hand it to the upload queue, which stages and flushes as its ring fills
+    constexpr uint32_t kBatch = 64;
+    std::vector<TerrainVertex> scratch(size_t(kBatch) * kTerrainChunkVerts);
+    m_bounds.resize(chunks);
+    for (uint32_t first = 0; first < chunks; first += kBatch) {
+        const uint32_t n = std::min(kBatch, chunks - first);
+        g_jobs.parallel_for(n, 1, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i)
+                m_bounds[first + i] = build_chunk_mesh(map, first + i, m_palette, &scratch[size_t(i) * kTerrainChunkVerts]);
+        });
+        if (auto r = uploads.buffer(m_vertices.buffer(), kChunkBytes * first, scratch.data(), kChunkBytes * n)) return r;
+    }
+    m_dirty.clear();
+    map.take_dirty(m_dirty);   // all of them: just built
+    m_dirty.clear();
+
+    return uploads.flush();
+}
+
+void TerrainRenderer::destroy(VkDevice device) {
+    if (m_pipeline) vkDestroyPipeline(device, m_pipeline, nullptr);
+    if (m_layout)   vkDestroyPipelineLayout(device, m_layout, nullptr);
+    m_pipeline = VK_NULL_HANDLE;
+    m_layout   = VK_NULL_HANDLE;
+    m_vertices.destroy(device);
+    m_indices.destroy(device);
+    m_bounds.clear();
+    m_dirty.clear();
+    m_slots.clear();
+    m_stats = {};
+}
+
+VkResult TerrainRenderer::update(VkCommandBuffer cb, MappedArena& arena, TileMap& map) {
+    m_stats.chunks_rebuilt = m_stats.chunks_pending = 0;
+    if (!map.any_dirty()) return VK_SUCCESS;
+
+    arena.assert_matches(VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+    m_dirty.clear();
+    map.take_dirty(m_dirty);
+
+    // arena slices first (sequential: the arena isn't thread-safe)...
+    VkResult result = VK_SUCCESS;
+    m_slots.clear();
+    for (size_t i = 0; i < m_dirty.size(); ++i) {
+        UploadAlloc a{};
+        if (arena.alloc(kChunkBytes, a, alignof(TerrainVertex)) != VK_SUCCESS) {
+            // out of room: the rest stays dirty. Some progress is worth
+            // another call next frame; none means the arena has to grow
+            for (size_t j = i; j < m_dirty.size(); ++j) map.mark_dirty(m_dirty[j]);
+            result = m_slots.empty() ? VK_ERROR_OUT_OF_DEVICE_MEMORY : VK_INCOMPLETE;
+            break;
+        }
+        m_slots.push_back(a);
+    }
+    m_stats.chunks_pending = uint32_t(m_dirty.size() - m_slots.size());
+    if (m_slots.empty()) return result;
+
+    // last frame's vertex fetches are done before we overwrite
+    auto war = render::buffer_barrier2(m_vertices.buffer(),
+        VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT, 0,
+        VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
+    render::cmd_barriers(cb, {}, { &war, 1 });
+
+    // ...then the meshes, written straight into them across the job pool
+    g_jobs.parallel_for(uint32_t(m_slots.size()), 4, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            const uint32_t c = m_dirty[i];
+            m_bounds[c] = build_chunk_mesh(map, c, m_palette, static_cast<TerrainVertex*>(m_slots[i].cpu_ptr));
+        }
+    });
+
+    for (size_t i = 0; i < m_slots.size(); ++i) {
+        const UploadAlloc& a = m_slots[i];
+        arena.flush(a, kChunkBytes);
+        VkBufferCopy copy{ a.offset, kChunkBytes * m_dirty[i], kChunkBytes };
+        vkCmdCopyBuffer(cb, a.buffer, m_vertices.buffer(), 1, &copy);
+        ++m_stats.chunks_rebuilt;
+    }
+
+    auto raw = render::buffer_barrier2(m_vertices.buffer(),
+        VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+        VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT, VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT);
+    render::cmd_barriers(cb, {}, { &raw, 1 });
+    return result;
+}
+
+void TerrainRenderer::draw(VkCommandBuffer cb, const float view_proj[16]) {
+    m_stats.chunks_drawn = m_stats.chunks_culled = 0;
+    if (m_bounds.empty()) return;
+
+    const Frustum f = Frustum::from_view_proj(view_proj);
+
+    vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
+    vkCmdPushConstants(cb, m_layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(float)*16, view_proj);
+    VkBuffer vb = m_vertices.buffer();
+    VkDeviceSize vbOff = 0;
+    vkCmdBindVertexBuffers(cb, 0, 1, &vb, &vbOff);
+    vkCmdBindIndexBuffer(cb, m_indices.buffer(), 0, VK_INDEX_TYPE_UINT16);
+
+    for (uint32_t c = 0; c < m_bounds.size(); ++c) {
+        if (!f.aabb(m_bounds[c].min, m_bounds[c].max)) { ++m_stats.chunks_culled; continue; }
+        vkCmdDrawIndexed(cb, kTerrainChunkIndices, 1, 0, int32_t(c * kTerrainChunkVerts), 0);
+        ++m_stats.chunks_drawn;
+    }
+}
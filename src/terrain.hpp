@@ -0,0 +1,92 @@
+#ifndef TERRAIN_HPP
+#define TERRAIN_HPP
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "render.hpp"
+#include "render_pipeline.hpp"
+#include "memory.hpp"
+#include "upload.hpp"
+#include "frustum.hpp"
+#include "terrain_mesh.hpp"
+
+constexpr const char* terrain_vs = R"GLSL(
+#version 450
+layout(push_constant) uniform PC { mat4 view_proj; } pc;
+
+layout(location=0) in vec3 in_pos;
+layout(location=1) in vec4 in_color;   // R8G8B8A8_UNORM
+
+layout(location=0) out vec4 vColor;
+
+void main() {
+    vColor = in_color;
+    gl_Position = pc.view_proj * vec4(in_pos, 1.0);
+}
+)GLSL";
+
+constexpr const char* terrain_fs = R"GLSL(
+#version 450
+layout(location=0) in  vec4 vColor;
+layout(location=0) out vec4 outColor;
+void main() { outColor = vColor; }
+)GLSL";
+
+struct TerrainStats {
+    uint32_t chunks_drawn   = 0;
+    uint32_t chunks_culled  = 0;
+    uint32_t chunks_rebuilt = 0;   // by the last update()
+    uint32_t chunks_pending = 0;   // left dirty by the last update() for lack of arena room
+};
+
+// Tile map renderer. The map is cut into kTerrainChunk² tile chunks whose
+// meshes live in one device-local vertex buffer (a fixed slice per chunk)
+// and share one index buffer. Meshes are built once at create() and only
+// rebuilt when TileMap::set() touched the chunk; draw() culls chunk AABBs
+// against the frustum on the CPU and issues one indexed draw per visible
+// chunk. Chunk meshes are built in parallel on g_jobs.
+class TerrainRenderer {
+public:
+    // Initial meshes go through 'uploads' (fresh buffers); the caller runs
+    // uploads.acquire() on the graphics side as for any other upload.
+    VkResult create(VkDevice device, VkPhysicalDevice phys,
+                    const RenderTargets& targets,
+                    VkShaderModule vs, VkShaderModule fs,
+                    UploadQueue& uploads,
+                    TileMap& map,
+                    std::span<const uint32_t> palette,     // RGBA8 per tile type
+                    const VkPipelineDepthStencilStateCreateInfo* depth = nullptr);
+    void destroy(VkDevice device);
+
+    // Outside rendering: rebuilds dirty chunks straight into 'arena' (needs
+    // TRANSFER_SRC usage) and copies them into place. When the arena runs
+    // out the rest stay dirty: VK_INCOMPLETE if some chunks made it (call
+    // again next frame), VK_ERROR_OUT_OF_DEVICE_MEMORY if none did, which
+    // the caller has to fix (a bigger arena, or fewer uploads sharing it)
+    // because the same call would fail the same way.
+    VkResult update(VkCommandBuffer cb, MappedArena& arena, TileMap& map);
+
+    // Inside rendering.
+    void draw(VkCommandBuffer cb, const float view_proj[16]);
+
+    const TerrainStats& stats() const { return m_stats; }
+
+private:
+    static constexpr VkDeviceSize kChunkBytes = VkDeviceSize(kTerrainChunkVerts) * sizeof(TerrainVertex);
+
+    VkPipelineLayout m_layout   = VK_NULL_HANDLE;
+    VkPipeline       m_pipeline = VK_NULL_HANDLE;
+
+    GpuBuffer m_vertices;   // kChunkBytes per chunk
+    GpuBuffer m_indices;    // shared uint16 pattern
+
+    std::vector<ChunkBounds> m_bounds;
+    std::vector<uint32_t>    m_dirty;      // scratch for take_dirty
+    std::vector<UploadAlloc> m_slots;      // scratch: arena slice per dirty chunk
+    std::vector<uint32_t>    m_palette;
+    TerrainStats             m_stats;
+};
+
+#endif // TERRAIN_HPP
@@ -0,0 +1,93 @@
+#include "terrain_mesh.hpp"
+#include <algorithm>
+
+void TileMap::resize(uint32_t width, uint32_t height) {
+    m_w  = width;
+    m_h  = height;
+    m_cx = (width  + kTerrainChunk - 1) / kTerrainChunk;
+    m_cy = (height + kTerrainChunk - 1) / kTerrainChunk;
+    m_tiles.assign(size_t(width) * height, Tile{});
+    m_dirty.assign(size_t(m_cx) * m_cy, 1);
+    m_dirty_count = m_cx * m_cy;
+}
+
+void TileMap::set(uint32_t x, uint32_t y, Tile t) {
+    Tile& cur = m_tiles[size_t(y) * m_w + x];
+    if (cur.type == t.type && cur.elevation == t.elevation) return;
+    cur = t;
+
+    mark_dirty((y / kTerrainChunk) * m_cx + (x / kTerrainChunk));
+}
+
+void TileMap::take_dirty(std::vector<uint32_t>& out) {
+    if (!m_dirty_count) return;
+    for (uint32_t i = 0; i < m_dirty.size(); ++i) {
+        if (!m_dirty[i]) continue;
+        m_dirty[i] = 0;
+        out.push_back(i);
+    }
+    m_dirty_count = 0;
+}
+
+void TileMap::mark_all_dirty() {
+    std::fill(m_dirty.begin(), m_dirty.end(), uint8_t(1));
+    m_dirty_count = static_cast<uint32_t>(m_dirty.size());
+}
+
+// darken by up to ~30% for low ground so elevation reads without lighting
+static uint32_t shade(uint32_t rgba, uint8_t elevation) {
+    const uint32_t k = 180u + std::min<uint32_t>(elevation, 15u) * 5u;   // 180..255
+    const uint32_t r = ((rgba >>  0) & 0xFF) * k / 255u;
+    const uint32_t g = ((rgba >>  8) & 0xFF) * k / 255u;
+    const uint32_t b = ((rgba >> 16) & 0xFF) * k / 255u;
+    return r | (g << 8) | (b << 16) | (rgba & 0xFF000000u);
+}
+
+ChunkBounds build_chunk_mesh(const TileMap& map, uint32_t chunk,
+                             std::span<const uint32_t> palette,
+                             TerrainVertex* out)
+{
+    const uint32_t cx = chunk % map.chunks_x();
+    const uint32_t cy = chunk / map.chunks_x();
+    const uint32_t x0 = cx * kTerrainChunk;
+    const uint32_t y0 = cy * kTerrainChunk;
+
+    ChunkBounds b{ { x0 * kTerrainTileSize, 0.f, y0 * kTerrainTileSize },
+                   { (x0 + kTerrainChunk) * kTerrainTileSize, 0.f, (y0 + kTerrainChunk) * kTerrainTileSize } };
+    uint8_t lo = 255, hi = 0;
+
+    for (uint32_t ty = 0; ty < kTerrainChunk; ++ty) {
+        for (uint32_t tx = 0; tx < kTerrainChunk; ++tx, out += 4) {
+            const uint32_t x = x0 + tx, y = y0 + ty;
+            if (x >= map.width() || y >= map.height()) {
+                out[0] = out[1] = out[2] = out[3] = TerrainVertex{ 0.f, 0.f, 0.f, 0u };
+                continue;
+            }
+            const Tile& t = map.at(x, y);
+            lo = std::min(lo, t.elevation);
+            hi = std::max(hi, t.elevation);
+
+            const uint32_t c  = shade(t.type < palette.size() ? palette[t.type] : 0xFFFF00FFu, t.elevation);
+            const float    h  = t.elevation * kTerrainStepHeight;
+            const float    fx = x * kTerrainTileSize, fz = y * kTerrainTileSize;
+            out[0] = { fx,                    h, fz,                    c };
+            out[1] = { fx + kTerrainTileSize, h, fz,                    c };
+            out[2] = { fx,                    h, fz + kTerrainTileSize, c };
+            out[3] = { fx + kTerrainTileSize, h, fz + kTerrainTileSize, c };
+        }
+    }
+
+    if (lo <= hi) {
+        b.min[1] = lo * kTerrainStepHeight;
+        b.max[1] = hi * kTerrainStepHeight;
+    }
+    return b;
+}
+
+void build_chunk_indices(uint16_t* out) {
+    for (uint32_t q = 0; q < kTerrainChunk * kTerrainChunk; ++q, out += 6) {
+        const uint16_t v = static_cast<uint16_t>(q * 4);
+        out[0] = v;     out[1] = v + 2; out[2] = v + 1;
+        out[3] = v + 1; out[4] = v + 2; out[5] = v + 3;
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef TERRAIN_MESH_HPP
+#define TERRAIN_MESH_HPP
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// CPU side of the terrain: the tile grid, per-chunk dirty tracking and the
+// chunk mesh builder. No Vulkan here, so the sim and benchmarks can use it.
+
+constexpr uint32_t kTerrainChunk       = 32;                                   // tiles per chunk side
+constexpr uint32_t kTerrainChunkVerts  = kTerrainChunk * kTerrainChunk * 4;    // 4096: fits uint16 indices
+constexpr uint32_t kTerrainChunkIndices= kTerrainChunk * kTerrainChunk * 6;
+constexpr float    kTerrainTileSize    = 1.0f;    // world units per tile (x/z)
+constexpr float    kTerrainStepHeight  = 0.25f;   // world units per elevation step (y)
+
+struct Tile {
+    uint8_t type      = 0;   // palette index
+    uint8_t elevation = 0;
+};
+
+// Position + RGBA8 color (16B), same layout as UnitVertex.
+struct TerrainVertex {
+    float    x, y, z;
+    uint32_t color;
+};
+
+class TileMap {
+public:
+    TileMap() = default;
+    TileMap(uint32_t width, uint32_t height) { resize(width, height); }
+
+    void resize(uint32_t width, uint32_t height);
+
+    uint32_t width()    const { return m_w; }
+    uint32_t height()   const { return m_h; }
+    uint32_t chunks_x() const { return m_cx; }
+    uint32_t chunks_y() const { return m_cy; }
+    uint32_t chunk_count() const { return m_cx * m_cy; }
+
+    const Tile& at(uint32_t x, uint32_t y) const { return m_tiles[size_t(y) * m_w + x]; }
+
+    // Writes go through set() so the owning chunk gets rebuilt.
+    void set(uint32_t x, uint32_t y, Tile t);
+
+    // Appends the chunks changed since the last call (index = cy * chunks_x + cx)
+    // and clears their flags.
+    void take_dirty(std::vector<uint32_t>& out);
+    bool any_dirty() const { return m_dirty_count != 0; }
+
+    // Marks everything dirty (after bulk edits through tiles()).
+    void mark_all_dirty();
+    void mark_dirty(uint32_t chunk) {
+        if (!m_dirty[chunk]) { m_dirty[chunk] = 1; ++m_dirty_count; }
+    }
+    std::span<Tile> tiles() { return m_tiles; }
+
+private:
+    uint32_t m_w = 0, m_h = 0;
+    uint32_t m_cx = 0, m_cy = 0;
+    std::vector<Tile>    m_tiles;
+    std::vector<uint8_t> m_dirty;       // per chunk
+    uint32_t             m_dirty_count = 0;
+};
+
+struct ChunkBounds {
+    float min[3];
+    float max[3];
+};
+
+// Writes exactly kTerrainChunkVerts vertices for chunk 'chunk' (4 per tile,
+// flat-topped at the tile's elevation; tiles past the map edge collapse to
+// degenerate quads). palette[type] is RGBA8; missing entries are magenta.
+ChunkBounds build_chunk_mesh(const TileMap& map, uint32_t chunk,
+                             std::span<const uint32_t> palette,
+                             TerrainVertex* out);
+
+// The index pattern every chunk shares (kTerrainChunkIndices entries).
+void build_chunk_indices(uint16_t* out);
+
+#endif // TERRAIN_MESH_HPP
@@ -1,9 +1,13 @@
 // src/text_atlas.cpp
 #include "text_atlas.hpp"
+#include "render_pipeline.hpp"
+#include "jobs.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstring>
+#include <mutex>
 
 // -----------------------------
 // helpers (internal)
@@ -16,6 +20,9 @@ static std::vector<uint32_t> ascii_set() {
     return v;
 }
 
+// codepoint sets at least this big rasterize on the job pool
+static constexpr size_t kParallelGlyphs = 256;
+
 static uint32_t next_pow2(uint32_t v) {
     if (v == 0) return 1;
     v--; v|=v>>1; v|=v>>2; v|=v>>4; v|=v>>8; v|=v>>16;
@@ -30,42 +37,6 @@ static uint32_t find_mem_type(uint32_t typeBits, VkMemoryPropertyFlags req, VkPh
     return ~0u;
 }
 
-// Classic barrier path (no sync2)
-static void classic_layout_transition(VkCommandBuffer cb, VkImage img,
-                                      VkImageLayout oldLayout, VkImageLayout newLayout) {
-    VkImageMemoryBarrier b{};
-    b.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    b.oldLayout = oldLayout;
-    b.newLayout = newLayout;
-    b.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    b.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    b.image = img;
-    b.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    b.subresourceRange.baseMipLevel = 0;
-    b.subresourceRange.levelCount   = 1;
-    b.subresourceRange.baseArrayLayer = 0;
-    b.subresourceRange.layerCount     = 1;
-
-    VkPipelineStageFlags srcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-    VkPipelineStageFlags dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-    if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
-        srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-        dstStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-        b.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        b.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-    } else if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
-        b.srcAccessMask = 0;
-        b.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-    }
-
-    vkCmdPipelineBarrier(cb,
-        srcStage, dstStage,
-        0,
-        0, nullptr,
-        0, nullptr,
-        1, &b);
-}
-
 // -----------------------------
 // FreeType CPU atlas build
 // -----------------------------
@@ -89,17 +60,15 @@ bool build_cpu_font_atlas(FT_Library ft, const char* font_path,
     struct Tmp {
         uint32_t cp; int w,h,bx,by,adv; std::vector<uint8_t> pix;
     };
-    std::vector<Tmp> glyphs; glyphs.reserve(cps.size());
 
-    size_t totalPx = 0;
-    for (uint32_t cp : cps) {
-        if (FT_Load_Char(face, cp, FT_LOAD_RENDER)) continue;
-        FT_GlyphSlot g = face->glyph;
+    // render one glyph into t; false if the face has nothing for cp
+    auto rasterize = [](FT_Face f, uint32_t cp, Tmp& t) {
+        if (FT_Load_Char(f, cp, FT_LOAD_RENDER)) return false;
+        FT_GlyphSlot g = f->glyph;
         const int w = int(g->bitmap.width);
         const int h = int(g->bitmap.rows);
         const int pitch = g->bitmap.pitch;
 
-        Tmp t{};
         t.cp = cp; t.w=w; t.h=h; t.bx=g->bitmap_left; t.by=g->bitmap_top; t.adv=int(g->advance.x >> 6);
         t.pix.resize(size_t(std::max(0,w)) * std::max(0,h));
 
@@ -116,11 +85,48 @@ bool build_cpu_font_atlas(FT_Library ft, const char* font_path,
                 }
             }
         }
+        return true;
+    };
 
-        glyphs.push_back(std::move(t));
-        totalPx += size_t(std::max(1,w)) * std::max(1,h);
+    std::vector<Tmp> glyphs; glyphs.reserve(cps.size());
+
+    if (cps.size() < kParallelGlyphs || g_jobs.worker_count() == 0) {
+        for (uint32_t cp : cps) {
+            Tmp t{};
+            if (rasterize(face, cp, t)) glyphs.push_back(std::move(t));
+        }
+    } else {
+        // Big sets (CJK ranges) rasterize in chunks on the job pool. A face
+        // can't be shared between threads, so each chunk opens its own; face
+        // creation/destruction on one FT_Library has to be serialized.
+        static std::mutex face_mutex;
+        std::vector<Tmp>     slots(cps.size());
+        std::vector<uint8_t> found(cps.size(), 0);
+        std::atomic<bool>    open_failed{false};
+        g_jobs.parallel_for(uint32_t(cps.size()), 128, [&](uint32_t begin, uint32_t end) {
+            FT_Face f = nullptr;
+            {
+                std::lock_guard lock(face_mutex);
+                if (FT_New_Face(ft, font_path, 0, &f)) { open_failed = true; return; }
+            }
+            FT_Set_Pixel_Sizes(f, 0, pixel_height);
+            for (uint32_t i = begin; i < end; ++i) found[i] = rasterize(f, cps[i], slots[i]);
+            std::lock_guard lock(face_mutex);
+            FT_Done_Face(f);
+        });
+        // a chunk without a face would leave a hole in the atlas: fail like
+        // the open above does
+        if (open_failed) {
+            FT_Done_Face(face);
+            return false;
+        }
+        for (size_t i = 0; i < cps.size(); ++i)
+            if (found[i]) glyphs.push_back(std::move(slots[i]));
     }
 
+    size_t totalPx = 0;
+    for (const Tmp& t : glyphs) totalPx += size_t(std::max(1,t.w)) * std::max(1,t.h);
+
     const uint32_t targetArea = uint32_t(totalPx + totalPx/8);
     const uint32_t estSide = next_pow2(uint32_t(std::ceil(std::sqrt(double(targetArea)))));
     const uint32_t atlasW  = std::clamp(estSide, 256u, 2048u);
@@ -211,7 +217,7 @@ VkResult build_font_atlas_gpu(VkDevice device, VkPhysicalDevice phys,
         mai.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
         mai.allocationSize = mr.size;
         mai.memoryTypeIndex = mt;
-        r = vkAllocateMemory(device, &mai, nullptr, &out.memory); if (r) goto END;
+        r = tracked_allocate(device, mai, &out.memory, MemoryCategory::Texture); if (r) goto END;
         r = vkBindImageMemory(device, out.image, out.memory, 0); if (r) goto END;
     }
 
@@ -253,7 +259,7 @@ VkResult build_font_atlas_gpu(VkDevice device, VkPhysicalDevice phys,
         mai.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
         mai.allocationSize = mr.size;
         mai.memoryTypeIndex = mt;
-        r = vkAllocateMemory(device, &mai, nullptr, &stagingMem); if (r) goto END;
+        r = tracked_allocate(device, mai, &stagingMem, MemoryCategory::Staging); if (r) goto END;
         r = vkBindBufferMemory(device, staging, stagingMem, 0); if (r) goto END;
 
         void* mapped = nullptr;
@@ -282,40 +288,13 @@ VkResult build_font_atlas_gpu(VkDevice device, VkPhysicalDevice phys,
         bi.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
         r = vkBeginCommandBuffer(cb, &bi); if (r) goto END;
 
-        // sync2 available?
-        PFN_vkCmdPipelineBarrier2 pfnBarrier2 =
-            reinterpret_cast<PFN_vkCmdPipelineBarrier2>(
-                vkGetDeviceProcAddr(device, "vkCmdPipelineBarrier2"));
-
         // UNDEFINED -> TRANSFER_DST
-        if (pfnBarrier2) {
-            VkImageMemoryBarrier2 b{};
-            b.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
-            b.srcStageMask = VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT;
-            b.srcAccessMask= 0;
-            b.dstStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
-            b.dstAccessMask= VK_ACCESS_2_TRANSFER_WRITE_BIT;
-            b.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-            b.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-            b.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            b.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            b.image = out.image;
-            b.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            b.subresourceRange.baseMipLevel = 0;
-            b.subresourceRange.levelCount   = 1;
-            b.subresourceRange.baseArrayLayer = 0;
-            b.subresourceRange.layerCount     = 1;
-
-            VkDependencyInfo dep{};
-            dep.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
-            dep.imageMemoryBarrierCount = 1;
-            dep.pImageMemoryBarriers = &b;
-
-            pfnBarrier2(cb, &dep);
-        } else {
-            classic_layout_transition(cb, out.image,
-                                      VK_IMAGE_LAYOUT_UNDEFINED,
-                                      VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        {
+            VkImageMemoryBarrier2 b = render::image_barrier2(out.image,
+                VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                VK_PIPELINE_STAGE_2_NONE,     0,
+                VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
+            render::cmd_barriers(cb, {&b, 1});
         }
 
         // copy buffer -> image
@@ -333,34 +312,12 @@ VkResult build_font_atlas_gpu(VkDevice device, VkPhysicalDevice phys,
                                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
 
         // TRANSFER_DST -> SHADER_READ_ONLY
-        if (pfnBarrier2) {
-            VkImageMemoryBarrier2 b{};
-            b.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
-            b.srcStageMask  = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
-            b.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
-            b.dstStageMask  = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
-            b.dstAccessMask = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT;
-            b.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-            b.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            b.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            b.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            b.image = out.image;
-            b.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            b.subresourceRange.baseMipLevel = 0;
-            b.subresourceRange.levelCount   = 1;
-            b.subresourceRange.baseArrayLayer = 0;
-            b.subresourceRange.layerCount     = 1;
-
-            VkDependencyInfo dep{};
-            dep.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
-            dep.imageMemoryBarrierCount = 1;
-            dep.pImageMemoryBarriers = &b;
-
-            pfnBarrier2(cb, &dep);
-        } else {
-            classic_layout_transition(cb, out.image,
-                                      VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                                      VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        {
+            VkImageMemoryBarrier2 b = render::image_barrier2(out.image,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                VK_PIPELINE_STAGE_2_TRANSFER_BIT,        VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT);
+            render::cmd_barriers(cb, {&b, 1});
         }
 
         r = vkEndCommandBuffer(cb); if (r) goto END;
@@ -385,7 +342,7 @@ END:
     if (cb)   vkFreeCommandBuffers(device, pool, 1, &cb);
     if (pool) vkDestroyCommandPool(device, pool, nullptr);
     if (staging != VK_NULL_HANDLE) vkDestroyBuffer(device, staging, nullptr);
-    if (stagingMem != VK_NULL_HANDLE) vkFreeMemory(device, stagingMem, nullptr);
+    if (stagingMem != VK_NULL_HANDLE) tracked_free(device, stagingMem);
 
     if(r) {
         destroy_gpu_font_atlas(device, out);
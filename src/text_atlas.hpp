@@ -2,6 +2,7 @@
 #define TEXT_ATLAS_HPP
 
 #include <vulkan/vulkan.h>
+#include "memory_tracker.hpp"
 #include <ft2build.h>
 #include FT_FREETYPE_H
 #include <unordered_map>
@@ -32,6 +33,8 @@ struct FontAtlasGPU {
 
 // Build CPU atlas from a trusted font.
 // Returns false on FreeType failure.
+// Large codepoint sets rasterize on g_jobs; 'ft' must not be used by other
+// threads meanwhile.
 bool build_cpu_font_atlas(FT_Library ft, const char* font_path,
                           uint32_t pixel_height,
                           FontAtlasCPU& out,
@@ -56,7 +59,7 @@ inline void destroy_gpu_font_atlas(VkDevice dev, FontAtlasGPU& gpu) {
     // if (gpu.sampler) vkDestroySampler(dev, gpu.sampler, nullptr);
     if (gpu.view)    vkDestroyImageView(dev, gpu.view, nullptr);
     if (gpu.image)   vkDestroyImage(dev, gpu.image, nullptr);
-    if (gpu.memory)  vkFreeMemory(dev, gpu.memory, nullptr);
+    if (gpu.memory)  tracked_free(dev, gpu.memory);
     gpu = {};
 }
 
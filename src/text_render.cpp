@@ -90,20 +90,23 @@ void text_line_draw_info(std::vector<TriPair>& out,
 
 
 VkResult TextRenderer::build_pipeline_(VkDevice device,
+                                         DescriptorLayoutCache& layouts,
                                          VkRenderPass rp,
                                          VkShaderModule vs, VkShaderModule fs,
-                                         const VkViewport& vp, const VkRect2D& sc)
+                                         const VkPipelineRenderingCreateInfo* rendering)
 {
 
     // set=1: combined image sampler for FS
     VkDescriptorSetLayoutBinding b1 =
         render::desc_binding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT);
-    auto l1 = render::desc_layout_info({ &b1, 1 });
-    VK_CHECK(vkCreateDescriptorSetLayout(device, &l1, nullptr, &m_set));
+    VK_CHECK(layouts.get({ &b1, 1 }, m_set));
 
-    // pipeline layout: [ set0_empty, set1_atlas ] + FS push-constant vec4
-    VkPushConstantRange pc{ VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(float)*4 };
-    auto pl = render::layout_info({ &m_set, 1 }, { &pc, 1 });
+    // pipeline layout: [ set0_empty, set1_atlas ] + VS view vec4 + FS color vec4
+    VkPushConstantRange pc[2] = {
+        { VK_SHADER_STAGE_VERTEX_BIT,   0,               sizeof(float)*4 },
+        { VK_SHADER_STAGE_FRAGMENT_BIT, sizeof(float)*4, sizeof(float)*4 }
+    };
+    auto pl = render::layout_info({ &m_set, 1 }, pc);
     VK_CHECK(vkCreatePipelineLayout(device, &pl, nullptr, &m_layout));
 
     // vertex input: one per-instance binding (binding 0)
@@ -120,7 +123,6 @@ VkResult TextRenderer::build_pipeline_(VkDevice device,
     };
     auto vin   = render::vertex_input_info({ &bind, 1 }, attrs);
     auto ia    = render::input_assembly_info(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_FALSE);
-    auto vpst  = render::viewport_state_info_static({ &vp, 1 }, { &sc, 1 });
     auto rs    = render::rasterization_state_info(/*cull*/VK_CULL_MODE_NONE);
     auto ms    = render::multisample_state_info();
     VkPipelineColorBlendAttachmentState att[1] = { render::alpha_blend };
@@ -128,8 +130,10 @@ VkResult TextRenderer::build_pipeline_(VkDevice device,
     auto stages= render::fragment_vertex_stage_info(fs, vs);
 
     return render::create_graphics_pipeline(
-        m_pipeline, device, stages, &vpst, m_layout, rp,
-        rs, cb, vin, ia, ms
+        m_pipeline, device, stages, /*dynamic viewport*/nullptr, m_layout, rp,
+        rs, cb, vin, ia, ms,
+        0, nullptr, nullptr, nullptr, 0, VK_NULL_HANDLE, -1,
+        rendering
     );
 }
 
@@ -139,24 +143,20 @@ VkResult TextRenderer::build_pipeline_(VkDevice device,
 VkResult TextRenderer::create(VkDevice device,
                                 VkRenderPass renderPass,
                                 VkShaderModule vs, VkShaderModule fs,
-                                const VkViewport& viewport,
-                                const VkRect2D&  scissor,
                                 VkImageView atlasView,
-                                VkSampler   atlasSampler)
+                                VkSampler   atlasSampler,
+                                DescriptorLayoutCache& layouts,
+                                DescriptorAllocator&   descriptors,
+                                const VkPipelineRenderingCreateInfo* rendering)
 {
     m_atlasView    = atlasView;
     m_atlasSampler = atlasSampler;
 
     // pipeline + layout
-    if (auto r = build_pipeline_(device, renderPass, vs, fs, viewport, scissor)) return r;
-
-    // descriptor pool & set for atlas
-    VkDescriptorPoolSize poolSize = render::desc_pool_size(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1);
-    auto pinfo = render::desc_pool_info({ &poolSize, 1 }, /*max_sets*/1);
-    if (vkCreateDescriptorPool(device, &pinfo, nullptr, &m_pool)) return VK_ERROR_INITIALIZATION_FAILED;
+    if (auto r = build_pipeline_(device, layouts, renderPass, vs, fs, rendering)) return r;
 
-    auto ainfo = render::desc_alloc_info(m_pool, { &m_set, 1 });
-    if (vkAllocateDescriptorSets(device, &ainfo, &m_ds)) return VK_ERROR_INITIALIZATION_FAILED;
+    // set for atlas (from the shared allocator)
+    if (descriptors.allocate(m_set, m_ds)) return VK_ERROR_INITIALIZATION_FAILED;
 
     VkDescriptorImageInfo ii = render::desc_image_info(m_atlasSampler, m_atlasView,
         VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
@@ -192,9 +192,11 @@ VkResult TextRenderer::record_draw( VkCommandBuffer cb,
     vkCmdBindDescriptorSets(cb, VK_PIPELINE_BIND_POINT_GRAPHICS,
                             m_layout, 0, 1, &m_ds, 0, nullptr);
 
-    // push color
+    // push view + color
+    vkCmdPushConstants(cb, m_layout, VK_SHADER_STAGE_VERTEX_BIT,
+                       0, sizeof(float)*4, m_view);
     vkCmdPushConstants(cb, m_layout, VK_SHADER_STAGE_FRAGMENT_BIT,
-                       0, sizeof(float)*4, rgba);
+                       sizeof(float)*4, sizeof(float)*4, rgba);
 
     // bind vertex buffer at the arena offset
     VkBuffer vb = a.buffer;
@@ -224,13 +226,11 @@ VkResult TextRenderer::record_draw_line( VkCommandBuffer cb,
 void TextRenderer::destroy(VkDevice device)
 {
 
-    if (m_pool)  vkDestroyDescriptorPool(device, m_pool, nullptr);
     if (m_pipeline) vkDestroyPipeline(device, m_pipeline, nullptr);
     if (m_layout)   vkDestroyPipelineLayout(device, m_layout, nullptr);
-    if (m_set)vkDestroyDescriptorSetLayout(device, m_set, nullptr);
 
     m_set = VK_NULL_HANDLE;
     m_layout = VK_NULL_HANDLE; m_pipeline = VK_NULL_HANDLE;
-    m_pool = VK_NULL_HANDLE; m_ds = VK_NULL_HANDLE;
+    m_ds = VK_NULL_HANDLE;
     m_atlasView = VK_NULL_HANDLE; m_atlasSampler = VK_NULL_HANDLE;
 }
\ No newline at end of file
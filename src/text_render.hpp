@@ -6,6 +6,7 @@
 #include "render_pipeline.hpp"
 #include "text_atlas.hpp"
 #include "memory.hpp"
+#include "descriptors.hpp"
 
 int measure_text_x_px(const FontAtlasCPU& cpu, std::string_view s);
 inline int measure_y_px(const FontAtlasCPU& cpu){
@@ -22,6 +23,8 @@ static_assert(sizeof(TriPair) == 32, "TriPair must be 32B");
 //we feed in a TriPair
 constexpr const char* text_render_vs = R"GLSL(
 #version 450
+layout(push_constant) uniform PC { vec4 view; } pc;  // ndc = pos * view.xy + view.zw
+
 // per-instance attributes (binding 0)
 layout(location=0) in vec2 in_screen_base;  // x0,y0
 layout(location=1) in vec2 in_screen_side;  // dx,dy
@@ -40,7 +43,7 @@ void main() {
     uint vi = uint(gl_VertexIndex % 3);  // 0..2 within the triangle
     vec2 pos = tri_corner(in_screen_base, in_screen_side, vi);
     vUV      = tri_corner(in_uv_base,     in_uv_side,     vi);
-    gl_Position = vec4(pos, 0.0, 1.0);
+    gl_Position = vec4(pos * pc.view.xy + pc.view.zw, 0.0, 1.0);
 }
 )GLSL";
 
@@ -48,7 +51,7 @@ void main() {
 
 constexpr const char* text_render_fs = R"GLSL(
 #version 450
-layout(push_constant) uniform PC { vec4 color; } pc;
+layout(push_constant) uniform PC { layout(offset=16) vec4 color; } pc;
 
 layout(location=0) in  vec2 vUV;
 layout(location=0) out vec4 outColor;
@@ -75,13 +78,21 @@ void text_line_draw_info(std::vector<TriPair>& out,
 class TextRenderer {
 public:
     // 1) Create pipeline/layouts/descriptors (atlas sampler is non-owned & reused).
+    //    With dynamic rendering pass renderPass = VK_NULL_HANDLE + 'rendering'.
+    //    Viewport/scissor are dynamic: whoever begins the pass sets them.
     VkResult create(VkDevice device,
                     VkRenderPass renderPass,
                     VkShaderModule vs, VkShaderModule fs,
-                    const VkViewport& viewport,
-                    const VkRect2D&  scissor,
                     VkImageView atlasView,
-                    VkSampler   atlasSampler);
+                    VkSampler   atlasSampler,
+                    DescriptorLayoutCache& layouts,
+                    DescriptorAllocator&   descriptors,   // persistent (not reset per frame)
+                    const VkPipelineRenderingCreateInfo* rendering = nullptr);
+
+    // Screen transform for the following draws: ndc = pos * (view[0], view[1])
+    // + (view[2], view[3]). Set once per frame, e.g. from Camera::screen_view
+    // so lines are laid out in pixels; defaults to identity (positions in NDC).
+    void set_view(const float view[4]) { for (int i = 0; i < 4; ++i) m_view[i] = view[i]; }
 
     // 2) Record a draw given TriPairs (we pack to TriInstance internally).
     VkResult record_draw( VkCommandBuffer cb,
@@ -104,26 +115,28 @@ public:
 
 private:
     // pipeline bits
-	VkDescriptorSetLayout m_set  = VK_NULL_HANDLE;
+	VkDescriptorSetLayout m_set  = VK_NULL_HANDLE;   // owned by the layout cache
 
     
     VkPipelineLayout      m_layout    = VK_NULL_HANDLE;
     VkPipeline            m_pipeline  = VK_NULL_HANDLE;
 
-    // descriptors
-    VkDescriptorPool m_pool = VK_NULL_HANDLE;
+    // descriptors (set lives in the caller's DescriptorAllocator)
     VkDescriptorSet  m_ds   = VK_NULL_HANDLE;
 
     // non-owned atlas handles
     VkImageView     m_atlasView   = VK_NULL_HANDLE;
     VkSampler       m_atlasSampler= VK_NULL_HANDLE;
 
+    float           m_view[4] = { 1.f, 1.f, 0.f, 0.f };
+
 private:
 
     VkResult build_pipeline_(VkDevice device,
+                             DescriptorLayoutCache& layouts,
                              VkRenderPass rp,
                              VkShaderModule vs, VkShaderModule fs,
-                             const VkViewport& vp, const VkRect2D& sc);    
+                             const VkPipelineRenderingCreateInfo* rendering);
 };
 
 
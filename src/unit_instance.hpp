@@ -0,0 +1,18 @@
+#ifndef UNIT_INSTANCE_HPP
+#define UNIT_INSTANCE_HPP
+
+#include <cstdint>
+
+// Per-unit state as the GPU sees it (std430, 32B). Kept apart from
+// unit_renderer.hpp so the sim side can fill instances without Vulkan.
+struct UnitInstance {
+    float    x, y, z;   // world position
+    float    yaw;       // radians around +Y
+    float    scale;
+    float    radius;    // bounding sphere of the mesh at scale 1
+    uint32_t type;      // index into the meshes passed to create()
+    uint32_t tint;      // RGBA8, R in the low byte
+};
+static_assert(sizeof(UnitInstance) == 32, "UnitInstance must match the std430 layout");
+
+#endif // UNIT_INSTANCE_HPP
@@ -0,0 +1,249 @@
+#include "unit_renderer.hpp"
+#include <cstddef>
+#include <cstring>
+
+VkResult UnitRenderer::create(VkDevice device, VkPhysicalDevice phys,
+                              VkRenderPass renderPass,
+                              VkShaderModule cull_cs, VkShaderModule vs, VkShaderModule fs,
+                              DescriptorLayoutCache& layouts,
+                              DescriptorAllocator&   descriptors,
+                              std::span<const UnitMesh> meshes,
+                              uint32_t max_units,
+                              const VkPipelineRenderingCreateInfo* rendering,
+                              const VkPipelineDepthStencilStateCreateInfo* depth)
+{
+    DEBUG_ASSERT(!meshes.empty() && max_units > 0);
+    m_max   = max_units;
+    m_count = 0;
+    m_first_instance = g_vulkan.draw_indirect_first_instance;
+
+    const uint32_t types = static_cast<uint32_t>(meshes.size());
+    m_reset.resize(types);
+    for (uint32_t t = 0; t < types; ++t) {
+        m_reset[t].indexCount    = meshes[t].index_count;
+        m_reset[t].instanceCount = 0;
+        m_reset[t].firstIndex    = meshes[t].first_index;
+        m_reset[t].vertexOffset  = meshes[t].vertex_offset;
+        m_reset[t].firstInstance = m_first_instance ? t * max_units : 0;
+    }
+
+    // buffers
+    const VkBufferUsageFlags indirect = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                                        VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    if (auto r = m_units.create(device, phys, VkDeviceSize(max_units) * sizeof(UnitInstance),
+                                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT)) return r;
+    if (auto r = m_visible.create(device, phys, VkDeviceSize(types) * max_units * sizeof(uint32_t),
+                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)) return r;
+    if (auto r = m_commands.create(device, phys, VkDeviceSize(types) * sizeof(VkDrawIndexedIndirectCommand),
+                                   indirect)) return r;
+    if (auto r = m_draw_count.create(device, phys, sizeof(uint32_t), indirect)) return r;
+
+    // set 0: units, visible, commands, count (the graphics side only reads the first two)
+    const VkShaderStageFlags both = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT;
+    const VkDescriptorSetLayoutBinding bindings[4] = {
+        render::desc_binding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, both),
+        render::desc_binding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, both),
+        render::desc_binding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        render::desc_binding(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+    };
+    if (auto r = layouts.get(bindings, m_set_layout)) return r;
+    if (auto r = descriptors.allocate(m_set_layout, m_set)) return r;
+
+    const VkDescriptorBufferInfo infos[4] = {
+        render::desc_buffer_info(m_units.buffer()),
+        render::desc_buffer_info(m_visible.buffer()),
+        render::desc_buffer_info(m_commands.buffer()),
+        render::desc_buffer_info(m_draw_count.buffer()),
+    };
+    VkWriteDescriptorSet writes[4];
+    for (uint32_t i = 0; i < 4; ++i) writes[i] = render::desc_write_buffer(m_set, i, &infos[i]);
+    vkUpdateDescriptorSets(device, 4, writes, 0, nullptr);
+
+    // cull pipeline
+    VkPushConstantRange cull_pc{ VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CullPC) };
+    auto cl = render::layout_info({ &m_set_layout, 1 }, { &cull_pc, 1 });
+    VK_CHECK(vkCreatePipelineLayout(device, &cl, nullptr, &m_cull_layout));
+    if (auto r = render::create_compute_pipeline(m_cull, device, cull_cs, m_cull_layout)) return r;
+
+    // draw pipeline
+    VkPushConstantRange draw_pc{ VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(DrawPC) };
+    auto dl = render::layout_info({ &m_set_layout, 1 }, { &draw_pc, 1 });
+    VK_CHECK(vkCreatePipelineLayout(device, &dl, nullptr, &m_draw_layout));
+
+    VkVertexInputBindingDescription bind{
+        .binding   = 0,
+        .stride    = sizeof(UnitVertex),
+        .inputRate = VK_VERTEX_INPUT_RATE_VERTEX
+    };
+    VkVertexInputAttributeDescription attrs[2] = {
+        { .location=0, .binding=0, .format=VK_FORMAT_R32G32B32_SFLOAT, .offset=offsetof(UnitVertex, x)     },
+        { .location=1, .binding=0, .format=VK_FORMAT_R8G8B8A8_UNORM,   .offset=offsetof(UnitVertex, color) }
+    };
+    auto vin   = render::vertex_input_info({ &bind, 1 }, attrs);
+    auto ia    = render::input_assembly_info(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_FALSE);
+    auto rs    = render::rasterization_state_info(VK_CULL_MODE_BACK_BIT);
+    auto ms    = render::multisample_state_info();
+    VkPipelineColorBlendAttachmentState att[1] = { render::alpha_blend };
+    auto cb    = render::color_blend_state(att);
+    auto stages= render::fragment_vertex_stage_info(fs, vs);
+
+    return render::create_graphics_pipeline(
+        m_draw, device, stages, /*dynamic viewport*/nullptr, m_draw_layout, renderPass,
+        rs, cb, vin, ia, ms,
+        0, nullptr, depth, nullptr, 0, VK_NULL_HANDLE, -1,
+        rendering
+    );
+}
+
+void UnitRenderer::destroy(VkDevice device) {
+    if (m_cull)        vkDestroyPipeline(device, m_cull, nullptr);
+    if (m_draw)        vkDestroyPipeline(device, m_draw, nullptr);
+    if (m_cull_layout) vkDestroyPipelineLayout(device, m_cull_layout, nullptr);
+    if (m_draw_layout) vkDestroyPipelineLayout(device, m_draw_layout, nullptr);
+    m_units.destroy(device);
+    m_visible.destroy(device);
+    m_commands.destroy(device);
+    m_draw_count.destroy(device);
+
+    m_cull = m_draw = VK_NULL_HANDLE;
+    m_cull_layout = m_draw_layout = VK_NULL_HANDLE;
+    m_set_layout = VK_NULL_HANDLE;
+    m_set = VK_NULL_HANDLE;
+    m_reset.clear();
+    m_max = m_count = 0;
+}
+
+VkResult UnitRenderer::upload(VkCommandBuffer cb, MappedArena& arena, std::span<const UnitInstance> units) {
+    UnitInstance* out = nullptr;
+    if (auto r = map_units(arena, static_cast<uint32_t>(units.size()), out)) return r;
+    if (m_pending_count) std::memcpy(out, units.data(), size_t(m_pending_count) * sizeof(UnitInstance));
+    return commit_units(cb, arena);
+}
+
+VkResult UnitRenderer::map_units(MappedArena& arena, uint32_t count, UnitInstance*& out) {
+    arena.assert_matches(VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+    DEBUG_ASSERT(count <= m_max);
+
+    out = nullptr;
+    m_pending       = {};
+    m_pending_count = std::min(count, m_max);
+    if (m_pending_count == 0) return VK_SUCCESS;
+
+    const VkDeviceSize bytes = VkDeviceSize(m_pending_count) * sizeof(UnitInstance);
+    if (auto r = arena.alloc(bytes, m_pending, alignof(UnitInstance))) { m_pending_count = 0; return r; }
+    out = static_cast<UnitInstance*>(m_pending.cpu_ptr);
+    return VK_SUCCESS;
+}
+
+VkResult UnitRenderer::commit_units(VkCommandBuffer cb, MappedArena& arena) {
+    m_count = m_pending_count;
+    m_pending_count = 0;
+    if (m_count == 0) return VK_SUCCESS;
+
+    const VkDeviceSize bytes = VkDeviceSize(m_count) * sizeof(UnitInstance);
+    arena.flush(m_pending, bytes);
+
+    // last frame's cull/draw reads finish before the overwrite
+    auto war = render::buffer_barrier2(m_units.buffer(),
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT, 0,
+        VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
+    render::cmd_barriers(cb, {}, { &war, 1 });
+
+    VkBufferCopy copy{ m_pending.offset, 0, bytes };
+    vkCmdCopyBuffer(cb, m_pending.buffer, m_units.buffer(), 1, &copy);
+
+    auto raw = render::buffer_barrier2(m_units.buffer(),
+        VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT,
+        VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+    render::cmd_barriers(cb, {}, { &raw, 1 });
+    return VK_SUCCESS;
+}
+
+void UnitRenderer::cull(VkCommandBuffer cb, const float view_proj[16]) {
+    const VkDeviceSize cmd_bytes = VkDeviceSize(m_reset.size()) * sizeof(VkDrawIndexedIndirectCommand);
+
+    // previous frame's indirect/vertex reads are done before the reset
+    const VkBufferMemoryBarrier2 before[3] = {
+        render::buffer_barrier2(m_commands.buffer(),
+            VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, 0,
+            VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT),
+        render::buffer_barrier2(m_draw_count.buffer(),
+            VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, 0,
+            VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT),
+        render::buffer_barrier2(m_visible.buffer(),
+            VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT, 0,
+            VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT),
+    };
+    render::cmd_barriers(cb, {}, before);
+
+    vkCmdUpdateBuffer(cb, m_commands.buffer(), 0, cmd_bytes, m_reset.data());
+    vkCmdFillBuffer(cb, m_draw_count.buffer(), 0, sizeof(uint32_t), 0);
+
+    const VkBufferMemoryBarrier2 reset[2] = {
+        render::buffer_barrier2(m_commands.buffer(),
+            VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+            VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT),
+        render::buffer_barrier2(m_draw_count.buffer(),
+            VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+            VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT),
+    };
+    render::cmd_barriers(cb, {}, reset);
+
+    if (m_count > 0) {
+        CullPC pc{};
+        const Frustum f = Frustum::from_view_proj(view_proj);
+        std::memcpy(pc.planes, f.planes, sizeof(pc.planes));
+        pc.unit_count = m_count;
+        pc.type_count = static_cast<uint32_t>(m_reset.size());
+        pc.per_type   = m_max;
+
+        render::cmd_bind_compute(cb, m_cull, m_cull_layout, { &m_set, 1 });
+        vkCmdPushConstants(cb, m_cull_layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pc), &pc);
+        render::cmd_dispatch_items(cb, m_count, kLocalSize);
+    }
+
+    const VkBufferMemoryBarrier2 after[3] = {
+        render::compute_write_barrier2(m_commands.buffer(),
+            VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT),
+        render::compute_write_barrier2(m_draw_count.buffer(),
+            VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT),
+        render::compute_write_barrier2(m_visible.buffer(),
+            VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT),
+    };
+    render::cmd_barriers(cb, {}, after);
+}
+
+void UnitRenderer::draw(VkCommandBuffer cb, VkBuffer vertices, VkBuffer indices, const float view_proj[16]) {
+    if (m_count == 0) return;
+
+    vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, m_draw);
+    vkCmdBindDescriptorSets(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, m_draw_layout, 0, 1, &m_set, 0, nullptr);
+    VkDeviceSize vbOff = 0;
+    vkCmdBindVertexBuffers(cb, 0, 1, &vertices, &vbOff);
+    vkCmdBindIndexBuffer(cb, indices, 0, VK_INDEX_TYPE_UINT32);
+
+    DrawPC pc{};
+    std::memcpy(pc.view_proj, view_proj, sizeof(pc.view_proj));
+    pc.base = 0;
+
+    const uint32_t types  = static_cast<uint32_t>(m_reset.size());
+    const uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+
+    if (m_first_instance && g_vulkan.draw_indirect_count) {
+        vkCmdPushConstants(cb, m_draw_layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(pc), &pc);
+        g_vulkan.cmd_draw_indexed_indirect_count(cb, m_commands.buffer(), 0,
+                                                 m_draw_count.buffer(), 0, types, stride);
+    } else if (m_first_instance && g_vulkan.multi_draw_indirect) {
+        // empty types just draw zero instances
+        vkCmdPushConstants(cb, m_draw_layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(pc), &pc);
+        vkCmdDrawIndexedIndirect(cb, m_commands.buffer(), 0, types, stride);
+    } else {
+        // one call per type; the slice offset travels in the push constant
+        for (uint32_t t = 0; t < types; ++t) {
+            pc.base = m_first_instance ? 0 : t * m_max;
+            vkCmdPushConstants(cb, m_draw_layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(pc), &pc);
+            vkCmdDrawIndexedIndirect(cb, m_commands.buffer(), VkDeviceSize(t) * stride, 1, stride);
+        }
+    }
+}
@@ -0,0 +1,180 @@
+#ifndef UNIT_RENDERER_HPP
+#define UNIT_RENDERER_HPP
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "render.hpp"
+#include "render_pipeline.hpp"
+#include "memory.hpp"
+#include "descriptors.hpp"
+#include "frustum.hpp"
+#include "unit_instance.hpp"
+
+// Mesh vertex: position + RGBA8 color (16B).
+struct UnitVertex {
+    float    x, y, z;
+    uint32_t color;
+};
+
+// One unit type: a range of the shared index/vertex buffers.
+struct UnitMesh {
+    uint32_t index_count;
+    uint32_t first_index;
+    int32_t  vertex_offset;
+};
+
+// Cull: one thread per unit, bounding sphere vs 6 planes, survivors appended
+// to their type's slice of the visible list via the draw command's instanceCount.
+constexpr const char* unit_cull_cs = R"GLSL(
+#version 450
+layout(local_size_x = 64) in;
+
+struct Unit { vec3 pos; float yaw; float scale; float radius; uint type; uint tint; };
+struct DrawCmd { uint indexCount; uint instanceCount; uint firstIndex; int vertexOffset; uint firstInstance; };
+
+layout(std430, set=0, binding=0) readonly  buffer Units   { Unit units[]; };
+layout(std430, set=0, binding=1) writeonly buffer Visible { uint visible[]; };
+layout(std430, set=0, binding=2)           buffer Draws   { DrawCmd draws[]; };
+layout(std430, set=0, binding=3)           buffer Count   { uint draw_count; };
+
+layout(push_constant) uniform PC {
+    vec4 planes[6];
+    uint unit_count;
+    uint type_count;
+    uint per_type;     // visible slots per type
+} pc;
+
+void main() {
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= pc.unit_count) return;
+
+    Unit u = units[i];
+    if (u.type >= pc.type_count) return;
+    float r = u.radius * u.scale;
+    for (int p = 0; p < 6; ++p)
+        if (dot(pc.planes[p].xyz, u.pos) + pc.planes[p].w < -r) return;
+
+    uint slot = atomicAdd(draws[u.type].instanceCount, 1u);
+    visible[u.type * pc.per_type + slot] = i;
+    atomicMax(draw_count, u.type + 1u);  // trailing empty types are never drawn
+}
+)GLSL";
+
+constexpr const char* unit_render_vs = R"GLSL(
+#version 450
+struct Unit { vec3 pos; float yaw; float scale; float radius; uint type; uint tint; };
+
+layout(std430, set=0, binding=0) readonly buffer Units   { Unit units[]; };
+layout(std430, set=0, binding=1) readonly buffer Visible { uint visible[]; };
+
+layout(push_constant) uniform PC {
+    mat4 view_proj;
+    uint base;         // added to gl_InstanceIndex when firstInstance can't carry it
+} pc;
+
+layout(location=0) in vec3 in_pos;
+layout(location=1) in vec4 in_color;   // R8G8B8A8_UNORM
+
+layout(location=0) out vec4 vColor;
+
+void main() {
+    Unit u = units[visible[gl_InstanceIndex + pc.base]];
+    float c = cos(u.yaw), s = sin(u.yaw);
+    vec3 p = in_pos * u.scale;
+    p = vec3(p.x * c - p.z * s, p.y, p.x * s + p.z * c) + u.pos;
+
+    vColor = in_color * unpackUnorm4x8(u.tint);
+    gl_Position = pc.view_proj * vec4(p, 1.0);
+}
+)GLSL";
+
+constexpr const char* unit_render_fs = R"GLSL(
+#version 450
+layout(location=0) in  vec4 vColor;
+layout(location=0) out vec4 outColor;
+void main() { outColor = vColor; }
+)GLSL";
+
+// GPU-driven unit drawing. Unit state lives in a persistent device-local
+// storage buffer; each frame a compute pass culls it against the camera
+// frustum and compacts survivors per unit type, writing one indexed indirect
+// command per type. draw() then issues a single vkCmdDrawIndexedIndirectCount
+// (GPU-written draw count), or vkCmdDrawIndexedIndirect with every type when
+// that extension is missing, or one indirect call per type when the device
+// lacks multiDrawIndirect / drawIndirectFirstInstance. The CPU never loops
+// over units when recording.
+//
+// Per frame, outside the render pass: upload() (when units changed), cull().
+// Inside it: draw().
+class UnitRenderer {
+public:
+    VkResult create(VkDevice device, VkPhysicalDevice phys,
+                    VkRenderPass renderPass,
+                    VkShaderModule cull_cs, VkShaderModule vs, VkShaderModule fs,
+                    DescriptorLayoutCache& layouts,
+                    DescriptorAllocator&   descriptors,   // persistent (not reset per frame)
+                    std::span<const UnitMesh> meshes,
+                    uint32_t max_units,
+                    const VkPipelineRenderingCreateInfo* rendering = nullptr,
+                    const VkPipelineDepthStencilStateCreateInfo* depth = nullptr);
+    void destroy(VkDevice device);
+
+    // Copies 'units' (via 'arena', which needs TRANSFER_SRC usage) into the
+    // persistent buffer starting at unit 0; unit_count() becomes units.size().
+    VkResult upload(VkCommandBuffer cb, MappedArena& arena, std::span<const UnitInstance> units);
+
+    // Same without the intermediate array, for callers that produce units in
+    // place (write_unit_instances from the entity store): map_units() reserves
+    // 'count' units in the arena and points 'out' at them, commit_units()
+    // flushes what was written and records the copy.
+    VkResult map_units(MappedArena& arena, uint32_t count, UnitInstance*& out);
+    VkResult commit_units(VkCommandBuffer cb, MappedArena& arena);
+
+    // Resets the indirect commands and runs the cull pass.
+    void cull(VkCommandBuffer cb, const float view_proj[16]);
+
+    // Inside rendering: binds the mesh buffers (UnitVertex / uint32 indices) and draws.
+    void draw(VkCommandBuffer cb, VkBuffer vertices, VkBuffer indices, const float view_proj[16]);
+
+    uint32_t unit_count() const { return m_count; }
+    uint32_t max_units()  const { return m_max; }
+    VkBuffer units()      const { return m_units.buffer(); }   // for other compute passes
+
+private:
+    static constexpr uint32_t kLocalSize = 64;
+
+    struct CullPC {
+        float    planes[6][4];
+        uint32_t unit_count;
+        uint32_t type_count;
+        uint32_t per_type;
+    };
+    struct DrawPC {
+        float    view_proj[16];
+        uint32_t base;
+    };
+
+    VkDescriptorSetLayout m_set_layout = VK_NULL_HANDLE;  // owned by the layout cache
+    VkDescriptorSet       m_set        = VK_NULL_HANDLE;
+    VkPipelineLayout      m_cull_layout = VK_NULL_HANDLE;
+    VkPipelineLayout      m_draw_layout = VK_NULL_HANDLE;
+    VkPipeline            m_cull = VK_NULL_HANDLE;
+    VkPipeline            m_draw = VK_NULL_HANDLE;
+
+    GpuBuffer m_units;     // UnitInstance[max]
+    GpuBuffer m_visible;   // uint[types * max]
+    GpuBuffer m_commands;  // VkDrawIndexedIndirectCommand[types]
+    GpuBuffer m_draw_count; // uint
+
+    std::vector<VkDrawIndexedIndirectCommand> m_reset;   // commands with instanceCount = 0
+    uint32_t m_max   = 0;
+    uint32_t m_count = 0;
+
+    UploadAlloc m_pending{};          // between map_units and commit_units
+    uint32_t    m_pending_count = 0;
+    bool     m_first_instance = false;  // firstInstance carries the type's slice offset
+};
+
+#endif // UNIT_RENDERER_HPP
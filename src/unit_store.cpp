@@ -0,0 +1,48 @@
+#include "unit_store.hpp"
+#include "flow_field.hpp"
+#include <algorithm>
+
+void integrate_velocity(UnitStore& units, float dt) {
+    const uint32_t n = units.pack<Position, Velocity>();
+    Position*       p = units.pool<Position>().values().data();
+    const Velocity* v = units.pool<Velocity>().values().data();
+    for (uint32_t i = 0; i < n; ++i) {
+        p[i].x += v[i].x * dt;
+        p[i].z += v[i].z * dt;
+    }
+}
+
+void steer_along(UnitStore& units, std::span<const Entity> group, const FlowField& field, float speed) {
+    for (Entity e : group) {
+        const Position* p = units.get<Position>(e);
+        Velocity*       v = units.get<Velocity>(e);
+        if (!p || !v) continue;
+        float dx = 0.f, dz = 0.f;
+        field.steer(p->x, p->z, dx, dz);
+        *v = Velocity{ dx * speed, dz * speed };
+    }
+}
+
+void update_unit_grid(UnitStore& units, SpatialGrid& grid) {
+    const auto&     pool = units.pool<Position>();
+    const Position* p    = pool.values().data();
+    const Entity*   e    = pool.entities().data();
+    for (uint32_t i = 0; i < pool.size(); ++i) grid.update(e[i], p[i].x, p[i].y, p[i].z);
+}
+
+void update_unit_fog(UnitStore& units, FogOfWar& fog) {
+    const auto&   pool = units.pool<Sight>();
+    const Sight*  s    = pool.values().data();
+    const Entity* e    = pool.entities().data();
+    for (uint32_t i = 0; i < pool.size(); ++i)
+        if (const Position* p = units.get<Position>(e[i])) fog.update(e[i], s[i].player, p->x, p->z, s[i].radius);
+}
+
+uint32_t write_unit_instances(UnitStore& units, UnitInstance* out, uint32_t max) {
+    const uint32_t n = std::min(units.pack<Position, UnitLook>(), max);
+    const Position* p = units.pool<Position>().values().data();
+    const UnitLook* l = units.pool<UnitLook>().values().data();
+    for (uint32_t i = 0; i < n; ++i)
+        out[i] = UnitInstance{ p[i].x, p[i].y, p[i].z, l[i].yaw, l[i].scale, l[i].radius, l[i].type, l[i].tint };
+    return n;
+}
@@ -0,0 +1,68 @@
+#ifndef UNIT_STORE_HPP
+#define UNIT_STORE_HPP
+
+#include <cstdint>
+#include <span>
+
+#include "entity_store.hpp"
+#include "fog.hpp"
+#include "spatial_grid.hpp"
+#include "unit_instance.hpp"
+
+// The simulation's unit components. Hot per-tick data (position, velocity,
+// health) is split so each system touches only the arrays it needs; UnitLook
+// holds what only the renderer reads.
+struct Position { float x, y, z; };
+struct Velocity { float x, z; };
+struct Health   { int32_t hp, max_hp; };
+struct UnitLook {
+    float    yaw;
+    float    scale;
+    float    radius;
+    uint32_t type;   // UnitMesh index
+    uint32_t tint;   // RGBA8
+};
+struct Sight    { uint32_t player, radius; };   // radius in tiles
+struct Agent    { float radius, max_speed, vx, vz; };   // avoidance body; vx/vz = last avoided velocity
+
+using UnitStore = EntityStore<Position, Velocity, Health, UnitLook, Sight, Agent>;
+
+struct FlowField;
+
+// position += velocity * dt for every unit that has both.
+void integrate_velocity(UnitStore& units, float dt);
+
+// Points each unit of a group at 'speed' along the shared flow field (zero
+// velocity at the goal or where it can't be reached). Units without a
+// Velocity are skipped.
+void steer_along(UnitStore& units, std::span<const Entity> group, const FlowField& field, float speed);
+
+// Brings the grid up to date with every unit's Position; run once per tick
+// after movement. Units that stayed in their cell cost a store, so this is
+// linear in the unit count with no rehashing.
+void update_unit_grid(UnitStore& units, SpatialGrid& grid);
+
+// Same for fog of war: every unit with Position + Sight. Only units that
+// crossed a tile boundary touch the bitsets.
+void update_unit_fog(UnitStore& units, FogOfWar& fog);
+
+// destroy() that also takes the unit out of the grid (and the fog).
+inline bool destroy_unit(UnitStore& units, SpatialGrid& grid, Entity e) {
+    grid.remove(e);
+    return units.destroy(e);
+}
+inline bool destroy_unit(UnitStore& units, SpatialGrid& grid, FogOfWar& fog, Entity e) {
+    fog.remove(e);
+    return destroy_unit(units, grid, e);
+}
+
+// Writes one UnitInstance per unit with Position + UnitLook straight into
+// 'out' (e.g. UnitRenderer::map_units memory) in dense order: two linear
+// reads and one linear write per unit, no per-unit lookups. Returns the
+// count written (at most 'max').
+uint32_t write_unit_instances(UnitStore& units, UnitInstance* out, uint32_t max);
+
+// How many write_unit_instances would write (to size the map_units call).
+inline uint32_t renderable_units(UnitStore& units) { return units.pack<Position, UnitLook>(); }
+
+#endif // UNIT_STORE_HPP
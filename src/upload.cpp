@@ -0,0 +1,220 @@
+#include "upload.hpp"
+#include "render_pipeline.hpp"
+
+VkResult UploadQueue::create(VkDevice device, VkPhysicalDevice phys, VkDeviceSize staging_bytes) {
+    destroy();
+    m_device = device;
+    m_phys   = phys;
+    m_transfer_ownership = g_vulkan.dedicated_transfer && g_vulkan.transfer_family != g_vulkan.graphics_family;
+
+    if (auto e = m_timeline.create(device)) return e;
+    m_retire.init(device);
+    if (auto e = m_staging.create(device, phys, staging_bytes, VK_BUFFER_USAGE_TRANSFER_SRC_BIT)) return e;
+
+    VkCommandPoolCreateInfo pci{};
+    pci.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    pci.flags            = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    pci.queueFamilyIndex = g_vulkan.transfer_family;
+    return vkCreateCommandPool(device, &pci, nullptr, &m_pool);
+}
+
+void UploadQueue::destroy() {
+    if (!m_device) return;
+    if (m_pool) vkDestroyCommandPool(m_device, m_pool, nullptr); // frees every cb
+    m_pool = VK_NULL_HANDLE;
+    m_cb   = VK_NULL_HANDLE;
+    m_free_cbs.clear();
+    m_in_flight.clear();
+    m_acquire_images.clear();  m_open_images.clear();
+    m_acquire_buffers.clear(); m_open_buffers.clear();
+    m_release_value = m_staging_last_use = 0;
+
+    m_staging.destroy(m_device);
+    m_retire.flush();
+    m_timeline.destroy();
+    m_device = VK_NULL_HANDLE;
+}
+
+VkResult UploadQueue::begin_() {
+    if (m_cb) return VK_SUCCESS;
+
+    if (!m_free_cbs.empty()) {
+        m_cb = m_free_cbs.back();
+        m_free_cbs.pop_back();
+        if (auto e = vkResetCommandBuffer(m_cb, 0)) return e;
+    } else {
+        VkCommandBufferAllocateInfo cai{};
+        cai.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        cai.commandPool        = m_pool;
+        cai.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        cai.commandBufferCount = 1;
+        if (auto e = vkAllocateCommandBuffers(m_device, &cai, &m_cb)) return e;
+    }
+
+    VkCommandBufferBeginInfo bi{};
+    bi.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    bi.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    return vkBeginCommandBuffer(m_cb, &bi);
+}
+
+VkResult UploadQueue::stage_(const void* data, VkDeviceSize bytes, VkDeviceSize align, UploadAlloc& out) {
+    // ring is empty once every flush that read it finished
+    if (m_staging.used() && !m_cb && m_timeline.completed(m_staging_last_use)) m_staging.reset();
+
+    if (m_staging.allocAndWrite(data, bytes, out, align) == VK_SUCCESS) return VK_SUCCESS;
+
+    // full: push what we have, wait for it, start over
+    if (auto e = flush()) return e;
+    if (auto e = m_timeline.wait(m_staging_last_use)) return e;
+    m_staging.reset();
+
+    // still too big for the ring: grow (old buffer is idle, but go through the queue anyway)
+    if (auto e = m_staging.maybe_realloc(m_phys, align_up(bytes + align, 1ull << 20),
+                                         m_retire, m_timeline.submitted_value())) return e;
+    return m_staging.allocAndWrite(data, bytes, out, align);
+}
+
+VkResult UploadQueue::image(VkImage dst, VkFormat format, VkOffset3D offset, VkExtent3D extent,
+                            const void* texels, VkDeviceSize bytes,
+                            VkImageLayout final_layout,
+                            VkPipelineStageFlags2 dst_stage, VkAccessFlags2 dst_access) {
+    UploadAlloc src{};
+    if (auto e = stage_(texels, bytes, 16, src)) return e;
+    if (auto e = begin_()) return e;
+
+    const VkImageAspectFlags aspect = render::aspect_for_format(format);
+
+    VkImageMemoryBarrier2 to_dst = render::image_barrier2(dst,
+        VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        VK_PIPELINE_STAGE_2_NONE, 0,
+        VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT, aspect);
+    render::cmd_barriers(m_cb, { &to_dst, 1 });
+
+    VkBufferImageCopy region{};
+    region.bufferOffset                = src.offset;
+    region.imageSubresource.aspectMask = aspect;
+    region.imageSubresource.layerCount = 1;
+    region.imageOffset                 = offset;
+    region.imageExtent                 = extent;
+    vkCmdCopyBufferToImage(m_cb, src.buffer, dst, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+    if (!m_transfer_ownership) {
+        VkImageMemoryBarrier2 b = render::image_barrier2(dst,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, final_layout,
+            VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+            dst_stage, dst_access, aspect);
+        render::cmd_barriers(m_cb, { &b, 1 });
+        return VK_SUCCESS;
+    }
+
+    // release here (no dst scope), acquire on graphics with the identical layout pair
+    VkImageMemoryBarrier2 release = render::image_barrier2(dst,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, final_layout,
+        VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+        VK_PIPELINE_STAGE_2_NONE, 0, aspect,
+        g_vulkan.transfer_family, g_vulkan.graphics_family);
+    render::cmd_barriers(m_cb, { &release, 1 });
+
+    VkImageMemoryBarrier2 acquire = release;
+    acquire.srcStageMask  = VK_PIPELINE_STAGE_2_NONE;
+    acquire.srcAccessMask = 0;
+    acquire.dstStageMask  = dst_stage;
+    acquire.dstAccessMask = dst_access;
+    m_open_images.push_back(acquire);
+    return VK_SUCCESS;
+}
+
+VkResult UploadQueue::buffer(VkBuffer dst, VkDeviceSize dst_offset, const void* data, VkDeviceSize bytes,
+                             VkPipelineStageFlags2 dst_stage, VkAccessFlags2 dst_access) {
+    UploadAlloc src{};
+    if (auto e = stage_(data, bytes, 16, src)) return e;
+    if (auto e = begin_()) return e;
+
+    VkBufferCopy copy{ src.offset, dst_offset, bytes };
+    vkCmdCopyBuffer(m_cb, src.buffer, dst, 1, &copy);
+
+    VkBufferMemoryBarrier2 b = render::buffer_barrier2(dst,
+        VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+        m_transfer_ownership ? VK_PIPELINE_STAGE_2_NONE : dst_stage,
+        m_transfer_ownership ? 0 : dst_access,
+        dst_offset, bytes);
+    if (m_transfer_ownership) {
+        b.srcQueueFamilyIndex = g_vulkan.transfer_family;
+        b.dstQueueFamilyIndex = g_vulkan.graphics_family;
+    }
+    render::cmd_barriers(m_cb, {}, { &b, 1 });
+
+    if (m_transfer_ownership) {
+        VkBufferMemoryBarrier2 acquire = b;
+        acquire.srcStageMask  = VK_PIPELINE_STAGE_2_NONE;
+        acquire.srcAccessMask = 0;
+        acquire.dstStageMask  = dst_stage;
+        acquire.dstAccessMask = dst_access;
+        m_open_buffers.push_back(acquire);
+    }
+    return VK_SUCCESS;
+}
+
+VkResult UploadQueue::flush(uint64_t* out_value) {
+    if (out_value) *out_value = 0;
+    if (!m_cb) return VK_SUCCESS;
+
+    if (auto e = vkEndCommandBuffer(m_cb)) return e;
+
+    VkSubmitInfo si{};
+    si.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    si.commandBufferCount = 1;
+    si.pCommandBuffers    = &m_cb;
+
+    uint64_t value = 0;
+    if (auto e = m_timeline.submit(g_vulkan.transfer_queue, si, value)) return e;
+
+    m_in_flight.push_back({ m_cb, value });
+    m_cb = VK_NULL_HANDLE;
+    m_staging_last_use = value;
+
+    m_acquire_images.insert(m_acquire_images.end(), m_open_images.begin(), m_open_images.end());
+    m_acquire_buffers.insert(m_acquire_buffers.end(), m_open_buffers.begin(), m_open_buffers.end());
+    m_open_images.clear();
+    m_open_buffers.clear();
+    m_release_value = value;
+
+    // a fence can't be waited on by another queue: finish here instead
+    if (!g_vulkan.timeline_semaphore)
+        if (auto e = m_timeline.wait(value)) return e;
+
+    if (out_value) *out_value = value;
+    return VK_SUCCESS;
+}
+
+bool UploadQueue::acquire(VkCommandBuffer cb, VkSemaphore& wait_semaphore, uint64_t& wait_value) {
+    wait_semaphore = VK_NULL_HANDLE;
+    wait_value     = 0;
+
+    // cmd_barriers' classic path takes at most 32 of each per call
+    constexpr size_t kBatch = 32;
+    for (size_t i = 0; i < m_acquire_images.size(); i += kBatch)
+        render::cmd_barriers(cb, std::span(m_acquire_images).subspan(i, std::min(kBatch, m_acquire_images.size() - i)));
+    for (size_t i = 0; i < m_acquire_buffers.size(); i += kBatch)
+        render::cmd_barriers(cb, {}, std::span(m_acquire_buffers).subspan(i, std::min(kBatch, m_acquire_buffers.size() - i)));
+
+    const bool had = !m_acquire_images.empty() || !m_acquire_buffers.empty();
+    m_acquire_images.clear();
+    m_acquire_buffers.clear();
+
+    if (had && g_vulkan.timeline_semaphore && !m_timeline.completed(m_release_value)) {
+        wait_semaphore = m_timeline.semaphore();
+        wait_value     = m_release_value;
+        return true;
+    }
+    return false;
+}
+
+void UploadQueue::collect() {
+    m_timeline.poll();
+    while (!m_in_flight.empty() && m_timeline.completed(m_in_flight.front().value)) {
+        m_free_cbs.push_back(m_in_flight.front().cb);
+        m_in_flight.pop_front();
+    }
+    m_retire.collect(m_timeline);
+}
@@ -0,0 +1,87 @@
+#ifndef UPLOAD_HPP
+#define UPLOAD_HPP
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "platform.hpp"
+#include "memory.hpp"
+#include "gpu_timeline.hpp"
+#include "deletion_queue.hpp"
+
+// Background uploads on g_vulkan.transfer_queue. Copies are staged in a mapped
+// ring, recorded into a transfer command buffer and submitted by flush(). When
+// the transfer family is dedicated, every destination is released to the
+// graphics family there and acquired by the graphics queue in acquire(),
+// which also hands back the timeline wait the graphics submit must include.
+// Without a dedicated family the same API records plain barriers and the
+// graphics side has nothing to do.
+//
+// Destinations are treated as new: previous contents are not preserved
+// (ownership moves without a graphics-side release). Use it to stream fresh
+// textures, chunks and buffers, not to patch resources in use.
+class UploadQueue {
+public:
+    VkResult create(VkDevice device, VkPhysicalDevice phys, VkDeviceSize staging_bytes = 16ull << 20);
+    void     destroy();   // device must be idle
+
+    // Tightly packed texels for 'extent' at 'offset' (mip 0, layer 0). The
+    // image ends up in final_layout, visible to (dst_stage, dst_access) on the
+    // graphics queue once acquired.
+    VkResult image(VkImage dst, VkFormat format, VkOffset3D offset, VkExtent3D extent,
+                   const void* texels, VkDeviceSize bytes,
+                   VkImageLayout final_layout      = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                   VkPipelineStageFlags2 dst_stage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+                   VkAccessFlags2 dst_access       = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT);
+
+    VkResult buffer(VkBuffer dst, VkDeviceSize dst_offset, const void* data, VkDeviceSize bytes,
+                    VkPipelineStageFlags2 dst_stage = VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT,
+                    VkAccessFlags2 dst_access       = VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT);
+
+    // Submits everything recorded since the last flush. Returns the transfer
+    // timeline value (0 when there was nothing to submit). Without timeline
+    // semaphores the graphics queue can't wait on it, so this blocks instead.
+    VkResult flush(uint64_t* out_value = nullptr);
+
+    // Graphics side, once per frame before touching flushed uploads: records
+    // the acquire barriers into 'cb' and returns true (with the semaphore and
+    // value to wait on at 'wait_stage') if the graphics submit must wait.
+    bool acquire(VkCommandBuffer cb, VkSemaphore& wait_semaphore, uint64_t& wait_value);
+    static constexpr VkPipelineStageFlags wait_stage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+    // Frees staging/command buffers of finished uploads. Cheap; call per frame.
+    void collect();
+
+    GpuTimeline& timeline() { return m_timeline; }
+
+private:
+    VkResult stage_(const void* data, VkDeviceSize bytes, VkDeviceSize align, UploadAlloc& out);
+    VkResult begin_();
+
+    struct InFlight {
+        VkCommandBuffer cb;
+        uint64_t        value;
+    };
+
+    VkDevice         m_device = VK_NULL_HANDLE;
+    VkPhysicalDevice m_phys   = VK_NULL_HANDLE;
+    bool             m_transfer_ownership = false;   // dedicated family -> release/acquire
+
+    GpuTimeline   m_timeline;
+    DeletionQueue m_retire;
+    MappedArena   m_staging;
+    uint64_t      m_staging_last_use = 0;  // value of the last flush that read the ring
+
+    VkCommandPool                m_pool = VK_NULL_HANDLE;
+    VkCommandBuffer              m_cb   = VK_NULL_HANDLE;  // recording, not yet flushed
+    std::vector<VkCommandBuffer> m_free_cbs;
+    std::deque<InFlight>         m_in_flight;
+
+    // acquire halves: recorded ones wait for m_release_value, open ones for the next flush
+    std::vector<VkImageMemoryBarrier2>  m_acquire_images,  m_open_images;
+    std::vector<VkBufferMemoryBarrier2> m_acquire_buffers, m_open_buffers;
+    uint64_t                            m_release_value = 0;
+};
+
+#endif // UPLOAD_HPP
@@ -0,0 +1,84 @@
+// tests/auto_tests/camera_math.cpp
+#include <cmath>
+#include <cstdio>
+#include "camera.hpp"
+
+#define TEST_NAME "camera_math"
+#include "check.hpp"
+
+static bool near(float a, float b, float eps = 1e-3f) { return std::fabs(a - b) <= eps; }
+
+static void round_trip(Camera& cam, const char* label) {
+    for (float x = -20.f; x <= 20.f; x += 5.f) {
+        for (float z = -20.f; z <= 20.f; z += 5.f) {
+            const float wx = cam.target[0] + x, wz = cam.target[2] + z;
+            float sx, sy, rx, rz;
+            if (!cam.world_to_screen(wx, 0.f, wz, sx, sy)) { check(false, label); return; }
+            if (!cam.screen_to_world(sx, sy, rx, rz))      { check(false, label); return; }
+            if (!near(rx, wx) || !near(rz, wz)) {
+                std::fprintf(stderr, "[camera_math] %s: (%g,%g) -> (%g,%g) -> (%g,%g)\n",
+                             label, wx, wz, sx, sy, rx, rz);
+                check(false, label);
+                return;
+            }
+        }
+    }
+}
+
+int main() {
+    Camera cam;
+    cam.set_viewport(1280.f, 720.f);
+    cam.target[0] = 100.f; cam.target[2] = 50.f;
+
+    // TopDown: target at the center, +x right, +z down, zoom = visible height
+    cam.mode = CameraMode::TopDown;
+    cam.zoom = 40.f;
+    cam.update();
+    float sx, sy;
+    check(cam.world_to_screen(100.f, 0.f, 50.f, sx, sy) && near(sx, 640.f) && near(sy, 360.f), "top-down center");
+    check(cam.world_to_screen(100.f, 0.f, 70.f, sx, sy) && near(sy, 720.f), "top-down +z is screen bottom");
+    check(cam.world_to_screen(110.f, 0.f, 50.f, sx, sy) && sx > 640.f, "top-down +x is screen right");
+    round_trip(cam, "top-down round trip");
+
+    // Isometric: same center, higher ground appears higher on screen
+    cam.mode = CameraMode::Isometric;
+    cam.update();
+    check(cam.world_to_screen(100.f, 0.f, 50.f, sx, sy) && near(sx, 640.f) && near(sy, 360.f), "iso center");
+    float sy_high;
+    cam.world_to_screen(100.f, 5.f, 50.f, sx, sy_high);
+    check(sy_high < 360.f, "iso up is screen up");
+    round_trip(cam, "iso round trip");
+
+    // zoom_at keeps the ground under the cursor
+    float gx0, gz0, gx1, gz1;
+    cam.screen_to_world(200.f, 500.f, gx0, gz0);
+    cam.zoom_at(2.f, 200.f, 500.f);
+    cam.screen_to_world(200.f, 500.f, gx1, gz1);
+    check(near(cam.zoom, 20.f) && near(gx0, gx1) && near(gz0, gz1), "zoom_at anchor");
+
+    // pan_pixels: the ground follows the drag
+    cam.screen_to_world(640.f, 360.f, gx0, gz0);
+    cam.pan_pixels(100.f, -40.f);
+    cam.screen_to_world(740.f, 320.f, gx1, gz1);
+    check(near(gx0, gx1) && near(gz0, gz1), "pan_pixels follows cursor");
+
+    // culling: a box under the target is in, one far away is out
+    const float in_mn[3]  = { cam.target[0] - 1.f, 0.f, cam.target[2] - 1.f };
+    const float in_mx[3]  = { cam.target[0] + 1.f, 1.f, cam.target[2] + 1.f };
+    const float out_mn[3] = { cam.target[0] + 500.f, 0.f, cam.target[2] };
+    const float out_mx[3] = { cam.target[0] + 501.f, 1.f, cam.target[2] + 1.f };
+    check(cam.visible(in_mn, in_mx),   "aabb at target visible");
+    check(!cam.visible(out_mn, out_mx), "aabb far away culled");
+    check(!cam.visible(cam.target[0] - 500.f, 0.f, cam.target[2], 1.f), "sphere far away culled");
+
+    // labels: a wide label whose anchor is just off the left edge still shows
+    cam.mode = CameraMode::TopDown;
+    cam.update();
+    const float edge_x = cam.target[0] - 0.5f * cam.zoom * (1280.f / 720.f) - 0.5f;
+    check(cam.label_visible(edge_x, 0.f, cam.target[2], 200.f, 20.f, sx, sy), "label overlapping edge");
+    check(!cam.label_visible(edge_x, 0.f, cam.target[2], 4.f, 4.f, sx, sy),   "small label off screen");
+
+    if (g_failures) return 1;
+    std::printf("[camera_math] OK\n");
+    return 0;
+}
@@ -0,0 +1,20 @@
+// tests/auto_tests/check.hpp
+// The failure counter every auto test shares. Define TEST_NAME (the file's
+// name, as a string literal) before including; main() returns 1 if
+// g_failures is non-zero. Not a test itself: only .cpp files get collected.
+#ifndef TESTS_CHECK_HPP
+#define TESTS_CHECK_HPP
+
+#include <cstdio>
+
+#ifndef TEST_NAME
+#error "define TEST_NAME before including check.hpp"
+#endif
+
+static int g_failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok) { std::fprintf(stderr, "[" TEST_NAME "] FAIL: %s\n", what); ++g_failures; }
+}
+
+#endif // TESTS_CHECK_HPP
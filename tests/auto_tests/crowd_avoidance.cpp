@@ -0,0 +1,126 @@
+// tests/auto_tests/crowd_avoidance.cpp
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "avoidance.hpp"
+#include "jobs.hpp"
+
+#define TEST_NAME "crowd_avoidance"
+#include "check.hpp"
+
+constexpr float kDt = 1.f / 30.f;
+
+// Steers every agent at its goal, solves, integrates. Returns the deepest
+// overlap seen (as a fraction of the pair's combined radius).
+static float run(CrowdAvoidance& crowd, AvoidanceAgents& a, const std::vector<float>& gx,
+                 const std::vector<float>& gz, int ticks) {
+    float worst = 0.f;
+    for (int t = 0; t < ticks; ++t) {
+        for (uint32_t i = 0; i < a.size(); ++i) {
+            const float dx = gx[i] - a.x[i], dz = gz[i] - a.z[i], d = std::sqrt(dx * dx + dz * dz);
+            const float s  = d > 1e-4f ? std::min(a.max_speed[i], d / kDt) / d : 0.f;
+            a.pref_x[i] = dx * s;
+            a.pref_z[i] = dz * s;
+        }
+        crowd.solve(a, kDt);
+        for (uint32_t i = 0; i < a.size(); ++i) { a.x[i] += a.vx[i] * kDt; a.z[i] += a.vz[i] * kDt; }
+
+        for (uint32_t i = 0; i < a.size(); ++i)
+            for (uint32_t j = i + 1; j < a.size(); ++j) {
+                const float dx = a.x[j] - a.x[i], dz = a.z[j] - a.z[i];
+                const float rr = a.radius[i] + a.radius[j];
+                const float d  = std::sqrt(dx * dx + dz * dz);
+                if (d < rr) worst = std::max(worst, 1.f - d / rr);
+            }
+    }
+    return worst;
+}
+
+static float farthest_from_goal(const AvoidanceAgents& a, const std::vector<float>& gx, const std::vector<float>& gz) {
+    float worst = 0.f;
+    for (uint32_t i = 0; i < a.size(); ++i)
+        worst = std::max(worst, std::hypot(gx[i] - a.x[i], gz[i] - a.z[i]));
+    return worst;
+}
+
+int main() {
+    CrowdAvoidance crowd;
+
+    // head-on pair: they sidestep instead of walking through each other
+    {
+        AvoidanceAgents a;
+        a.resize(2);
+        a.x = { -5.f, 5.f };  a.z = { 0.f, 0.f };
+        a.vx = { 0.f, 0.f };  a.vz = { 0.f, 0.f };
+        a.radius = { 0.5f, 0.5f }; a.max_speed = { 2.f, 2.f };
+        const std::vector<float> gx{ 5.f, -5.f }, gz{ 0.f, 0.f };
+        const float overlap = run(crowd, a, gx, gz, 300);
+        check(overlap < 0.05f, "head-on pair keeps apart");
+        check(farthest_from_goal(a, gx, gz) < 0.1f, "head-on pair arrives");
+    }
+
+    // two 5x5 squads swap places through each other
+    {
+        AvoidanceAgents a;
+        a.resize(50);
+        std::vector<float> gx(50), gz(50);
+        for (uint32_t i = 0; i < 50; ++i) {
+            const uint32_t k = i % 25;
+            const bool     right = i >= 25;
+            const float    ox = float(k % 5) * 1.2f, oz = float(k / 5) * 1.2f + 0.1f * float(k % 3);
+            a.x[i] = right ? 20.f + ox : ox;  a.z[i] = oz;
+            gx[i]  = right ? ox : 20.f + ox;  gz[i]  = oz;
+            a.vx[i] = a.vz[i] = 0.f;
+            a.radius[i] = 0.4f; a.max_speed[i] = 2.f;
+        }
+        const float overlap = run(crowd, a, gx, gz, 1500);
+        check(overlap < 0.1f, "crossing squads keep apart");
+        check(farthest_from_goal(a, gx, gz) < 0.1f, "crossing squads arrive");
+    }
+
+    // same answer with and without workers, to the bit
+    {
+        std::mt19937 rng(48);
+        std::uniform_real_distribution<float> pos(0.f, 40.f), vel(-2.f, 2.f);
+        AvoidanceAgents base;
+        base.resize(2000);
+        for (uint32_t i = 0; i < base.size(); ++i) {
+            base.x[i] = pos(rng); base.z[i] = pos(rng);
+            base.vx[i] = vel(rng); base.vz[i] = vel(rng);
+            base.pref_x[i] = vel(rng); base.pref_z[i] = vel(rng);
+            base.radius[i] = 0.3f; base.max_speed[i] = 2.5f;
+        }
+        AvoidanceAgents serial = base, threaded = base;
+        crowd.solve(serial, kDt);
+        g_jobs.start(3);
+        crowd.solve(threaded, kDt);
+        g_jobs.stop();
+        check(std::memcmp(serial.vx.data(), threaded.vx.data(), serial.vx.size() * sizeof(float)) == 0 &&
+              std::memcmp(serial.vz.data(), threaded.vz.data(), serial.vz.size() * sizeof(float)) == 0,
+              "thread count doesn't change the result");
+        bool capped = true;
+        for (uint32_t i = 0; i < serial.size(); ++i)
+            capped &= std::hypot(serial.vx[i], serial.vz[i]) <= serial.max_speed[i] * 1.001f;
+        check(capped, "max speed respected");
+    }
+
+    // UnitStore path: Velocity in is the preference, out is the answer
+    {
+        UnitStore units;
+        Entity a = units.create(), b = units.create(), lone = units.create();
+        units.add<Position>(a, { 0.f, 0.f, 0.f });  units.add<Velocity>(a, { 1.f, 0.f });
+        units.add<Position>(b, { 1.2f, 0.f, 0.f }); units.add<Velocity>(b, { -1.f, 0.f });
+        units.add<Position>(lone, { 30.f, 0.f, 30.f }); units.add<Velocity>(lone, { 0.f, 1.5f });
+        for (Entity e : { a, b, lone }) units.add<Agent>(e, { 0.5f, 2.f, 0.f, 0.f });
+        crowd.solve(units, kDt);
+        check(units.get<Velocity>(a)->z != 0.f || units.get<Velocity>(a)->x < 1.f, "closing pair deflects");
+        check(units.get<Velocity>(lone)->x == 0.f && units.get<Velocity>(lone)->z == 1.5f, "free unit keeps its preference");
+        check(units.get<Agent>(lone)->vz == 1.5f, "agent remembers the solved velocity");
+    }
+
+    if (g_failures) return 1;
+    std::printf("[crowd_avoidance] OK\n");
+    return 0;
+}
@@ -0,0 +1,156 @@
+// tests/auto_tests/draw_queue.cpp
+// DrawQueue on the CPU: the order replay() walks packets in and the binds it
+// keeps, through the command list overload (no device needed).
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+#include "draw_queue.hpp"
+
+#define TEST_NAME "draw_queue"
+#include "check.hpp"
+
+// Distinct non-null handles; replay only compares them.
+template <class H>
+static H fake(uint64_t v) {
+    H h{};
+    std::memcpy(&h, &v, sizeof h);
+    return h;
+}
+
+static int count_ops(const std::vector<DrawCommand>& cmds, DrawCommand::Op op) {
+    return int(std::count_if(cmds.begin(), cmds.end(), [&](const DrawCommand& c) { return c.op == op; }));
+}
+
+static DrawPacket packet(uint64_t key, VkPipeline pipeline, VkPipelineLayout layout) {
+    DrawPacket p;
+    p.key      = key;
+    p.pipeline = pipeline;
+    p.layout   = layout;
+    p.count    = 3;
+    return p;
+}
+
+int main() {
+    const VkPipelineLayout layout_a = fake<VkPipelineLayout>(0x100), layout_b = fake<VkPipelineLayout>(0x101);
+    const VkBuffer         vb = fake<VkBuffer>(0x200), ib = fake<VkBuffer>(0x201);
+
+    // --- depth keys ---
+    check(draw_key::depth(1.f) < draw_key::depth(2.f) && draw_key::depth(2.f) < draw_key::depth(100.f), "depth orders near to far");
+    check(draw_key::depth(1.f, true) > draw_key::depth(2.f, true), "back_to_front flips it");
+    check(draw_key::depth(-1.f) == 0 && draw_key::depth(std::numeric_limits<float>::quiet_NaN()) == 0, "negative and NaN depth clamp to 0");
+    check(draw_key::depth(1e30f) <= 0xFFFFFFu, "depth fits 24 bits");
+
+    // --- sort: key order, stable for equal keys, one pass per replay ---
+    {
+        DrawQueue q;
+        std::mt19937 rng(29);
+        std::vector<uint64_t> keys;
+        for (int i = 0; i < 2000; ++i) {
+            // few distinct values per field, so equal keys happen
+            const uint64_t k = draw_key::make(uint8_t(rng() % 3), uint16_t(rng() % 4 * 1000), uint16_t(rng() % 5),
+                                              draw_key::depth(float(rng() % 8)));
+            keys.push_back(k);
+            q.push(packet(k, fake<VkPipeline>(1 + draw_key::pipeline(k)), layout_a));
+        }
+        q.sort();
+
+        bool ordered = true, stable = true, right_pass = true;
+        size_t drawn = 0;
+        for (uint8_t pass = 0; pass < 3; ++pass) {
+            std::vector<DrawCommand> cmds;
+            q.replay(cmds, pass);
+            uint32_t prev = UINT32_MAX;
+            for (const DrawCommand& c : cmds) {
+                if (c.op != DrawCommand::Draw) continue;
+                right_pass &= draw_key::pass(keys[c.packet]) == pass;
+                if (prev != UINT32_MAX) {
+                    ordered &= keys[prev] <= keys[c.packet];
+                    stable  &= keys[prev] != keys[c.packet] || prev < c.packet;
+                }
+                prev = c.packet;
+                ++drawn;
+            }
+        }
+        check(ordered, "packets replay in key order");
+        check(stable, "equal keys keep submission order");
+        check(right_pass, "replay(pass) only walks that pass");
+        check(drawn == keys.size() && q.stats().draws == keys.size(), "every packet drawn once");
+
+        std::vector<DrawCommand> none;
+        q.replay(none, 7);
+        check(none.empty(), "empty pass records nothing");
+    }
+
+    // --- redundant binds: 2 pipelines x 3 materials x 4 draws, pushed shuffled ---
+    {
+        DrawQueue q;
+        std::vector<DrawPacket> packets;
+        for (uint16_t pl = 0; pl < 2; ++pl)
+            for (uint16_t m = 0; m < 3; ++m)
+                for (uint32_t d = 0; d < 4; ++d) {
+                    DrawPacket p = packet(draw_key::make(0, pl, m, d), fake<VkPipeline>(1 + pl), layout_a);
+                    p.set           = fake<VkDescriptorSet>(0x300 + m);
+                    p.vertex_buffer = vb;
+                    p.index_buffer  = ib;
+                    packets.push_back(p);
+                }
+        std::shuffle(packets.begin(), packets.end(), std::mt19937(7));
+        for (const DrawPacket& p : packets) q.push(p);
+        q.sort();
+
+        std::vector<DrawCommand> cmds;
+        q.replay(cmds, 0);
+        check(q.stats().draws == 24 && count_ops(cmds, DrawCommand::DrawIndexed) == 24, "all draws indexed");
+        check(q.stats().pipeline_binds == 2 && count_ops(cmds, DrawCommand::BindPipeline) == 2, "one bind per pipeline");
+        check(q.stats().set_binds == 6 && count_ops(cmds, DrawCommand::BindSet) == 6, "one bind per material run");
+        check(q.stats().buffer_binds == 2 && count_ops(cmds, DrawCommand::BindVertexBuffer) == 1 &&
+              count_ops(cmds, DrawCommand::BindIndexBuffer) == 1, "shared buffers bound once");
+        check(!cmds.empty() && cmds[0].op == DrawCommand::BindPipeline, "pipeline bound before anything else");
+
+        // state is per replay: the same pass again binds everything again
+        cmds.clear();
+        q.replay(cmds, 0);
+        check(count_ops(cmds, DrawCommand::BindPipeline) == 2 && q.stats().pipeline_binds == 4, "replay starts from nothing bound");
+
+        q.clear();
+        check(q.size() == 0 && q.stats().draws == 0 && q.stats().pipeline_binds == 0, "clear drops packets and stats");
+    }
+
+    // --- what forces a rebind ---
+    {
+        DrawQueue q;
+        const VkDescriptorSet set = fake<VkDescriptorSet>(0x400);
+        // same set, but the layout changes between pipelines: bound twice
+        DrawPacket a = packet(draw_key::make(0, 0, 0), fake<VkPipeline>(1), layout_a);
+        DrawPacket b = packet(draw_key::make(0, 1, 0), fake<VkPipeline>(2), layout_b);
+        a.set = b.set = set;
+        // same index buffer, other index type / offset: rebound; vertex offset too
+        a.vertex_buffer = b.vertex_buffer = vb;
+        b.vertex_offset = 64;
+        a.index_buffer  = b.index_buffer = ib;
+        b.index_type    = VK_INDEX_TYPE_UINT32;
+        // push constants on every packet that has them
+        const uint32_t pc[2] = { 1, 2 };
+        a.push_stages = b.push_stages = VK_SHADER_STAGE_VERTEX_BIT;
+        a.push_size   = b.push_size   = sizeof(uint32_t);
+        q.push(b, &pc[1]);
+        q.push(a, &pc[0]);
+        q.sort();
+
+        std::vector<DrawCommand> cmds;
+        q.replay(cmds, 0);
+        check(count_ops(cmds, DrawCommand::BindSet) == 2, "layout change rebinds sets");
+        check(count_ops(cmds, DrawCommand::BindVertexBuffer) == 2, "vertex offset change rebinds");
+        check(count_ops(cmds, DrawCommand::BindIndexBuffer) == 2, "index type change rebinds");
+        check(count_ops(cmds, DrawCommand::PushConstants) == 2, "push constants per packet");
+        check(cmds.back().op == DrawCommand::DrawIndexed && cmds.back().packet == 0, "packets refer to push order");
+    }
+
+    if (g_failures) return 1;
+    std::printf("[draw_queue] OK\n");
+    return 0;
+}
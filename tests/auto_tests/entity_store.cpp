@@ -0,0 +1,82 @@
+// tests/auto_tests/entity_store.cpp
+#include <cstdio>
+#include <vector>
+#include "unit_store.hpp"
+
+#define TEST_NAME "entity_store"
+#include "check.hpp"
+
+int main() {
+    UnitStore units;
+
+    // --- generational handles ---
+    Entity a = units.create();
+    Entity b = units.create();
+    units.add<Position>(a, { 1, 0, 1 });
+    units.add<Position>(b, { 2, 0, 2 });
+    check(units.destroy(a), "destroy live");
+    check(!units.destroy(a), "double destroy");
+    check(!units.alive(a) && !units.get<Position>(a), "stale handle resolves to nothing");
+
+    Entity c = units.create();   // recycles a's index
+    check(c.index == a.index && !(c == a), "index reused with a new generation");
+    check(!units.get<Position>(c), "recycled index starts empty");
+    check(units.get<Position>(b) && units.get<Position>(b)->x == 2.f, "other entity untouched");
+    units.destroy(b);
+    units.destroy(c);
+    check(units.size() == 0 && units.pool<Position>().size() == 0, "all gone");
+
+    // --- swap-and-pop keeps the sparse table right ---
+    std::vector<Entity> es;
+    for (int i = 0; i < 100; ++i) {
+        Entity e = units.create();
+        units.add<Position>(e, { float(i), 0, 0 });
+        if (i % 3 == 0) units.add<Velocity>(e, { 1.f, float(i) });
+        if (i % 2 == 0) units.add<UnitLook>(e, { 0, 1, 0.5f, uint32_t(i), 0xFFFFFFFFu });
+        es.push_back(e);
+    }
+    for (int i = 0; i < 100; i += 5) units.destroy(es[i]);
+    bool ok = true;
+    for (int i = 0; i < 100; ++i) {
+        const Position* p = units.get<Position>(es[i]);
+        ok &= (i % 5 == 0) ? p == nullptr : (p && p->x == float(i));
+    }
+    check(ok, "positions follow their entities after removals");
+
+    // --- pack_shared lines both pools up ---
+    const uint32_t n = units.pack<Position, Velocity>();
+    uint32_t expect = 0;
+    for (int i = 0; i < 100; ++i) expect += (i % 3 == 0) && (i % 5 != 0);
+    check(n == expect, "pack count");
+    ok = true;
+    for (uint32_t i = 0; i < n; ++i)
+        ok &= units.pool<Position>().entities()[i] == units.pool<Velocity>().entities()[i];
+    check(ok, "packed prefixes share entity order");
+
+    integrate_velocity(units, 0.5f);
+    ok = true;
+    for (int i = 0; i < 100; ++i) {
+        if (i % 5 == 0) continue;
+        const Position* p = units.get<Position>(es[i]);
+        const float want_x = float(i) + ((i % 3 == 0) ? 0.5f : 0.f);
+        const float want_z = (i % 3 == 0) ? float(i) * 0.5f : 0.f;
+        ok &= p->x == want_x && p->z == want_z;
+    }
+    check(ok, "integrate_velocity moves only units with velocity");
+
+    // --- streaming instances ---
+    const uint32_t r = renderable_units(units);
+    std::vector<UnitInstance> out(r);
+    check(write_unit_instances(units, out.data(), r) == r, "write count");
+    ok = true;
+    for (uint32_t i = 0; i < r; ++i) {
+        const Entity    e = units.pool<UnitLook>().entities()[i];
+        const Position* p = units.get<Position>(e);
+        ok &= out[i].x == p->x && out[i].type == e.index;   // type was set to the creation order == index
+    }
+    check(r == 40 && ok, "instances match their entities");
+
+    if (g_failures) return 1;
+    std::printf("[entity_store] OK\n");
+    return 0;
+}
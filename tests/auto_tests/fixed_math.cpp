@@ -0,0 +1,96 @@
+// tests/auto_tests/fixed_math.cpp
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include "fixed.hpp"
+
+#define TEST_NAME "fixed_math"
+#include "check.hpp"
+
+constexpr double kTwoPi = 6.283185307179586;
+
+int main() {
+    // arithmetic
+    {
+        constexpr Fixed a = Fixed::from_int(3), b = Fixed::from_ratio(1, 4);
+        static_assert((a * b).raw == Fixed::from_ratio(3, 4).raw);
+        static_assert((a / b).raw == Fixed::from_int(12).raw);
+        static_assert((-a).floor() == -3 && (-b).floor() == -1);
+        static_assert(Fixed::from_int(-2) < b && fx_abs(Fixed::from_int(-2)) == Fixed::from_int(2));
+        check((Fixed::from_float(1.5f) * Fixed::from_float(-2.25f)).to_float() == -3.375f, "multiply");
+        check((Fixed::from_int(32767) + Fixed::from_int(1)).raw == INT32_MIN, "add wraps");
+
+        // division floors like the shifts do, whatever the signs
+        static_assert(Fixed::from_ratio(-1, 3).raw == -21846 && Fixed::from_ratio(1, -3).raw == -21846);
+        static_assert(Fixed::from_ratio(1, 3).raw == 21845 && Fixed::from_ratio(-1, -3).raw == 21845);
+        check((Fixed::from_int(-1) / Fixed::from_int(3)).raw == -21846, "negative quotient floors");
+        check((Fixed::from_raw(-1) / Fixed::from_int(2)).raw == -1, "tiny negative quotient floors");
+        check((Fixed::from_raw(-1) * Fixed::from_ratio(1, 2)).raw == -1, "multiply floors");
+    }
+
+    // sqrt: floor of the exact root, compared in integers
+    {
+        std::mt19937 rng(49);
+        std::uniform_int_distribution<int32_t> raw(0, INT32_MAX);
+        bool ok = true;
+        for (int i = 0; i < 20000; ++i) {
+            const int32_t  v = i < 100 ? i : raw(rng);
+            const uint64_t r = uint64_t(fx_sqrt(Fixed::from_raw(v)).raw), s = uint64_t(v) << 16;
+            ok &= r * r <= s && (r + 1) * (r + 1) > s;
+        }
+        check(ok, "sqrt exact");
+        check(fx_sqrt(Fixed::from_int(9)) == Fixed::from_int(3), "sqrt(9)");
+        check(fx_sqrt(Fixed::from_int(-4)).raw == 0, "sqrt of negative");
+        check(fx_length({ Fixed::from_int(3000), Fixed::from_int(4000) }) == Fixed::from_int(5000), "length without overflow");
+        check(fx_length({ Fixed::from_int(32767), {} }) == Fixed::from_int(32767), "length at the top of the range");
+        check(fx_length({ Fixed::from_int(30000), Fixed::from_int(30000) }).raw == INT32_MAX, "long length saturates");
+        check(fx_length({ Fixed::from_raw(INT32_MIN), Fixed::from_raw(INT32_MIN) }).raw == INT32_MAX, "longest length saturates");
+        const FxVec2 n = fx_normalize({ Fixed::from_int(30000), Fixed::from_int(-30000) });
+        check(std::fabs(n.x.to_float() - 0.70710678f) < 1e-4f && std::fabs(n.z.to_float() + 0.70710678f) < 1e-4f,
+              "normalize past the length range");
+    }
+
+    // sin/cos against libm at every angle
+    {
+        double worst = 0;
+        for (uint32_t a = 0; a < 65536; ++a) {
+            const double t = kTwoPi * a / 65536.0;
+            worst = std::max(worst, std::fabs(double(fx_sin(FxAngle(a)).to_float()) - std::sin(t)));
+            worst = std::max(worst, std::fabs(double(fx_cos(FxAngle(a)).to_float()) - std::cos(t)));
+        }
+        check(worst < 4e-5, "sin/cos accuracy");
+        check(fx_sin(kFxQuarterTurn) == Fixed::from_int(1) && fx_cos(kFxHalfTurn) == Fixed::from_int(-1), "exact axes");
+    }
+
+    // atan2 inverts sin/cos, and is within a step of libm for odd vectors
+    {
+        bool ok = true;
+        for (uint32_t a = 0; a < 65536; a += 7) {
+            const FxAngle back = fx_atan2(fx_sin(FxAngle(a)) * Fixed::from_int(100), fx_cos(FxAngle(a)) * Fixed::from_int(100));
+            ok &= std::abs(int16_t(uint16_t(back - a))) <= 2;
+        }
+        check(ok, "atan2 round trip");
+
+        std::mt19937 rng(50);
+        std::uniform_int_distribution<int32_t> raw(-2000000000, 2000000000), tiny(-40, 40);
+        int worst = 0;
+        for (int i = 0; i < 20000; ++i) {
+            const int32_t x = i & 1 ? raw(rng) : tiny(rng), z = i & 2 ? raw(rng) : tiny(rng);
+            if (x == 0 && z == 0) continue;
+            double t = std::atan2(double(z), double(x));
+            if (t < 0) t += kTwoPi;
+            const int expect = int(std::lround(t / kTwoPi * 65536.0)) & 0xFFFF;
+            const int got    = fx_atan2(Fixed::from_raw(z), Fixed::from_raw(x));
+            worst = std::max(worst, std::abs(int16_t(uint16_t(got - expect))));
+        }
+        check(worst <= 1, "atan2 accuracy");
+        check(fx_atan2({}, {}) == 0, "atan2(0, 0)");
+    }
+
+    if (g_failures) return 1;
+    std::printf("[fixed_math] OK\n");
+    return 0;
+}
@@ -0,0 +1,127 @@
+// tests/auto_tests/fog_of_war.cpp
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "unit_store.hpp"
+
+#define TEST_NAME "fog_of_war"
+#include "check.hpp"
+
+constexpr uint32_t W = 200, H = 150, kPlayers = 3;
+
+// From scratch: every unit's disc, same rule as the stencils.
+static std::vector<uint8_t> brute_visible(UnitStore& units, uint32_t player) {
+    std::vector<uint8_t> vis(W * H, 0);
+    const auto& pool = units.pool<Sight>();
+    for (uint32_t i = 0; i < pool.size(); ++i) {
+        const Sight& s = pool.values()[i];
+        if (s.player != player) continue;
+        const Position* p = units.get<Position>(pool.entities()[i]);
+        const int cx = std::clamp(int(std::floor(p->x)), 0, int(W) - 1);
+        const int cy = std::clamp(int(std::floor(p->z)), 0, int(H) - 1);
+        const int r  = int(std::min(s.radius, FogOfWar::kMaxSight));
+        for (int y = std::max(0, cy - r); y <= std::min(int(H) - 1, cy + r); ++y)
+            for (int x = std::max(0, cx - r); x <= std::min(int(W) - 1, cx + r); ++x)
+                if ((x - cx) * (x - cx) + (y - cy) * (y - cy) <= r * r + r) vis[y * W + x] = 1;
+    }
+    return vis;
+}
+
+static std::vector<uint8_t> texels(const FogOfWar& fog, uint32_t player) {
+    std::vector<uint8_t> t(W * H);
+    fog.write_texels(player, FogRect{ 0, 0, W, H }, t.data());
+    return t;
+}
+
+int main() {
+    UnitStore units;
+    FogOfWar  fog;
+    fog.init(W, H, kPlayers);
+
+    std::mt19937 rng(47);
+    std::uniform_real_distribution<float> px(0.f, float(W)), pz(0.f, float(H)), step(-0.6f, 0.6f);
+    std::vector<Entity> es;
+    for (int i = 0; i < 300; ++i) {
+        Entity e = units.create();
+        units.add<Position>(e, { px(rng), 0.f, pz(rng) });
+        units.add<Sight>(e, { uint32_t(i) % kPlayers, 2 + uint32_t(i) % 9 });
+        es.push_back(e);
+    }
+    update_unit_fog(units, fog);
+    check(fog.stamps() == 300, "one stamp per unit");
+
+    update_unit_fog(units, fog);
+    check(fog.stamps() == 300, "nobody moved, nothing restamped");
+
+    std::vector<std::vector<uint8_t>> explored(kPlayers);
+    for (uint32_t p = 0; p < kPlayers; ++p) explored[p] = brute_visible(units, p);
+    std::vector<std::vector<uint8_t>> shown(kPlayers);   // what an uploader holds, patched with dirty rects
+    for (uint32_t p = 0; p < kPlayers; ++p) shown[p].assign(W * H, FogOfWar::kTexelHidden);
+
+    std::vector<FogRect> dirty;
+    bool all_match = true, explored_ok = true, uploads_ok = true;
+    for (int tick = 0; tick < 60; ++tick) {
+        for (Entity e : es) {
+            if (!units.alive(e)) continue;
+            Position* p = units.get<Position>(e);
+            p->x = std::clamp(p->x + step(rng), 0.f, float(W) - 0.01f);
+            p->z = std::clamp(p->z + step(rng), 0.f, float(H) - 0.01f);
+        }
+        if (tick == 30)   // a few die
+            for (int k = 0; k < 40; ++k) { fog.remove(es[size_t(k) * 7]); units.destroy(es[size_t(k) * 7]); }
+        if (tick == 40)   // sight upgrade for one player
+            for (uint32_t i = 0; i < units.pool<Sight>().size(); ++i)
+                if (units.pool<Sight>().values()[i].player == 1) units.pool<Sight>().values()[i].radius += 3;
+        update_unit_fog(units, fog);
+
+        for (uint32_t p = 0; p < kPlayers; ++p) {
+            const std::vector<uint8_t> vis = brute_visible(units, p);
+            for (uint32_t i = 0; i < W * H; ++i) {
+                explored[p][i] |= vis[i];
+                all_match   &= fog.visible(p, i % W, i / W) == bool(vis[i]);
+                explored_ok &= fog.explored(p, i % W, i / W) == bool(explored[p][i]);
+            }
+            // patching only the dirty rects must reproduce the full picture
+            dirty.clear();
+            fog.take_dirty(p, dirty);
+            for (const FogRect& r : dirty) {
+                std::vector<uint8_t> patch(size_t(r.w) * r.h);
+                fog.write_texels(p, r, patch.data());
+                for (uint32_t y = 0; y < r.h; ++y)
+                    for (uint32_t x = 0; x < r.w; ++x) shown[p][(r.y + y) * W + r.x + x] = patch[y * r.w + x];
+            }
+            uploads_ok &= shown[p] == texels(fog, p);
+        }
+    }
+    check(all_match, "incremental visibility matches a full recompute");
+    check(explored_ok, "explored is everything ever visible");
+    check(uploads_ok, "dirty rects cover every changed texel");
+    check(!fog.any_dirty(0) && !fog.any_dirty(2), "take_dirty clears the flags");
+
+    // a still world stamps nothing and dirties nothing
+    const uint64_t before = fog.stamps();
+    update_unit_fog(units, fog);
+    check(fog.stamps() == before && !fog.any_dirty(0), "idle tick is free");
+
+    // everyone leaves: nothing visible, explored stays
+    for (Entity e : es) if (units.alive(e)) fog.remove(e);
+    bool none = true, kept = false;
+    for (uint32_t p = 0; p < kPlayers; ++p)
+        for (uint32_t i = 0; i < W * H; ++i) { none &= !fog.visible(p, i % W, i / W); kept |= fog.explored(p, i % W, i / W); }
+    check(none, "no viewers, no vision");
+    check(kept, "explored is sticky");
+    check(!fog.remove(es[1]), "removing twice is refused");
+
+    fog.mark_all_dirty(1);
+    dirty.clear();
+    fog.take_dirty(1, dirty);
+    uint32_t covered = 0;
+    for (const FogRect& r : dirty) covered += r.w * r.h;
+    check(covered == W * H, "mark_all_dirty covers the map exactly");
+
+    if (g_failures) return 1;
+    std::printf("[fog_of_war] OK\n");
+    return 0;
+}
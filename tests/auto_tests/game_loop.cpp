@@ -0,0 +1,110 @@
+// tests/auto_tests/game_loop.cpp
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include "game_loop.hpp"
+
+#define TEST_NAME "game_loop"
+#include "check.hpp"
+
+// Every field written with the same tick: a reader seeing mixed values saw a torn snapshot.
+struct Snap {
+    uint64_t values[256];
+};
+
+// Time only moves when the test says so; shared with the sim thread.
+static std::atomic<int64_t> g_now{1'000'000'000};
+static int64_t fake_now() { return g_now.load(); }
+static void advance(std::chrono::nanoseconds d) { g_now += d.count(); }
+
+int main() {
+    using namespace std::chrono_literals;
+
+    // --- inline: ticks follow the clock, not pump() calls ---
+    {
+        GameLoop loop;
+        loop.set_clock(fake_now);
+        uint64_t ran = 0, published = 0;
+        loop.start(200.0, [&](uint64_t n) { check(n == ran, "inline tick order"); ++ran; },
+                          [&](uint64_t n) { published = n; }, /*threaded*/false, /*max_catchup*/1000);
+        check(loop.pump() == 0 && ran == 0, "nothing due at start");
+        advance(4ms);
+        check(loop.pump() == 0, "nothing due before one tick");
+        advance(8ms);   // 12ms: two ticks
+        check(loop.pump() == 2 && ran == 2, "ticks due so far run");
+        check(loop.pump() == 0, "pumping again runs nothing");
+        for (int i = 0; i < 50; ++i) { advance(3ms); loop.pump(); }   // 162ms
+        check(ran == 32, "inline tick count follows the clock");
+        check(published == ran, "inline publish after batch");
+        advance(500us);   // 162.5ms: half into tick 33
+        check(std::fabs(loop.alpha(ran) - 0.5f) < 1e-3f, "alpha is the fraction into the next tick");
+        check(loop.alpha(ran - 1) == 1.f && loop.alpha(ran + 1) == 0.f, "alpha clamped to 0..1");
+        loop.stop();
+    }
+
+    // --- catch-up clamp: a long stall drops time instead of running it all ---
+    {
+        GameLoop loop;
+        loop.set_clock(fake_now);
+        uint64_t ran = 0;
+        loop.start(1000.0, [&](uint64_t) { ++ran; }, nullptr, false, /*max_catchup*/4);
+        advance(50ms);
+        check(loop.pump() == 4, "stall clamps to max_catchup");
+        check(loop.stats().dropped_ticks == 46, "stall drops the rest");
+        advance(1ms);
+        check(loop.pump() == 1, "back on schedule after the drop");
+        loop.stop();
+    }
+
+    // --- threaded: sim ticks on its own while the "renderer" reads snapshots ---
+    {
+        SnapshotExchange<Snap> ex;
+        GameLoop loop;
+        loop.set_clock(fake_now);
+        uint64_t state = 0;   // sim-thread only
+        loop.start(500.0,
+            [&](uint64_t) { ++state; },
+            [&](uint64_t n) {
+                for (uint64_t& v : ex.write().values) v = state;
+                ex.publish(n);
+            },
+            /*threaded*/true, /*max_catchup*/1000);
+
+        // the renderer stalls for 100 ticks' worth: the sim runs them anyway
+        // (real time only bounds how long we wait for the thread)
+        const auto deadline = std::chrono::steady_clock::now() + 10s;
+        advance(200ms);
+        while (loop.ticks() < 100 && std::chrono::steady_clock::now() < deadline) std::this_thread::sleep_for(1ms);
+        check(loop.ticks() == 100, "render stalls don't slow the sim");
+        check(ex.acquire() && ex.current_tick() == 100, "latest snapshot after the stall");
+
+        // then reads race the sim thread as time moves, a tick at a time
+        uint64_t last = 0, seen = 0;
+        bool torn = false, backwards = false;
+        for (uint64_t target = 101; target <= 300 && std::chrono::steady_clock::now() < deadline; ++target) {
+            advance(2ms);
+            while (last < target && std::chrono::steady_clock::now() < deadline) {
+                if (!ex.acquire()) continue;
+                const Snap& s = ex.current();
+                for (uint64_t v : s.values) torn |= v != s.values[0];
+                backwards |= ex.current_tick() < last;
+                last = ex.current_tick();
+                ++seen;
+            }
+        }
+        loop.stop();
+
+        std::printf("[game_loop] threaded: %llu ticks, %llu snapshots read\n",
+                    (unsigned long long)loop.ticks(), (unsigned long long)seen);
+        check(ex.ready(), "snapshot ready");
+        check(!torn, "no torn snapshots");
+        check(!backwards, "snapshot ticks monotonic");
+        check(last == 300, "every tick published");
+    }
+
+    if (g_failures) return 1;
+    std::printf("[game_loop] OK\n");
+    return 0;
+}
@@ -0,0 +1,153 @@
+// tests/auto_tests/hpa_pathfinding.cpp
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "hpa.hpp"
+
+#define TEST_NAME "hpa_pathfinding"
+#include "check.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t N = 256;
+// HPA* only crosses sectors at transitions, so it can lose a little to the
+// grid optimum; it must never beat it.
+constexpr double kMaxStretch = 1.25;
+
+static uint32_t open_tile(const CostField& c, std::mt19937& rng) {
+    for (;;) {
+        const uint32_t i = rng() % (N * N);
+        if (c.cost[i] != CostField::kBlocked) return i;
+    }
+}
+
+// Compares 'queries' random HPA* paths against plain A*. Returns the worst stretch.
+static double compare(const HpaPathfinder& hpa, const CostField& c, std::mt19937& rng, int queries) {
+    double worst = 1.0;
+    std::vector<uint32_t> path, ref;
+    for (int q = 0; q < queries; ++q) {
+        const uint32_t a = open_tile(c, rng), b = open_tile(c, rng);
+        const uint32_t best = hpa::find_path_grid(c, a, b, ref);
+        const uint32_t got  = hpa.find_path(a, b, path);
+        if (best == hpa::kNoPath) {
+            check(got == hpa::kNoPath && path.empty(), "unreachable goal reported as such");
+            continue;
+        }
+        check(got != hpa::kNoPath, "reachable goal found");
+        if (got == hpa::kNoPath) continue;
+        check(path.front() == a && path.back() == b, "path runs start to goal");
+        check(hpa::path_cost(c, path) == got, "path is legal and costs what was reported");
+        check(got >= best, "never cheaper than the optimum");
+        worst = std::max(worst, double(got) / std::max(1u, best));
+    }
+    return worst;
+}
+
+int main() {
+    g_jobs.start();
+
+    CostField costs;
+    costs.width = costs.height = N;
+    costs.cost.assign(N * N, 1);
+    std::mt19937 rng(46);
+    for (int w = 0; w < 220; ++w) {   // thin walls, plenty of dead ends
+        const uint32_t x = rng() % N, y = rng() % N, len = 6 + rng() % 40;
+        const bool horizontal = rng() & 1;
+        for (uint32_t k = 0; k < len; ++k) {
+            const uint32_t tx = horizontal ? x + k : x, ty = horizontal ? y : y + k;
+            if (tx < N && ty < N) costs.cost[ty * N + tx] = CostField::kBlocked;
+        }
+    }
+    for (int m = 0; m < 30; ++m) {    // slow ground
+        const uint32_t cx = rng() % N, cy = rng() % N, r = 3 + rng() % 10;
+        for (uint32_t y = cy > r ? cy - r : 0; y < std::min(N, cy + r); ++y)
+            for (uint32_t x = cx > r ? cx - r : 0; x < std::min(N, cx + r); ++x)
+                if (costs.cost[y * N + x] == 1) costs.cost[y * N + x] = 4;
+    }
+    // a walled-in pocket nothing outside can reach
+    for (uint32_t k = 100; k <= 110; ++k) {
+        costs.cost[100 * N + k] = costs.cost[110 * N + k] = CostField::kBlocked;
+        costs.cost[k * N + 100] = costs.cost[k * N + 110] = CostField::kBlocked;
+    }
+
+    HpaPathfinder hpa;
+    hpa.build(costs, 16);
+    check(hpa.sector_count() == 256, "16x16 sectors");
+    check(hpa.node_count() > 0, "abstract graph has nodes");
+
+    std::vector<uint32_t> path;
+    check(hpa.find_path(5 * N + 5, 5 * N + 5, path) == 0 && path.size() == 1, "start == goal");
+    check(hpa.find_path(5 * N + 5, 105 * N + 105, path) == hpa::kNoPath, "walled pocket is unreachable");
+    check(hpa.find_path(100 * N + 100, 5 * N + 5, path) == hpa::kNoPath, "blocked start");
+
+    double worst = compare(hpa, costs, rng, 120);
+    check(worst <= kMaxStretch, "paths within the stretch bound");
+
+    // place buildings: blocks straddling sector borders, then repair just there
+    for (int b = 0; b < 24; ++b) {
+        const uint32_t x0 = (1 + rng() % 15) * 16 - 2, y0 = rng() % (N - 4);
+        for (uint32_t y = y0; y < y0 + 4; ++y)
+            for (uint32_t x = x0; x < x0 + 4; ++x) costs.cost[y * N + x] = CostField::kBlocked;
+        hpa.repair(x0, y0, x0 + 3, y0 + 3);
+    }
+    // open the pocket back up (a building destroyed)
+    costs.cost[100 * N + 105] = 1;
+    hpa.repair(105, 100, 105, 100);
+    check(hpa.find_path(5 * N + 5, 105 * N + 105, path) != hpa::kNoPath, "repair opens the pocket");
+
+    const double worst_repaired = compare(hpa, costs, rng, 120);
+    check(worst_repaired <= kMaxStretch, "paths within the stretch bound after repair");
+
+    // a repaired graph matches one built from scratch: same nodes, and the
+    // same cost for every query (any stale transition or in-sector edge
+    // shows up as a different answer somewhere)
+    HpaPathfinder fresh;
+    fresh.build(costs, 16);
+    check(fresh.node_count() == hpa.node_count(), "repair keeps the node count of a rebuild");
+    {
+        bool same = true;
+        std::vector<uint32_t> fresh_path;
+        for (int q = 0; q < 300; ++q) {
+            const uint32_t a = open_tile(costs, rng), b = open_tile(costs, rng);
+            same &= hpa.find_path(a, b, path) == fresh.find_path(a, b, fresh_path);
+        }
+        // across the repaired borders in particular
+        for (uint32_t y = 8; y < N; y += 16)
+            for (uint32_t x = 8; x + 16 < N; x += 16) {
+                const uint32_t a = y * N + x, b = y * N + x + 16;
+                if (costs.cost[a] == CostField::kBlocked || costs.cost[b] == CostField::kBlocked) continue;
+                same &= hpa.find_path(a, b, path) == fresh.find_path(a, b, fresh_path);
+            }
+        check(same, "repair matches a rebuild");
+    }
+
+    // batched throughput: queue, dispatch to the pool, collect
+    constexpr int kBatch = 1000;
+    std::vector<uint32_t> tickets;
+    auto t0 = Clock::now();
+    for (int q = 0; q < kBatch; ++q) tickets.push_back(hpa.request(open_tile(costs, rng), open_tile(costs, rng)));
+    hpa.dispatch();
+    hpa.wait();
+    int collected = 0;
+    for (uint32_t t : tickets) collected += hpa.poll(t, path);
+    const double batch_ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    check(collected == kBatch, "every ticket answered");
+    check(!hpa.poll(tickets[0], path), "a ticket is handed over once");
+
+    // the same queries through plain A* on this thread, for scale
+    std::vector<uint32_t> ref;
+    t0 = Clock::now();
+    for (int q = 0; q < 50; ++q) hpa::find_path_grid(costs, open_tile(costs, rng), open_tile(costs, rng), ref);
+    const double grid_ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count() / 50;
+
+    g_jobs.stop();
+    if (g_failures) return 1;
+    std::printf("[hpa_pathfinding] %u nodes, worst stretch %.3f / %.3f after repair\n",
+                hpa.node_count(), worst, worst_repaired);
+    std::printf("[hpa_pathfinding] batch of %d: %.1f ms (%.0f queries/s), grid A* %.3f ms/query\n",
+                kBatch, batch_ms, kBatch * 1000.0 / batch_ms, grid_ms);
+    std::printf("[hpa_pathfinding] OK\n");
+    return 0;
+}
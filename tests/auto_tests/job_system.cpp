@@ -0,0 +1,69 @@
+// tests/auto_tests/job_system.cpp
+#include <atomic>
+#include <cstdio>
+#include <vector>
+#include "jobs.hpp"
+
+#define TEST_NAME "job_system"
+#include "check.hpp"
+
+static void exercise(JobSystem& js, const char* label) {
+    std::printf("[job_system] %s: %u workers\n", label, js.worker_count());
+
+    // parallel_for covers every index exactly once
+    std::vector<uint32_t> hits(100000, 0);
+    js.parallel_for(uint32_t(hits.size()), 0, [&](uint32_t b, uint32_t e) {
+        for (uint32_t i = b; i < e; ++i) ++hits[i];
+    });
+    bool once = true;
+    for (uint32_t h : hits) once &= h == 1;
+    check(once, "parallel_for covers each index once");
+
+    // fan-out / fan-in through a counter, with nested jobs
+    std::atomic<uint32_t> leaves{0};
+    JobCounter fan;
+    for (int i = 0; i < 64; ++i) {
+        js.run([&] {
+            JobCounter inner;
+            for (int k = 0; k < 16; ++k) js.run([&] { leaves.fetch_add(1); }, &inner);
+            js.wait(inner);   // waiting inside a job runs other jobs
+        }, &fan);
+    }
+    js.wait(fan);
+    check(leaves.load() == 64 * 16, "nested fan-out completes");
+
+    // dependency chain: stage 2 starts only when stage 1 is done
+    std::atomic<uint32_t> stage1{0};
+    std::atomic<bool>     ordered{true};
+    JobCounter first, second;
+    for (int i = 0; i < 32; ++i) js.run([&] { stage1.fetch_add(1); }, &first);
+    for (int i = 0; i < 8; ++i)
+        js.run_after(first, [&] { if (stage1.load() != 32) ordered = false; }, &second);
+    js.wait(second);
+    check(ordered.load(), "run_after waits for its dependency");
+
+    // run_after on a counter that's already zero runs right away
+    JobCounter idle, after;
+    bool ran = false;
+    js.run_after(idle, [&] { ran = true; }, &after);
+    js.wait(after);
+    check(ran, "run_after on a finished counter");
+}
+
+int main() {
+    {
+        JobSystem inline_only;      // never started: the waiting thread runs everything
+        exercise(inline_only, "no workers");
+    }
+    {
+        JobSystem pool;
+        pool.start(4);
+        exercise(pool, "pool");
+        pool.stop();
+        check(!pool.running(), "stopped");
+    }
+
+    if (g_failures) return 1;
+    std::printf("[job_system] OK\n");
+    return 0;
+}
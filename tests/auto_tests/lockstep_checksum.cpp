@@ -0,0 +1,105 @@
+// tests/auto_tests/lockstep_checksum.cpp
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "lockstep.hpp"
+
+#define TEST_NAME "lockstep_checksum"
+#include "check.hpp"
+
+constexpr uint32_t kPlayers = 2, kUnitsPerPlayer = 200;
+constexpr uint64_t kTicks = 600;
+
+// Both players spawn their armies on tick 0, then keep ordering random
+// groups around; every command gets a per-player sequence number.
+static std::vector<SimCommand> make_game() {
+    std::mt19937 rng(49);
+    std::uniform_int_distribution<int32_t> coord(0, 200 * Fixed::kOne);
+    std::uniform_int_distribution<uint32_t> unit(0, kUnitsPerPlayer - 1);
+    std::vector<SimCommand> cmds;
+    uint32_t seq[kPlayers] = {};
+    for (uint32_t p = 0; p < kPlayers; ++p)
+        for (uint32_t i = 0; i < kUnitsPerPlayer; ++i)
+            cmds.push_back({ 0, p, seq[p]++, SimCommandType::Spawn, {},
+                             Fixed::from_raw(coord(rng)), Fixed::from_raw(coord(rng)) });
+    for (uint64_t t = 1; t < kTicks; t += 3)
+        for (uint32_t p = 0; p < kPlayers; ++p)
+            for (int k = 0; k < 8; ++k) {
+                // spawn order is (player, seq), so player p owns indices p*N .. p*N+N-1
+                const Entity e{ p * kUnitsPerPlayer + unit(rng), 0 };
+                const bool stop = rng() % 10 == 0;
+                cmds.push_back({ t, p, seq[p]++, stop ? SimCommandType::Stop : SimCommandType::Move, e,
+                                 Fixed::from_raw(coord(rng)), Fixed::from_raw(coord(rng)) });
+            }
+    return cmds;
+}
+
+// Everything scheduled up front, in the order given.
+static void run_all(LockstepSim& sim, const std::vector<SimCommand>& cmds) {
+    for (const SimCommand& c : cmds) sim.schedule(c);
+    while (sim.tick() < kTicks) sim.step();
+}
+
+int main() {
+    const std::vector<SimCommand> game = make_game();
+
+    LockstepSim a;
+    run_all(a, game);
+
+    // b hears the same commands the way a peer would: shuffled, each tick's
+    // batch arriving only just before it runs
+    LockstepSim b;
+    {
+        std::vector<SimCommand> shuffled = game;
+        std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(7));
+        std::stable_sort(shuffled.begin(), shuffled.end(),
+                         [](const SimCommand& x, const SimCommand& y) { return x.tick < y.tick; });
+        size_t next = 0;
+        while (b.tick() < kTicks) {
+            while (next < shuffled.size() && shuffled[next].tick == b.tick()) b.schedule(shuffled[next++]);
+            b.step();
+        }
+    }
+    check(a.checksums().size() == kTicks && b.checksums().size() == kTicks, "one checksum per tick");
+    check(first_desync(a.checksums(), b.checksums()) == UINT64_MAX, "arrival order doesn't matter");
+    check(a.checksum() == b.checksum(), "final states match");
+    check(a.state().pool<SimBody>().size() == kPlayers * kUnitsPerPlayer, "everyone spawned");
+
+    // units actually went somewhere: the state kept changing
+    {
+        uint32_t same = 0;
+        for (uint64_t t = 1; t < kTicks; ++t) same += a.checksums()[t] == a.checksums()[t - 1];
+        check(same == 0, "state changes every tick");
+        check(a.state().pool<SimMove>().size() < a.state().pool<SimBody>().size(), "some units arrived");
+    }
+
+    // orders for someone else's unit and late commands are dropped the same
+    // way everywhere
+    {
+        LockstepSim c;
+        std::vector<SimCommand> cheat = game;
+        cheat.push_back({ 50, 1, 1000000, SimCommandType::Move, Entity{ 0, 0 }, Fixed::from_int(5), Fixed::from_int(5) });
+        run_all(c, cheat);
+        check(first_desync(a.checksums(), c.checksums()) == UINT64_MAX, "foreign unit orders ignored");
+        check(!c.schedule({ 10, 0, 0, SimCommandType::Stop, Entity{ 0, 0 }, {}, {} }), "late command rejected");
+    }
+
+    // one command off by 1/65536 of a tile: the histories split on that tick
+    {
+        std::vector<SimCommand> altered = game;
+        // the tick's last move, so nothing later on the tick overrides it
+        auto it = std::find_if(altered.rbegin(), altered.rend(), [](const SimCommand& c) {
+            return c.tick == 301 && c.type == SimCommandType::Move;
+        });
+        it->x.raw += 1;
+        LockstepSim d;
+        run_all(d, altered);
+        check(first_desync(a.checksums(), d.checksums()) == 301, "desync found on the altered tick");
+    }
+
+    if (g_failures) return 1;
+    std::printf("[lockstep_checksum] OK\n");
+    return 0;
+}
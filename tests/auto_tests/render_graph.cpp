@@ -0,0 +1,149 @@
+// tests/auto_tests/render_graph.cpp
+// RenderGraph on the CPU through plan(): pass order, culling, transient
+// aliasing and the barriers between passes. No device needed.
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+#include "render_graph.hpp"
+
+#define TEST_NAME "render_graph"
+#include "check.hpp"
+
+static const VkExtent2D kExtent = { 64, 64 };
+static const RGImageDesc kColor = { VK_FORMAT_R8G8B8A8_UNORM, kExtent };
+
+static size_t position(const RenderGraph& g, uint32_t pass) {
+    const auto order = g.pass_order();
+    return size_t(std::find(order.begin(), order.end(), pass) - order.begin());
+}
+
+static RGMemoryReq same_size(RGHandle) { return { 1000, 256, 0 }; }
+
+int main() {
+    // --- ordering: dependencies hold, independent work goes in between ---
+    {
+        RenderGraph g;
+        const RGHandle x = g.create_transient("x", kColor), y = g.create_transient("y", kColor);
+        const RGHandle z = g.create_transient("z", kColor);
+        const RGHandle back = g.import_image("back", VK_FORMAT_B8G8R8A8_UNORM, kExtent, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+        const uint32_t a = g.add_pass("a", nullptr).color(x).index();
+        const uint32_t b = g.add_pass("b", nullptr).sampled(x).color(y).index();
+        const uint32_t c = g.add_pass("c", nullptr).color(z).index();
+        const uint32_t d = g.add_pass("d", nullptr).sampled(y).sampled(z).color(back).index();
+        g.plan(same_size);
+
+        check(g.live_pass_count() == 4, "every pass feeds the backbuffer");
+        check(position(g, a) < position(g, b) && position(g, b) < position(g, d) && position(g, c) < position(g, d),
+              "producers run before consumers");
+        const std::vector<uint32_t> expect = { a, c, b, d };
+        check(std::equal(g.pass_order().begin(), g.pass_order().end(), expect.begin(), expect.end()),
+              "independent pass scheduled between producer and consumer");
+    }
+
+    // --- write after read: a later clear waits for the earlier reader ---
+    {
+        RenderGraph g;
+        const RGHandle t = g.create_transient("t", kColor);
+        const RGHandle back = g.import_image("back", VK_FORMAT_B8G8R8A8_UNORM, kExtent, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+        const uint32_t w1 = g.add_pass("w1", nullptr).color(t).index();
+        const uint32_t r  = g.add_pass("r", nullptr).sampled(t).color(back).index();
+        const uint32_t w2 = g.add_pass("w2", nullptr).color(t).index();
+        const uint32_t r2 = g.add_pass("r2", nullptr).sampled(t).color(back, VK_ATTACHMENT_LOAD_OP_LOAD).index();
+        g.plan(same_size);
+        check(g.live_pass_count() == 4, "both writes live");
+        check(position(g, w1) < position(g, r) && position(g, r) < position(g, w2) && position(g, w2) < position(g, r2),
+              "rewrite waits for the reader");
+    }
+
+    // --- culling ---
+    {
+        RenderGraph g;
+        const RGHandle used   = g.create_transient("used", kColor);
+        const RGHandle unused = g.create_transient("unused", kColor);
+        const RGHandle chain  = g.create_transient("chain", kColor);
+        const RGHandle back   = g.import_image("back", VK_FORMAT_B8G8R8A8_UNORM, kExtent, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+        const uint32_t produce  = g.add_pass("produce", nullptr).color(used).index();
+        const uint32_t orphan   = g.add_pass("orphan", nullptr).color(unused).index();
+        const uint32_t dead_src = g.add_pass("dead_src", nullptr).color(chain).index();
+        const uint32_t dead_use = g.add_pass("dead_use", nullptr).sampled(chain).index();   // writes nothing
+        const uint32_t readback = g.add_pass("readback", nullptr).side_effect().index();
+        const uint32_t present  = g.add_pass("present", nullptr).sampled(used).color(back).index();
+        g.plan(same_size);
+
+        check(g.live_pass_count() == 3, "three live passes");
+        check(position(g, produce) < 3 && position(g, present) < 3 && position(g, readback) < 3, "live passes kept");
+        check(position(g, orphan) == 3, "output nobody reads is culled");
+        check(position(g, dead_src) == 3 && position(g, dead_use) == 3, "chain ending in nothing is culled");
+        check(g.transient_block(used) != UINT32_MAX, "used transient placed");
+        check(g.transient_block(unused) == UINT32_MAX && g.transient_block(chain) == UINT32_MAX,
+              "culled transients get no memory");
+        check(g.pass_barrier_count(orphan) == 0, "culled pass has no barriers");
+    }
+
+    // --- aliasing: a chain t1 -> t2 -> t3, so t1 and t3 never live together ---
+    {
+        RenderGraph g;
+        const RGHandle t1 = g.create_transient("t1", kColor), t2 = g.create_transient("t2", kColor);
+        const RGHandle t3 = g.create_transient("t3", kColor);
+        const RGHandle other = g.create_transient("other", kColor);   // lives the whole frame, other memory type
+        const RGHandle back  = g.import_image("back", VK_FORMAT_B8G8R8A8_UNORM, kExtent, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+        g.add_pass("p1", nullptr).color(t1).color(other);
+        g.add_pass("p2", nullptr).sampled(t1).color(t2);
+        g.add_pass("p3", nullptr).sampled(t2).color(t3);
+        g.add_pass("p4", nullptr).sampled(t3).sampled(other).color(back);
+        g.plan([&](RGHandle h) { return h == other ? RGMemoryReq{ 4096, 4096, 1 } : RGMemoryReq{ 1000, 256, 0 }; });
+
+        check(g.live_pass_count() == 4, "chain live");
+        check(g.transient_block(t1) == g.transient_block(t2) && g.transient_block(t2) == g.transient_block(t3),
+              "same memory type shares a block");
+        check(g.transient_block(other) != g.transient_block(t1), "other memory type, other block");
+        check(g.transient_offset(t1) == g.transient_offset(t3), "disjoint lifetimes alias");
+        const VkDeviceSize o1 = g.transient_offset(t1), o2 = g.transient_offset(t2);
+        check(o2 >= o1 + 1000 || o1 >= o2 + 1000, "overlapping lifetimes don't");
+        check(o2 % 256 == 0 && o1 % 256 == 0, "offsets aligned");
+        check(g.transient_bytes() == 1024 + 1000 + 4096, "two slots instead of three");
+
+        // a second plan starts over
+        g.plan([&](RGHandle h) { return h == other ? RGMemoryReq{ 4096, 4096, 1 } : RGMemoryReq{ 1000, 256, 0 }; });
+        check(g.transient_bytes() == 1024 + 1000 + 4096, "replanning gives the same layout");
+    }
+
+    // --- barriers: read-after-read in the same stage needs none ---
+    {
+        RenderGraph g;
+        const RGHandle t = g.create_transient("t", kColor);
+        const RGHandle back = g.import_image("back", VK_FORMAT_B8G8R8A8_UNORM, kExtent, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+        const uint32_t w  = g.add_pass("w", nullptr).color(t).index();
+        const uint32_t r1 = g.add_pass("r1", nullptr).sampled(t).color(back).index();
+        const uint32_t r2 = g.add_pass("r2", nullptr).sampled(t).color(back, VK_ATTACHMENT_LOAD_OP_LOAD).index();
+        const uint32_t r3 = g.add_pass("r3", nullptr).sampled(t, VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT)
+                                                  .color(back, VK_ATTACHMENT_LOAD_OP_LOAD).index();
+        g.plan(same_size);
+        check(g.pass_barrier_count(w) == 1, "first write: one barrier (from whatever held the memory)");
+        check(g.pass_barrier_count(r1) == 2, "first read: transition t, transition back");
+        check(g.pass_barrier_count(r2) == 1, "second read in the same stage: only back's write-after-write");
+        check(g.pass_barrier_count(r3) == 2, "read in a new stage: t's missing dependency, back's write-after-write");
+    }
+
+    // --- imported images: the first barrier makes earlier writes available ---
+    {
+        RenderGraph g;
+        // last frame's output, already in the layout we read it in
+        const RGHandle history = g.import_image("history", VK_FORMAT_R8G8B8A8_UNORM, kExtent,
+                                                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        // written earlier on the queue, kept (LOAD): a transition, not a discard
+        const RGHandle back = g.import_image("back", VK_FORMAT_B8G8R8A8_UNORM, kExtent,
+                                             VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+        const uint32_t p = g.add_pass("p", nullptr).sampled(history).color(back, VK_ATTACHMENT_LOAD_OP_LOAD).index();
+        g.plan(same_size);
+        check(g.pass_barrier_count(p) == 2, "read in place and transition both get a barrier");
+        bool all_available = g.pass_barrier_count(p) == 2;
+        for (size_t i = 0; i < g.pass_barrier_count(p); ++i)
+            all_available &= g.pass_barrier_src_access(p, i) != 0;
+        check(all_available, "first barrier on an imported image has a src access");
+    }
+
+    if (g_failures) return 1;
+    std::printf("[render_graph] OK\n");
+    return 0;
+}
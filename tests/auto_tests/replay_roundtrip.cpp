@@ -0,0 +1,110 @@
+// tests/auto_tests/replay_roundtrip.cpp
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <vector>
+#include "replay.hpp"
+
+#define TEST_NAME "replay_roundtrip"
+#include "check.hpp"
+
+// Fields a command type doesn't use aren't stored (Stop has no x/z).
+static bool same(const SimCommand& a, const SimCommand& b) {
+    return a.tick == b.tick && a.player == b.player && a.seq == b.seq && a.type == b.type &&
+           a.unit == b.unit && (a.type == SimCommandType::Stop || (a.x == b.x && a.z == b.z));
+}
+
+static bool same(const Replay& a, const Replay& b) {
+    if (a.ticks != b.ticks || a.checksum != b.checksum || a.commands.size() != b.commands.size()) return false;
+    for (size_t i = 0; i < a.commands.size(); ++i)
+        if (!same(a.commands[i], b.commands[i])) return false;
+    return true;
+}
+
+int main() {
+    // record a live game: commands scheduled a few ticks ahead, captured per step
+    constexpr uint32_t kPlayers = 3, kUnits = 60;
+    constexpr uint64_t kTicks = 400;
+    LockstepSim recorded;
+    Replay      replay;
+    {
+        std::mt19937 rng(50);
+        std::uniform_int_distribution<int32_t>  coord(-100 * Fixed::kOne, 100 * Fixed::kOne);
+        std::uniform_int_distribution<uint32_t> unit(0, kUnits - 1);
+        uint32_t seq[kPlayers] = {};
+        for (uint32_t p = 0; p < kPlayers; ++p)
+            for (uint32_t i = 0; i < kUnits; ++i)
+                recorded.schedule({ 0, p, seq[p]++, SimCommandType::Spawn, {},
+                                    Fixed::from_raw(coord(rng)), Fixed::from_raw(coord(rng)) });
+        while (recorded.tick() < kTicks) {
+            const uint64_t due = recorded.tick() + 3;
+            if (due < kTicks && rng() % 4 == 0) {
+                const uint32_t p = rng() % kPlayers, owner = rng() % 8 ? p : (p + 1) % kPlayers;
+                const Fixed    x = Fixed::from_raw(coord(rng)), z = Fixed::from_raw(coord(rng));
+                for (int k = 0; k < 6; ++k)
+                    recorded.schedule({ due, p, seq[p]++, rng() % 5 ? SimCommandType::Move : SimCommandType::Stop,
+                                        Entity{ owner * kUnits + unit(rng), 0 }, x, z });
+            }
+            recorded.step();
+            replay_capture(replay, recorded);
+        }
+    }
+    check(replay.ticks == kTicks && replay.checksum == recorded.checksum(), "capture tracks the sim");
+    check(replay.commands.size() > kPlayers * kUnits, "orders were recorded");
+
+    // bytes and back
+    const std::vector<uint8_t> bytes = encode_replay(replay);
+    Replay decoded;
+    check(decode_replay(bytes, decoded) && same(replay, decoded), "encode/decode round trip");
+    check(bytes.size() < replay.commands.size() * 12, "compact encoding");
+
+    // playback walks the same states
+    {
+        LockstepSim played;
+        check(replay_play(decoded, played), "playback matches the recorded checksum");
+        check(first_desync(recorded.checksums(), played.checksums()) == UINT64_MAX &&
+              played.checksums().size() == kTicks, "every tick matches");
+
+        // a move that lands: right type, player's own unit
+        Replay tampered = decoded;
+        size_t i = tampered.commands.size() / 2;
+        while (tampered.commands[i].type != SimCommandType::Move || tampered.commands[i].unit.index / kUnits != tampered.commands[i].player) ++i;
+        tampered.commands[i].x.raw ^= 1 << 12;
+        LockstepSim off;
+        check(!replay_play(tampered, off), "a changed command is caught");
+    }
+
+    // damaged files are rejected, never half-read
+    {
+        bool all_rejected = true;
+        for (size_t n = 0; n < bytes.size(); ++n)
+            all_rejected &= !decode_replay(std::span(bytes.data(), n), decoded);
+        check(all_rejected, "truncated data rejected");
+
+        std::vector<uint8_t> junk = bytes;
+        junk.push_back(0);
+        check(!decode_replay(junk, decoded), "trailing bytes rejected");
+        junk = bytes;
+        junk[0] = 'X';
+        check(!decode_replay(junk, decoded), "bad magic rejected");
+
+        Replay past_end = replay;
+        past_end.ticks = past_end.commands.back().tick;
+        check(!decode_replay(encode_replay(past_end), decoded), "commands past the end rejected");
+    }
+
+    // through a file
+    {
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / "replay_roundtrip.mgrp";
+        Replay loaded;
+        check(save_replay(path.string().c_str(), replay), "save");
+        check(load_replay(path.string().c_str(), loaded) && same(replay, loaded), "load");
+        std::filesystem::remove(path);
+        check(!load_replay(path.string().c_str(), loaded), "missing file");
+    }
+
+    if (g_failures) return 1;
+    std::printf("[replay_roundtrip] OK\n");
+    return 0;
+}
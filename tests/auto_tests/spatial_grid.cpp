@@ -0,0 +1,141 @@
+// tests/auto_tests/spatial_grid.cpp
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "unit_store.hpp"
+#include "selection.hpp"
+
+#define TEST_NAME "spatial_grid"
+#include "check.hpp"
+
+static bool less_entity(Entity a, Entity b) { return a.index < b.index; }
+
+static bool same_set(std::vector<Entity> a, std::vector<Entity> b) {
+    std::sort(a.begin(), a.end(), less_entity);
+    std::sort(b.begin(), b.end(), less_entity);
+    return a == b;
+}
+
+int main() {
+    constexpr float kWorld = 256.f;
+    UnitStore   units;
+    SpatialGrid grid;
+    grid.init(kWorld, kWorld, 8.f);
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> pos(0.f, kWorld), vel(-6.f, 6.f);
+    std::vector<Entity> es;
+    for (int i = 0; i < 3000; ++i) {
+        Entity e = units.create();
+        units.add<Position>(e, { pos(rng), 0.f, pos(rng) });
+        units.add<Velocity>(e, { vel(rng), vel(rng) });
+        es.push_back(e);
+    }
+    update_unit_grid(units, grid);
+    check(grid.size() == 3000, "every unit inserted");
+
+    // brute force references
+    auto brute_radius = [&](float x, float z, float r) {
+        std::vector<Entity> v;
+        const auto& pool = units.pool<Position>();
+        for (uint32_t i = 0; i < pool.size(); ++i) {
+            const Position& p = pool.values()[i];
+            if ((p.x - x) * (p.x - x) + (p.z - z) * (p.z - z) <= r * r) v.push_back(pool.entities()[i]);
+        }
+        return v;
+    };
+    auto brute_rect = [&](float x0, float z0, float x1, float z1) {
+        std::vector<Entity> v;
+        const auto& pool = units.pool<Position>();
+        for (uint32_t i = 0; i < pool.size(); ++i) {
+            const Position& p = pool.values()[i];
+            if (p.x >= x0 && p.x <= x1 && p.z >= z0 && p.z <= z1) v.push_back(pool.entities()[i]);
+        }
+        return v;
+    };
+
+    // --- incremental updates over many ticks, some units leaving the map ---
+    bool radius_ok = true, rect_ok = true;
+    std::vector<Entity> got;
+    for (int tick = 0; tick < 50; ++tick) {
+        integrate_velocity(units, 0.1f);
+        if (tick % 10 == 5)
+            for (int k = 0; k < 20; ++k) destroy_unit(units, grid, es[size_t(tick) * 20 + k]);
+        update_unit_grid(units, grid);
+
+        const float x = pos(rng), z = pos(rng);
+        got.clear();
+        grid.query_radius(x, z, 12.f, got);
+        radius_ok &= same_set(got, brute_radius(x, z, 12.f));
+        got.clear();
+        grid.query_rect(x + 20.f, z + 15.f, x - 20.f, z - 15.f, got);   // corners in any order
+        rect_ok &= same_set(got, brute_rect(x - 20.f, z - 15.f, x + 20.f, z + 15.f));
+    }
+    check(radius_ok, "radius queries match brute force");
+    check(rect_ok, "rect queries match brute force");
+    check(grid.size() == units.size(), "destroyed units leave the grid");
+    check(!grid.remove(es[5 * 20]) && !grid.contains(es[5 * 20]), "destroyed handle is gone");
+
+    // units pushed off the map clamp into border cells and are still found
+    got.clear();
+    grid.query_rect(-1e4f, -1e4f, 1e4f, 1e4f, got);
+    check(got.size() == units.size(), "everything inside the huge rect");
+
+    // --- box selection through both camera modes matches per-unit projection ---
+    for (CameraMode mode : { CameraMode::TopDown, CameraMode::Isometric }) {
+        Camera cam;
+        cam.mode = mode;
+        cam.target[0] = cam.target[2] = 128.f;
+        cam.zoom = 60.f;
+        cam.set_viewport(1280.f, 720.f);
+        cam.update();
+
+        const float box[4] = { 300.f, 200.f, 900.f, 520.f };
+        got.clear();
+        select_in_box(grid, cam, box[0], box[1], box[2], box[3], got);
+
+        std::vector<Entity> want;
+        const auto& pool = units.pool<Position>();
+        for (uint32_t i = 0; i < pool.size(); ++i) {
+            const Position& p = pool.values()[i];
+            float sx, sy;
+            if (cam.world_to_screen(p.x, p.y, p.z, sx, sy) &&
+                sx >= box[0] && sx <= box[2] && sy >= box[1] && sy <= box[3])
+                want.push_back(pool.entities()[i]);
+        }
+        check(!want.empty() && same_set(got, want), mode == CameraMode::TopDown ? "top-down box select"
+                                                                                 : "isometric box select");
+
+        // clicking right on a unit picks it
+        const Entity target = want.front();
+        const Position* p = units.get<Position>(target);
+        float sx, sy;
+        cam.world_to_screen(p->x, p->y, p->z, sx, sy);
+        const Entity hit = pick_unit(grid, cam, sx + 0.5f, sy - 0.5f, 1.5f);
+        check(hit.valid() && units.get<Position>(hit), "pick_unit finds a unit under the cursor");
+    }
+
+    // --- gestures from raw mouse input ---
+    BoxSelect sel;
+    MouseInput m;
+    m.begin_frame();
+    m.left = m.left_pressed = true; m.x = m.press_x = 100.f; m.y = m.press_y = 100.f;
+    check(sel.update(m) == BoxSelect::Gesture::None, "press alone is no gesture");
+    m.begin_frame();
+    m.x = 160.f; m.y = 40.f;
+    check(sel.update(m) == BoxSelect::Gesture::None && sel.dragging(), "moving past the threshold drags");
+    m.begin_frame();
+    m.left = false; m.left_released = true;
+    check(sel.update(m) == BoxSelect::Gesture::Box, "release ends the box");
+    check(sel.box()[0] == 100.f && sel.box()[1] == 40.f && sel.box()[2] == 160.f && sel.box()[3] == 100.f,
+          "box is sorted");
+
+    m.begin_frame();   // press and release within one poll, barely moving
+    m.left_pressed = m.left_released = true; m.press_x = 50.f; m.press_y = 50.f; m.x = 51.f; m.y = 50.f;
+    check(sel.update(m) == BoxSelect::Gesture::Click && sel.click_x() == 51.f, "short press is a click");
+
+    if (g_failures) return 1;
+    std::printf("[spatial_grid] OK\n");
+    return 0;
+}
@@ -0,0 +1,92 @@
+// tests/benchmarks/flow_field_512.cpp
+// Flow fields on a 512x512 tile map with walls and slow ground: one field
+// built on the calling thread, sixteen destinations through the cache on the
+// job pool, and steering 10k units along a shared field.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "flow_field.hpp"
+#include "unit_store.hpp"
+
+using Clock = std::chrono::steady_clock;
+static double ms_since(Clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+int main() {
+    constexpr uint32_t N = 512;
+    // tile types: 0 grass, 1 wall, 2 mud
+    const uint8_t cost_per_type[] = { 1, CostField::kBlocked, 4 };
+
+    TileMap map(N, N);
+    std::mt19937 rng(99);
+    for (int w = 0; w < 400; ++w) {   // walls: thin horizontal or vertical runs
+        const uint32_t x = rng() % N, y = rng() % N, len = 8 + rng() % 56;
+        const bool horizontal = rng() & 1;
+        for (uint32_t k = 0; k < len; ++k) {
+            const uint32_t tx = horizontal ? x + k : x, ty = horizontal ? y : y + k;
+            if (tx < N && ty < N) map.tiles()[size_t(ty) * N + tx].type = 1;
+        }
+    }
+    for (int m = 0; m < 60; ++m) {    // mud patches
+        const uint32_t cx = rng() % N, cy = rng() % N, r = 4 + rng() % 12;
+        for (uint32_t y = cy > r ? cy - r : 0; y < std::min(N, cy + r); ++y)
+            for (uint32_t x = cx > r ? cx - r : 0; x < std::min(N, cx + r); ++x)
+                if (map.at(x, y).type == 0) map.tiles()[size_t(y) * N + x].type = 2;
+    }
+
+    auto t0 = Clock::now();
+    CostField costs = cost_field_from_tiles(map, cost_per_type);
+    const double cost_ms = ms_since(t0);
+
+    // 1) one field, no workers: integration + direction on this thread
+    FlowField field;
+    constexpr int kSerialRuns = 5;
+    t0 = Clock::now();
+    for (int i = 0; i < kSerialRuns; ++i) build_flow_field(costs, N / 2, N / 2, field);
+    const double serial_ms = ms_since(t0) / kSerialRuns;
+    uint32_t reachable = 0;
+    for (uint8_t d : field.direction) reachable += d != kFlowNone;
+
+    // 2) sixteen destinations requested at once, built on the pool
+    g_jobs.start();
+    double cache_ms = 0;
+    {
+        FlowFieldCache cache(64);
+        cache.set_costs(costs);
+        t0 = Clock::now();
+        for (uint32_t g = 0; g < 16; ++g) cache.request(32 + (g % 4) * 140, 32 + (g / 4) * 140);
+        cache.wait_idle();
+        cache_ms = ms_since(t0);
+    }
+
+    // 3) 10k units in one group steering along a shared field, per tick
+    UnitStore units;
+    std::vector<Entity> group;
+    std::uniform_real_distribution<float> pos(0.f, float(N));
+    for (int i = 0; i < 10000; ++i) {
+        Entity e = units.create();
+        units.add<Position>(e, { pos(rng), 0.f, pos(rng) });
+        units.add<Velocity>(e, { 0.f, 0.f });
+        group.push_back(e);
+    }
+    constexpr int kTicks = 100;
+    t0 = Clock::now();
+    for (int t = 0; t < kTicks; ++t) {
+        steer_along(units, group, field, 3.f);
+        integrate_velocity(units, 1.f / 30.f);
+    }
+    const double steer_ms = ms_since(t0) / kTicks;
+
+    std::printf("flow field %ux%u: %u of %u tiles reach the goal\n", N, N, reachable, N * N);
+    std::printf("  cost field        %8.2f ms\n", cost_ms);
+    std::printf("  one field         %8.2f ms  (caller only)\n", serial_ms);
+    std::printf("  16 goals, cached  %8.2f ms  (%u workers + caller)\n", cache_ms, g_jobs.worker_count());
+    std::printf("  steer 10k units   %8.3f ms/tick\n", steer_ms);
+    g_jobs.stop();
+    return 0;
+}
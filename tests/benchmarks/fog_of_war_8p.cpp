@@ -0,0 +1,85 @@
+// tests/benchmarks/fog_of_war_8p.cpp
+// Fog of war for an 8-player game on a 1024x1024 map with 10k units moving
+// at walking pace: incremental updates (restamp on tile crossings) against
+// recomputing every player's bitsets from scratch each tick, plus how many
+// texels the dirty rects would upload for one player per tick.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "unit_store.hpp"
+
+using Clock = std::chrono::steady_clock;
+static double ms_since(Clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+int main() {
+    constexpr uint32_t N = 1024, kPlayers = 8, kUnits = 10000, kTicks = 120;
+    constexpr float    kDt = 1.f / 30.f;
+
+    UnitStore units;
+    std::mt19937 rng(8);
+    std::uniform_real_distribution<float> pos(0.f, float(N)), dir(-1.f, 1.f);
+    for (uint32_t i = 0; i < kUnits; ++i) {
+        Entity e = units.create();
+        units.add<Position>(e, { pos(rng), 0.f, pos(rng) });
+        units.add<Velocity>(e, { 3.f * dir(rng), 3.f * dir(rng) });   // up to ~4 tiles/s
+        units.add<Sight>(e, { i % kPlayers, 6 + i % 7 });
+    }
+    auto step = [&] {
+        integrate_velocity(units, kDt);
+        for (Position& p : units.pool<Position>().values()) {   // wrap at the edges
+            if (p.x < 0.f) p.x += float(N); else if (p.x >= float(N)) p.x -= float(N);
+            if (p.z < 0.f) p.z += float(N); else if (p.z >= float(N)) p.z -= float(N);
+        }
+    };
+
+    // 1) incremental
+    FogOfWar fog;
+    fog.init(N, N, kPlayers);
+    auto t0 = Clock::now();
+    update_unit_fog(units, fog);
+    const double first_ms = ms_since(t0);
+
+    std::vector<FogRect> dirty;
+    uint64_t texels = 0, rects = 0;
+    const uint64_t stamps0 = fog.stamps();
+    double inc_ms = 0;
+    for (uint32_t t = 0; t < kTicks; ++t) {
+        step();
+        t0 = Clock::now();
+        update_unit_fog(units, fog);
+        inc_ms += ms_since(t0);
+
+        dirty.clear();
+        fog.take_dirty(0, dirty);   // what player 0's FogTexture would upload
+        for (const FogRect& r : dirty) texels += uint64_t(r.w) * r.h;
+        rects += dirty.size();
+        for (uint32_t p = 1; p < kPlayers; ++p) { dirty.clear(); fog.take_dirty(p, dirty); }
+    }
+    const double stamps_per_tick = double(fog.stamps() - stamps0) / kTicks;
+
+    // 2) from scratch: a fresh FogOfWar per tick, every unit stamped
+    constexpr uint32_t kFullTicks = 10;
+    double full_ms = 0;
+    for (uint32_t t = 0; t < kFullTicks; ++t) {
+        step();
+        t0 = Clock::now();
+        FogOfWar scratch;
+        scratch.init(N, N, kPlayers);
+        update_unit_fog(units, scratch);
+        full_ms += ms_since(t0);
+    }
+
+    std::printf("fog of war %ux%u, %u players, %u units, %u ticks\n", N, N, kPlayers, kUnits, kTicks);
+    std::printf("  first stamp         %8.2f ms\n", first_ms);
+    std::printf("  incremental         %8.3f ms/tick  (%.0f restamps/tick)\n", inc_ms / kTicks, stamps_per_tick);
+    std::printf("  full recompute      %8.3f ms/tick\n", full_ms / kFullTicks);
+    std::printf("  player 0 upload     %8.1f KiB/tick in %.1f rects  (full image %u KiB)\n",
+                double(texels) / kTicks / 1024.0, double(rects) / kTicks, N * N / 1024);
+    return 0;
+}
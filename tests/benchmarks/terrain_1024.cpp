@@ -0,0 +1,91 @@
+// tests/benchmarks/terrain_1024.cpp
+// CPU side of the terrain on a 1024x1024 tile map: full mesh build (serial and
+// on the job pool), per-frame chunk culling while panning, and rebuilding the
+// chunks a few edits touch.
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "terrain_mesh.hpp"
+#include "camera.hpp"
+#include "jobs.hpp"
+
+using Clock = std::chrono::steady_clock;
+static double ms_since(Clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+int main() {
+    constexpr uint32_t N = 1024;
+    const uint32_t palette[] = { 0xFF3C8C3Cu, 0xFF2E6BB4u, 0xFF6FA0C8u, 0xFF808080u };
+
+    TileMap map(N, N);
+    std::mt19937 rng(1234);
+    for (uint32_t y = 0; y < N; ++y)
+        for (uint32_t x = 0; x < N; ++x)
+            map.tiles()[size_t(y) * N + x] = Tile{ uint8_t(((x / 7) ^ (y / 5)) & 3), uint8_t((x * y) % 13) };
+    map.mark_all_dirty();
+
+    // 1) full build (what create() does before uploading)
+    std::vector<TerrainVertex> verts(size_t(map.chunk_count()) * kTerrainChunkVerts);
+    std::vector<ChunkBounds>   bounds(map.chunk_count());
+    std::vector<uint32_t>      dirty;
+    auto t0 = Clock::now();
+    map.take_dirty(dirty);
+    for (uint32_t c : dirty) bounds[c] = build_chunk_mesh(map, c, palette, &verts[size_t(c) * kTerrainChunkVerts]);
+    const double build_ms = ms_since(t0);
+
+    // 1b) the same build spread over the job pool (what create() does now)
+    g_jobs.start();
+    t0 = Clock::now();
+    g_jobs.parallel_for(map.chunk_count(), 4, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t c = begin; c < end; ++c)
+            bounds[c] = build_chunk_mesh(map, c, palette, &verts[size_t(c) * kTerrainChunkVerts]);
+    });
+    const double par_build_ms = ms_since(t0);
+
+    // 2) culling while panning a 96x54-tile view across the map
+    constexpr int kFrames = 1000;
+    uint64_t drawn = 0;
+    Camera cam;
+    cam.mode  = CameraMode::TopDown;
+    cam.zoom  = 54.f;
+    cam.depth = 64.f;
+    cam.set_viewport(1920.f, 1080.f);
+    t0 = Clock::now();
+    for (int f = 0; f < kFrames; ++f) {
+        cam.target[0] = 48.f + (f % 928);
+        cam.target[2] = 27.f + ((f * 7) % 970);
+        cam.update();
+        for (const ChunkBounds& b : bounds) drawn += cam.visible(b.min, b.max);
+    }
+    const double cull_ms = ms_since(t0) / kFrames;
+
+    // 3) 100 scattered edits per frame, then rebuild only what they touched
+    constexpr int kEditFrames = 100;
+    uint64_t rebuilt = 0;
+    t0 = Clock::now();
+    for (int f = 0; f < kEditFrames; ++f) {
+        for (int e = 0; e < 100; ++e) {
+            const uint32_t x = rng() % N, y = rng() % N;
+            Tile t = map.at(x, y);
+            map.set(x, y, Tile{ uint8_t((t.type + 1) & 3), t.elevation });
+        }
+        dirty.clear();
+        map.take_dirty(dirty);
+        for (uint32_t c : dirty) bounds[c] = build_chunk_mesh(map, c, palette, &verts[size_t(c) * kTerrainChunkVerts]);
+        rebuilt += dirty.size();
+    }
+    const double edit_ms = ms_since(t0) / kEditFrames;
+
+    std::printf("terrain %ux%u: %u chunks, %.1f MiB vertices\n", N, N, map.chunk_count(),
+                verts.size() * sizeof(TerrainVertex) / (1024.0 * 1024.0));
+    std::printf("  full build      %8.2f ms\n", build_ms);
+    std::printf("  parallel build  %8.2f ms  (%u workers + caller)\n", par_build_ms, g_jobs.worker_count());
+    std::printf("  cull per frame  %8.4f ms  (%.1f chunks visible)\n", cull_ms, double(drawn) / kFrames);
+    std::printf("  100 edits/frame %8.3f ms  (%.1f chunks rebuilt)\n", edit_ms, double(rebuilt) / kEditFrames);
+    g_jobs.stop();
+    return 0;
+}
@@ -0,0 +1,284 @@
+// tests/visual_tests/draw_queue_view.cpp
+// DrawQueue on a device. Pass 0: a grid of opaque tiles in three materials
+// (one uniform-buffer descriptor set each), pushed in a fresh random order
+// every frame. Pass 1: translucent indexed hexagons circling the cursor,
+// keyed back to front by their distance to it, so the nearest end up on top
+// (their sets are rebound only where neighbours differ). sort() should bring
+// pass 0 down to one pipeline bind and three set binds however the tiles were
+// pushed; the console logs the bind counts whenever they change.
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "platform.hpp"
+#include "render.hpp"
+#include "render_pipeline.hpp"
+#include "shader_compile.hpp"
+#include "memory.hpp"
+#include "descriptors.hpp"
+#include "draw_queue.hpp"
+
+static const char* kTileVS = R"GLSL(
+#version 450
+layout(push_constant) uniform PC { vec4 rect; } pc;   // NDC x, y, w, h
+const vec2 kCorner[6] = vec2[](vec2(0,0), vec2(1,0), vec2(0,1),
+                               vec2(1,0), vec2(1,1), vec2(0,1));
+void main() {
+    gl_Position = vec4(pc.rect.xy + kCorner[gl_VertexIndex] * pc.rect.zw, 0.0, 1.0);
+}
+)GLSL";
+
+static const char* kShapeVS = R"GLSL(
+#version 450
+layout(push_constant) uniform PC { vec4 place; } pc;  // NDC offset.xy, scale.xy
+layout(location=0) in vec2 in_pos;
+void main() {
+    gl_Position = vec4(pc.place.xy + in_pos * pc.place.zw, 0.0, 1.0);
+}
+)GLSL";
+
+static const char* kMaterialFS = R"GLSL(
+#version 450
+layout(set=0, binding=0) uniform Material { vec4 color; } mat;
+layout(location=0) out vec4 outColor;
+void main() { outColor = mat.color; }
+)GLSL";
+
+static VkShaderModule make_shader(VkDevice dev, EShLanguage stage, std::string_view src, const char* dbg) {
+    auto res = shader::compile_glsl_to_spirv(stage, src, shader::Options(), dbg);
+    if (!res.ok) {
+        std::fprintf(stderr, "[draw_queue_view] %s compile failed:\n%s\n", dbg, res.log.c_str());
+        std::abort();
+    }
+    return shader::make_shader_module(dev, res.spirv);
+}
+
+static void fill(VkDevice device, GpuBuffer& buf, const void* src, size_t bytes) {
+    void* p = nullptr;
+    VK_CHECK(vkMapMemory(device, buf.memory(), 0, VK_WHOLE_SIZE, 0, &p));
+    std::memcpy(p, src, bytes);
+    vkUnmapMemory(device, buf.memory());
+}
+
+enum : uint16_t { kTilePipeline = 0, kShapePipeline = 1 };
+enum : uint8_t  { kOpaquePass = 0, kOverlayPass = 1 };
+
+int main() {
+    if (!platform_init(VK_API_VERSION_1_0, true)) {
+        std::fprintf(stderr, "[draw_queue_view] platform_init failed\n");
+        return 1;
+    }
+    VkDevice         device = g_vulkan.device;
+    VkPhysicalDevice phys   = g_vulkan.physical_device;
+    const VkExtent2D screen = g_vulkan.swapchain_extent;
+
+    RenderTargets    rt;
+    CommandResources cmd;
+    FrameSync        sync;
+    rt.init(device, g_vulkan.swapchain_format, g_vulkan.swapchain_extent, g_vulkan.swapchain_image_views,
+            VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_STORE,
+            VK_IMAGE_LAYOUT_UNDEFINED, g_vulkan.swapchain_images);
+    cmd.init(device, g_vulkan.graphics_family, rt.image_count());
+    sync.init(device);
+
+    const VkMemoryPropertyFlags host = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+    // ----- Materials: one uniform buffer and set each -----
+    DescriptorLayoutCache layouts;
+    DescriptorAllocator   descriptors;
+    layouts.init(device);
+    VK_CHECK(descriptors.create(device, 8));
+
+    const VkDescriptorSetLayoutBinding binding =
+        render::desc_binding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_FRAGMENT_BIT);
+    VkDescriptorSetLayout set_layout = VK_NULL_HANDLE;
+    VK_CHECK(layouts.get({ &binding, 1 }, set_layout));
+
+    constexpr uint32_t kMaterials = 3;
+    const float colors[kMaterials][4] = {
+        { 0.25f, 0.3f, 0.4f, 0.6f }, { 0.35f, 0.45f, 0.3f, 0.6f }, { 0.5f, 0.3f, 0.3f, 0.6f },
+    };
+    GpuBuffer       material_buffers[kMaterials];
+    VkDescriptorSet materials[kMaterials];
+    for (uint32_t m = 0; m < kMaterials; ++m) {
+        VK_CHECK(material_buffers[m].create(device, phys, sizeof(colors[m]), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, host));
+        fill(device, material_buffers[m], colors[m], sizeof(colors[m]));
+        VK_CHECK(descriptors.allocate(set_layout, materials[m]));
+        const VkDescriptorBufferInfo info = render::desc_buffer_info(material_buffers[m].buffer());
+        const VkWriteDescriptorSet   write = render::desc_write_buffer(materials[m], 0, &info, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+        vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+    }
+
+    // ----- Pipelines: both share one layout, so sets survive pipeline changes -----
+    VkShaderModule tile_vs  = make_shader(device, EShLangVertex,   kTileVS,     "tile_vs");
+    VkShaderModule shape_vs = make_shader(device, EShLangVertex,   kShapeVS,    "shape_vs");
+    VkShaderModule fs       = make_shader(device, EShLangFragment, kMaterialFS, "material_fs");
+
+    VkPushConstantRange pc{ VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(float) * 4 };
+    auto pl = render::layout_info({ &set_layout, 1 }, { &pc, 1 });
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+    VK_CHECK(vkCreatePipelineLayout(device, &pl, nullptr, &layout));
+
+    auto rs = render::rasterization_state_info(VK_CULL_MODE_NONE);
+    auto ms = render::multisample_state_info();
+    auto ia = render::input_assembly_info(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_FALSE);
+
+    VkPipeline tile_pipeline = VK_NULL_HANDLE, shape_pipeline = VK_NULL_HANDLE;
+    {
+        VkPipelineColorBlendAttachmentState att[1] = { render::no_blend };
+        auto stages = render::fragment_vertex_stage_info(fs, tile_vs);
+        VK_CHECK(render::create_graphics_pipeline(
+            tile_pipeline, device, stages, /*dynamic viewport*/nullptr, layout, rt.render_pass,
+            rs, render::color_blend_state(att), render::vertex_input_info(), ia, ms,
+            0, nullptr, nullptr, nullptr, 0, VK_NULL_HANDLE, -1, rt.pipeline_rendering()));
+    }
+    {
+        VkVertexInputBindingDescription bind{
+            .binding   = 0,
+            .stride    = sizeof(float) * 2,
+            .inputRate = VK_VERTEX_INPUT_RATE_VERTEX
+        };
+        VkVertexInputAttributeDescription attr{ .location=0, .binding=0, .format=VK_FORMAT_R32G32_SFLOAT, .offset=0 };
+        VkPipelineColorBlendAttachmentState att[1] = { render::alpha_blend };
+        auto stages = render::fragment_vertex_stage_info(fs, shape_vs);
+        VK_CHECK(render::create_graphics_pipeline(
+            shape_pipeline, device, stages, /*dynamic viewport*/nullptr, layout, rt.render_pass,
+            rs, render::color_blend_state(att), render::vertex_input_info({ &bind, 1 }, { &attr, 1 }), ia, ms,
+            0, nullptr, nullptr, nullptr, 0, VK_NULL_HANDLE, -1, rt.pipeline_rendering()));
+    }
+
+    // ----- Hexagon mesh: center + 6 corners, uint16 indices -----
+    float hex[7][2] = { { 0.f, 0.f } };
+    uint16_t hex_indices[18];
+    for (int i = 0; i < 6; ++i) {
+        const float a = float(i) * 1.04719755f;
+        hex[i + 1][0] = std::cos(a);
+        hex[i + 1][1] = std::sin(a);
+        hex_indices[i * 3 + 0] = 0;
+        hex_indices[i * 3 + 1] = uint16_t(1 + i);
+        hex_indices[i * 3 + 2] = uint16_t(1 + (i + 1) % 6);
+    }
+    GpuBuffer hex_vb, hex_ib;
+    VK_CHECK(hex_vb.create(device, phys, sizeof(hex), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, host));
+    VK_CHECK(hex_ib.create(device, phys, sizeof(hex_indices), VK_BUFFER_USAGE_INDEX_BUFFER_BIT, host));
+    fill(device, hex_vb, hex, sizeof(hex));
+    fill(device, hex_ib, hex_indices, sizeof(hex_indices));
+
+    // ----- Scene -----
+    constexpr uint32_t GW = 32, GH = 18, kHexes = 24;
+    std::vector<uint32_t> tile_order(GW * GH);
+    for (uint32_t i = 0; i < tile_order.size(); ++i) tile_order[i] = i;
+    std::mt19937 rng(29);
+
+    const float px_x = 2.f / float(screen.width), px_y = 2.f / float(screen.height);
+    DrawQueue queue;
+    DrawQueueStats last{};
+    uint64_t frame = 0;
+
+    while (!platform_should_quit()) {
+        // ----- queue the frame -----
+        queue.clear();
+        std::shuffle(tile_order.begin(), tile_order.end(), rng);
+        const float tw = 2.f / GW, th = 2.f / GH;
+        for (uint32_t i : tile_order) {
+            const uint32_t x = i % GW, y = i / GW;
+            DrawPacket p;
+            p.key         = draw_key::make(kOpaquePass, kTilePipeline, uint16_t((x / 4 + y / 3) % kMaterials));
+            p.pipeline    = tile_pipeline;
+            p.layout      = layout;
+            p.set         = materials[draw_key::material(p.key)];
+            p.count       = 6;
+            p.push_stages = VK_SHADER_STAGE_VERTEX_BIT;
+            p.push_size   = sizeof(float) * 4;
+            const float rect[4] = { -1.f + x * tw + 0.1f * tw, -1.f + y * th + 0.1f * th, 0.8f * tw, 0.8f * th };
+            queue.push(p, rect);
+        }
+
+        const float mx = g_mouse.x * px_x - 1.f, my = g_mouse.y * px_y - 1.f;
+        for (uint32_t i = 0; i < kHexes; ++i) {
+            const float a = 0.01f * float(frame) * (1.f + 0.1f * float(i % 5)) + float(i) * 0.7f;
+            const float r = 120.f + 12.f * float(i);
+            const float cx = mx + std::cos(a) * r * px_x, cy = my + std::sin(a) * r * px_y;
+            const float d  = std::hypot((cx - mx) / px_x, (cy - my) / px_y);
+            DrawPacket p;
+            // material left out of the key: depth alone orders the blended pass
+            p.key           = draw_key::make(kOverlayPass, kShapePipeline, 0, draw_key::depth(d, true));
+            p.pipeline      = shape_pipeline;
+            p.layout        = layout;
+            p.set           = materials[i % kMaterials];
+            p.vertex_buffer = hex_vb.buffer();
+            p.index_buffer  = hex_ib.buffer();
+            p.index_type    = VK_INDEX_TYPE_UINT16;
+            p.count         = 18;
+            p.push_stages   = VK_SHADER_STAGE_VERTEX_BIT;
+            p.push_size     = sizeof(float) * 4;
+            const float s = 40.f + 4.f * float(i % 7);
+            const float place[4] = { cx, cy, s * px_x, s * px_y };
+            queue.push(p, place);
+        }
+        queue.sort();
+        ++frame;
+
+        // ----- frame -----
+        VK_CHECK(vkWaitForFences(device, 1, &sync.in_flight_fence, VK_TRUE, UINT64_MAX));
+        VK_CHECK(vkResetFences(device, 1, &sync.in_flight_fence));
+
+        uint32_t imageIndex = 0;
+        VkResult acq = vkAcquireNextImageKHR(device, g_vulkan.swapchain, UINT64_MAX,
+                                             sync.image_available, VK_NULL_HANDLE, &imageIndex);
+        if (acq == VK_ERROR_OUT_OF_DATE_KHR) break;
+        VK_CHECK(acq);
+
+        VkCommandBuffer cb = cmd.buffers[imageIndex];
+        VK_CHECK(vkResetCommandBuffer(cb, 0));
+        VkCommandBufferBeginInfo bi{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+        VK_CHECK(vkBeginCommandBuffer(cb, &bi));
+
+        VkClearValue clear{}; clear.color = {{0.05f, 0.06f, 0.08f, 1.0f}};
+        rt.begin(cb, imageIndex, std::span{&clear, 1});
+        queue.replay(cb, kOpaquePass);
+        queue.replay(cb, kOverlayPass);
+        rt.end(cb, imageIndex);
+        VK_CHECK(vkEndCommandBuffer(cb));
+
+        const DrawQueueStats& st = queue.stats();
+        if (st.draws != last.draws || st.pipeline_binds != last.pipeline_binds ||
+            st.set_binds != last.set_binds || st.buffer_binds != last.buffer_binds) {
+            std::fprintf(stdout, "[draw_queue_view] %u draws: %u pipeline, %u set, %u buffer binds\n",
+                         st.draws, st.pipeline_binds, st.set_binds, st.buffer_binds);
+            last = st;
+        }
+
+        VK_CHECK(sync.submit_one(g_vulkan.graphics_queue, imageIndex, cmd));
+        VkResult pres = sync.present_one(g_vulkan.present_queue, g_vulkan.swapchain, imageIndex);
+        if (pres == VK_ERROR_OUT_OF_DATE_KHR || pres == VK_SUBOPTIMAL_KHR) break;
+        VK_CHECK(pres);
+    }
+
+    // ----- Cleanup -----
+    VK_CHECK(vkDeviceWaitIdle(device));
+    vkDestroyPipeline(device, tile_pipeline, nullptr);
+    vkDestroyPipeline(device, shape_pipeline, nullptr);
+    vkDestroyPipelineLayout(device, layout, nullptr);
+    hex_vb.destroy(device);
+    hex_ib.destroy(device);
+    for (GpuBuffer& b : material_buffers) b.destroy(device);
+    descriptors.destroy();
+    layouts.destroy();
+    vkDestroyShaderModule(device, tile_vs, nullptr);
+    vkDestroyShaderModule(device, shape_vs, nullptr);
+    vkDestroyShaderModule(device, fs, nullptr);
+    sync.shutdown(device);
+    cmd.shutdown(device);
+    rt.shutdown(device);
+    platform_shutdown();
+
+    std::fprintf(stdout, "[draw_queue_view] OK\n");
+    return 0;
+}
@@ -0,0 +1,269 @@
+// tests/visual_tests/flow_field_view.cpp
+// Flow-field debug view: walls, an arrow per tile pointing down the field,
+// shaded by distance to the goal. Left click moves the goal (fields come from
+// the cache, built on the job pool), right click toggles a wall (new costs,
+// cache dropped). Everything is drawn with TextRenderer's triangle instances
+// sampling one solid texel of the font atlas.
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <string_view>
+
+#include "platform.hpp"
+#include "render.hpp"
+#include "render_pipeline.hpp"
+#include "shader_compile.hpp"
+#include "text_format_caps.hpp"
+#include "text_atlas.hpp"
+#include "text_render.hpp"
+#include "camera.hpp"
+#include "flow_field.hpp"
+
+static const char* kFallbackFonts[] = {
+    "assets/Arialn.ttf",
+#ifdef __linux__
+    "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf",
+    "/usr/share/fonts/truetype/liberation/LiberationSans-Regular.ttf",
+#endif
+#ifdef _WIN32
+    "C:\\Windows\\Fonts\\arial.ttf",
+#endif
+#ifdef __APPLE__
+    "/System/Library/Fonts/Supplemental/Arial.ttf",
+    "/System/Library/Fonts/Supplemental/Helvetica.ttc",
+#endif
+};
+
+static bool try_build_cpu_atlas_from_any_font(uint32_t px, FontAtlasCPU& out) {
+    for (const char* path : kFallbackFonts)
+        if (build_cpu_font_atlas(free_type, path, px, out)) return true;
+    return false;
+}
+
+// uv "triangle" collapsed onto a fully covered atlas texel: solid color fill
+static bool find_solid_texel(const FontAtlasCPU& cpu, RightTriangle& uv) {
+    for (uint32_t y = 0; y < cpu.height; ++y)
+        for (uint32_t x = 0; x < cpu.width; ++x)
+            if (cpu.pixels[size_t(y) * cpu.width + x] == 255) {
+                uv = { (x + 0.5f) / cpu.width, (y + 0.5f) / cpu.height, 0.f, 0.f };
+                return true;
+            }
+    return false;
+}
+
+static void push_quad(std::vector<TriPair>& out, float x, float y, float w, float h, const RightTriangle& uv) {
+    out.push_back({ { x,     y,      w,  h }, uv });
+    out.push_back({ { x + w, y + h, -w, -h }, uv });
+}
+
+// Right triangles only have axis-aligned legs: a diagonal arrow is one wedge
+// with its right angle at the tip, a straight one is two halves split along
+// the shaft.
+static void push_arrow(std::vector<TriPair>& out, float cx, float cy, float s, uint8_t dir, const RightTriangle& uv) {
+    const float dx = float(kFlowDx[dir]), dy = float(kFlowDy[dir]);
+    if (dir & 1) {
+        const float tip_x = cx + dx * s * 0.35f, tip_y = cy + dy * s * 0.35f;
+        out.push_back({ { tip_x, tip_y, -dx * s * 0.7f, -dy * s * 0.7f }, uv });
+        return;
+    }
+    const float h = s * 0.4f, w = s * 0.25f;
+    if (dx != 0.f) {
+        out.push_back({ { cx - dx * h, cy, dx * 2.f * h,  w }, uv });
+        out.push_back({ { cx - dx * h, cy, dx * 2.f * h, -w }, uv });
+    } else {
+        out.push_back({ { cx, cy - dy * h,  w, dy * 2.f * h }, uv });
+        out.push_back({ { cx, cy - dy * h, -w, dy * 2.f * h }, uv });
+    }
+}
+
+static VkShaderModule make_shader(VkDevice dev, EShLanguage stage, std::string_view src, const char* dbg) {
+    auto res = shader::compile_glsl_to_spirv(stage, src, shader::Options(), dbg);
+    if (!res.ok) {
+        std::fprintf(stderr, "[flow_field_view] %s compile failed:\n%s\n", dbg, res.log.c_str());
+        std::abort();
+    }
+    return shader::make_shader_module(dev, res.spirv);
+}
+
+int main() {
+    if (!platform_init(VK_API_VERSION_1_0, true)) {
+        std::fprintf(stderr, "[flow_field_view] platform_init failed\n");
+        return 1;
+    }
+    const VkExtent2D screen = g_vulkan.swapchain_extent;
+
+    VkFormat format; VkFilter filter;
+    FontAtlasCPU cpu{};
+    RightTriangle solid{};
+    if (!pick_text_format_and_filter(g_vulkan.physical_device, format, filter) ||
+        !try_build_cpu_atlas_from_any_font(choose_font_px_for_screen(screen, 1.0 / 40.0), cpu) ||
+        !find_solid_texel(cpu, solid)) {
+        std::fprintf(stderr, "[flow_field_view] no usable font atlas\n");
+        platform_shutdown();
+        return 1;
+    }
+    FontAtlasGPU gpu{};
+    VK_CHECK(build_font_atlas_gpu(g_vulkan.device, g_vulkan.physical_device,
+                                  g_vulkan.graphics_queue, g_vulkan.graphics_family, format, cpu, gpu));
+    VkSampler sampler = VK_NULL_HANDLE;
+    (void)filter;   // the fills want NEAREST regardless
+    VK_CHECK(build_text_sampler(&sampler, VK_FILTER_NEAREST, g_vulkan.device));
+
+    RenderTargets    rt;
+    CommandResources cmd;
+    FrameSync        sync;
+    rt.init(g_vulkan.device, g_vulkan.swapchain_format, g_vulkan.swapchain_extent, g_vulkan.swapchain_image_views,
+            VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_STORE,
+            VK_IMAGE_LAYOUT_UNDEFINED, g_vulkan.swapchain_images);
+    cmd.init(g_vulkan.device, g_vulkan.graphics_family, rt.image_count());
+    sync.init(g_vulkan.device);
+
+    VkShaderModule vs = make_shader(g_vulkan.device, EShLangVertex,   text_render_vs, "text_render_vs");
+    VkShaderModule fs = make_shader(g_vulkan.device, EShLangFragment, text_render_fs, "text_render_fs");
+
+    DescriptorLayoutCache layouts;
+    DescriptorAllocator   descriptors;
+    layouts.init(g_vulkan.device);
+    VK_CHECK(descriptors.create(g_vulkan.device, 8));
+
+    TextRenderer text;
+    VK_CHECK(text.create(g_vulkan.device, rt.render_pass, vs, fs, gpu.view, sampler,
+                         layouts, descriptors, rt.pipeline_rendering()));
+    Camera camera;
+    camera.set_viewport(float(screen.width), float(screen.height));
+    float screen_view[4];
+    camera.screen_view(screen_view);
+    text.set_view(screen_view);
+
+    // ----- Map: a few walls with gaps, fitted to the screen -----
+    constexpr uint32_t W = 96, H = 54;
+    const float cell   = std::min(float(screen.width) / W, float(screen.height) / H);
+    const float left   = 0.5f * (float(screen.width)  - cell * W);
+    const float top    = 0.5f * (float(screen.height) - cell * H);
+
+    CostField costs;
+    costs.width = W; costs.height = H;
+    costs.cost.assign(size_t(W) * H, 1);
+    for (uint32_t y = 4; y < H - 4; ++y) {
+        if (y != H / 2)      costs.cost[size_t(y) * W + W / 3]     = CostField::kBlocked;
+        if (y > 10)          costs.cost[size_t(y) * W + 2 * W / 3] = CostField::kBlocked;
+    }
+    for (uint32_t x = 10; x < W / 3; ++x) costs.cost[size_t(H / 4) * W + x] = CostField::kBlocked;
+    for (uint32_t y = 30; y < 44; ++y)                                            // a patch of slow ground
+        for (uint32_t x = 40; x < 56; ++x) costs.cost[size_t(y) * W + x] = 6;
+
+    FlowFieldCache cache;
+    cache.set_costs(costs);
+    uint32_t goal_x = W - 8, goal_y = H / 2;
+    std::shared_ptr<const FlowField> field;
+
+    constexpr int kBands = 4;
+    const float band_color[kBands][4] = {
+        { 0.35f, 0.95f, 0.45f, 1.f }, { 0.75f, 0.9f, 0.3f, 1.f },
+        { 0.95f, 0.65f, 0.25f, 1.f }, { 0.9f, 0.3f, 0.25f, 1.f },
+    };
+    const float wall_color[4] = { 0.45f, 0.45f, 0.5f, 1.f };
+    const float mud_color[4]  = { 0.25f, 0.18f, 0.1f, 1.f };
+    const float goal_color[4] = { 1.f, 1.f, 1.f, 1.f };
+    const float hud_color[4]  = { 0.8f, 0.8f, 0.9f, 1.f };
+
+    std::vector<TriPair> walls, mud, goal, arrows[kBands];
+    char hud[160] = "";
+
+    MappedArena arena{};
+    VK_CHECK(arena.create(g_vulkan.device, g_vulkan.physical_device,
+                          sizeof(TriPair) * (4 * size_t(W) * H + 2 * sizeof(hud)), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT));
+
+    while (!platform_should_quit()) {
+        // ----- input: tile under the cursor -----
+        const int tx = int(std::floor((g_mouse.x - left) / cell));
+        const int ty = int(std::floor((g_mouse.y - top) / cell));
+        const bool on_map = tx >= 0 && ty >= 0 && tx < int(W) && ty < int(H);
+        if (on_map && g_mouse.left_pressed && costs.at(tx, ty) != CostField::kBlocked) {
+            goal_x = uint32_t(tx); goal_y = uint32_t(ty);
+        }
+        if (on_map && g_mouse.right_pressed && !(uint32_t(tx) == goal_x && uint32_t(ty) == goal_y)) {
+            uint8_t& c = costs.cost[size_t(ty) * W + tx];
+            c = c == CostField::kBlocked ? 1 : CostField::kBlocked;
+            cache.set_costs(costs);
+            field.reset();
+        }
+        // keep drawing the previous field until the new one lands
+        if (auto f = cache.request(goal_x, goal_y)) field = std::move(f);
+
+        // ----- geometry -----
+        walls.clear(); mud.clear(); goal.clear();
+        for (auto& a : arrows) a.clear();
+        uint32_t far = 1;
+        if (field)
+            for (uint32_t d : field->integration) if (d != FlowField::kUnreachable) far = std::max(far, d);
+        for (uint32_t y = 0; y < H; ++y)
+            for (uint32_t x = 0; x < W; ++x) {
+                const float px = left + x * cell, py = top + y * cell;
+                const uint8_t c = costs.at(x, y);
+                if (c == CostField::kBlocked) { push_quad(walls, px, py, cell, cell, solid); continue; }
+                if (c > 1) push_quad(mud, px, py, cell, cell, solid);
+                if (!field || field->width != W) continue;
+                const uint8_t d = field->dir_at(x, y);
+                if (d >= 8) continue;
+                const uint32_t band = std::min<uint32_t>(kBands - 1, uint32_t(uint64_t(field->integration[size_t(y) * W + x]) * kBands / (far + 1)));
+                push_arrow(arrows[band], px + 0.5f * cell, py + 0.5f * cell, cell, d, solid);
+            }
+        push_quad(goal, left + goal_x * cell + 0.15f * cell, top + goal_y * cell + 0.15f * cell, 0.7f * cell, 0.7f * cell, solid);
+        std::snprintf(hud, sizeof(hud), "goal %u,%u  %s  fields built %u  over capacity %u  [LMB goal, RMB wall]",
+                      goal_x, goal_y, field && field->goal_x == goal_x && field->goal_y == goal_y ? "ready" : "building",
+                      cache.builds(), cache.over_capacity());
+
+        // ----- frame -----
+        VK_CHECK(vkWaitForFences(g_vulkan.device, 1, &sync.in_flight_fence, VK_TRUE, UINT64_MAX));
+        VK_CHECK(vkResetFences(g_vulkan.device, 1, &sync.in_flight_fence));
+        arena.reset();
+
+        uint32_t imageIndex = 0;
+        VkResult acq = vkAcquireNextImageKHR(g_vulkan.device, g_vulkan.swapchain, UINT64_MAX,
+                                             sync.image_available, VK_NULL_HANDLE, &imageIndex);
+        if (acq == VK_ERROR_OUT_OF_DATE_KHR) break;
+        VK_CHECK(acq);
+
+        VkCommandBuffer cb = cmd.buffers[imageIndex];
+        VK_CHECK(vkResetCommandBuffer(cb, 0));
+        VkCommandBufferBeginInfo bi{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+        VK_CHECK(vkBeginCommandBuffer(cb, &bi));
+
+        VkClearValue clear{}; clear.color = {{0.05f, 0.06f, 0.08f, 1.0f}};
+        rt.begin(cb, imageIndex, std::span{&clear, 1});
+        VK_CHECK(text.record_draw(cb, arena, mud, mud_color));
+        VK_CHECK(text.record_draw(cb, arena, walls, wall_color));
+        for (int b = 0; b < kBands; ++b) VK_CHECK(text.record_draw(cb, arena, arrows[b], band_color[b]));
+        VK_CHECK(text.record_draw(cb, arena, goal, goal_color));
+        VK_CHECK(text.record_draw_line(cb, arena, hud, 8.f, float(measure_y_px(cpu)), 1.f, -1.f, cpu, hud_color));
+        rt.end(cb, imageIndex);
+        VK_CHECK(vkEndCommandBuffer(cb));
+
+        VK_CHECK(sync.submit_one(g_vulkan.graphics_queue, imageIndex, cmd));
+        VkResult pres = sync.present_one(g_vulkan.present_queue, g_vulkan.swapchain, imageIndex);
+        if (pres == VK_ERROR_OUT_OF_DATE_KHR || pres == VK_SUBOPTIMAL_KHR) break;
+        VK_CHECK(pres);
+    }
+
+    // ----- Cleanup -----
+    cache.wait_idle();
+    VK_CHECK(vkDeviceWaitIdle(g_vulkan.device));
+    text.destroy(g_vulkan.device);
+    descriptors.destroy();
+    layouts.destroy();
+    arena.destroy(g_vulkan.device);
+    vkDestroyShaderModule(g_vulkan.device, vs, nullptr);
+    vkDestroyShaderModule(g_vulkan.device, fs, nullptr);
+    vkDestroySampler(g_vulkan.device, sampler, nullptr);
+    destroy_gpu_font_atlas(g_vulkan.device, gpu);
+    sync.shutdown(g_vulkan.device);
+    cmd.shutdown(g_vulkan.device);
+    rt.shutdown(g_vulkan.device);
+    platform_shutdown();
+
+    std::fprintf(stdout, "[flow_field_view] OK\n");
+    return 0;
+}
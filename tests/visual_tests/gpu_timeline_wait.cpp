@@ -0,0 +1,98 @@
+// tests/visual_tests/gpu_timeline_wait.cpp
+// GpuTimeline::submit with a caller that chains its own
+// VkTimelineSemaphoreSubmitInfo: a wait on (and a signal of) another
+// timeline semaphore, once as the first pNext entry and once behind a
+// VkProtectedSubmitInfo. Both have to survive the merge with the
+// timeline's own signal. Needs a device; run with validation layers on.
+#include <cstdio>
+
+#include "platform.hpp"
+#include "gpu_timeline.hpp"
+
+#define TEST_NAME "gpu_timeline_wait"
+#include "../auto_tests/check.hpp"
+
+int main() {
+    if (!platform_init(VK_API_VERSION_1_2, true)) {
+        std::fprintf(stderr, "[gpu_timeline_wait] platform_init failed\n");
+        return 1;
+    }
+    if (!g_vulkan.timeline_semaphore) {
+        std::fprintf(stdout, "[gpu_timeline_wait] no timeline semaphores, nothing to test\n");
+        platform_shutdown();
+        return 0;
+    }
+    VkDevice device = g_vulkan.device;
+    VkQueue  queue  = g_vulkan.graphics_queue;
+
+    GpuTimeline timeline;
+    VK_CHECK(timeline.create(device));
+
+    // the caller's own timeline (e.g. an UploadQueue release semaphore)
+    VkSemaphoreTypeCreateInfo type{ VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO };
+    type.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    VkSemaphoreCreateInfo sci{ VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
+    sci.pNext = &type;
+    VkSemaphore other = VK_NULL_HANDLE;
+    VK_CHECK(vkCreateSemaphore(device, &sci, nullptr, &other));
+
+    // other = 1, submitted directly
+    {
+        const uint64_t one = 1;
+        VkTimelineSemaphoreSubmitInfo ts{ VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO };
+        ts.signalSemaphoreValueCount = 1;
+        ts.pSignalSemaphoreValues    = &one;
+        VkSubmitInfo si{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
+        si.pNext                = &ts;
+        si.signalSemaphoreCount = 1;
+        si.pSignalSemaphores    = &other;
+        VK_CHECK(vkQueueSubmit(queue, 1, &si, VK_NULL_HANDLE));
+    }
+
+    // wait other >= n, signal other = n + 1, through the timeline; 'front'
+    // (if any) goes ahead of the caller's timeline struct in the chain
+    auto step = [&](uint64_t n, VkBaseOutStructure* front) {
+        const uint64_t             wait_value = n, signal_value = n + 1;
+        const VkPipelineStageFlags stage      = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        VkTimelineSemaphoreSubmitInfo ts{ VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO };
+        ts.waitSemaphoreValueCount   = 1;
+        ts.pWaitSemaphoreValues      = &wait_value;
+        ts.signalSemaphoreValueCount = 1;
+        ts.pSignalSemaphoreValues    = &signal_value;
+        if (front) front->pNext = reinterpret_cast<VkBaseOutStructure*>(&ts);
+
+        VkSubmitInfo si{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
+        si.pNext                = front ? static_cast<const void*>(front) : &ts;
+        si.waitSemaphoreCount   = 1;
+        si.pWaitSemaphores      = &other;
+        si.pWaitDstStageMask    = &stage;
+        si.signalSemaphoreCount = 1;
+        si.pSignalSemaphores    = &other;
+        uint64_t value = 0;
+        VK_CHECK(timeline.submit(queue, si, value));
+        if (front) check(front->pNext == reinterpret_cast<VkBaseOutStructure*>(&ts), "caller's chain restored");
+        return value;
+    };
+
+    const uint64_t first = step(1, nullptr);
+    uint64_t last = first;
+    if (g_vulkan.api_version >= VK_API_VERSION_1_1) {
+        VkProtectedSubmitInfo prot{ VK_STRUCTURE_TYPE_PROTECTED_SUBMIT_INFO };
+        prot.protectedSubmit = VK_FALSE;
+        last = step(2, reinterpret_cast<VkBaseOutStructure*>(&prot));
+    }
+
+    check(timeline.wait(last, 2'000'000'000ull) == VK_SUCCESS, "timeline value signalled");
+    uint64_t counter = 0;
+    VK_CHECK(g_vulkan.get_semaphore_counter_value(device, other, &counter));
+    check(counter == (last == first ? 2u : 3u), "caller's timeline waits and signals kept");
+
+    VK_CHECK(vkDeviceWaitIdle(device));
+    vkDestroySemaphore(device, other, nullptr);
+    timeline.destroy();
+    platform_shutdown();
+
+    if (g_failures) return 1;
+    std::fprintf(stdout, "[gpu_timeline_wait] OK\n");
+    return 0;
+}
@@ -13,6 +13,8 @@
 #include "text_format_caps.hpp"
 #include "text_atlas.hpp"
 #include "text_render.hpp"   // your VB-only TextRenderer API
+#include "camera.hpp"
+#include "memory_overlay.hpp"
 #include <chrono>
 
 static const char* kFallbackFonts[] = {
@@ -40,15 +42,19 @@ static bool try_build_cpu_atlas_from_any_font(uint32_t px, FontAtlasCPU& out) {
     return false;
 }
 
-static VkShaderModule make_shader(VkDevice dev, EShLanguage stage,
-                                  std::string_view src, const char* dbg) {
-    shader::Options opt; // engine defaults (VK 1.0 / SPV 1.0 or whatever you default to)
-    auto res = shader::compile_glsl_to_spirv(stage, src, opt, dbg);
-    if (!res.ok) {
-        std::fprintf(stderr, "[text_render_hello] %s compile failed:\n%s\n", dbg, res.log.c_str());
+// Both stages compile side by side on the job pool.
+static void make_shaders(VkDevice dev, VkShaderModule& vs, VkShaderModule& fs) {
+    shader::CompileJob jobs[2] = {
+        { EShLangVertex,   text_render_vs, {}, "text_render_vs" },
+        { EShLangFragment, text_render_fs, {}, "text_render_fs" },
+    };
+    if (!shader::compile_many(jobs)) {
+        for (const auto& j : jobs)
+            if (!j.result.ok) std::fprintf(stderr, "[text_render_hello] compile failed:\n%s\n", j.result.log.c_str());
         std::abort();
     }
-    return shader::make_shader_module(dev, res.spirv);
+    vs = shader::make_shader_module(dev, jobs[0].result.spirv);
+    fs = shader::make_shader_module(dev, jobs[1].result.spirv);
 }
 
 int main(int argc, char** argv) {
@@ -92,32 +98,48 @@ int main(int argc, char** argv) {
     CommandResources cmd;
     FrameSync        sync;
 
-    rt.init(g_vulkan.device, g_vulkan.swapchain_format, g_vulkan.swapchain_extent, g_vulkan.swapchain_image_views);
-    cmd.init(g_vulkan.device, g_vulkan.graphics_family, static_cast<uint32_t>(rt.framebuffers.size()));
+    rt.init(g_vulkan.device, g_vulkan.swapchain_format, g_vulkan.swapchain_extent, g_vulkan.swapchain_image_views,
+            VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_STORE,
+            VK_IMAGE_LAYOUT_UNDEFINED, g_vulkan.swapchain_images);
+    cmd.init(g_vulkan.device, g_vulkan.graphics_family, rt.image_count());
     sync.init(g_vulkan.device);
 
     // ----- Shaders -----
-    VkShaderModule vs = make_shader(g_vulkan.device, EShLangVertex,   text_render_vs, "text_render_vs");
-    VkShaderModule fs = make_shader(g_vulkan.device, EShLangFragment, text_render_fs, "text_render_fs");
+    VkShaderModule vs = VK_NULL_HANDLE, fs = VK_NULL_HANDLE;
+    make_shaders(g_vulkan.device, vs, fs);
+
+    // ----- Descriptors -----
+    DescriptorLayoutCache layouts;
+    DescriptorAllocator   descriptors;   // persistent sets
+    layouts.init(g_vulkan.device);
+    VK_CHECK(descriptors.create(g_vulkan.device, /*initial_sets*/8));
 
     // ----- Text renderer -----
     TextRenderer text; // your class (VB-only under the hood)
 
-    // Create with static viewport/scissor from your globals
+    // Viewport/scissor are dynamic (rt.begin sets them)
     VK_CHECK(text.create(g_vulkan.device,
                          rt.render_pass,
                          vs, fs,
-                         g_vulkan.viewport,
-                         g_vulkan.scissor,
                          gpu.view,
-                         sampler));
+                         sampler,
+                         layouts, descriptors,
+                         rt.pipeline_rendering()));
 
     // Pre-reserve for worst-case glyph count (2 triangles per glyph)
     constexpr std::string_view kMsg = "Hello, world!";
 
-    // Pixel→NDC scale so RightTriangle positions are in clip space
-    const float sx_ndc = 2.0f / float(screen.width);
-    const float sy_ndc = -2.0f / float(screen.height); // minus: top-left pixel (0,0) → NDC (-1,+1)
+    // Lay text out in pixels (origin top-left, y down); the camera's screen
+    // view turns that into NDC in the vertex shader.
+    Camera camera;
+    camera.set_viewport(float(screen.width), float(screen.height));
+    float screen_view[4];
+    camera.screen_view(screen_view);
+    text.set_view(screen_view);
+
+    // Glyph scale in pixels: y is negated since glyph bearings point up.
+    const float sx = 1.0f;
+    const float sy = -1.0f;
 
     // Center horizontally, reasonable baseline vertically.
     const int text_w_px = measure_text_x_px(cpu, kMsg);
@@ -125,21 +147,12 @@ int main(int argc, char** argv) {
     const float origin_x_px = 0.5f * (float(screen.width) - float(text_w_px));
     const float origin_y_px = 0.5f * float(screen.height) + 0.35f * float(line_h_px); // eyeballed baseline
 
-    const float origin_x_ndc = -1.0f + sx_ndc * origin_x_px;
-    const float origin_y_ndc = +1.0f + sy_ndc * origin_y_px;
-
-    const float sx = sx_ndc;
-    const float sy = sy_ndc;
-
     const float color[4] = {1, 1, 1, 1}; // white
 
     // FPS padding and baseline (in pixels)
     constexpr int pad_px = 8;
-    const float fps_x_px        = float(pad_px);
-
-    // pixel→NDC (you’re using +X right, +Y down viewport)
-    const float fps_x_ndc = -1.0f + sx_ndc * fps_x_px;
-    const float fps_y_ndc = -0.95f - sy_ndc * measure_y_px(cpu);
+    const float fps_x_px = float(pad_px);
+    const float fps_y_px = float(pad_px + line_h_px);
 
     const float color_fps[4] = {0.6f, 0.0f, 0.6f, 1.0f};
 
@@ -147,9 +160,12 @@ int main(int argc, char** argv) {
     double acc = 0.0; int frames = 0;
     auto   t_last = std::chrono::steady_clock::now();
 
+    // Memory overlay under the FPS line
+    MemoryOverlay mem_overlay;
+
     MappedArena text_arena{};
     VK_CHECK(text_arena.create(g_vulkan.device, g_vulkan.physical_device, 
-        sizeof(TriPair)*uint32_t(kMsg.size()+sizeof(fps_buf)),
+        sizeof(TriPair)*uint32_t(kMsg.size()+sizeof(fps_buf)+2*MemoryOverlay::max_glyphs()),
         VK_BUFFER_USAGE_VERTEX_BUFFER_BIT
     ));
 
@@ -164,6 +180,7 @@ int main(int argc, char** argv) {
             double dt = std::chrono::duration<double>(t_now - t_last).count();
             t_last = t_now;
             acc += dt; frames++;
+            mem_overlay.update(g_vulkan.physical_device, dt);
             if (acc >= 0.25) {
 
                 float fps = frames / acc;
@@ -193,22 +210,21 @@ int main(int argc, char** argv) {
 
 
         VkClearValue clear{}; clear.color = {{0.06f, 0.06f, 0.09f, 1.0f}};
-        auto rpbi = render::render_pass_begin_info(
-            rt.render_pass, rt.framebuffers[imageIndex], g_vulkan.swapchain_extent, std::span{&clear,1});
-        vkCmdBeginRenderPass(cb, &rpbi, VK_SUBPASS_CONTENTS_INLINE);
+        rt.begin(cb, imageIndex, std::span{&clear,1});
 
         // Draw the line
         VK_CHECK(text.record_draw_line(cb,text_arena,
                                        kMsg,
-                                       origin_x_ndc, origin_y_ndc,  // pen origin in NDC
-                                       sx, sy,                       // pixel->NDC scale
+                                       origin_x_px, origin_y_px,    // pen origin in pixels
+                                       sx, sy,                       // glyph scale
                                        cpu,
                                        color));
         // FPS (top-left)
         std::string_view fps_sv(fps_buf);
         VK_CHECK(text.record_draw_line(cb,text_arena,
-                                       fps_sv, fps_x_ndc, fps_y_ndc, sx_ndc, sy_ndc, cpu, color_fps));
-        vkCmdEndRenderPass(cb);
+                                       fps_sv, fps_x_px, fps_y_px, sx, sy, cpu, color_fps));
+        VK_CHECK(mem_overlay.record(cb, text_arena, text, cpu, fps_x_px, fps_y_px + float(line_h_px)));
+        rt.end(cb, imageIndex);
         VK_CHECK(vkEndCommandBuffer(cb));
 
         VK_CHECK(sync.submit_one(g_vulkan.graphics_queue, imageIndex, cmd));
@@ -221,6 +237,8 @@ int main(int argc, char** argv) {
     // ----- Cleanup -----
     VK_CHECK(vkDeviceWaitIdle(g_vulkan.device));
     text.destroy(g_vulkan.device);
+    descriptors.destroy();
+    layouts.destroy();
     text_arena.destroy(g_vulkan.device);
     if (vs) vkDestroyShaderModule(g_vulkan.device, vs, nullptr);
     if (fs) vkDestroyShaderModule(g_vulkan.device, fs, nullptr);
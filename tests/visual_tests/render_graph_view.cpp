@@ -0,0 +1,235 @@
+// tests/visual_tests/render_graph_view.cpp
+// RenderGraph driving a whole frame: an animated pattern into a full-size
+// transient, downsampled into a half-size one, blurred into another, then
+// composited onto the imported swapchain image. A fifth pass writes an image
+// nobody reads and must be culled. 'scene' and 'blurred' never live at the
+// same time, so they should share memory; the console prints the pass order,
+// where each transient landed and the total transient bytes. Expect a soft,
+// slowly moving pattern with a vignette.
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+
+#include "platform.hpp"
+#include "render.hpp"
+#include "render_pipeline.hpp"
+#include "shader_compile.hpp"
+#include "descriptors.hpp"
+#include "text_render.hpp"
+#include "render_graph.hpp"
+
+static const char* kFullscreenVS = R"GLSL(
+#version 450
+layout(location=0) out vec2 vUV;
+void main() {
+    vUV = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
+    gl_Position = vec4(vUV * 2.0 - 1.0, 0.0, 1.0);
+}
+)GLSL";
+
+static const char* kPatternFS = R"GLSL(
+#version 450
+layout(push_constant) uniform PC { vec4 p; } pc;   // x = time
+layout(location=0) in  vec2 vUV;
+layout(location=0) out vec4 outColor;
+void main() {
+    vec2 q = vUV * 12.0;
+    float stripes = 0.5 + 0.5 * sin(q.x + q.y + pc.p.x * 2.0);
+    float rings   = 0.5 + 0.5 * sin(length(vUV - 0.5) * 40.0 - pc.p.x * 3.0);
+    outColor = vec4(stripes, rings, 0.5 + 0.5 * sin(pc.p.x), 1.0);
+}
+)GLSL";
+
+// copy (p.z = 0) or 3x3 blur spaced p.xy apart (p.z = 1), times a vignette (p.w)
+static const char* kFilterFS = R"GLSL(
+#version 450
+layout(set=0, binding=0) uniform sampler2D src;
+layout(push_constant) uniform PC { vec4 p; } pc;
+layout(location=0) in  vec2 vUV;
+layout(location=0) out vec4 outColor;
+void main() {
+    vec4 c = texture(src, vUV);
+    if (pc.p.z > 0.5) {
+        c = vec4(0.0);
+        for (int y = -1; y <= 1; ++y)
+            for (int x = -1; x <= 1; ++x)
+                c += texture(src, vUV + vec2(x, y) * pc.p.xy) * (float((2 - abs(x)) * (2 - abs(y))) / 16.0);
+    }
+    float v = 1.0 - pc.p.w * dot(vUV - 0.5, vUV - 0.5) * 2.0;
+    outColor = vec4(c.rgb * v, 1.0);
+}
+)GLSL";
+
+static VkShaderModule make_shader(VkDevice dev, EShLanguage stage, std::string_view src, const char* dbg) {
+    auto res = shader::compile_glsl_to_spirv(stage, src, shader::Options(), dbg);
+    if (!res.ok) {
+        std::fprintf(stderr, "[render_graph_view] %s compile failed:\n%s\n", dbg, res.log.c_str());
+        std::abort();
+    }
+    return shader::make_shader_module(dev, res.spirv);
+}
+
+int main() {
+    if (!platform_init(VK_API_VERSION_1_0, true)) {
+        std::fprintf(stderr, "[render_graph_view] platform_init failed\n");
+        return 1;
+    }
+    VkDevice         device = g_vulkan.device;
+    VkPhysicalDevice phys   = g_vulkan.physical_device;
+    const VkExtent2D screen = g_vulkan.swapchain_extent;
+    const VkExtent2D half   = { std::max(1u, screen.width / 2), std::max(1u, screen.height / 2) };
+
+    CommandResources cmd;
+    FrameSync        sync;
+    cmd.init(device, g_vulkan.graphics_family, uint32_t(g_vulkan.swapchain_images.size()));
+    sync.init(device);
+
+    VkShaderModule vs      = make_shader(device, EShLangVertex,   kFullscreenVS, "fullscreen_vs");
+    VkShaderModule pattern = make_shader(device, EShLangFragment, kPatternFS,    "pattern_fs");
+    VkShaderModule filter  = make_shader(device, EShLangFragment, kFilterFS,     "filter_fs");
+
+    DescriptorLayoutCache layouts;
+    DescriptorAllocator   descriptors;
+    layouts.init(device);
+    VK_CHECK(descriptors.create(device, 8));
+
+    const VkDescriptorSetLayoutBinding binding =
+        render::desc_binding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT);
+    VkDescriptorSetLayout set_layout = VK_NULL_HANDLE;
+    VK_CHECK(layouts.get({ &binding, 1 }, set_layout));
+
+    VkPushConstantRange pc{ VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(float) * 4 };
+    VkPipelineLayout pattern_layout = VK_NULL_HANDLE, filter_layout = VK_NULL_HANDLE;
+    auto ppl = render::layout_info({}, { &pc, 1 });
+    auto fpl = render::layout_info({ &set_layout, 1 }, { &pc, 1 });
+    VK_CHECK(vkCreatePipelineLayout(device, &ppl, nullptr, &pattern_layout));
+    VK_CHECK(vkCreatePipelineLayout(device, &fpl, nullptr, &filter_layout));
+
+    VkSampler sampler = VK_NULL_HANDLE;
+    VK_CHECK(build_text_sampler(&sampler, VK_FILTER_LINEAR, device));
+
+    // ----- Graph: declared once; the record functions read what's filled in below -----
+    VkPipeline      pipelines[4] = {};    // scene, down, blur, post
+    VkDescriptorSet sets[3]      = {};    // scene, half, blurred as sampled
+    float           time = 0.f;
+
+    auto fullscreen = [&](VkCommandBuffer cb, VkPipeline pipe, VkPipelineLayout layout, VkDescriptorSet set,
+                          const float p[4]) {
+        vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, pipe);
+        if (set) vkCmdBindDescriptorSets(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, 1, &set, 0, nullptr);
+        vkCmdPushConstants(cb, layout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(float) * 4, p);
+        vkCmdDraw(cb, 3, 1, 0, 0);
+    };
+
+    RenderGraph g;
+    const VkFormat color = VK_FORMAT_R8G8B8A8_UNORM;
+    const RGHandle scene   = g.create_transient("scene",   { color, screen });
+    const RGHandle halfres = g.create_transient("half",    { color, half });
+    const RGHandle blurred = g.create_transient("blurred", { color, half });
+    const RGHandle unused  = g.create_transient("unused",  { color, screen });
+    const RGHandle back    = g.import_image("swapchain", g_vulkan.swapchain_format, screen, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+
+    const uint32_t passes[4] = {
+        g.add_pass("scene", [&](VkCommandBuffer cb, const RenderGraph&) {
+            const float p[4] = { time, 0.f, 0.f, 0.f };
+            fullscreen(cb, pipelines[0], pattern_layout, VK_NULL_HANDLE, p);
+        }).color(scene).index(),
+        g.add_pass("down", [&](VkCommandBuffer cb, const RenderGraph&) {
+            const float p[4] = { 0.f, 0.f, 0.f, 0.f };
+            fullscreen(cb, pipelines[1], filter_layout, sets[0], p);
+        }).sampled(scene).color(halfres, VK_ATTACHMENT_LOAD_OP_DONT_CARE).index(),
+        g.add_pass("blur", [&](VkCommandBuffer cb, const RenderGraph&) {
+            const float p[4] = { 2.f / float(half.width), 2.f / float(half.height), 1.f, 0.f };
+            fullscreen(cb, pipelines[2], filter_layout, sets[1], p);
+        }).sampled(halfres).color(blurred, VK_ATTACHMENT_LOAD_OP_DONT_CARE).index(),
+        g.add_pass("post", [&](VkCommandBuffer cb, const RenderGraph&) {
+            const float p[4] = { 0.f, 0.f, 0.f, 1.f };
+            fullscreen(cb, pipelines[3], filter_layout, sets[2], p);
+        }).sampled(blurred).color(back, VK_ATTACHMENT_LOAD_OP_DONT_CARE).index(),
+    };
+    const uint32_t culled = g.add_pass("unused", [](VkCommandBuffer, const RenderGraph&) {
+        std::fprintf(stderr, "[render_graph_view] culled pass ran\n");
+        std::abort();
+    }).color(unused).index();
+    VK_CHECK(g.compile(device, phys));
+
+    std::fprintf(stdout, "[render_graph_view] %u live passes:", g.live_pass_count());
+    for (uint32_t p : g.pass_order()) std::fprintf(stdout, " %u", p);
+    std::fprintf(stdout, "  (pass %u culled)\n", culled);
+    for (RGHandle h : { scene, halfres, blurred, unused }) {
+        if (g.transient_block(h) == UINT32_MAX)
+            std::fprintf(stdout, "[render_graph_view]   transient %u: no memory\n", h);
+        else
+            std::fprintf(stdout, "[render_graph_view]   transient %u: block %u offset %llu\n", h,
+                         g.transient_block(h), (unsigned long long)g.transient_offset(h));
+    }
+    std::fprintf(stdout, "[render_graph_view] %llu transient bytes\n", (unsigned long long)g.transient_bytes());
+
+    // ----- Pipelines and sets: need the compiled passes and images -----
+    auto rs = render::rasterization_state_info(VK_CULL_MODE_NONE);
+    auto ms = render::multisample_state_info();
+    auto ia = render::input_assembly_info(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_FALSE);
+    VkPipelineColorBlendAttachmentState att[1] = { render::no_blend };
+    for (int i = 0; i < 4; ++i) {
+        auto stages = render::fragment_vertex_stage_info(i == 0 ? pattern : filter, vs);
+        VK_CHECK(render::create_graphics_pipeline(
+            pipelines[i], device, stages, /*dynamic viewport*/nullptr, i == 0 ? pattern_layout : filter_layout,
+            g.pass_render_pass(passes[i]), rs, render::color_blend_state(att), render::vertex_input_info(), ia, ms,
+            0, nullptr, nullptr, nullptr, 0, VK_NULL_HANDLE, -1, g.pass_rendering(passes[i])));
+    }
+    const RGHandle sampled[3] = { scene, halfres, blurred };
+    for (int i = 0; i < 3; ++i) {
+        VK_CHECK(descriptors.allocate(set_layout, sets[i]));
+        const VkDescriptorImageInfo info  = render::desc_image_info(sampler, g.view(sampled[i]));
+        const VkWriteDescriptorSet  write = render::desc_write_image(sets[i], 0, &info);
+        vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+    }
+
+    while (!platform_should_quit()) {
+        time += 1.f / 60.f;
+
+        VK_CHECK(vkWaitForFences(device, 1, &sync.in_flight_fence, VK_TRUE, UINT64_MAX));
+        VK_CHECK(vkResetFences(device, 1, &sync.in_flight_fence));
+
+        uint32_t imageIndex = 0;
+        VkResult acq = vkAcquireNextImageKHR(device, g_vulkan.swapchain, UINT64_MAX,
+                                             sync.image_available, VK_NULL_HANDLE, &imageIndex);
+        if (acq == VK_ERROR_OUT_OF_DATE_KHR) break;
+        VK_CHECK(acq);
+
+        VkCommandBuffer cb = cmd.buffers[imageIndex];
+        VK_CHECK(vkResetCommandBuffer(cb, 0));
+        VkCommandBufferBeginInfo bi{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+        VK_CHECK(vkBeginCommandBuffer(cb, &bi));
+
+        g.bind_imported(back, g_vulkan.swapchain_images[imageIndex], g_vulkan.swapchain_image_views[imageIndex]);
+        g.execute(cb);
+        VK_CHECK(vkEndCommandBuffer(cb));
+
+        VK_CHECK(sync.submit_one(g_vulkan.graphics_queue, imageIndex, cmd));
+        VkResult pres = sync.present_one(g_vulkan.present_queue, g_vulkan.swapchain, imageIndex);
+        if (pres == VK_ERROR_OUT_OF_DATE_KHR || pres == VK_SUBOPTIMAL_KHR) break;
+        VK_CHECK(pres);
+    }
+
+    // ----- Cleanup -----
+    VK_CHECK(vkDeviceWaitIdle(device));
+    for (VkPipeline p : pipelines) vkDestroyPipeline(device, p, nullptr);
+    vkDestroyPipelineLayout(device, pattern_layout, nullptr);
+    vkDestroyPipelineLayout(device, filter_layout, nullptr);
+    g.destroy(device);
+    descriptors.destroy();
+    layouts.destroy();
+    vkDestroySampler(device, sampler, nullptr);
+    vkDestroyShaderModule(device, vs, nullptr);
+    vkDestroyShaderModule(device, pattern, nullptr);
+    vkDestroyShaderModule(device, filter, nullptr);
+    sync.shutdown(device);
+    cmd.shutdown(device);
+    platform_shutdown();
+
+    std::fprintf(stdout, "[render_graph_view] OK\n");
+    return 0;
+}
@@ -0,0 +1,233 @@
+// tests/visual_tests/sprite_batch_view.cpp
+// SpriteBatch with three bindless textures: a ring, a checker and a 1x1
+// white texel for solid bars. A few thousand spinning icons drift around the
+// screen, each with a health bar. Pushed grouped by texture the batch is
+// three runs (one draw with descriptor indexing); left click toggles
+// interleaved pushes, which breaks every sprite into its own run on devices
+// without it. The reservation is a little short of the sprites pushed, so
+// the last few are refused every frame. The console logs draws per frame.
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "platform.hpp"
+#include "render.hpp"
+#include "render_pipeline.hpp"
+#include "shader_compile.hpp"
+#include "descriptors.hpp"
+#include "bindless.hpp"
+#include "text_atlas.hpp"
+#include "text_render.hpp"
+#include "sprite_batch.hpp"
+
+static VkShaderModule make_shader(VkDevice dev, EShLanguage stage, std::string_view src, const char* dbg) {
+    auto res = shader::compile_glsl_to_spirv(stage, src, shader::Options(), dbg);
+    if (!res.ok) {
+        std::fprintf(stderr, "[sprite_batch_view] %s compile failed:\n%s\n", dbg, res.log.c_str());
+        std::abort();
+    }
+    return shader::make_shader_module(dev, res.spirv);
+}
+
+// RGBA8 texels in a FontAtlasCPU: build_font_atlas_gpu copies whatever the
+// pixels hold, so with an RGBA format it uploads any small texture.
+static FontAtlasCPU texture_cpu(uint32_t size, uint32_t (*texel)(uint32_t x, uint32_t y, uint32_t size)) {
+    FontAtlasCPU cpu{};
+    cpu.width = cpu.height = size;
+    cpu.pixels.resize(size_t(size) * size * 4);
+    for (uint32_t y = 0; y < size; ++y)
+        for (uint32_t x = 0; x < size; ++x) {
+            const uint32_t c = texel(x, y, size);
+            for (int k = 0; k < 4; ++k) cpu.pixels[(size_t(y) * size + x) * 4 + k] = uint8_t(c >> (8 * k));
+        }
+    return cpu;
+}
+
+static uint32_t white(uint32_t, uint32_t, uint32_t) { return 0xFFFFFFFFu; }
+
+static uint32_t checker(uint32_t x, uint32_t y, uint32_t) {
+    return ((x / 4 + y / 4) & 1) ? 0xFFFFFFFFu : 0xFF606060u;
+}
+
+static uint32_t ring(uint32_t x, uint32_t y, uint32_t size) {
+    const float h = 0.5f * float(size), dx = float(x) + 0.5f - h, dy = float(y) + 0.5f - h;
+    const float d = std::sqrt(dx * dx + dy * dy) / h;   // 0 center .. 1 edge
+    const float a = std::clamp(1.f - std::abs(d - 0.75f) * 8.f, 0.f, 1.f);
+    return pack_rgba(1.f, 1.f, 1.f, a);
+}
+
+struct Icon {
+    float    x, y, vx, vy, spin, health;
+    uint32_t texture;   // 0 ring, 1 checker
+    uint32_t tint;
+};
+
+int main() {
+    if (!platform_init(VK_API_VERSION_1_2, true)) {
+        std::fprintf(stderr, "[sprite_batch_view] platform_init failed\n");
+        return 1;
+    }
+    VkDevice         device = g_vulkan.device;
+    VkPhysicalDevice phys   = g_vulkan.physical_device;
+    const VkExtent2D screen = g_vulkan.swapchain_extent;
+
+    RenderTargets    rt;
+    CommandResources cmd;
+    FrameSync        sync;
+    rt.init(device, g_vulkan.swapchain_format, g_vulkan.swapchain_extent, g_vulkan.swapchain_image_views,
+            VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_STORE,
+            VK_IMAGE_LAYOUT_UNDEFINED, g_vulkan.swapchain_images);
+    cmd.init(device, g_vulkan.graphics_family, rt.image_count());
+    sync.init(device);
+
+    // ----- Textures, registered before anything is submitted (the plain table needs that) -----
+    DescriptorLayoutCache layouts;
+    layouts.init(device);
+    BindlessTextures textures;
+    VK_CHECK(textures.create(device, layouts, 16));
+
+    VkSampler sampler = VK_NULL_HANDLE;
+    VK_CHECK(build_text_sampler(&sampler, VK_FILTER_LINEAR, device));
+
+    FontAtlasGPU images[3]{};
+    uint32_t     slots[3];
+    const FontAtlasCPU cpus[3] = { texture_cpu(32, ring), texture_cpu(32, checker), texture_cpu(1, white) };
+    for (int i = 0; i < 3; ++i) {
+        VK_CHECK(build_font_atlas_gpu(device, phys, g_vulkan.graphics_queue, g_vulkan.graphics_family,
+                                      VK_FORMAT_R8G8B8A8_UNORM, cpus[i], images[i]));
+        slots[i] = textures.add(images[i].view, sampler);
+        if (slots[i] == BindlessTextures::INVALID) {
+            std::fprintf(stderr, "[sprite_batch_view] bindless table full\n");
+            platform_shutdown();
+            return 1;
+        }
+    }
+    const uint32_t kWhite = slots[2];
+
+    VkShaderModule vs = make_shader(device, EShLangVertex,   sprite_batch_vs,           "sprite_batch_vs");
+    VkShaderModule fs = make_shader(device, EShLangFragment, sprite_batch_fs(textures), "sprite_batch_fs");
+
+    SpriteBatch batch;
+    VK_CHECK(batch.create(device, rt.render_pass, vs, fs, textures, rt.pipeline_rendering()));
+
+    // ----- Icons -----
+    constexpr uint32_t kIcons = 3000, kSprites = 2 * kIcons;   // icon + health bar
+    constexpr uint32_t kReserve = kSprites - 40;               // the last pushes get refused
+    std::mt19937 rng(35);
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    std::vector<Icon> icons(kIcons);
+    for (Icon& ic : icons) {
+        ic.x  = unit(rng) * float(screen.width);
+        ic.y  = unit(rng) * float(screen.height);
+        ic.vx = (unit(rng) - 0.5f) * 120.f;
+        ic.vy = (unit(rng) - 0.5f) * 120.f;
+        ic.spin    = (unit(rng) - 0.5f) * 4.f;
+        ic.health  = unit(rng);
+        ic.texture = rng() & 1;
+        ic.tint    = pack_rgba(0.5f + 0.5f * unit(rng), 0.5f + 0.5f * unit(rng), 0.5f + 0.5f * unit(rng), 1.f);
+    }
+
+    MappedArena arena{};
+    VK_CHECK(arena.create(device, phys, sizeof(SpriteInstance) * kReserve + 256, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT));
+
+    float view[4];
+    SpriteBatch::pixel_view(screen, view);
+
+    bool     interleave = false;
+    uint32_t last_draws = UINT32_MAX, time_step = 0;
+    std::vector<SpriteInstance> sprites;
+    sprites.reserve(kSprites);
+
+    while (!platform_should_quit()) {
+        if (g_mouse.left_pressed) interleave = !interleave;
+
+        // ----- simulate -----
+        const float dt = 1.f / 60.f;
+        const float t  = float(time_step++) * dt;
+        for (Icon& ic : icons) {
+            ic.x += ic.vx * dt; ic.y += ic.vy * dt;
+            if (ic.x < 0.f || ic.x > float(screen.width))  ic.vx = -ic.vx;
+            if (ic.y < 0.f || ic.y > float(screen.height)) ic.vy = -ic.vy;
+        }
+
+        // icons and bars, either grouped by texture or alternating
+        sprites.clear();
+        auto icon_sprite = [&](const Icon& ic) {
+            sprites.push_back({ ic.x, ic.y, 24.f, 24.f, 0.f, 0.f, 1.f, 1.f, ic.spin * t, ic.tint, slots[ic.texture], 0 });
+        };
+        auto bar_sprite = [&](const Icon& ic) {
+            const float w = 24.f * ic.health;
+            sprites.push_back({ ic.x - 12.f + 0.5f * w, ic.y - 17.f, w, 3.f, 0.f, 0.f, 1.f, 1.f, 0.f,
+                                pack_rgba(1.f - ic.health, ic.health, 0.1f, 1.f), kWhite, 0 });
+        };
+        if (interleave) {
+            for (const Icon& ic : icons) { icon_sprite(ic); bar_sprite(ic); }
+        } else {
+            for (uint32_t tex = 0; tex < 2; ++tex)
+                for (const Icon& ic : icons) if (ic.texture == tex) icon_sprite(ic);
+            for (const Icon& ic : icons) bar_sprite(ic);
+        }
+
+        // ----- frame -----
+        VK_CHECK(vkWaitForFences(device, 1, &sync.in_flight_fence, VK_TRUE, UINT64_MAX));
+        VK_CHECK(vkResetFences(device, 1, &sync.in_flight_fence));
+        arena.reset();
+
+        uint32_t imageIndex = 0;
+        VkResult acq = vkAcquireNextImageKHR(device, g_vulkan.swapchain, UINT64_MAX,
+                                             sync.image_available, VK_NULL_HANDLE, &imageIndex);
+        if (acq == VK_ERROR_OUT_OF_DATE_KHR) break;
+        VK_CHECK(acq);
+
+        VK_CHECK(batch.begin(arena, kReserve));
+        uint32_t refused = 0;
+        for (const SpriteInstance& s : sprites) refused += !batch.push(s);
+
+        VkCommandBuffer cb = cmd.buffers[imageIndex];
+        VK_CHECK(vkResetCommandBuffer(cb, 0));
+        VkCommandBufferBeginInfo bi{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+        VK_CHECK(vkBeginCommandBuffer(cb, &bi));
+
+        VkClearValue clear{}; clear.color = {{0.05f, 0.06f, 0.08f, 1.0f}};
+        rt.begin(cb, imageIndex, std::span{&clear, 1});
+        const uint32_t pushed = batch.size();
+        batch.record(cb, arena, textures, view);
+        rt.end(cb, imageIndex);
+        VK_CHECK(vkEndCommandBuffer(cb));
+
+        if (batch.draw_count() != last_draws) {
+            std::fprintf(stdout, "[sprite_batch_view] %s: %u sprites in %u draws, %u refused\n",
+                         interleave ? "interleaved" : "grouped", pushed, batch.draw_count(), refused);
+            last_draws = batch.draw_count();
+        }
+
+        VK_CHECK(sync.submit_one(g_vulkan.graphics_queue, imageIndex, cmd));
+        VkResult pres = sync.present_one(g_vulkan.present_queue, g_vulkan.swapchain, imageIndex);
+        if (pres == VK_ERROR_OUT_OF_DATE_KHR || pres == VK_SUBOPTIMAL_KHR) break;
+        VK_CHECK(pres);
+    }
+
+    // ----- Cleanup -----
+    VK_CHECK(vkDeviceWaitIdle(device));
+    batch.destroy(device);
+    textures.destroy();
+    layouts.destroy();
+    arena.destroy(device);
+    for (FontAtlasGPU& img : images) destroy_gpu_font_atlas(device, img);
+    vkDestroySampler(device, sampler, nullptr);
+    vkDestroyShaderModule(device, vs, nullptr);
+    vkDestroyShaderModule(device, fs, nullptr);
+    sync.shutdown(device);
+    cmd.shutdown(device);
+    rt.shutdown(device);
+    platform_shutdown();
+
+    std::fprintf(stdout, "[sprite_batch_view] OK\n");
+    return 0;
+}
@@ -0,0 +1,186 @@
+// tests/visual_tests/terrain_view.cpp
+// TerrainRenderer on a 256x256 tile map (64 chunks), colored by elevation.
+// Left drag pans, the wheel zooms, right click raises the ground under the
+// cursor (one or a few chunks rebuilt), middle click regenerates the whole
+// map. The update arena only holds 16 chunk meshes, so a regenerate takes
+// four frames of VK_INCOMPLETE; the console logs each partial update.
+// Chunks outside the view are culled on the CPU.
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <span>
+#include <string_view>
+
+#include "platform.hpp"
+#include "render.hpp"
+#include "render_pipeline.hpp"
+#include "shader_compile.hpp"
+#include "memory.hpp"
+#include "upload.hpp"
+#include "camera.hpp"
+#include "terrain.hpp"
+
+static VkShaderModule make_shader(VkDevice dev, EShLanguage stage, std::string_view src, const char* dbg) {
+    auto res = shader::compile_glsl_to_spirv(stage, src, shader::Options(), dbg);
+    if (!res.ok) {
+        std::fprintf(stderr, "[terrain_view] %s compile failed:\n%s\n", dbg, res.log.c_str());
+        std::abort();
+    }
+    return shader::make_shader_module(dev, res.spirv);
+}
+
+// RGBA8, R in the low byte: water, sand, grass, forest, rock, snow
+static const uint32_t kPalette[] = {
+    0xFFB0602Au, 0xFF7CC8E0u, 0xFF48A856u, 0xFF2E7034u, 0xFF707880u, 0xFFF0F0F0u,
+};
+constexpr uint32_t kTypes = sizeof(kPalette) / sizeof(kPalette[0]);
+constexpr uint8_t  kMaxElevation = 16;
+
+static Tile tile_for(int elevation) {
+    const uint8_t e = uint8_t(std::clamp(elevation, 0, int(kMaxElevation)));
+    return { uint8_t(std::min<uint32_t>(kTypes - 1, e * kTypes / (kMaxElevation + 1))), e };
+}
+
+// a few overlapping waves, shifted by 'seed'
+static void generate(TileMap& map, uint32_t seed) {
+    const float s = float(seed) * 1.7f;
+    std::span<Tile> tiles = map.tiles();
+    for (uint32_t y = 0; y < map.height(); ++y)
+        for (uint32_t x = 0; x < map.width(); ++x) {
+            const float fx = float(x), fy = float(y);
+            const float h = 0.5f + 0.25f * std::sin(fx * 0.031f + s) * std::cos(fy * 0.027f - s)
+                                 + 0.15f * std::sin((fx + fy) * 0.071f + 2.f * s)
+                                 + 0.08f * std::cos(fx * 0.19f - fy * 0.13f + s);
+            tiles[size_t(y) * map.width() + x] = tile_for(int(h * kMaxElevation));
+        }
+    map.mark_all_dirty();
+}
+
+int main() {
+    if (!platform_init(VK_API_VERSION_1_2, true)) {
+        std::fprintf(stderr, "[terrain_view] platform_init failed\n");
+        return 1;
+    }
+    VkDevice         device = g_vulkan.device;
+    VkPhysicalDevice phys   = g_vulkan.physical_device;
+    const VkExtent2D screen = g_vulkan.swapchain_extent;
+
+    RenderTargets    rt;
+    CommandResources cmd;
+    FrameSync        sync;
+    rt.init(device, g_vulkan.swapchain_format, g_vulkan.swapchain_extent, g_vulkan.swapchain_image_views,
+            VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_STORE,
+            VK_IMAGE_LAYOUT_UNDEFINED, g_vulkan.swapchain_images);
+    cmd.init(device, g_vulkan.graphics_family, rt.image_count());
+    sync.init(device);
+
+    VkShaderModule vs = make_shader(device, EShLangVertex,   terrain_vs, "terrain_vs");
+    VkShaderModule fs = make_shader(device, EShLangFragment, terrain_fs, "terrain_fs");
+
+    TileMap map(256, 256);
+    uint32_t seed = 0;
+    generate(map, seed);
+
+    UploadQueue uploads;
+    VK_CHECK(uploads.create(device, phys));
+    TerrainRenderer terrain;
+    VK_CHECK(terrain.create(device, phys, rt, vs, fs, uploads, map, kPalette));
+
+    // room for 16 chunk meshes per frame
+    MappedArena arena{};
+    VK_CHECK(arena.create(device, phys, 16 * VkDeviceSize(kTerrainChunkVerts) * sizeof(TerrainVertex),
+                          VK_BUFFER_USAGE_TRANSFER_SRC_BIT));
+
+    Camera camera;
+    camera.set_viewport(float(screen.width), float(screen.height));
+    camera.target[0] = 0.5f * float(map.width())  * kTerrainTileSize;
+    camera.target[2] = 0.5f * float(map.height()) * kTerrainTileSize;
+    camera.zoom      = 96.f;
+    camera.update();
+
+    bool middle_was_down = false;
+    uint32_t last_drawn = UINT32_MAX;
+
+    while (!platform_should_quit()) {
+        // ----- input -----
+        if (g_mouse.left && (g_mouse.dx != 0.f || g_mouse.dy != 0.f)) camera.pan_pixels(g_mouse.dx, g_mouse.dy);
+        if (g_mouse.wheel != 0.f) camera.zoom_at(std::pow(1.15f, g_mouse.wheel), g_mouse.x, g_mouse.y);
+        float wx, wz;
+        if (g_mouse.right_pressed && camera.screen_to_world(g_mouse.x, g_mouse.y, wx, wz)) {
+            // a 7x7 patch can straddle up to four chunks
+            const int cx = int(std::floor(wx / kTerrainTileSize)), cz = int(std::floor(wz / kTerrainTileSize));
+            for (int y = cz - 3; y <= cz + 3; ++y)
+                for (int x = cx - 3; x <= cx + 3; ++x)
+                    if (x >= 0 && y >= 0 && x < int(map.width()) && y < int(map.height()))
+                        map.set(uint32_t(x), uint32_t(y), tile_for(map.at(uint32_t(x), uint32_t(y)).elevation + 2));
+        }
+        if (g_mouse.middle && !middle_was_down) generate(map, ++seed);
+        middle_was_down = g_mouse.middle;
+
+        // ----- frame -----
+        VK_CHECK(vkWaitForFences(device, 1, &sync.in_flight_fence, VK_TRUE, UINT64_MAX));
+        VK_CHECK(vkResetFences(device, 1, &sync.in_flight_fence));
+        arena.reset();
+        uploads.collect();
+
+        uint32_t imageIndex = 0;
+        VkResult acq = vkAcquireNextImageKHR(device, g_vulkan.swapchain, UINT64_MAX,
+                                             sync.image_available, VK_NULL_HANDLE, &imageIndex);
+        if (acq == VK_ERROR_OUT_OF_DATE_KHR) break;
+        VK_CHECK(acq);
+
+        VkCommandBuffer cb = cmd.buffers[imageIndex];
+        VK_CHECK(vkResetCommandBuffer(cb, 0));
+        VkCommandBufferBeginInfo bi{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+        VK_CHECK(vkBeginCommandBuffer(cb, &bi));
+
+        // the initial meshes, on the first frame (a no-op afterwards)
+        VkSemaphore upload_wait = VK_NULL_HANDLE;
+        uint64_t    upload_value = 0;
+        if (!uploads.acquire(cb, upload_wait, upload_value)) upload_wait = VK_NULL_HANDLE;
+
+        const VkResult up = terrain.update(cb, arena, map);
+        if (up != VK_SUCCESS && up != VK_INCOMPLETE) {
+            // the arena can't take even one chunk: growing it is the caller's job
+            std::fprintf(stderr, "[terrain_view] update failed: %s\n", vk_result_str(up));
+            break;
+        }
+        const TerrainStats& st = terrain.stats();
+        if (st.chunks_rebuilt)
+            std::fprintf(stdout, "[terrain_view] rebuilt %u chunks, %u pending%s\n", st.chunks_rebuilt, st.chunks_pending,
+                         up == VK_INCOMPLETE ? " (arena full, rest next frame)" : "");
+
+        VkClearValue clear{}; clear.color = {{0.05f, 0.06f, 0.08f, 1.0f}};
+        rt.begin(cb, imageIndex, std::span{&clear, 1});
+        terrain.draw(cb, camera.view_proj());
+        rt.end(cb, imageIndex);
+        VK_CHECK(vkEndCommandBuffer(cb));
+
+        if (st.chunks_drawn != last_drawn) {
+            std::fprintf(stdout, "[terrain_view] %u chunks drawn, %u culled\n", st.chunks_drawn, st.chunks_culled);
+            last_drawn = st.chunks_drawn;
+        }
+
+        VK_CHECK(sync.submit_one(g_vulkan.graphics_queue, imageIndex, cmd, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                                 VK_NULL_HANDLE, upload_wait, upload_value, UploadQueue::wait_stage));
+        VkResult pres = sync.present_one(g_vulkan.present_queue, g_vulkan.swapchain, imageIndex);
+        if (pres == VK_ERROR_OUT_OF_DATE_KHR || pres == VK_SUBOPTIMAL_KHR) break;
+        VK_CHECK(pres);
+    }
+
+    // ----- Cleanup -----
+    VK_CHECK(vkDeviceWaitIdle(device));
+    terrain.destroy(device);
+    uploads.destroy();
+    arena.destroy(device);
+    vkDestroyShaderModule(device, vs, nullptr);
+    vkDestroyShaderModule(device, fs, nullptr);
+    sync.shutdown(device);
+    cmd.shutdown(device);
+    rt.shutdown(device);
+    platform_shutdown();
+
+    std::fprintf(stdout, "[terrain_view] OK\n");
+    return 0;
+}
@@ -105,29 +105,27 @@ int main(int argc, char** argv) {
     RenderTargets   rt;
     CommandResources cmd;
     FrameSync        sync;
-    rt.init(g_vulkan.device, g_vulkan.swapchain_format,
-            g_vulkan.swapchain_extent, g_vulkan.swapchain_image_views);
+    rt.init(g_vulkan.device, g_vulkan.swapchain_format, g_vulkan.swapchain_extent, g_vulkan.swapchain_image_views,
+            VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_STORE,
+            VK_IMAGE_LAYOUT_UNDEFINED, g_vulkan.swapchain_images);
     cmd.init(g_vulkan.device, g_vulkan.graphics_family,
-             static_cast<uint32_t>(rt.framebuffers.size()));
+             rt.image_count());
     sync.init(g_vulkan.device);
 
     // 4) Descriptor set (combined image sampler)
+    DescriptorLayoutCache layouts;
+    DescriptorAllocator   descriptors;
     VkDescriptorSetLayout dsl = VK_NULL_HANDLE;
-    VkDescriptorPool       dp  = VK_NULL_HANDLE;
-    VkDescriptorSet        ds  = VK_NULL_HANDLE;
+    VkDescriptorSet       ds  = VK_NULL_HANDLE;
 
     {
+        layouts.init(g_vulkan.device);
+        VK_CHECK(descriptors.create(g_vulkan.device, /*initial_sets=*/4));
+
         auto binding  = render::desc_binding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1,
                                      VK_SHADER_STAGE_FRAGMENT_BIT);
-        auto dslci    = render::desc_layout_info({&binding, 1});
-        VK_CHECK(vkCreateDescriptorSetLayout(g_vulkan.device, &dslci, nullptr, &dsl));
-
-        auto ps       = render::desc_pool_size(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1);
-        auto dpci     = render::desc_pool_info({&ps, 1}, /*max_sets=*/1);
-        VK_CHECK(vkCreateDescriptorPool(g_vulkan.device, &dpci, nullptr, &dp));
-
-        auto dsai     = render::desc_alloc_info(dp, {&dsl, 1});
-        VK_CHECK(vkAllocateDescriptorSets(g_vulkan.device, &dsai, &ds));
+        VK_CHECK(layouts.get({&binding, 1}, dsl));
+        VK_CHECK(descriptors.allocate(dsl, ds));
 
         auto di       = render::desc_image_info(sampler, gpu.view);
         auto w        = render::desc_write_image(ds, 0, &di);
@@ -157,22 +155,20 @@ int main(int argc, char** argv) {
 
         auto stages = render::fragment_vertex_stage_info(fs, vs);
 
-        auto vpst = render::viewport_state_info_static(
-            { &g_vulkan.viewport, 1 },
-            { &g_vulkan.scissor, 1 }
-        );
-
         //pipline
         const VkPipelineColorBlendAttachmentState blend = render::no_blend; // or alpha_blend
         VK_CHECK(render::create_graphics_pipeline_basic(
             /*outPipe*/ gp,
             /*device*/  g_vulkan.device,
             /*stages*/  stages,
-            /*viewport*/&vpst,
+            /*viewport*/nullptr,   // dynamic, set by rt.begin
             /*layout*/  pl,
             /*rp*/      rt.render_pass,
             /*cull*/    VK_CULL_MODE_NONE,
-            /*blend*/   blend
+            /*blend*/   blend,
+            /*subpass*/ 0,
+            /*dyn*/     nullptr,
+            /*rendering*/rt.pipeline_rendering()
         ));
     }
 
@@ -196,14 +192,7 @@ int main(int argc, char** argv) {
         VkClearValue clear{};
         clear.color = {{0.05f, 0.05f, 0.08f, 1.0f}};
 
-        auto rpbi = render::render_pass_begin_info(
-            rt.render_pass,
-            rt.framebuffers[imageIndex],
-            g_vulkan.swapchain_extent,
-            std::span{&clear, 1},
-            VkOffset2D{0,0}
-        );
-        vkCmdBeginRenderPass(cb, &rpbi, VK_SUBPASS_CONTENTS_INLINE);
+        rt.begin(cb, imageIndex, std::span{&clear, 1});
 
         vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, gp);
         vkCmdBindDescriptorSets(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, pl,
@@ -212,7 +201,7 @@ int main(int argc, char** argv) {
 
         vkCmdDraw(cb, 3, 1, 0, 0);
 
-        vkCmdEndRenderPass(cb);
+        rt.end(cb, imageIndex);
         VK_CHECK(vkEndCommandBuffer(cb));
 
         VK_CHECK(sync.submit_one(g_vulkan.graphics_queue, imageIndex, cmd));
@@ -228,8 +217,8 @@ int main(int argc, char** argv) {
     if (pl) vkDestroyPipelineLayout(g_vulkan.device, pl, nullptr);
     if (vs) vkDestroyShaderModule(g_vulkan.device, vs, nullptr);
     if (fs) vkDestroyShaderModule(g_vulkan.device, fs, nullptr);
-    if (dp) vkDestroyDescriptorPool(g_vulkan.device, dp, nullptr);
-    if (dsl) vkDestroyDescriptorSetLayout(g_vulkan.device, dsl, nullptr);
+    descriptors.destroy();
+    layouts.destroy();
     if (sampler) vkDestroySampler(g_vulkan.device,sampler,nullptr);
 
     destroy_gpu_font_atlas(g_vulkan.device, gpu);
@@ -87,8 +87,10 @@ static int run_visual_triangle_with_opts(const shader::Options& opt) {
     CommandResources cmds;
     FrameSync sync;
 
-    rt.init(g_vulkan.device, g_vulkan.swapchain_format, g_vulkan.swapchain_extent, g_vulkan.swapchain_image_views);
-    cmds.init(g_vulkan.device, g_vulkan.graphics_family, static_cast<uint32_t>(rt.framebuffers.size()));
+    rt.init(g_vulkan.device, g_vulkan.swapchain_format, g_vulkan.swapchain_extent, g_vulkan.swapchain_image_views,
+            VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_STORE,
+            VK_IMAGE_LAYOUT_UNDEFINED, g_vulkan.swapchain_images);
+    cmds.init(g_vulkan.device, g_vulkan.graphics_family, rt.image_count());
     sync.init(g_vulkan.device);
 
     // compile shaders
@@ -124,7 +126,8 @@ static int run_visual_triangle_with_opts(const shader::Options& opt) {
         /*cull=*/VK_CULL_MODE_NONE,     // keep old behavior; omit to use 3D defaults
         /*blend=*/render::no_blend,     // keep old behavior; omit to use alpha blend
         /*subpass=*/0,
-        /*dynamic_state=*/&dyn
+        /*dynamic_state=*/&dyn,
+        /*rendering=*/rt.pipeline_rendering()
     ));
 
     const double t0 = SDL_GetTicks() / 1000.0;
@@ -147,13 +150,7 @@ static int run_visual_triangle_with_opts(const shader::Options& opt) {
 
         VkClearValue clear; clear.color = {{0.02f,0.02f,0.02f,1.0f}};
         VkClearValue clears[1]={}; clears[0].color = {{0.02f,0.02f,0.02f,1.0f}};
-        auto rpbi = render::render_pass_begin_info(
-            rt.render_pass,
-            rt.framebuffers[image_index],
-            g_vulkan.swapchain_extent,
-            clears
-        );
-        vkCmdBeginRenderPass(cb, &rpbi, VK_SUBPASS_CONTENTS_INLINE);
+        rt.begin(cb, image_index, clears);
 
         vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, gp);
         vkCmdSetViewport(cb, 0, 1, &g_vulkan.viewport);
@@ -161,7 +158,7 @@ static int run_visual_triangle_with_opts(const shader::Options& opt) {
         vkCmdPushConstants(cb, pl, VK_SHADER_STAGE_VERTEX_BIT|VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(float), &t);
         vkCmdDraw(cb, 3, 1, 0, 0);
 
-        vkCmdEndRenderPass(cb);
+        rt.end(cb, image_index);
         VK_CHECK(vkEndCommandBuffer(cb));
 
         VK_CHECK(sync.submit_one(g_vulkan.graphics_queue, image_index, cmds));
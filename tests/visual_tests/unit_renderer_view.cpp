@@ -0,0 +1,269 @@
+// tests/visual_tests/unit_renderer_view.cpp
+// UnitRenderer through all three draw paths, side by side: the same grid of
+// spinning pyramids and cubes in three columns. Left: the device's own path
+// (vkCmdDrawIndexedIndirectCount when present). Middle: the same renderer
+// with draw_indirect_count switched off, so one multi-draw
+// vkCmdDrawIndexedIndirect. Right: a second renderer created without
+// drawIndirectFirstInstance, one indirect call per type with the slice
+// offset in the push constant. The three columns should look the same; the
+// console says which path each one took. No depth buffer: units overlap in
+// whatever order the cull pass wrote them.
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "platform.hpp"
+#include "render.hpp"
+#include "render_pipeline.hpp"
+#include "shader_compile.hpp"
+#include "memory.hpp"
+#include "descriptors.hpp"
+#include "camera.hpp"
+#include "unit_renderer.hpp"
+
+static VkShaderModule make_shader(VkDevice dev, EShLanguage stage, std::string_view src, const char* dbg) {
+    auto res = shader::compile_glsl_to_spirv(stage, src, shader::Options(), dbg);
+    if (!res.ok) {
+        std::fprintf(stderr, "[unit_renderer_view] %s compile failed:\n%s\n", dbg, res.log.c_str());
+        std::abort();
+    }
+    return shader::make_shader_module(dev, res.spirv);
+}
+
+static uint32_t rgba(float r, float g, float b) {
+    auto c = [](float v) { return uint32_t(std::clamp(v, 0.f, 1.f) * 255.f + 0.5f); };
+    return c(r) | c(g) << 8 | c(b) << 16 | 0xFFu << 24;
+}
+
+// Convex meshes around 'center': each triangle is turned to face outward
+// (counter-clockwise seen from outside, the pipeline culls back faces) and
+// shaded by how much it faces up.
+struct MeshBuilder {
+    std::vector<UnitVertex> vertices;
+    std::vector<uint32_t>   indices;
+
+    UnitMesh begin() const { return { 0, uint32_t(indices.size()), int32_t(vertices.size()) }; }
+    void end(UnitMesh& m) const { m.index_count = uint32_t(indices.size()) - m.first_index; }
+
+    void tri(const UnitMesh& m, const float* a, const float* b, const float* c, const float center[3], const float base[3]) {
+        const float e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+        const float e2[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+        float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+        const float mid[3] = { (a[0] + b[0] + c[0]) / 3.f - center[0], (a[1] + b[1] + c[1]) / 3.f - center[1],
+                               (a[2] + b[2] + c[2]) / 3.f - center[2] };
+        if (n[0] * mid[0] + n[1] * mid[1] + n[2] * mid[2] < 0.f) {
+            std::swap(b, c);
+            for (float& v : n) v = -v;
+        }
+        const float len   = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        const float shade = 0.55f + 0.45f * (len > 0.f ? n[1] / len : 0.f);
+        const uint32_t color = rgba(base[0] * shade, base[1] * shade, base[2] * shade);
+        const uint32_t first = uint32_t(vertices.size()) - uint32_t(m.vertex_offset);
+        for (const float* p : { a, b, c }) vertices.push_back({ p[0], p[1], p[2], color });
+        for (uint32_t i = 0; i < 3; ++i) indices.push_back(first + i);
+    }
+};
+
+static constexpr uint32_t kGrid = 32;                 // kGrid x kGrid units
+static constexpr float    kSpacing = 2.f;
+static constexpr float    kRadius  = 1.25f;           // both meshes fit in it at scale 1
+
+int main() {
+    if (!platform_init(VK_API_VERSION_1_2, true)) {
+        std::fprintf(stderr, "[unit_renderer_view] platform_init failed\n");
+        return 1;
+    }
+    VkDevice         device = g_vulkan.device;
+    VkPhysicalDevice phys   = g_vulkan.physical_device;
+    const VkExtent2D screen = g_vulkan.swapchain_extent;
+
+    RenderTargets    rt;
+    CommandResources cmd;
+    FrameSync        sync;
+    rt.init(device, g_vulkan.swapchain_format, g_vulkan.swapchain_extent, g_vulkan.swapchain_image_views,
+            VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_STORE,
+            VK_IMAGE_LAYOUT_UNDEFINED, g_vulkan.swapchain_images);
+    cmd.init(device, g_vulkan.graphics_family, rt.image_count());
+    sync.init(device);
+
+    // ----- Meshes: pyramid, cube, and a type no unit uses -----
+    MeshBuilder mb;
+    UnitMesh meshes[3];
+    {
+        const float center[3] = { 0.f, 0.4f, 0.f };
+        const float base[3]   = { 0.95f, 0.55f, 0.2f };
+        const float apex[3] = { 0.f, 1.2f, 0.f };
+        const float c[4][3] = { { -0.6f, 0.f, -0.6f }, { 0.6f, 0.f, -0.6f }, { 0.6f, 0.f, 0.6f }, { -0.6f, 0.f, 0.6f } };
+        meshes[0] = mb.begin();
+        for (int i = 0; i < 4; ++i) mb.tri(meshes[0], c[i], c[(i + 1) % 4], apex, center, base);
+        mb.tri(meshes[0], c[0], c[1], c[2], center, base);
+        mb.tri(meshes[0], c[0], c[2], c[3], center, base);
+        mb.end(meshes[0]);
+    }
+    {
+        const float center[3] = { 0.f, 0.5f, 0.f };
+        const float base[3]   = { 0.3f, 0.6f, 0.95f };
+        float v[8][3];
+        for (int i = 0; i < 8; ++i) {
+            v[i][0] = i & 1 ? 0.5f : -0.5f;
+            v[i][1] = i & 2 ? 1.f : 0.f;
+            v[i][2] = i & 4 ? 0.5f : -0.5f;
+        }
+        // faces as corner quads; tri() fixes the winding
+        const int quads[6][4] = { { 0, 1, 3, 2 }, { 4, 5, 7, 6 }, { 0, 1, 5, 4 }, { 2, 3, 7, 6 }, { 0, 2, 6, 4 }, { 1, 3, 7, 5 } };
+        meshes[1] = mb.begin();
+        for (const auto& q : quads) {
+            mb.tri(meshes[1], v[q[0]], v[q[1]], v[q[2]], center, base);
+            mb.tri(meshes[1], v[q[0]], v[q[2]], v[q[3]], center, base);
+        }
+        mb.end(meshes[1]);
+    }
+    meshes[2] = meshes[1];   // never referenced: its command keeps zero instances
+
+    // host-visible, written once
+    GpuBuffer vertices, indices;
+    const VkMemoryPropertyFlags host = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    VK_CHECK(vertices.create(device, phys, sizeof(UnitVertex) * mb.vertices.size(), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, host));
+    VK_CHECK(indices.create(device, phys, sizeof(uint32_t) * mb.indices.size(), VK_BUFFER_USAGE_INDEX_BUFFER_BIT, host));
+    auto fill = [&](GpuBuffer& buf, const void* src, size_t bytes) {
+        void* p = nullptr;
+        VK_CHECK(vkMapMemory(device, buf.memory(), 0, VK_WHOLE_SIZE, 0, &p));
+        std::memcpy(p, src, bytes);
+        vkUnmapMemory(device, buf.memory());
+    };
+    fill(vertices, mb.vertices.data(), sizeof(UnitVertex) * mb.vertices.size());
+    fill(indices,  mb.indices.data(),  sizeof(uint32_t) * mb.indices.size());
+
+    // ----- Renderers -----
+    VkShaderModule cs = make_shader(device, EShLangCompute,  unit_cull_cs,   "unit_cull_cs");
+    VkShaderModule vs = make_shader(device, EShLangVertex,   unit_render_vs, "unit_render_vs");
+    VkShaderModule fs = make_shader(device, EShLangFragment, unit_render_fs, "unit_render_fs");
+
+    DescriptorLayoutCache layouts;
+    DescriptorAllocator   descriptors;
+    layouts.init(device);
+    VK_CHECK(descriptors.create(device, 8));
+
+    constexpr uint32_t kUnits = kGrid * kGrid;
+    UnitRenderer indirect, per_draw;
+    VK_CHECK(indirect.create(device, phys, rt.render_pass, cs, vs, fs, layouts, descriptors,
+                             meshes, kUnits, rt.pipeline_rendering()));
+    // the renderer reads the flag once, in create()
+    const bool first_instance = g_vulkan.draw_indirect_first_instance;
+    g_vulkan.draw_indirect_first_instance = false;
+    VK_CHECK(per_draw.create(device, phys, rt.render_pass, cs, vs, fs, layouts, descriptors,
+                             meshes, kUnits, rt.pipeline_rendering()));
+    g_vulkan.draw_indirect_first_instance = first_instance;
+
+    const bool has_count = g_vulkan.draw_indirect_count;
+    auto path_name = [&](bool fi, bool count) {
+        return fi && count ? "DrawIndexedIndirectCount"
+             : fi && g_vulkan.multi_draw_indirect ? "multi-draw DrawIndexedIndirect" : "one DrawIndexedIndirect per type";
+    };
+    std::fprintf(stdout, "[unit_renderer_view] left:   %s\n", path_name(first_instance, has_count));
+    std::fprintf(stdout, "[unit_renderer_view] middle: %s\n", path_name(first_instance, false));
+    std::fprintf(stdout, "[unit_renderer_view] right:  %s\n", path_name(false, has_count));
+
+    MappedArena arena{};
+    VK_CHECK(arena.create(device, phys, 2 * sizeof(UnitInstance) * kUnits + 1024, VK_BUFFER_USAGE_TRANSFER_SRC_BIT));
+
+    // ----- Units: a grid alternating the two meshes, a few left out -----
+    std::vector<UnitInstance> units;
+    units.reserve(kUnits);
+    for (uint32_t z = 0; z < kGrid; ++z)
+        for (uint32_t x = 0; x < kGrid; ++x) {
+            if ((x * 7 + z * 3) % 11 == 0) continue;   // holes show a type's slice isn't read past its count
+            UnitInstance u{};
+            u.x      = (float(x) - 0.5f * (kGrid - 1)) * kSpacing;
+            u.z      = (float(z) - 0.5f * (kGrid - 1)) * kSpacing;
+            u.scale  = 0.8f + 0.4f * float((x + z) % 3) / 2.f;
+            u.radius = kRadius;
+            u.type   = (x + z) & 1;
+            u.tint   = rgba(0.6f + 0.4f * float(x) / kGrid, 1.f, 0.6f + 0.4f * float(z) / kGrid);
+            units.push_back(u);
+        }
+
+    // three columns, one camera: every column has the same size
+    const uint32_t col_w = screen.width / 3;
+    Camera camera;
+    camera.set_viewport(float(col_w), float(screen.height));
+    camera.zoom = kGrid * kSpacing * 0.6f;
+    uint64_t frame = 0;
+
+    while (!platform_should_quit()) {
+        for (size_t i = 0; i < units.size(); ++i)
+            units[i].yaw = 0.02f * float(frame) + 0.3f * float(i % 13);
+        camera.yaw = 0.78539816f + 0.002f * float(frame);
+        camera.update();
+        ++frame;
+
+        // ----- frame -----
+        VK_CHECK(vkWaitForFences(device, 1, &sync.in_flight_fence, VK_TRUE, UINT64_MAX));
+        VK_CHECK(vkResetFences(device, 1, &sync.in_flight_fence));
+        arena.reset();
+
+        uint32_t imageIndex = 0;
+        VkResult acq = vkAcquireNextImageKHR(device, g_vulkan.swapchain, UINT64_MAX,
+                                             sync.image_available, VK_NULL_HANDLE, &imageIndex);
+        if (acq == VK_ERROR_OUT_OF_DATE_KHR) break;
+        VK_CHECK(acq);
+
+        VkCommandBuffer cb = cmd.buffers[imageIndex];
+        VK_CHECK(vkResetCommandBuffer(cb, 0));
+        VkCommandBufferBeginInfo bi{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+        VK_CHECK(vkBeginCommandBuffer(cb, &bi));
+
+        for (UnitRenderer* r : { &indirect, &per_draw }) {
+            VK_CHECK(r->upload(cb, arena, units));
+            r->cull(cb, camera.view_proj());
+        }
+
+        VkClearValue clear{}; clear.color = {{0.05f, 0.06f, 0.08f, 1.0f}};
+        rt.begin(cb, imageIndex, std::span{&clear, 1});
+        const VkExtent2D col = { col_w, screen.height };
+
+        render::cmd_set_viewport_scissor(cb, col, { 0, 0 });
+        indirect.draw(cb, vertices.buffer(), indices.buffer(), camera.view_proj());
+
+        g_vulkan.draw_indirect_count = false;
+        render::cmd_set_viewport_scissor(cb, col, { int32_t(col_w), 0 });
+        indirect.draw(cb, vertices.buffer(), indices.buffer(), camera.view_proj());
+        g_vulkan.draw_indirect_count = has_count;
+
+        render::cmd_set_viewport_scissor(cb, col, { int32_t(2 * col_w), 0 });
+        per_draw.draw(cb, vertices.buffer(), indices.buffer(), camera.view_proj());
+
+        rt.end(cb, imageIndex);
+        VK_CHECK(vkEndCommandBuffer(cb));
+
+        VK_CHECK(sync.submit_one(g_vulkan.graphics_queue, imageIndex, cmd));
+        VkResult pres = sync.present_one(g_vulkan.present_queue, g_vulkan.swapchain, imageIndex);
+        if (pres == VK_ERROR_OUT_OF_DATE_KHR || pres == VK_SUBOPTIMAL_KHR) break;
+        VK_CHECK(pres);
+    }
+
+    // ----- Cleanup -----
+    VK_CHECK(vkDeviceWaitIdle(device));
+    indirect.destroy(device);
+    per_draw.destroy(device);
+    descriptors.destroy();
+    layouts.destroy();
+    arena.destroy(device);
+    vertices.destroy(device);
+    indices.destroy(device);
+    vkDestroyShaderModule(device, cs, nullptr);
+    vkDestroyShaderModule(device, vs, nullptr);
+    vkDestroyShaderModule(device, fs, nullptr);
+    sync.shutdown(device);
+    cmd.shutdown(device);
+    rt.shutdown(device);
+    platform_shutdown();
+
+    std::fprintf(stdout, "[unit_renderer_view] OK\n");
+    return 0;
+}